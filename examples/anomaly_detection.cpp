@@ -16,19 +16,6 @@
 
 using namespace dpan;
 
-/// Convert float array to byte vector
-std::vector<uint8_t> FloatsToBytes(const std::vector<float>& floats) {
-    std::vector<uint8_t> bytes;
-    bytes.reserve(floats.size() * sizeof(float));
-
-    for (float value : floats) {
-        const uint8_t* byte_ptr = reinterpret_cast<const uint8_t*>(&value);
-        bytes.insert(bytes.end(), byte_ptr, byte_ptr + sizeof(float));
-    }
-
-    return bytes;
-}
-
 /// Generate normal data (sine wave with noise)
 std::vector<float> GenerateNormalData(size_t samples, float frequency = 1.0f, float noise_level = 0.1f) {
     std::mt19937 gen(42);
@@ -104,9 +91,8 @@ int main() {
 
     for (size_t i = 0; i < num_training_samples; ++i) {
         auto normal_data = GenerateNormalData(window_size);
-        auto bytes = FloatsToBytes(normal_data);
 
-        engine.ProcessInput(bytes, DataModality::NUMERIC);
+        engine.ProcessInput(InputView::Floats(normal_data.data(), normal_data.size()));
     }
 
     auto stats = engine.GetStatistics();
@@ -165,8 +151,7 @@ int main() {
     std::cout << "Step 4: Demonstrating adaptive learning...\n";
 
     // Add the normal test data to training set
-    auto normal_bytes = FloatsToBytes(normal_test);
-    engine.ProcessInput(normal_bytes, DataModality::NUMERIC);
+    engine.ProcessInput(InputView::Floats(normal_test.data(), normal_test.size()));
 
     auto updated_stats = engine.GetStatistics();
     std::cout << "  Patterns after update: " << updated_stats.total_patterns << "\n";
@@ -22,6 +22,7 @@
 #include "core/types.hpp"
 #include "storage/pattern_database.hpp"
 #include "similarity/similarity_metric.hpp"
+#include "similarity/pairwise_similarity_cache.hpp"
 #include <memory>
 #include <vector>
 #include <map>
@@ -248,6 +249,14 @@ public:
     /// @param metric Shared pointer to similarity metric
     void SetSimilarityMetric(std::shared_ptr<SimilarityMetric> metric);
 
+    /// Set shared pairwise similarity cache
+    ///
+    /// When set, metric-based pairwise similarities are memoized across
+    /// attention computations until either pattern changes.
+    ///
+    /// @param cache Shared pointer to cache (nullptr disables caching)
+    void SetSimilarityCache(std::shared_ptr<PairwiseSimilarityCache> cache);
+
     /// Set association matrix for comparing with explicit associations
     ///
     /// @param matrix Pointer to association matrix
@@ -409,6 +418,9 @@ private:
     /// Similarity metric for computing pairwise similarities
     std::shared_ptr<SimilarityMetric> similarity_metric_;
 
+    /// Optional shared memo of pairwise similarities
+    std::shared_ptr<PairwiseSimilarityCache> similarity_cache_;
+
     /// Cache of computed attention matrices
     /// Maps from cache key to attention matrix
     std::map<std::string, std::vector<std::vector<float>>> cache_;
@@ -272,26 +272,13 @@ std::vector<PatternID> AssociationLearningSystem::Predict(
     size_t k,
     const ContextVector* context
 ) const {
-    auto associations = matrix_.GetOutgoingAssociations(pattern);
-
-    std::vector<const AssociationEdge*> sorted_assocs(associations.begin(), associations.end());
-    std::sort(sorted_assocs.begin(), sorted_assocs.end(),
-        [context](const AssociationEdge* a, const AssociationEdge* b) {
-            float strength_a = context ? a->GetContextualStrength(*context) : a->GetStrength();
-            float strength_b = context ? b->GetContextualStrength(*context) : b->GetStrength();
-            return strength_a > strength_b;
-        });
+    auto scored = PredictWithConfidence(pattern, k, context);
 
     std::vector<PatternID> predictions;
-    predictions.reserve(std::min(k, sorted_assocs.size()));
-
-    for (size_t i = 0; i < std::min(k, sorted_assocs.size()); ++i) {
-        predictions.push_back(sorted_assocs[i]->GetTarget());
-    }
+    predictions.reserve(scored.size());
 
-    {
-        std::lock_guard<std::mutex> lock(stats_mutex_);
-        stats_.predictions_count++;
+    for (const auto& [target, strength] : scored) {
+        predictions.push_back(target);
     }
 
     return predictions;
@@ -302,23 +289,30 @@ std::vector<std::pair<PatternID, float>> AssociationLearningSystem::PredictWithC
     size_t k,
     const ContextVector* context
 ) const {
-    auto associations = matrix_.GetOutgoingAssociations(pattern);
-
     std::vector<std::pair<PatternID, float>> predictions;
-    predictions.reserve(associations.size());
 
-    for (const auto* edge : associations) {
-        float strength = context ? edge->GetContextualStrength(*context) : edge->GetStrength();
-        predictions.emplace_back(edge->GetTarget(), strength);
+    if (context) {
+        auto associations = matrix_.GetOutgoingAssociations(pattern);
+        predictions.reserve(associations.size());
+
+        for (const auto* edge : associations) {
+            predictions.emplace_back(edge->GetTarget(), edge->GetContextualStrength(*context));
+        }
+    } else {
+        // Context-free strengths come straight from the matrix's CSR snapshot
+        predictions = matrix_.GetOutgoingStrengths(pattern);
     }
 
-    std::sort(predictions.begin(), predictions.end(),
-        [](const auto& a, const auto& b) {
-            return a.second > b.second;
-        });
+    auto by_strength = [](const auto& a, const auto& b) {
+        return a.second > b.second;
+    };
 
     if (predictions.size() > k) {
+        std::partial_sort(predictions.begin(), predictions.begin() + k, predictions.end(),
+                          by_strength);
         predictions.resize(k);
+    } else {
+        std::sort(predictions.begin(), predictions.end(), by_strength);
     }
 
     {
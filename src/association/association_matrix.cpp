@@ -109,6 +109,145 @@ void AssociationMatrix::RebuildIndices() {
     }
 }
 
+// ============================================================================
+// Snapshot Maintenance
+// ============================================================================
+
+std::shared_ptr<AssociationSnapshot> AssociationMatrix::BuildSnapshot() const {
+    auto topology = std::make_shared<AssociationSnapshot::Topology>();
+    std::vector<float> strengths;
+
+    auto& patterns = topology->patterns;
+    auto& index = topology->index;
+    index.reserve(outgoing_index_.size() * 2);
+    topology->offsets.reserve(outgoing_index_.size() + 1);
+    topology->targets.reserve(edge_lookup_.size());
+    strengths.reserve(edge_lookup_.size());
+    topology->edge_positions.assign(edges_.size(), AssociationSnapshot::kNotFound);
+
+    // Sources take the first dense indices, so rows are laid out in
+    // outgoing-index order; patterns that are only targets follow with
+    // empty rows
+    for (const auto& [source, edge_indices] : outgoing_index_) {
+        index.emplace(source, static_cast<uint32_t>(patterns.size()));
+        patterns.push_back(source);
+    }
+
+    for (const auto& [source, edge_indices] : outgoing_index_) {
+        topology->offsets.push_back(topology->targets.size());
+        for (size_t edge_index : edge_indices) {
+            const AssociationEdge& edge = *edges_[edge_index];
+            auto [it, inserted] = index.emplace(edge.GetTarget(),
+                                                static_cast<uint32_t>(patterns.size()));
+            if (inserted) {
+                patterns.push_back(edge.GetTarget());
+            }
+            topology->edge_positions[edge_index] =
+                static_cast<uint32_t>(topology->targets.size());
+            topology->targets.push_back(it->second);
+            strengths.push_back(edge.GetStrength());
+        }
+    }
+    topology->offsets.resize(patterns.size() + 1, topology->targets.size());
+
+    return std::shared_ptr<AssociationSnapshot>(
+        new AssociationSnapshot(std::move(topology), std::move(strengths)));
+}
+
+std::shared_ptr<const AssociationSnapshot> AssociationMatrix::CurrentSnapshot(bool force) const {
+    if (!force && !config_.enable_snapshot) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+
+    if (snapshot_topology_stale_) {
+        // Rebuilding costs about one pass over the edges; until traversals
+        // on the stale matrix have done that much work, keep using it
+        if (!force && snapshot_stale_work_.load(std::memory_order_relaxed) < edge_lookup_.size()) {
+            return nullptr;
+        }
+        snapshot_ = BuildSnapshot();
+        snapshot_topology_stale_ = false;
+        snapshot_strengths_stale_ = false;
+        snapshot_dirty_edges_.clear();
+        return snapshot_;
+    }
+
+    if (snapshot_strengths_stale_ || !snapshot_dirty_edges_.empty()) {
+        // The current snapshot is held elsewhere; patch a copy
+        std::shared_ptr<AssociationSnapshot> patched(
+            new AssociationSnapshot(snapshot_->topology_, snapshot_->strengths_));
+        const auto& positions = patched->topology_->edge_positions;
+
+        if (snapshot_strengths_stale_) {
+            for (size_t i = 0; i < positions.size(); ++i) {
+                if (positions[i] != AssociationSnapshot::kNotFound) {
+                    patched->strengths_[positions[i]] = edges_[i]->GetStrength();
+                }
+            }
+        } else {
+            for (size_t edge_index : snapshot_dirty_edges_) {
+                patched->strengths_[positions[edge_index]] = edges_[edge_index]->GetStrength();
+            }
+        }
+
+        snapshot_ = std::move(patched);
+        snapshot_strengths_stale_ = false;
+        snapshot_dirty_edges_.clear();
+    }
+
+    return snapshot_;
+}
+
+void AssociationMatrix::MarkTopologyChanged() {
+    snapshot_.reset();
+    snapshot_topology_stale_ = true;
+    snapshot_strengths_stale_ = false;
+    snapshot_dirty_edges_.clear();
+    snapshot_stale_work_.store(0, std::memory_order_relaxed);
+}
+
+void AssociationMatrix::MarkStrengthChanged(size_t edge_index) {
+    if (snapshot_topology_stale_ || snapshot_strengths_stale_) {
+        return;
+    }
+
+    // Writers hold mutex_ exclusively, so a snapshot referenced only here
+    // is invisible to readers and can be patched in place
+    if (snapshot_.use_count() == 1) {
+        uint32_t position = snapshot_->topology_->edge_positions[edge_index];
+        snapshot_->strengths_[position] = edges_[edge_index]->GetStrength();
+        return;
+    }
+
+    snapshot_dirty_edges_.push_back(edge_index);
+    if (snapshot_dirty_edges_.size() > edge_lookup_.size()) {
+        snapshot_strengths_stale_ = true;
+        snapshot_dirty_edges_.clear();
+    }
+}
+
+void AssociationMatrix::MarkAllStrengthsChanged() {
+    if (snapshot_topology_stale_) {
+        return;
+    }
+
+    snapshot_dirty_edges_.clear();
+    if (snapshot_.use_count() != 1) {
+        snapshot_strengths_stale_ = true;
+        return;
+    }
+
+    const auto& positions = snapshot_->topology_->edge_positions;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        if (positions[i] != AssociationSnapshot::kNotFound) {
+            snapshot_->strengths_[positions[i]] = edges_[i]->GetStrength();
+        }
+    }
+    snapshot_strengths_stale_ = false;
+}
+
 // ============================================================================
 // Add/Update/Remove Operations
 // ============================================================================
@@ -135,6 +274,7 @@ bool AssociationMatrix::AddAssociation(const AssociationEdge& edge) {
 
     // Update indices
     UpdateIndices(index, true);
+    MarkTopologyChanged();
 
     return true;
 }
@@ -154,6 +294,7 @@ bool AssociationMatrix::UpdateAssociation(
     }
 
     edges_[it->second] = edge.Clone();
+    MarkStrengthChanged(it->second);
     return true;
 }
 
@@ -177,6 +318,7 @@ bool AssociationMatrix::RemoveAssociation(PatternID source, PatternID target) {
 
     // Mark for reuse
     ReleaseEdgeIndex(index);
+    MarkTopologyChanged();
 
     return true;
 }
@@ -295,6 +437,27 @@ std::vector<PatternID> AssociationMatrix::GetNeighbors(PatternID pattern, bool o
     return neighbors;
 }
 
+std::vector<std::pair<PatternID, float>> AssociationMatrix::GetOutgoingStrengths(PatternID source) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    if (auto snapshot = CurrentSnapshot(false)) {
+        return snapshot->GetOutgoing(source);
+    }
+
+    std::vector<std::pair<PatternID, float>> result;
+
+    auto it = outgoing_index_.find(source);
+    if (it != outgoing_index_.end()) {
+        result.reserve(it->second.size());
+        for (size_t index : it->second) {
+            result.emplace_back(edges_[index]->GetTarget(), edges_[index]->GetStrength());
+        }
+        snapshot_stale_work_.fetch_add(it->second.size(), std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
 std::vector<PatternID> AssociationMatrix::GetMutualNeighbors(PatternID pattern) const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
 
@@ -341,6 +504,7 @@ bool AssociationMatrix::StrengthenAssociation(PatternID source, PatternID target
     }
 
     edges_[it->second]->AdjustStrength(amount);
+    MarkStrengthChanged(it->second);
     return true;
 }
 
@@ -354,6 +518,7 @@ void AssociationMatrix::ApplyDecayAll(Timestamp::Duration elapsed_time) {
     for (const auto& [key, index] : edge_lookup_) {
         edges_[index]->ApplyDecay(elapsed_time);
     }
+    MarkAllStrengthsChanged();
 }
 
 void AssociationMatrix::ApplyDecayPattern(PatternID pattern, Timestamp::Duration elapsed_time) {
@@ -364,6 +529,7 @@ void AssociationMatrix::ApplyDecayPattern(PatternID pattern, Timestamp::Duration
     if (out_it != outgoing_index_.end()) {
         for (size_t index : out_it->second) {
             edges_[index]->ApplyDecay(elapsed_time);
+            MarkStrengthChanged(index);
         }
     }
 
@@ -372,6 +538,7 @@ void AssociationMatrix::ApplyDecayPattern(PatternID pattern, Timestamp::Duration
     if (in_it != incoming_index_.end()) {
         for (size_t index : in_it->second) {
             edges_[index]->ApplyDecay(elapsed_time);
+            MarkStrengthChanged(index);
         }
     }
 }
@@ -501,6 +668,15 @@ std::vector<AssociationMatrix::ActivationResult> AssociationMatrix::PropagateAct
 ) const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
 
+    // Context profiles live on the edges, so only context-free propagation
+    // can use the snapshot
+    if (!context) {
+        if (auto snapshot = CurrentSnapshot(false)) {
+            return snapshot->PropagateActivation(source, initial_activation,
+                                                 max_hops, min_activation);
+        }
+    }
+
     // Breadth-first propagation with activation accumulation
     std::unordered_map<PatternID, float> activations;
     std::queue<std::pair<PatternID, size_t>> queue;  // (pattern, hop_count)
@@ -509,6 +685,7 @@ std::vector<AssociationMatrix::ActivationResult> AssociationMatrix::PropagateAct
     activations[source] = initial_activation;
     queue.push({source, 0});
     visited.insert(source);
+    size_t traversed = 0;
 
     while (!queue.empty()) {
         auto [current, hops] = queue.front();
@@ -521,6 +698,7 @@ std::vector<AssociationMatrix::ActivationResult> AssociationMatrix::PropagateAct
         // Get outgoing associations
         auto it = outgoing_index_.find(current);
         if (it == outgoing_index_.end()) continue;
+        traversed += it->second.size();
 
         for (size_t edge_index : it->second) {
             const AssociationEdge& edge = *edges_[edge_index];
@@ -544,6 +722,10 @@ std::vector<AssociationMatrix::ActivationResult> AssociationMatrix::PropagateAct
         }
     }
 
+    if (!context) {
+        snapshot_stale_work_.fetch_add(traversed, std::memory_order_relaxed);
+    }
+
     // Convert to result vector (exclude source)
     std::vector<ActivationResult> results;
     results.reserve(activations.size());
@@ -563,6 +745,11 @@ std::vector<AssociationMatrix::ActivationResult> AssociationMatrix::PropagateAct
     return results;
 }
 
+std::shared_ptr<const AssociationSnapshot> AssociationMatrix::GetSnapshot() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return CurrentSnapshot(true);
+}
+
 // ============================================================================
 // Serialization
 // ============================================================================
@@ -621,6 +808,7 @@ void AssociationMatrix::Compact() {
 
     // Rebuild all indices
     RebuildIndices();
+    MarkTopologyChanged();
 }
 
 void AssociationMatrix::Clear() {
@@ -632,6 +820,7 @@ void AssociationMatrix::Clear() {
     edge_lookup_.clear();
     type_index_.clear();
     deleted_indices_.clear();
+    MarkTopologyChanged();
 }
 
 size_t AssociationMatrix::EstimateMemoryUsage() const {
@@ -653,6 +842,14 @@ size_t AssociationMatrix::EstimateMemoryUsage() const {
     // Deleted indices
     total += deleted_indices_.capacity() * sizeof(size_t);
 
+    // Snapshot
+    {
+        std::lock_guard<std::mutex> snapshot_lock(snapshot_mutex_);
+        if (snapshot_) {
+            total += snapshot_->EstimateMemoryUsage();
+        }
+    }
+
     return total;
 }
 
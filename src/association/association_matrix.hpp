@@ -2,8 +2,12 @@
 #pragma once
 
 #include "association/association_edge.hpp"
+#include "association/association_snapshot.hpp"
+#include <atomic>
 #include <vector>
 #include <unordered_map>
+#include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <optional>
 
@@ -29,6 +33,12 @@ struct PatternPairHash {
 /// - Direct hash-based (source, target) lookup
 /// - Type index for filtering by association type
 ///
+/// Context-free traversal (PropagateActivation, GetOutgoingStrengths) reads
+/// from an immutable CSR snapshot (AssociationSnapshot) instead. Strength
+/// changes patch the snapshot; structural changes mark it stale, and it is
+/// rebuilt once traversals over the stale matrix have touched as many edges
+/// as a rebuild would, so bursts of writes do not pay for one rebuild each.
+///
 /// Thread-safe with reader-writer locking (std::shared_mutex)
 class AssociationMatrix {
 public:
@@ -39,13 +49,13 @@ public:
         bool enable_reverse_lookup{true};
         bool enable_type_index{true};
         float load_factor_threshold{0.75f};
+
+        /// Serve context-free traversal from a CSR snapshot
+        bool enable_snapshot{true};
     };
 
     /// Activation propagation result
-    struct ActivationResult {
-        PatternID pattern;
-        float activation;
-    };
+    using ActivationResult = PatternActivation;
 
     // ========================================================================
     // Construction
@@ -97,6 +107,10 @@ public:
     /// Get mutual neighbors (patterns that are both predecessors and successors)
     std::vector<PatternID> GetMutualNeighbors(PatternID pattern) const;
 
+    /// Get successors of a pattern with their (context-free) strengths
+    /// @return (target, strength) pairs in outgoing-index order
+    std::vector<std::pair<PatternID, float>> GetOutgoingStrengths(PatternID source) const;
+
     // ========================================================================
     // Strength Operations
     // ========================================================================
@@ -165,6 +179,13 @@ public:
         const ContextVector* context = nullptr
     ) const;
 
+    /// Get a CSR snapshot of the current associations
+    ///
+    /// Builds or patches the snapshot if the matrix changed since the last
+    /// one. The snapshot stays valid (and unchanged) after later mutations.
+    /// @return Shared immutable snapshot
+    std::shared_ptr<const AssociationSnapshot> GetSnapshot() const;
+
     // ========================================================================
     // Serialization
     // ========================================================================
@@ -223,11 +244,31 @@ private:
     // Deleted edge indices for reuse
     std::vector<size_t> deleted_indices_;
 
+    // CSR snapshot. Writers (holding mutex_ exclusively) patch it or mark it
+    // stale; readers (holding mutex_ shared) build or refresh it under
+    // snapshot_mutex_. A snapshot held outside the matrix is never modified:
+    // strength patches then go to dirty_edges_ and are applied to a copy.
+    mutable std::mutex snapshot_mutex_;
+    mutable std::shared_ptr<AssociationSnapshot> snapshot_;
+    mutable bool snapshot_topology_stale_{true};
+    mutable bool snapshot_strengths_stale_{false};
+    mutable std::vector<size_t> snapshot_dirty_edges_;
+
+    // Edges traversed without a snapshot since the topology went stale
+    mutable std::atomic<size_t> snapshot_stale_work_{0};
+
     // Helper methods
     size_t AllocateEdgeIndex();
     void ReleaseEdgeIndex(size_t index);
     void UpdateIndices(size_t edge_index, bool add);
     void RebuildIndices();
+
+    // Snapshot helpers (callers hold mutex_)
+    std::shared_ptr<const AssociationSnapshot> CurrentSnapshot(bool force) const;
+    std::shared_ptr<AssociationSnapshot> BuildSnapshot() const;
+    void MarkTopologyChanged();
+    void MarkStrengthChanged(size_t edge_index);
+    void MarkAllStrengthsChanged();
 };
 
 } // namespace dpan
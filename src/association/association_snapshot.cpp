@@ -0,0 +1,133 @@
+// File: src/association/association_snapshot.cpp
+#include "association/association_snapshot.hpp"
+#include <algorithm>
+
+namespace dpan {
+
+namespace {
+
+/// Per-thread propagation state, sized to the largest snapshot seen and
+/// reset entry by entry so a query costs only what it reaches
+struct PropagationScratch {
+    static constexpr uint8_t kTouched = 1;
+    static constexpr uint8_t kVisited = 2;
+
+    std::vector<float> activation;
+    std::vector<uint8_t> state;
+    std::vector<uint32_t> touched;
+    std::vector<std::pair<uint32_t, size_t>> queue;  // (pattern, hop_count)
+
+    void Prepare(size_t patterns) {
+        if (activation.size() < patterns) {
+            activation.resize(patterns, 0.0f);
+            state.resize(patterns, 0);
+        }
+        touched.clear();
+        queue.clear();
+    }
+
+    void Reset() {
+        for (uint32_t index : touched) {
+            activation[index] = 0.0f;
+            state[index] = 0;
+        }
+    }
+};
+
+} // anonymous namespace
+
+uint32_t AssociationSnapshot::IndexOf(PatternID pattern) const {
+    auto it = topology_->index.find(pattern);
+    return it != topology_->index.end() ? it->second : kNotFound;
+}
+
+std::vector<std::pair<PatternID, float>> AssociationSnapshot::GetOutgoing(PatternID source) const {
+    std::vector<std::pair<PatternID, float>> outgoing;
+    uint32_t row = IndexOf(source);
+    if (row == kNotFound) {
+        return outgoing;
+    }
+
+    const Topology& topology = *topology_;
+    outgoing.reserve(topology.offsets[row + 1] - topology.offsets[row]);
+    for (size_t e = topology.offsets[row]; e < topology.offsets[row + 1]; ++e) {
+        outgoing.emplace_back(topology.patterns[topology.targets[e]], strengths_[e]);
+    }
+    return outgoing;
+}
+
+std::vector<PatternActivation> AssociationSnapshot::PropagateActivation(
+    PatternID source,
+    float initial_activation,
+    size_t max_hops,
+    float min_activation
+) const {
+    std::vector<PatternActivation> results;
+    uint32_t source_index = IndexOf(source);
+    if (source_index == kNotFound) {
+        return results;
+    }
+
+    const Topology& topology = *topology_;
+    thread_local PropagationScratch scratch;
+    scratch.Prepare(topology.patterns.size());
+
+    // Same breadth-first order and accumulation as the matrix, so the
+    // floating-point sums match exactly
+    scratch.activation[source_index] = initial_activation;
+    scratch.state[source_index] = PropagationScratch::kTouched | PropagationScratch::kVisited;
+    scratch.touched.push_back(source_index);
+    scratch.queue.push_back({source_index, 0});
+
+    for (size_t head = 0; head < scratch.queue.size(); ++head) {
+        auto [current, hops] = scratch.queue[head];
+        if (hops >= max_hops) continue;
+
+        float current_activation = scratch.activation[current];
+        for (size_t e = topology.offsets[current]; e < topology.offsets[current + 1]; ++e) {
+            uint32_t target = topology.targets[e];
+            float propagated = current_activation * strengths_[e];
+
+            uint8_t& state = scratch.state[target];
+            if (!(state & PropagationScratch::kTouched)) {
+                state |= PropagationScratch::kTouched;
+                scratch.touched.push_back(target);
+            }
+            scratch.activation[target] += propagated;
+
+            if (propagated >= min_activation && !(state & PropagationScratch::kVisited)) {
+                state |= PropagationScratch::kVisited;
+                scratch.queue.push_back({target, hops + 1});
+            }
+        }
+    }
+
+    results.reserve(scratch.touched.size());
+    for (uint32_t index : scratch.touched) {
+        float activation = scratch.activation[index];
+        if (index != source_index && activation >= min_activation) {
+            results.push_back({topology.patterns[index], activation});
+        }
+    }
+    scratch.Reset();
+
+    std::sort(results.begin(), results.end(),
+        [](const PatternActivation& a, const PatternActivation& b) {
+            return a.activation > b.activation;
+        });
+
+    return results;
+}
+
+size_t AssociationSnapshot::EstimateMemoryUsage() const {
+    const Topology& topology = *topology_;
+    return sizeof(*this) + sizeof(Topology) +
+           topology.patterns.capacity() * sizeof(PatternID) +
+           topology.index.size() * (sizeof(PatternID) + sizeof(uint32_t) + 16) +
+           topology.offsets.capacity() * sizeof(size_t) +
+           topology.targets.capacity() * sizeof(uint32_t) +
+           topology.edge_positions.capacity() * sizeof(uint32_t) +
+           strengths_.capacity() * sizeof(float);
+}
+
+} // namespace dpan
@@ -0,0 +1,104 @@
+// File: src/association/association_snapshot.hpp
+#pragma once
+
+#include "core/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dpan {
+
+/// Activation reached by propagation through the association graph
+struct PatternActivation {
+    PatternID pattern;
+    float activation;
+};
+
+/// AssociationSnapshot - Immutable compressed sparse row (CSR) view of an
+/// AssociationMatrix
+///
+/// Patterns are numbered densely. The outgoing associations of pattern i
+/// occupy positions [offsets[i], offsets[i + 1]) of the targets array (dense
+/// indices) and the strengths array, in the order the matrix lists them.
+/// Traversal follows array indices instead of hashing PatternIDs and
+/// dereferencing individually allocated edges, so results are identical to
+/// the matrix's own traversal.
+///
+/// A snapshot never changes once handed out: it describes the matrix as it
+/// was when taken and can be read from any thread without locking. Context
+/// profiles are not part of the snapshot. See AssociationMatrix::GetSnapshot.
+class AssociationSnapshot {
+public:
+    /// Dense index of a pattern that is not in the snapshot
+    static constexpr uint32_t kNotFound = UINT32_MAX;
+
+    /// Number of patterns (sources or targets of an association)
+    size_t GetPatternCount() const { return topology_->patterns.size(); }
+
+    /// Number of associations
+    size_t GetAssociationCount() const { return topology_->targets.size(); }
+
+    /// Dense index of a pattern
+    /// @return Index, or kNotFound if the pattern has no associations
+    uint32_t IndexOf(PatternID pattern) const;
+
+    /// Pattern at a dense index (index < GetPatternCount())
+    PatternID PatternAt(uint32_t index) const { return topology_->patterns[index]; }
+
+    /// Row offsets (GetPatternCount() + 1 entries)
+    const std::vector<size_t>& GetOffsets() const { return topology_->offsets; }
+
+    /// Target dense index of every association, row by row
+    const std::vector<uint32_t>& GetTargets() const { return topology_->targets; }
+
+    /// Strength of every association, row by row
+    const std::vector<float>& GetStrengths() const { return strengths_; }
+
+    /// Get successors of a pattern with their association strengths
+    /// @param source Source pattern
+    /// @return (target, strength) pairs in the matrix's order
+    std::vector<std::pair<PatternID, float>> GetOutgoing(PatternID source) const;
+
+    /// Propagate activation breadth-first, as
+    /// AssociationMatrix::PropagateActivation does without a context
+    /// @param source Starting pattern
+    /// @param initial_activation Initial activation strength
+    /// @param max_hops Maximum propagation distance
+    /// @param min_activation Minimum activation to continue propagation
+    /// @return Activated patterns (excluding source), descending by activation
+    std::vector<PatternActivation> PropagateActivation(
+        PatternID source,
+        float initial_activation,
+        size_t max_hops = 3,
+        float min_activation = 0.01f
+    ) const;
+
+    /// Estimate memory usage in bytes (shared topology included)
+    size_t EstimateMemoryUsage() const;
+
+private:
+    friend class AssociationMatrix;
+
+    /// Everything except strengths; shared by snapshots that differ only in
+    /// strengths
+    struct Topology {
+        std::vector<PatternID> patterns;
+        std::unordered_map<PatternID, uint32_t> index;
+        std::vector<size_t> offsets;
+        std::vector<uint32_t> targets;
+
+        /// Matrix edge index -> position in targets (kNotFound if unused)
+        std::vector<uint32_t> edge_positions;
+    };
+
+    AssociationSnapshot(std::shared_ptr<const Topology> topology, std::vector<float> strengths)
+        : topology_(std::move(topology)), strengths_(std::move(strengths)) {}
+
+    std::shared_ptr<const Topology> topology_;
+    std::vector<float> strengths_;
+};
+
+} // namespace dpan
@@ -1,9 +1,9 @@
 // File: src/association/categorical_learner.cpp
 #include "association/categorical_learner.hpp"
+#include "similarity/kmeans_clusterer.hpp"
 #include <algorithm>
-#include <random>
-#include <limits>
 #include <cmath>
+#include <stdexcept>
 
 namespace dpan {
 
@@ -66,28 +66,57 @@ bool CategoricalLearner::ComputeClusters(size_t k_clusters) {
         return false;
     }
 
-    // Initialize centroids using k-means++
-    InitializeCentroids(k_clusters);
+    // Contiguous feature matrix in ID order, so results do not depend on
+    // hash map layout
+    std::vector<PatternID> patterns;
+    patterns.reserve(pattern_features_.size());
+    for (const auto& [pattern, _] : pattern_features_) {
+        patterns.push_back(pattern);
+    }
+    std::sort(patterns.begin(), patterns.end(),
+              [](PatternID a, PatternID b) { return a.value() < b.value(); });
 
-    // K-means iteration
-    std::vector<FeatureVector> old_centroids;
-    for (size_t iter = 0; iter < config_.max_iterations; ++iter) {
-        // Save old centroids for convergence check
-        old_centroids = centroids_;
+    const size_t dimension = pattern_features_.at(patterns.front()).Dimension();
+    if (dimension == 0) {
+        return false;
+    }
+    std::vector<float> points;
+    points.reserve(patterns.size() * dimension);
+    for (const auto& pattern : patterns) {
+        const auto& features = pattern_features_.at(pattern).Data();
+        if (features.size() != dimension) {
+            throw std::invalid_argument("All patterns must have same feature dimension");
+        }
+        points.insert(points.end(), features.begin(), features.end());
+    }
 
-        // Assign patterns to nearest centroids
-        bool assignments_changed = AssignPatternsToClusters();
+    KMeansClusterer::Config kmeans_config;
+    kmeans_config.num_clusters = k_clusters;
+    kmeans_config.max_iterations = config_.max_iterations;
+    kmeans_config.tolerance = config_.convergence_threshold;
+    kmeans_config.seed = config_.seed;
+    auto result = KMeansClusterer(kmeans_config).Run(points.data(), patterns.size(), dimension);
 
-        // Update centroids
-        UpdateCentroids();
+    centroids_.clear();
+    centroids_.reserve(k_clusters);
+    for (size_t c = 0; c < k_clusters; ++c) {
+        const float* centroid = result.Centroid(c);
+        centroids_.emplace_back(std::vector<float>(centroid, centroid + dimension));
+    }
 
-        // Check for convergence
-        if (!assignments_changed && HasConverged(old_centroids)) {
-            return true;
-        }
+    pattern_to_cluster_.clear();
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        const size_t cluster = result.assignments[i];
+        const auto& features = pattern_features_.at(patterns[i]);
+
+        PatternCluster assignment;
+        assignment.cluster_id = cluster;
+        assignment.distance_to_centroid = std::sqrt(SquaredEuclideanDistance(
+            points.data() + i * dimension, result.Centroid(cluster), dimension));
+        assignment.similarity_to_centroid = features.CosineSimilarity(centroids_[cluster]);
+        pattern_to_cluster_[patterns[i]] = assignment;
     }
 
-    // Max iterations reached
     return true;
 }
 
@@ -282,168 +311,4 @@ CategoricalLearner::ClusteringStats CategoricalLearner::GetClusteringStats() con
     return stats;
 }
 
-// ============================================================================
-// Private Helper Methods
-// ============================================================================
-
-void CategoricalLearner::InitializeCentroids(size_t k) {
-    centroids_.clear();
-    centroids_.reserve(k);
-
-    if (pattern_features_.empty()) {
-        return;
-    }
-
-    // Use k-means++ initialization
-    std::random_device rd;
-    std::mt19937 gen(rd());
-
-    // Collect all patterns
-    std::vector<PatternID> patterns;
-    patterns.reserve(pattern_features_.size());
-    for (const auto& [pattern, _] : pattern_features_) {
-        patterns.push_back(pattern);
-    }
-
-    // Choose first centroid randomly
-    std::uniform_int_distribution<size_t> dist(0, patterns.size() - 1);
-    size_t first_idx = dist(gen);
-    centroids_.push_back(pattern_features_[patterns[first_idx]]);
-
-    // Choose remaining centroids
-    for (size_t i = 1; i < k; ++i) {
-        // Compute squared distances to nearest centroid for each pattern
-        std::vector<float> distances;
-        distances.reserve(patterns.size());
-
-        for (const auto& pattern : patterns) {
-            const auto& features = pattern_features_[pattern];
-
-            // Find minimum distance to existing centroids
-            float min_dist = std::numeric_limits<float>::max();
-            for (const auto& centroid : centroids_) {
-                float dist = ComputeDistance(features, centroid);
-                min_dist = std::min(min_dist, dist);
-            }
-
-            distances.push_back(min_dist * min_dist);  // Squared distance
-        }
-
-        // Choose next centroid with probability proportional to squared distance
-        std::discrete_distribution<size_t> weighted_dist(distances.begin(), distances.end());
-        size_t next_idx = weighted_dist(gen);
-        centroids_.push_back(pattern_features_[patterns[next_idx]]);
-    }
-}
-
-bool CategoricalLearner::AssignPatternsToClusters() {
-    bool changed = false;
-
-    for (const auto& [pattern, features] : pattern_features_) {
-        // Find nearest centroid
-        size_t nearest = FindNearestCentroid(features);
-
-        // Compute distance and similarity to nearest centroid
-        float distance = ComputeDistance(features, centroids_[nearest]);
-        float similarity = features.CosineSimilarity(centroids_[nearest]);
-
-        // Create assignment
-        PatternCluster assignment;
-        assignment.cluster_id = nearest;
-        assignment.distance_to_centroid = distance;
-        assignment.similarity_to_centroid = similarity;
-
-        // Check if assignment changed
-        auto it = pattern_to_cluster_.find(pattern);
-        if (it == pattern_to_cluster_.end() || it->second.cluster_id != nearest) {
-            changed = true;
-        }
-
-        pattern_to_cluster_[pattern] = assignment;
-    }
-
-    return changed;
-}
-
-void CategoricalLearner::UpdateCentroids() {
-    // Reset centroids
-    std::vector<FeatureVector> new_centroids(centroids_.size());
-    std::vector<size_t> cluster_counts(centroids_.size(), 0);
-
-    // Initialize centroids with correct dimensions
-    size_t feature_dim = 0;
-    if (!pattern_features_.empty()) {
-        feature_dim = pattern_features_.begin()->second.Dimension();
-    }
-
-    for (auto& centroid : new_centroids) {
-        centroid = FeatureVector(feature_dim);
-    }
-
-    // Sum features for each cluster
-    for (const auto& [pattern, assignment] : pattern_to_cluster_) {
-        size_t cluster_id = assignment.cluster_id;
-        const auto& features = pattern_features_[pattern];
-
-        for (size_t i = 0; i < feature_dim; ++i) {
-            new_centroids[cluster_id][i] += features[i];
-        }
-        cluster_counts[cluster_id]++;
-    }
-
-    // Compute averages
-    for (size_t i = 0; i < new_centroids.size(); ++i) {
-        if (cluster_counts[i] > 0) {
-            for (size_t j = 0; j < feature_dim; ++j) {
-                new_centroids[i][j] /= cluster_counts[i];
-            }
-            centroids_[i] = new_centroids[i];
-        }
-        // If cluster is empty, keep old centroid
-    }
-}
-
-float CategoricalLearner::ComputeDistance(
-    const FeatureVector& v1,
-    const FeatureVector& v2
-) const {
-    return v1.EuclideanDistance(v2);
-}
-
-size_t CategoricalLearner::FindNearestCentroid(const FeatureVector& features) const {
-    if (centroids_.empty()) {
-        return 0;
-    }
-
-    size_t nearest = 0;
-    float min_distance = ComputeDistance(features, centroids_[0]);
-
-    for (size_t i = 1; i < centroids_.size(); ++i) {
-        float distance = ComputeDistance(features, centroids_[i]);
-        if (distance < min_distance) {
-            min_distance = distance;
-            nearest = i;
-        }
-    }
-
-    return nearest;
-}
-
-bool CategoricalLearner::HasConverged(
-    const std::vector<FeatureVector>& old_centroids
-) const {
-    if (old_centroids.size() != centroids_.size()) {
-        return false;
-    }
-
-    for (size_t i = 0; i < centroids_.size(); ++i) {
-        float distance = ComputeDistance(centroids_[i], old_centroids[i]);
-        if (distance > config_.convergence_threshold) {
-            return false;
-        }
-    }
-
-    return true;
-}
-
 } // namespace dpan
@@ -12,8 +12,8 @@ namespace dpan {
 /// CategoricalLearner: Clusters patterns based on feature similarity
 ///
 /// Learns categorical relationships by grouping patterns with similar
-/// features using k-means clustering. Patterns within the same cluster
-/// are considered categorically related.
+/// features using k-means clustering (KMeansClusterer). Patterns within
+/// the same cluster are considered categorically related.
 ///
 /// Thread-safety: Not thread-safe. External synchronization required.
 class CategoricalLearner {
@@ -46,6 +46,8 @@ public:
         float min_categorical_similarity{0.7f};
         /// Whether to auto-recompute clusters when patterns are added
         bool auto_recompute{false};
+        /// Seed of the k-means++ centroid seeding
+        uint64_t seed{0x5EED5EEDULL};
     };
 
     // ========================================================================
@@ -86,6 +88,7 @@ public:
     /// Compute clusters using k-means algorithm
     /// @param k_clusters Number of clusters (uses config default if 0)
     /// @return True if clustering succeeded
+    /// @throws std::invalid_argument if pattern feature dimensions differ
     bool ComputeClusters(size_t k_clusters = 0);
 
     /// Get number of clusters
@@ -188,28 +191,6 @@ private:
 
     // Pattern to cluster assignments
     std::unordered_map<PatternID, PatternCluster> pattern_to_cluster_;
-
-    // Helper methods
-
-    /// Initialize centroids using k-means++ algorithm
-    void InitializeCentroids(size_t k);
-
-    /// Assign patterns to nearest centroid
-    /// @return True if any assignments changed
-    bool AssignPatternsToClusters();
-
-    /// Update centroids based on cluster assignments
-    void UpdateCentroids();
-
-    /// Compute distance between feature vectors
-    float ComputeDistance(const FeatureVector& v1, const FeatureVector& v2) const;
-
-    /// Find nearest centroid for a feature vector
-    /// @return Cluster ID of nearest centroid
-    size_t FindNearestCentroid(const FeatureVector& features) const;
-
-    /// Check if clustering has converged
-    bool HasConverged(const std::vector<FeatureVector>& old_centroids) const;
 };
 
 } // namespace dpan
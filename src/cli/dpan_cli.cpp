@@ -93,6 +93,8 @@ void DPANCli::InitializeEngine() {
     engine_config.extraction_config.min_pattern_size = 1;
     engine_config.extraction_config.max_pattern_size = 1000;
     engine_config.extraction_config.feature_dimension = 64;
+    // Hashed character / word n-grams keep word order, unlike byte histograms
+    engine_config.extraction_config.text_features = PatternExtractor::TextFeatures::HASHED_NGRAMS;
 
     // Lower thresholds for better learning
     engine_config.matching_config.similarity_threshold = 0.60f;
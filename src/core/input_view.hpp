@@ -0,0 +1,133 @@
+// File: src/core/input_view.hpp
+#pragma once
+
+#include "core/pattern_data.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace dpan {
+
+/// Element type of the samples behind an InputView
+enum class SampleType : uint8_t {
+    BYTES = 0,     ///< Raw bytes, interpreted per the extractor configuration
+    FLOAT32 = 1,   ///< 32-bit float samples
+    PCM16 = 2,     ///< Signed 16-bit PCM, scaled to [-1, 1)
+    IMAGE_U8 = 3,  ///< 8-bit interleaved pixels, scaled to [0, 1]
+};
+
+/// InputView - Non-owning, typed view of one input record
+///
+/// Lets callers hand samples to the engine in their native type instead of
+/// serializing them into a byte vector first. Sample views (FLOAT32, PCM16)
+/// are windowed in samples exactly like float input, so a PCM16 view and a
+/// FLOAT32 view of the decoded samples extract the same patterns. Image
+/// views may have padded rows (row_stride > width * channels).
+///
+/// The viewed memory must stay valid for the duration of the call that
+/// receives the view; nothing is retained.
+struct InputView {
+    const void* data{nullptr};
+    size_t count{0};  ///< Samples, bytes, or pixel values (width * height * channels)
+    SampleType type{SampleType::BYTES};
+    DataModality modality{DataModality::NUMERIC};
+
+    // Image geometry (IMAGE_U8 only)
+    size_t width{0};
+    size_t height{0};
+    size_t channels{1};    ///< Interleaved values per pixel
+    size_t row_stride{0};  ///< Bytes between row starts (>= width * channels)
+
+    /// View raw bytes, interpreted like Extract(const std::vector<uint8_t>&)
+    static InputView Bytes(const uint8_t* bytes, size_t size, DataModality modality) {
+        InputView view;
+        view.data = bytes;
+        view.count = size;
+        view.type = SampleType::BYTES;
+        view.modality = modality;
+        return view;
+    }
+
+    /// View float samples
+    static InputView Floats(const float* samples, size_t count,
+                            DataModality modality = DataModality::NUMERIC) {
+        InputView view;
+        view.data = samples;
+        view.count = count;
+        view.type = SampleType::FLOAT32;
+        view.modality = modality;
+        return view;
+    }
+
+    /// View signed 16-bit PCM samples
+    static InputView Pcm16(const int16_t* samples, size_t count,
+                           DataModality modality = DataModality::AUDIO) {
+        InputView view;
+        view.data = samples;
+        view.count = count;
+        view.type = SampleType::PCM16;
+        view.modality = modality;
+        return view;
+    }
+
+    /// View an 8-bit image with interleaved channels
+    /// @param pixels First pixel of the first row
+    /// @param width Pixels per row
+    /// @param height Number of rows
+    /// @param row_stride Bytes between row starts (0 = width * channels)
+    /// @param channels Values per pixel (1 = grayscale, 3 = RGB, ...)
+    /// @throws std::invalid_argument if channels is 0 or row_stride is
+    ///         shorter than a row
+    static InputView Image(const uint8_t* pixels, size_t width, size_t height,
+                           size_t row_stride = 0, size_t channels = 1) {
+        if (channels == 0) {
+            throw std::invalid_argument("Image must have at least one channel");
+        }
+        if (row_stride == 0) {
+            row_stride = width * channels;
+        }
+        if (row_stride < width * channels) {
+            throw std::invalid_argument("row_stride must be at least the image row size");
+        }
+        InputView view;
+        view.data = pixels;
+        view.count = width * height * channels;
+        view.type = SampleType::IMAGE_U8;
+        view.modality = DataModality::IMAGE;
+        view.width = width;
+        view.height = height;
+        view.channels = channels;
+        view.row_stride = row_stride;
+        return view;
+    }
+
+    /// Bytes per sample
+    size_t ElementSize() const {
+        switch (type) {
+            case SampleType::FLOAT32: return sizeof(float);
+            case SampleType::PCM16: return sizeof(int16_t);
+            default: return 1;
+        }
+    }
+
+    /// Payload size in bytes (row padding excluded)
+    size_t SizeBytes() const { return count * ElementSize(); }
+
+    bool Empty() const { return count == 0; }
+
+    /// Call fn(const uint8_t* bytes, size_t size) for each contiguous run of
+    /// payload bytes, in order (one run unless image rows are padded)
+    template <typename Fn>
+    void ForEachByteRun(Fn&& fn) const {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        if (type == SampleType::IMAGE_U8 && row_stride != width * channels) {
+            for (size_t row = 0; row < height; ++row) {
+                fn(bytes + row * row_stride, width * channels);
+            }
+            return;
+        }
+        fn(bytes, SizeBytes());
+    }
+};
+
+} // namespace dpan
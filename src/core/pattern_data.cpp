@@ -287,6 +287,30 @@ bool PatternData::operator==(const PatternData& other) const {
            compressed_data_ == other.compressed_data_;
 }
 
+uint64_t PatternData::ContentHash() const {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+
+    mix(static_cast<uint64_t>(modality_));
+    mix(static_cast<uint64_t>(original_size_));
+
+    // Mix eight bytes per step; this runs once per candidate during search
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= compressed_data_.size(); i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, compressed_data_.data() + i, sizeof(word));
+        mix(word);
+        hash ^= hash >> 29;
+    }
+    for (; i < compressed_data_.size(); ++i) {
+        mix(compressed_data_[i]);
+    }
+    return hash;
+}
+
 // Simple RLE (Run-Length Encoding) compression
 std::vector<uint8_t> PatternData::Compress(const std::vector<uint8_t>& data) {
     if (data.empty()) {
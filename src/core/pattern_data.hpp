@@ -64,6 +64,10 @@ public:
     // Check if empty
     bool IsEmpty() const { return compressed_data_.empty(); }
 
+    // 64-bit FNV-style hash of the encoded content (no decompression)
+    // Equal PatternData always hash equal; used to validate cached derived data
+    uint64_t ContentHash() const;
+
     // Serialization
     void Serialize(std::ostream& out) const;
     static PatternData Deserialize(std::istream& in);
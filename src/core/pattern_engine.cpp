@@ -6,8 +6,10 @@
 #include "similarity/geometric_similarity.hpp"
 #include "similarity/statistical_similarity.hpp"
 #include "similarity/frequency_similarity.hpp"
+#include <algorithm>
 #include <chrono>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace dpan {
 
@@ -58,14 +60,37 @@ void PatternEngine::InitializeComponents() {
 
     // Create pattern refiner
     refiner_ = std::make_unique<PatternRefiner>(database_);
+    if (config_.instance_reservoir_capacity > 0) {
+        InstanceReservoir::Config reservoir_config;
+        reservoir_config.capacity = config_.instance_reservoir_capacity;
+        refiner_->SetInstanceReservoir(std::make_shared<InstanceReservoir>(reservoir_config));
+    }
+    if (config_.enable_similarity_cache) {
+        similarity_cache_ = std::make_shared<PairwiseSimilarityCache>(config_.similarity_cache_config);
+        refiner_->SetSimilarityCache(similarity_cache_);
+    }
+
+    // Content hash index for the exact-duplicate fast path
+    if (config_.enable_duplicate_fast_path) {
+        content_index_ = std::make_shared<ContentHashIndex>();
+        matcher_->SetContentIndex(content_index_);
+    }
 
     // Create similarity search
     if (config_.enable_indexing) {
-        similarity_search_ = std::make_unique<SimilaritySearch>(
+        similarity_search_ = std::make_shared<SimilaritySearch>(
             database_,
             similarity_metric_
         );
+        similarity_search_->SetStoragePrecision(config_.search_precision,
+                                                config_.search_rerank_factor);
+
+        // Matching range queries go through the same search and its layout
+        matcher_->SetSearch(similarity_search_);
     }
+
+    // Merge candidates for RunMaintenance; seeded by the first run
+    merge_index_ = std::make_unique<MergeCandidateIndex>(MergeCandidateIndex::Config());
 }
 
 std::shared_ptr<SimilarityMetric> PatternEngine::CreateSimilarityMetric(
@@ -96,7 +121,10 @@ std::shared_ptr<SimilarityMetric> PatternEngine::CreateSimilarityMetric(
 PatternEngine::ProcessResult PatternEngine::ProcessInput(
     const std::vector<uint8_t>& raw_input,
     DataModality modality) {
+    return ProcessInput(InputView::Bytes(raw_input.data(), raw_input.size(), modality));
+}
 
+PatternEngine::ProcessResult PatternEngine::ProcessInput(const InputView& input) {
     auto start_time = std::chrono::high_resolution_clock::now();
 
     ProcessResult result;
@@ -105,7 +133,7 @@ PatternEngine::ProcessResult PatternEngine::ProcessInput(
     result.updated_patterns.clear();
 
     // Step 1: Extract patterns from raw input
-    auto extracted_patterns = extractor_->Extract(raw_input);
+    auto extracted_patterns = extractor_->Extract(input);
 
     if (extracted_patterns.empty()) {
         auto end_time = std::chrono::high_resolution_clock::now();
@@ -115,9 +143,27 @@ PatternEngine::ProcessResult PatternEngine::ProcessInput(
     }
 
     // Step 2: For each extracted pattern, find matches and make decisions
+    size_t duplicate_lookups = 0;
+    size_t duplicate_hits = 0;
+    uint64_t source_hash = content_index_ ? ContentHashIndex::SourceHash(input) : 0;
     for (const auto& pattern_data : extracted_patterns) {
-        auto matches = matcher_->FindMatches(pattern_data);
-        auto decision = matcher_->MakeDecision(pattern_data);
+        // Exact repeat of a stored pattern: update it without matching
+        if (content_index_) {
+            ++duplicate_lookups;
+            if (auto duplicate = matcher_->FindExactDuplicate(pattern_data, source_hash)) {
+                ++duplicate_hits;
+                result.activated_patterns.push_back(duplicate->id);
+                refiner_->RecordInstance(duplicate->id, pattern_data);
+                if (config_.enable_auto_refinement) {
+                    refiner_->AdjustConfidence(duplicate->id, true);
+                }
+                continue;
+            }
+        }
+
+        auto evaluation = matcher_->Evaluate(pattern_data);
+        const auto& matches = evaluation.matches;
+        const auto& decision = evaluation.decision;
 
         switch (decision.decision) {
             case PatternMatcher::Decision::CREATE_NEW: {
@@ -128,6 +174,12 @@ PatternEngine::ProcessResult PatternEngine::ProcessInput(
                     decision.confidence
                 );
                 result.created_patterns.push_back(new_id);
+                if (content_index_) {
+                    // Keyed on the input so lossy features of other inputs
+                    // do not resolve to this pattern
+                    content_index_->Add(new_id, pattern_data, source_hash);
+                }
+                SyncSearchIndices({new_id});
                 break;
             }
 
@@ -136,6 +188,7 @@ PatternEngine::ProcessResult PatternEngine::ProcessInput(
                 if (decision.existing_id.has_value()) {
                     PatternID match_id = decision.existing_id.value();
                     result.activated_patterns.push_back(match_id);
+                    refiner_->RecordInstance(match_id, pattern_data);
 
                     // Adjust confidence based on good match
                     if (config_.enable_auto_refinement) {
@@ -158,10 +211,12 @@ PatternEngine::ProcessResult PatternEngine::ProcessInput(
                     auto merge_result = refiner_->MergePatterns(merge_candidates);
                     if (merge_result.success) {
                         result.created_patterns.push_back(merge_result.merged_id);
+                        SyncSearchIndices({merge_result.merged_id});
                         // Mark originals as updated (merged away)
                         for (const auto& id : merge_candidates) {
                             result.updated_patterns.push_back(id);
                         }
+                        InvalidateSimilarities(merge_candidates);
                     }
                 }
                 break;
@@ -179,26 +234,342 @@ PatternEngine::ProcessResult PatternEngine::ProcessInput(
         total_inputs_processed_++;
         total_patterns_created_ += result.created_patterns.size();
         total_patterns_updated_ += result.updated_patterns.size();
+        duplicate_lookups_ += duplicate_lookups;
+        duplicate_hits_ += duplicate_hits;
     }
 
+    QueueForMaintenance(result.created_patterns);
+    QueueForMaintenance(result.activated_patterns);
+
     return result;
 }
 
+PatternEngine::BatchResult PatternEngine::ProcessBatch(
+    const std::vector<std::vector<uint8_t>>& inputs,
+    DataModality modality) {
+    std::vector<InputView> views;
+    views.reserve(inputs.size());
+    for (const auto& input : inputs) {
+        views.push_back(InputView::Bytes(input.data(), input.size(), modality));
+    }
+    return ProcessBatch(views);
+}
+
+PatternEngine::BatchResult PatternEngine::ProcessBatch(const std::vector<InputView>& inputs) {
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto elapsed_ms = [](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<float, std::milli>(to - from).count();
+    };
+
+    auto start_time = Clock::now();
+
+    BatchResult batch;
+    batch.results.resize(inputs.size());
+    for (auto& result : batch.results) {
+        result.processing_time_ms = 0.0f;
+    }
+
+    // Stage 1: Extract patterns from every input in parallel
+    std::vector<std::vector<PatternData>> extracted(inputs.size());
+    std::vector<uint64_t> source_hashes(inputs.size(), 0);
+    WorkerPool& pool = config_.batch_worker_pool ? *config_.batch_worker_pool
+                                                 : WorkerPool::Shared();
+    pool.ParallelFor(inputs.size(), [&](size_t i) {
+        extracted[i] = extractor_->Extract(inputs[i]);
+        source_hashes[i] = ContentHashIndex::SourceHash(inputs[i]);
+    });
+
+    auto extracted_time = Clock::now();
+    batch.extraction_time_ms = elapsed_ms(start_time, extracted_time);
+
+    // Stage 2: Match distinct windows with one batched search
+    struct WindowRef {
+        size_t input;
+        size_t window;
+    };
+    std::vector<WindowRef> distinct;                   // First occurrence of each window
+    std::vector<std::vector<size_t>> window_to_distinct(inputs.size());
+    std::unordered_map<uint64_t, std::vector<size_t>> distinct_by_key;
+
+    auto data_of = [&](size_t d) -> const PatternData& {
+        return extracted[distinct[d].input][distinct[d].window];
+    };
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        window_to_distinct[i].reserve(extracted[i].size());
+        for (size_t w = 0; w < extracted[i].size(); ++w) {
+            ++batch.windows;
+            const PatternData& data = extracted[i][w];
+            auto& bucket = distinct_by_key[ContentHashIndex::KeyOf(data, source_hashes[i])];
+
+            std::optional<size_t> repeat;
+            for (size_t d : bucket) {
+                if (source_hashes[distinct[d].input] == source_hashes[i] && data_of(d) == data) {
+                    repeat = d;
+                    break;
+                }
+            }
+            if (repeat) {
+                ++batch.intra_batch_duplicates;
+                window_to_distinct[i].push_back(*repeat);
+                continue;
+            }
+
+            bucket.push_back(distinct.size());
+            window_to_distinct[i].push_back(distinct.size());
+            distinct.push_back({i, w});
+        }
+    }
+
+    // Exact repeats of stored patterns skip matching
+    size_t duplicate_lookups = 0;
+    size_t duplicate_hits = 0;
+    std::vector<std::optional<PatternID>> stored_duplicate(distinct.size());
+    std::vector<PatternData> to_evaluate;
+    std::vector<size_t> evaluated_distinct;
+    for (size_t d = 0; d < distinct.size(); ++d) {
+        if (content_index_) {
+            ++duplicate_lookups;
+            auto duplicate = matcher_->FindExactDuplicate(
+                data_of(d), source_hashes[distinct[d].input]);
+            if (duplicate) {
+                ++duplicate_hits;
+                stored_duplicate[d] = duplicate->id;
+                continue;
+            }
+        }
+        to_evaluate.push_back(data_of(d));
+        evaluated_distinct.push_back(d);
+    }
+
+    auto evaluations = matcher_->EvaluateBatch(to_evaluate);
+
+    // New windows that would have matched a pattern created earlier in the
+    // batch are folded into it instead of creating their own
+    const float fold_threshold = config_.matching_config.weak_match_threshold;
+    const bool from_features = similarity_metric_->ComputesFromFeatures();
+    std::vector<size_t> pending;                        // Indices into evaluations
+    std::vector<FeatureVector> pending_features;
+    std::vector<std::vector<float>> pending_summaries;
+    std::unordered_map<size_t, size_t> folded_into;     // Evaluation -> pending slot
+    for (size_t e = 0; e < evaluations.size(); ++e) {
+        if (evaluations[e].decision.decision != PatternMatcher::Decision::CREATE_NEW) {
+            continue;
+        }
+
+        FeatureVector features;
+        std::vector<float> summary;
+        if (from_features) {
+            features = to_evaluate[e].GetFeatures();
+            summary = similarity_metric_->ComputeBoundSummary(features);
+        }
+
+        std::optional<size_t> best_slot;
+        float best_similarity = fold_threshold;
+        for (size_t slot = 0; slot < pending.size(); ++slot) {
+            float similarity;
+            if (from_features) {
+                // Same bound checks as the database search
+                if (similarity_metric_->UpperBoundFromSummaries(
+                        summary, pending_summaries[slot]) < best_similarity) {
+                    continue;
+                }
+                similarity = similarity_metric_->ComputeFromFeaturesBounded(
+                    features, summary, pending_features[slot], pending_summaries[slot],
+                    best_similarity);
+            } else {
+                similarity = similarity_metric_->Compute(to_evaluate[e], to_evaluate[pending[slot]]);
+            }
+
+            if (similarity > best_similarity || (!best_slot && similarity >= best_similarity)) {
+                best_similarity = similarity;
+                best_slot = slot;
+            }
+        }
+
+        if (best_slot) {
+            ++batch.intra_batch_merges;
+            folded_into[e] = *best_slot;
+        } else {
+            pending.push_back(e);
+            pending_features.push_back(std::move(features));
+            pending_summaries.push_back(std::move(summary));
+        }
+    }
+
+    auto matched_time = Clock::now();
+    batch.matching_time_ms = elapsed_ms(extracted_time, matched_time);
+
+    // Stage 3: Apply merges, creations and confidence adjustments
+    struct Outcome {
+        std::optional<PatternID> id;        // Pattern the window resolved to
+        bool created{false};
+        std::vector<PatternID> merged_away;
+    };
+    std::vector<Outcome> outcomes(distinct.size());
+    std::unordered_map<PatternID, PatternID> merged_into;
+    auto current_id = [&merged_into](PatternID id) {
+        for (auto it = merged_into.find(id); it != merged_into.end(); it = merged_into.find(id)) {
+            id = it->second;
+        }
+        return id;
+    };
+
+    for (size_t d = 0; d < distinct.size(); ++d) {
+        if (stored_duplicate[d]) {
+            outcomes[d].id = stored_duplicate[d];
+        }
+    }
+
+    for (size_t e = 0; e < evaluations.size(); ++e) {
+        const auto& evaluation = evaluations[e];
+        Outcome& outcome = outcomes[evaluated_distinct[e]];
+
+        if (evaluation.decision.decision == PatternMatcher::Decision::UPDATE_EXISTING) {
+            if (evaluation.decision.existing_id.has_value()) {
+                outcome.id = current_id(evaluation.decision.existing_id.value());
+            }
+        } else if (evaluation.decision.decision == PatternMatcher::Decision::MERGE_SIMILAR) {
+            std::vector<PatternID> merge_candidates;
+            for (const auto& match : evaluation.matches) {
+                if (match.similarity >= config_.matching_config.weak_match_threshold) {
+                    PatternID id = current_id(match.id);
+                    if (std::find(merge_candidates.begin(), merge_candidates.end(), id) ==
+                        merge_candidates.end()) {
+                        merge_candidates.push_back(id);
+                    }
+                }
+            }
+
+            if (merge_candidates.size() == 1) {
+                // Everything it matched was already merged earlier in the batch
+                outcome.id = merge_candidates.front();
+            } else if (!merge_candidates.empty() && config_.enable_auto_refinement) {
+                auto merge_result = refiner_->MergePatterns(merge_candidates);
+                if (merge_result.success) {
+                    outcome.id = merge_result.merged_id;
+                    outcome.created = true;
+                    outcome.merged_away = merge_candidates;
+                    InvalidateSimilarities(merge_candidates);
+                    SyncSearchIndices({merge_result.merged_id});
+                    for (const auto& id : merge_candidates) {
+                        merged_into[id] = merge_result.merged_id;
+                    }
+                }
+            }
+        }
+    }
+
+    // All new patterns in one StoreBatch
+    std::vector<PatternData> new_data;
+    std::vector<float> new_confidences;
+    new_data.reserve(pending.size());
+    new_confidences.reserve(pending.size());
+    for (size_t e : pending) {
+        new_data.push_back(to_evaluate[e]);
+        new_confidences.push_back(evaluations[e].decision.confidence);
+    }
+    auto new_ids = creator_->CreatePatternsBatch(new_data, new_confidences);
+    SyncSearchIndices(new_ids);
+    for (size_t slot = 0; slot < pending.size(); ++slot) {
+        size_t d = evaluated_distinct[pending[slot]];
+        outcomes[d].id = new_ids[slot];
+        outcomes[d].created = true;
+        if (content_index_) {
+            content_index_->Add(new_ids[slot], new_data[slot],
+                                source_hashes[distinct[d].input]);
+        }
+    }
+    for (const auto& [e, slot] : folded_into) {
+        outcomes[evaluated_distinct[e]].id = new_ids[slot];
+    }
+
+    // Distribute outcomes to the inputs; a window's first occurrence
+    // carries a creation, every other occurrence is an activation and,
+    // as in ProcessInput, an instance of the pattern it resolved to
+    std::unordered_map<PatternID, size_t> activations;
+    std::vector<bool> reported(distinct.size(), false);
+    size_t created_count = 0;
+    size_t updated_count = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        ProcessResult& result = batch.results[i];
+        for (size_t d : window_to_distinct[i]) {
+            const Outcome& outcome = outcomes[d];
+            if (!outcome.id) {
+                continue;
+            }
+
+            if (outcome.created && !reported[d]) {
+                result.created_patterns.push_back(*outcome.id);
+                result.updated_patterns.insert(result.updated_patterns.end(),
+                                               outcome.merged_away.begin(),
+                                               outcome.merged_away.end());
+                created_count++;
+                updated_count += outcome.merged_away.size();
+            } else {
+                result.activated_patterns.push_back(*outcome.id);
+                activations[*outcome.id]++;
+                refiner_->RecordInstance(*outcome.id, data_of(d));
+            }
+            reported[d] = true;
+        }
+    }
+
+    if (config_.enable_auto_refinement) {
+        for (const auto& [id, count] : activations) {
+            refiner_->AdjustConfidence(id, true, count);
+        }
+    }
+
+    auto end_time = Clock::now();
+    batch.apply_time_ms = elapsed_ms(matched_time, end_time);
+    batch.total_time_ms = elapsed_ms(start_time, end_time);
+    if (!inputs.empty()) {
+        float per_input = batch.total_time_ms / static_cast<float>(inputs.size());
+        for (auto& result : batch.results) {
+            result.processing_time_ms = per_input;
+        }
+    }
+
+    // Update statistics
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        total_inputs_processed_ += inputs.size();
+        total_patterns_created_ += created_count;
+        total_patterns_updated_ += updated_count;
+        duplicate_lookups_ += duplicate_lookups;
+        duplicate_hits_ += duplicate_hits;
+    }
+
+    for (const auto& result : batch.results) {
+        QueueForMaintenance(result.created_patterns);
+        QueueForMaintenance(result.activated_patterns);
+    }
+
+    return batch;
+}
+
 std::vector<PatternID> PatternEngine::DiscoverPatterns(
     const std::vector<uint8_t>& raw_input,
     DataModality modality) {
+    return DiscoverPatterns(InputView::Bytes(raw_input.data(), raw_input.size(), modality));
+}
 
+std::vector<PatternID> PatternEngine::DiscoverPatterns(const InputView& input) {
     std::vector<PatternID> discovered;
 
     // Extract patterns from raw input
-    auto extracted_patterns = extractor_->Extract(raw_input);
+    auto extracted_patterns = extractor_->Extract(input);
 
     // Create patterns for all extracted data
     for (const auto& pattern_data : extracted_patterns) {
         PatternID id = creator_->CreatePattern(pattern_data);
         discovered.push_back(id);
     }
+    SyncSearchIndices(discovered);
 
+    QueueForMaintenance(discovered);
     return discovered;
 }
 
@@ -230,6 +601,17 @@ std::vector<PatternID> PatternEngine::GetAllPatternIDs() const {
     return database_->FindAll();
 }
 
+std::vector<PatternID> PatternEngine::GetParentPatterns(PatternID id) const {
+    return database_->GetParentPatterns(id);
+}
+
+std::vector<HierarchyEntry> PatternEngine::TraverseHierarchy(
+        const std::vector<PatternID>& roots,
+        HierarchyDirection direction,
+        size_t max_depth) const {
+    return database_->TraverseHierarchy(roots, direction, max_depth);
+}
+
 // ============================================================================
 // Pattern Search
 // ============================================================================
@@ -296,12 +678,14 @@ PatternID PatternEngine::CreatePattern(
     float confidence) {
 
     PatternID id = creator_->CreatePattern(data, PatternType::ATOMIC, confidence);
+    SyncSearchIndices({id});
 
     {
         std::lock_guard<std::mutex> lock(stats_mutex_);
         total_patterns_created_++;
     }
 
+    QueueForMaintenance({id});
     return id;
 }
 
@@ -310,12 +694,14 @@ PatternID PatternEngine::CreateCompositePattern(
     const PatternData& data) {
 
     PatternID id = creator_->CreateCompositePattern(sub_patterns, data);
+    SyncSearchIndices({id});
 
     {
         std::lock_guard<std::mutex> lock(stats_mutex_);
         total_patterns_created_++;
     }
 
+    QueueForMaintenance({id});
     return id;
 }
 
@@ -326,64 +712,79 @@ bool PatternEngine::UpdatePattern(
     bool success = refiner_->UpdatePattern(id, new_data);
 
     if (success) {
-        std::lock_guard<std::mutex> lock(stats_mutex_);
-        total_patterns_updated_++;
+        if (content_index_) {
+            // The new data did not come from an input
+            content_index_->Remove(id);
+        }
+        SyncSearchIndices({id});
+        InvalidateSimilarities({id});
+    }
+
+    if (success) {
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            total_patterns_updated_++;
+        }
+        QueueForMaintenance({id});
     }
 
     return success;
 }
 
 bool PatternEngine::DeletePattern(PatternID id) {
-    return database_->Delete(id);
+    if (content_index_) {
+        content_index_->Remove(id);
+    }
+    if (auto reservoir = refiner_->GetInstanceReservoir()) {
+        reservoir->Remove(id);
+    }
+    merge_index_->Remove(id);
+    {
+        std::lock_guard<std::mutex> lock(maintenance_mutex_);
+        merged_away_.erase(id);
+    }
+    InvalidateSimilarities({id});
+    bool deleted = database_->Delete(id);
+    SyncSearchIndices({id});
+    return deleted;
 }
 
 // ============================================================================
 // Statistics & Information
 // ============================================================================
 
-PatternEngine::Statistics PatternEngine::GetStatistics() const {
+PatternEngine::Statistics PatternEngine::GetStatistics(bool verify) const {
     Statistics stats;
 
-    auto all_ids = database_->FindAll();
-    stats.total_patterns = all_ids.size();
-
-    float total_confidence = 0.0f;
-    float total_size = 0.0f;
-
-    for (const auto& id : all_ids) {
-        auto pattern_opt = database_->Retrieve(id);
-        if (pattern_opt.has_value()) {
-            const auto& pattern = pattern_opt.value();
+    PatternAggregates aggregates = database_->GetAggregates();
+    if (verify) {
+        PatternAggregates scanned = database_->ScanAggregates();
+        stats.aggregates_verified = true;
+        stats.aggregates_consistent = (scanned == aggregates);
+        aggregates = scanned;
+    }
 
-            // Count by type
-            switch (pattern.GetType()) {
-                case PatternType::ATOMIC:
-                    stats.atomic_patterns++;
-                    break;
-                case PatternType::COMPOSITE:
-                    stats.composite_patterns++;
-                    break;
-                case PatternType::META:
-                    stats.meta_patterns++;
-                    break;
-            }
+    stats.total_patterns = aggregates.total_patterns;
+    stats.atomic_patterns = aggregates.atomic_patterns;
+    stats.composite_patterns = aggregates.composite_patterns;
+    stats.meta_patterns = aggregates.meta_patterns;
+    stats.avg_confidence = aggregates.AverageConfidence();
+    stats.avg_pattern_size_bytes = aggregates.AverageFeatureBytes();
 
-            // Accumulate confidence
-            total_confidence += pattern.GetConfidenceScore();
+    // Get storage stats
+    stats.storage_stats = database_->GetStats();
 
-            // Estimate size (rough approximation)
-            total_size += pattern.GetData().GetFeatures().Dimension() * sizeof(float);
-        }
+    if (auto reservoir = refiner_->GetInstanceReservoir()) {
+        stats.patterns_with_instances = reservoir->Size();
+        stats.instance_reservoir_bytes = reservoir->GetMemoryBytes();
     }
 
-    if (stats.total_patterns > 0) {
-        stats.avg_confidence = total_confidence / stats.total_patterns;
-        stats.avg_pattern_size_bytes = total_size / stats.total_patterns;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats.duplicate_lookups = duplicate_lookups_;
+        stats.duplicate_hits = duplicate_hits_;
     }
 
-    // Get storage stats
-    stats.storage_stats = database_->GetStats();
-
     return stats;
 }
 
@@ -399,37 +800,159 @@ void PatternEngine::Flush() {
     database_->Flush();
 }
 
-void PatternEngine::RunMaintenance() {
+PatternEngine::MaintenanceResult PatternEngine::RunMaintenance() {
+    return RunMaintenance(config_.maintenance_time_budget_ms);
+}
+
+PatternEngine::MaintenanceResult PatternEngine::RunMaintenance(float time_budget_ms) {
+    using Clock = std::chrono::steady_clock;
+    const auto start_time = Clock::now();
+    auto elapsed_ms = [&]() {
+        return std::chrono::duration<float, std::milli>(Clock::now() - start_time).count();
+    };
+
+    MaintenanceResult result;
     if (!config_.enable_auto_refinement) {
-        return;
+        return result;
+    }
+
+    std::lock_guard<std::mutex> run_lock(maintenance_run_mutex_);
+
+    // First run: index and queue everything stored so far
+    {
+        std::lock_guard<std::mutex> lock(maintenance_mutex_);
+        if (!maintenance_seeded_) {
+            for (PatternID id : merge_index_->Rebuild(*database_)) {
+                if (maintenance_queued_.insert(id).second) {
+                    maintenance_queue_.push_back(id);
+                }
+            }
+            maintenance_seeded_ = true;
+        }
     }
 
-    auto all_ids = database_->FindAll();
+    const float merge_threshold = refiner_->GetMergeSimilarityThreshold();
+    while (true) {
+        if (time_budget_ms > 0.0f && result.patterns_checked > 0 &&
+            elapsed_ms() >= time_budget_ms) {
+            result.budget_exhausted = true;
+            break;
+        }
+
+        PatternID id;
+        {
+            std::lock_guard<std::mutex> lock(maintenance_mutex_);
+            if (maintenance_queue_.empty()) {
+                break;
+            }
+            id = maintenance_queue_.front();
+            maintenance_queue_.pop_front();
+            maintenance_queued_.erase(id);
+            if (merged_away_.count(id)) {
+                continue;
+            }
+        }
+        result.patterns_checked++;
+
+        auto node = database_->Retrieve(id);
+        if (!node) {
+            merge_index_->Remove(id);
+            continue;
+        }
+        merge_index_->Upsert(id, node->GetType(), node->GetData().GetFeatures());
 
-    // Check for patterns that need splitting
-    std::vector<PatternID> to_split;
-    for (const auto& id : all_ids) {
+        // Split patterns that are too general
         if (refiner_->NeedsSplitting(id)) {
-            to_split.push_back(id);
+            auto split = refiner_->SplitPattern(id, 2);
+            if (split.success) {
+                result.patterns_split++;
+                InvalidateSimilarities({id});
+                SyncSearchIndices(split.new_pattern_ids);
+                for (PatternID part : split.new_pattern_ids) {
+                    IndexForMerging(part);
+                }
+            }
+            continue;
+        }
+
+        // Merge with the nearest neighbor the refiner confirms
+        for (const auto& neighbor : merge_index_->Neighbors(
+                 id, config_.maintenance_merge_neighbors, merge_threshold)) {
+            {
+                std::lock_guard<std::mutex> lock(maintenance_mutex_);
+                if (merged_away_.count(neighbor.id)) {
+                    continue;
+                }
+            }
+            result.merge_candidates++;
+            if (!refiner_->ShouldMerge(id, neighbor.id)) {
+                continue;
+            }
+
+            auto merge = refiner_->MergePatterns({id, neighbor.id});
+            if (merge.success) {
+                result.patterns_merged++;
+                {
+                    std::lock_guard<std::mutex> lock(maintenance_mutex_);
+                    merged_away_.insert(id);
+                    merged_away_.insert(neighbor.id);
+                }
+                merge_index_->Remove(id);
+                merge_index_->Remove(neighbor.id);
+                InvalidateSimilarities({id, neighbor.id});
+                SyncSearchIndices({merge.merged_id});
+                IndexForMerging(merge.merged_id);
+            }
+            break;
         }
     }
 
-    // Split patterns that are too general
-    for (const auto& id : to_split) {
-        refiner_->SplitPattern(id, 2);
+    {
+        std::lock_guard<std::mutex> lock(maintenance_mutex_);
+        result.patterns_pending = maintenance_queue_.size();
     }
+    result.time_ms = elapsed_ms();
+    return result;
+}
 
-    // Check for similar patterns that should be merged
-    for (size_t i = 0; i < all_ids.size(); ++i) {
-        for (size_t j = i + 1; j < all_ids.size(); ++j) {
-            if (refiner_->ShouldMerge(all_ids[i], all_ids[j])) {
-                refiner_->MergePatterns({all_ids[i], all_ids[j]});
-                break;  // After merge, pattern IDs change
-            }
+void PatternEngine::QueueForMaintenance(const std::vector<PatternID>& ids) {
+    std::lock_guard<std::mutex> lock(maintenance_mutex_);
+
+    // Until the first run seeds the queue from the database there is
+    // nothing to add to
+    if (!maintenance_seeded_) {
+        return;
+    }
+    for (PatternID id : ids) {
+        if (maintenance_queued_.insert(id).second) {
+            maintenance_queue_.push_back(id);
         }
     }
 }
 
+void PatternEngine::IndexForMerging(PatternID id) {
+    if (auto node = database_->Retrieve(id)) {
+        merge_index_->Upsert(id, node->GetType(), node->GetData().GetFeatures());
+    }
+}
+
+void PatternEngine::SyncSearchIndices(const std::vector<PatternID>& ids) {
+    // The matcher passes changes on to its search, which is
+    // similarity_search_ when indexing is enabled
+    for (PatternID id : ids) {
+        matcher_->NotifyPatternChanged(id);
+    }
+}
+
+void PatternEngine::InvalidateSimilarities(const std::vector<PatternID>& ids) {
+    if (!similarity_cache_) {
+        return;
+    }
+    for (PatternID id : ids) {
+        similarity_cache_->Invalidate(id);
+    }
+}
+
 // ============================================================================
 // Snapshot & Restore
 // ============================================================================
@@ -463,6 +986,13 @@ bool PatternEngine::LoadSnapshot(const std::string& path) {
 
     if (config_.database_type == "persistent") {
         // Database automatically loads from config_.database_path
+        if (content_index_) {
+            content_index_->Clear();
+        }
+        if (similarity_search_) {
+            similarity_search_->ClearBoundCache();
+            similarity_search_->RebuildLayout();
+        }
         return true;
     }
 
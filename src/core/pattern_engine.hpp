@@ -1,18 +1,24 @@
 // File: src/core/pattern_engine.hpp
 #pragma once
 
+#include "core/input_view.hpp"
 #include "core/pattern_node.hpp"
+#include "core/worker_pool.hpp"
 #include "storage/pattern_database.hpp"
 #include "similarity/similarity_metric.hpp"
 #include "similarity/similarity_search.hpp"
+#include "similarity/pairwise_similarity_cache.hpp"
 #include "discovery/pattern_extractor.hpp"
 #include "discovery/pattern_matcher.hpp"
 #include "discovery/pattern_creator.hpp"
 #include "discovery/pattern_refiner.hpp"
+#include "discovery/merge_candidate_index.hpp"
+#include <deque>
 #include <memory>
 #include <vector>
 #include <string>
 #include <mutex>
+#include <unordered_set>
 
 namespace dpan {
 
@@ -39,6 +45,35 @@ public:
         // Engine options
         bool enable_auto_refinement{true};
         bool enable_indexing{true};
+
+        // Precision of the similarity search layout (FLOAT32 = search
+        // stored features directly) and the exact re-rank pool multiplier
+        FeaturePrecision search_precision{FeaturePrecision::FLOAT32};
+        size_t search_rerank_factor{4};
+
+        // Resolve inputs identical to a stored pattern by content hash,
+        // skipping similarity matching. Only patterns created from an input
+        // in this session are indexed (keyed on the raw input, which is not
+        // stored), so repeats of inputs from earlier sessions, and patterns
+        // that were merged, updated or created directly, go through matching.
+        bool enable_duplicate_fast_path{true};
+
+        // Pool for ProcessBatch extraction (null = WorkerPool::Shared())
+        std::shared_ptr<WorkerPool> batch_worker_pool;
+
+        // Matched inputs sampled per pattern for split decisions
+        // (0 = none; see InstanceReservoir)
+        size_t instance_reservoir_capacity{16};
+
+        // RunMaintenance: nearest neighbors checked as merge candidates per
+        // changed pattern, and wall-time budget per run (0 = unlimited)
+        size_t maintenance_merge_neighbors{8};
+        float maintenance_time_budget_ms{0.0f};
+
+        // Pattern-pair similarity cache used by the refiner and handed out
+        // by GetSimilarityCache() to memory and attention consumers
+        bool enable_similarity_cache{true};
+        PairwiseSimilarityCache::Config similarity_cache_config;
     };
 
     /// Result from processing input
@@ -49,6 +84,31 @@ public:
         float processing_time_ms;
     };
 
+    /// Result from processing a batch of inputs
+    struct BatchResult {
+        std::vector<ProcessResult> results;  ///< One per input, in order
+        size_t windows{0};                   ///< Patterns extracted from all inputs
+        size_t intra_batch_duplicates{0};    ///< Windows repeating an earlier window of the batch
+        size_t intra_batch_merges{0};        ///< New windows folded into a pattern created by the batch
+
+        // Per-stage wall time
+        float extraction_time_ms{0.0f};
+        float matching_time_ms{0.0f};
+        float apply_time_ms{0.0f};
+        float total_time_ms{0.0f};
+    };
+
+    /// Result from one maintenance run
+    struct MaintenanceResult {
+        size_t patterns_checked{0};       ///< Changed patterns examined
+        size_t patterns_split{0};
+        size_t patterns_merged{0};        ///< Merges performed (two patterns each)
+        size_t merge_candidates{0};       ///< Neighbors confirmed with ShouldMerge
+        size_t patterns_pending{0};       ///< Changed patterns left for later runs
+        bool budget_exhausted{false};     ///< Stopped by the time budget
+        float time_ms{0.0f};
+    };
+
     /// Engine statistics
     struct Statistics {
         size_t total_patterns{0};
@@ -58,6 +118,19 @@ public:
         float avg_confidence{0.0f};
         float avg_pattern_size_bytes{0.0f};
         StorageStats storage_stats;
+
+        // Exact-duplicate fast path in ProcessInput
+        size_t duplicate_lookups{0};
+        size_t duplicate_hits{0};
+
+        // Matched-instance samples kept for splitting
+        size_t patterns_with_instances{0};
+        size_t instance_reservoir_bytes{0};
+
+        // Verify mode: the maintained totals were cross-checked against a
+        // full scan, and whether they agreed
+        bool aggregates_verified{false};
+        bool aggregates_consistent{true};
     };
 
     /// Constructor
@@ -86,6 +159,36 @@ public:
         DataModality modality
     );
 
+    /// Process a typed input end-to-end without serializing it to bytes
+    /// (see PatternExtractor::Extract(const InputView&))
+    /// @param input View of the input samples
+    /// @return Processing result with activated/created patterns
+    ProcessResult ProcessInput(const InputView& input);
+
+    /// Process several inputs as one staged pipeline
+    ///
+    /// Extraction runs in parallel over the inputs, all extracted windows
+    /// are matched with one batched search, and new patterns are written
+    /// with a single StoreBatch. Every window is matched against the
+    /// database as it was before the batch; instead of seeing each other's
+    /// patterns, repeats of an earlier window in the batch share its
+    /// outcome, and new windows that match a pattern created earlier in the
+    /// batch (at least the weak match threshold) are folded into it.
+    /// Confidence adjustments are applied once per pattern. Each result's
+    /// processing_time_ms is the batch average per input.
+    /// @param inputs Raw input records
+    /// @param modality Data modality
+    /// @return Per-input results, batch counters and stage timings
+    BatchResult ProcessBatch(
+        const std::vector<std::vector<uint8_t>>& inputs,
+        DataModality modality
+    );
+
+    /// Process several typed inputs as one staged pipeline
+    /// @param inputs Views of the input records
+    /// @return Per-input results, batch counters and stage timings
+    BatchResult ProcessBatch(const std::vector<InputView>& inputs);
+
     /// Discover patterns from raw input
     /// @param raw_input Raw input bytes
     /// @param modality Data modality
@@ -95,6 +198,11 @@ public:
         DataModality modality
     );
 
+    /// Discover patterns from a typed input
+    /// @param input View of the input samples
+    /// @return IDs of discovered patterns
+    std::vector<PatternID> DiscoverPatterns(const InputView& input);
+
     // ========================================================================
     // Pattern Retrieval
     // ========================================================================
@@ -113,6 +221,20 @@ public:
     /// @return Vector of all pattern IDs in the database
     std::vector<PatternID> GetAllPatternIDs() const;
 
+    /// Get the composite and meta patterns that contain a pattern
+    /// @param id Pattern ID
+    /// @return Parent pattern IDs
+    std::vector<PatternID> GetParentPatterns(PatternID id) const;
+
+    /// Collect ancestors or descendants of several patterns at once
+    /// @param roots Starting patterns
+    /// @param direction ANCESTORS follows parents, DESCENDANTS sub-patterns
+    /// @param max_depth Deepest level to report
+    /// @return Reached patterns with their depth, breadth-first
+    std::vector<HierarchyEntry> TraverseHierarchy(const std::vector<PatternID>& roots,
+                                                  HierarchyDirection direction,
+                                                  size_t max_depth) const;
+
     // ========================================================================
     // Pattern Search
     // ========================================================================
@@ -180,13 +302,31 @@ public:
     // ========================================================================
 
     /// Get engine statistics
+    ///
+    /// Pattern counts, average confidence and average size come from the
+    /// totals the database maintains on every write, so this is O(1) in
+    /// the number of patterns. With verify set, the totals are also
+    /// recomputed by visiting every pattern (O(n)); the recomputed values
+    /// are reported and aggregates_consistent records whether the two
+    /// agreed. Writes racing with the scan can make them differ, so verify
+    /// is meaningful only while the engine is quiescent.
+    ///
+    /// @param verify Cross-check the maintained totals with a full scan
     /// @return Current engine statistics
-    Statistics GetStatistics() const;
+    Statistics GetStatistics(bool verify = false) const;
 
     /// Get configuration
     /// @return Current configuration
     const Config& GetConfig() const { return config_; }
 
+    /// Get the shared pattern-pair similarity cache
+    ///
+    /// Install it on other consumers of the same patterns (MemoryManager,
+    /// SelfAttention) so they share scores with the refiner. The engine
+    /// drops a pattern's entries when it updates, deletes or merges it.
+    /// @return Cache, or nullptr if enable_similarity_cache is false
+    std::shared_ptr<PairwiseSimilarityCache> GetSimilarityCache() const { return similarity_cache_; }
+
     // ========================================================================
     // Maintenance
     // ========================================================================
@@ -197,8 +337,36 @@ public:
     /// Flush pending writes
     void Flush();
 
-    /// Run maintenance tasks (auto-refinement, pruning, etc.)
-    void RunMaintenance();
+    /// Run maintenance tasks (auto-refinement) within the configured budget
+    ///
+    /// Equivalent to RunMaintenance(config.maintenance_time_budget_ms).
+    /// @return What the run did
+    MaintenanceResult RunMaintenance();
+
+    /// Split and merge patterns changed since the previous run
+    ///
+    /// Work is incremental: patterns created, updated or matched through
+    /// the engine are queued, and a run examines only queued patterns, so
+    /// maintenance can be called repeatedly (e.g. from a background
+    /// thread) at a cost proportional to recent changes. The first run
+    /// queues every stored pattern.
+    ///
+    /// Each examined pattern is split if PatternRefiner::NeedsSplitting
+    /// says so. Otherwise its maintenance_merge_neighbors nearest patterns
+    /// of the same type are looked up in a MergeCandidateIndex, and those
+    /// above the refiner's merge threshold are confirmed with ShouldMerge;
+    /// the first confirmed one is merged with it. Patterns produced by a
+    /// split or merge are indexed but not queued. Merged-away patterns stay
+    /// stored (see PatternRefiner::MergePatterns) but are no longer merge
+    /// candidates.
+    ///
+    /// The run stops once time_budget_ms has elapsed (0 = unlimited),
+    /// after at least one pattern; the rest stay queued for the next run.
+    /// Runs are serialized; engine calls may proceed concurrently.
+    ///
+    /// @param time_budget_ms Wall-time budget in milliseconds (0 = unlimited)
+    /// @return What the run did
+    MaintenanceResult RunMaintenance(float time_budget_ms);
 
     // ========================================================================
     // Snapshot & Restore
@@ -220,22 +388,48 @@ private:
     // Core components
     std::shared_ptr<PatternDatabase> database_;
     std::shared_ptr<SimilarityMetric> similarity_metric_;
-    std::unique_ptr<SimilaritySearch> similarity_search_;
+    std::shared_ptr<SimilaritySearch> similarity_search_;
     std::unique_ptr<PatternExtractor> extractor_;
     std::unique_ptr<PatternMatcher> matcher_;
     std::unique_ptr<PatternCreator> creator_;
     std::unique_ptr<PatternRefiner> refiner_;
+    std::shared_ptr<ContentHashIndex> content_index_;
+    std::shared_ptr<PairwiseSimilarityCache> similarity_cache_;
 
     // Statistics tracking
     mutable std::mutex stats_mutex_;
     size_t total_inputs_processed_{0};
     size_t total_patterns_created_{0};
     size_t total_patterns_updated_{0};
+    size_t duplicate_lookups_{0};
+    size_t duplicate_hits_{0};
+
+    // Incremental maintenance: merge candidate index and the patterns
+    // changed since the last run (queued only once the index is seeded)
+    std::mutex maintenance_run_mutex_;
+    std::mutex maintenance_mutex_;
+    std::unique_ptr<MergeCandidateIndex> merge_index_;
+    bool maintenance_seeded_{false};
+    std::deque<PatternID> maintenance_queue_;
+    std::unordered_set<PatternID> maintenance_queued_;
+    std::unordered_set<PatternID> merged_away_;
 
     // Helper methods
     void InitializeComponents();
     std::shared_ptr<SimilarityMetric> CreateSimilarityMetric(const std::string& metric_name);
     void UpdateStatisticsAfterProcessing(const ProcessResult& result);
+
+    /// Queue patterns for the next maintenance run
+    void QueueForMaintenance(const std::vector<PatternID>& ids);
+
+    /// Index a pattern produced by maintenance without queueing it
+    void IndexForMerging(PatternID id);
+
+    /// Report stored, updated or deleted patterns to the matcher and search
+    void SyncSearchIndices(const std::vector<PatternID>& ids);
+
+    /// Drop cached pair similarities of patterns that changed or are gone
+    void InvalidateSimilarities(const std::vector<PatternID>& ids);
 };
 
 } // namespace dpan
@@ -25,6 +25,7 @@ PatternNode::PatternNode(PatternNode&& other) noexcept
     last_accessed_.store(other.last_accessed_.load(std::memory_order_relaxed), std::memory_order_relaxed);
     access_count_.store(other.access_count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
     confidence_score_.store(other.confidence_score_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    generation_.store(other.generation_.load(std::memory_order_relaxed), std::memory_order_relaxed);
     // Note: mutex is not moved, a new one is default-constructed
 }
 
@@ -154,6 +155,10 @@ PatternNode PatternNode::Clone() const {
         confidence_score_.load(std::memory_order_relaxed),
         std::memory_order_relaxed
     );
+    cloned.generation_.store(
+        generation_.load(std::memory_order_relaxed),
+        std::memory_order_relaxed
+    );
 
     // Copy sub-patterns
     {
@@ -35,6 +35,13 @@ public:
     uint32_t GetAccessCount() const { return access_count_.load(std::memory_order_relaxed); }
     float GetConfidenceScore() const { return confidence_score_.load(std::memory_order_relaxed); }
 
+    // Generation counter: bumped whenever the pattern's content is replaced so
+    // derived values (e.g. cached pairwise similarities) can detect staleness.
+    // Preserved by Clone() and moves; not serialized.
+    uint64_t GetGeneration() const { return generation_.load(std::memory_order_acquire); }
+    void SetGeneration(uint64_t generation) { generation_.store(generation, std::memory_order_release); }
+    uint64_t BumpGeneration() { return generation_.fetch_add(1, std::memory_order_acq_rel) + 1; }
+
     // Setters (thread-safe)
     void SetActivationThreshold(float threshold);
     void SetBaseActivation(float activation);
@@ -88,6 +95,7 @@ private:
     mutable std::atomic<uint64_t> last_accessed_{0};  // Stored as micros
     std::atomic<uint32_t> access_count_{0};
     std::atomic<float> confidence_score_{0.5f};
+    std::atomic<uint64_t> generation_{0};
 
     // Hierarchical structure
     mutable std::mutex sub_patterns_mutex_;
@@ -0,0 +1,116 @@
+// File: src/core/worker_pool.cpp
+#include "core/worker_pool.hpp"
+#include <algorithm>
+
+namespace dpan {
+
+namespace {
+
+/// Set on pool threads so nested loops run inline
+thread_local bool t_inside_worker = false;
+
+} // anonymous namespace
+
+WorkerPool::WorkerPool(size_t num_workers) {
+    workers_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+WorkerPool& WorkerPool::Shared() {
+    static WorkerPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+void WorkerPool::ParallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1 || workers_.empty() || t_inside_worker) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->count = count;
+    job->fn = &fn;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(job);
+    }
+    work_available_.notify_all();
+
+    // The caller works too, then waits for indices claimed by workers
+    Drain(*job);
+
+    std::exception_ptr failure;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        job->done.wait(lock, [&job]() { return job->finished == job->count; });
+        auto it = std::find(jobs_.begin(), jobs_.end(), job);
+        if (it != jobs_.end()) {
+            jobs_.erase(it);
+        }
+        failure = job->failure;
+    }
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+void WorkerPool::Drain(Job& job) {
+    for (size_t i = job.next.fetch_add(1); i < job.count; i = job.next.fetch_add(1)) {
+        std::exception_ptr failure;
+        try {
+            (*job.fn)(i);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (failure && !job.failure) {
+            job.failure = failure;
+        }
+        if (++job.finished == job.count) {
+            job.done.notify_all();
+        }
+    }
+}
+
+void WorkerPool::WorkerLoop() {
+    t_inside_worker = true;
+    for (;;) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_available_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return;  // Stopping
+            }
+            job = jobs_.front();
+            if (job->next.load() >= job->count) {
+                // Every index is claimed; the owner waits for the rest
+                jobs_.pop_front();
+                continue;
+            }
+        }
+        Drain(*job);
+    }
+}
+
+} // namespace dpan
@@ -0,0 +1,73 @@
+// File: src/core/worker_pool.hpp
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dpan {
+
+/// WorkerPool - Persistent threads for data-parallel loops
+///
+/// ParallelFor hands out loop indices to the pool's workers and to the
+/// calling thread, which works alongside them until the loop is done, so a
+/// pool without workers simply runs loops on the caller. Calls made from
+/// inside a pool task run inline on that worker, which keeps nested
+/// parallel loops from waiting on the workers they occupy.
+///
+/// Thread-safety: ParallelFor may be called concurrently from any thread.
+class WorkerPool {
+public:
+    /// Constructor
+    /// @param num_workers Background threads (0 = loops run on the caller)
+    explicit WorkerPool(size_t num_workers);
+
+    /// Destructor; joins the workers
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /// Number of background threads
+    size_t GetWorkerCount() const { return workers_.size(); }
+
+    /// Run fn(i) for every i in [0, count) and wait for all of them
+    ///
+    /// Indices run in no particular order; callers that need ordered output
+    /// write to slot i. If any call throws, the remaining indices still run
+    /// and the first exception is rethrown here.
+    void ParallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+    /// Process-wide pool with one worker per additional hardware thread
+    static WorkerPool& Shared();
+
+private:
+    struct Job {
+        size_t count{0};
+        const std::function<void(size_t)>* fn{nullptr};
+        std::atomic<size_t> next{0};
+        size_t finished{0};  ///< Guarded by mutex_
+        std::exception_ptr failure;
+        std::condition_variable done;
+    };
+
+    /// Run indices of a job until none are left to claim
+    void Drain(Job& job);
+
+    void WorkerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::deque<std::shared_ptr<Job>> jobs_;
+    std::vector<std::thread> workers_;
+    bool stopping_{false};
+};
+
+} // namespace dpan
@@ -0,0 +1,97 @@
+// File: src/discovery/change_point_detector.cpp
+#include "discovery/change_point_detector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace dpan {
+
+ChangePointDetector::ChangePointDetector(const Config& config) : config_(config) {
+    if (!(config_.threshold > 0.0f)) {
+        throw std::invalid_argument("threshold must be positive");
+    }
+    if (!(config_.drift >= 0.0f)) {
+        throw std::invalid_argument("drift cannot be negative");
+    }
+    if (!(config_.min_scale > 0.0f)) {
+        throw std::invalid_argument("min_scale must be positive");
+    }
+}
+
+bool ChangePointDetector::Update(const float* samples, size_t count) {
+    if (count == 0) {
+        throw std::invalid_argument("Window must not be empty");
+    }
+
+    // Two passes in double: windows are short and this keeps the variance
+    // exact for signals with a large offset
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += samples[i];
+    }
+    const double mean = sum / static_cast<double>(count);
+    double squares = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        const double d = samples[i] - mean;
+        squares += d * d;
+    }
+    return Update(mean, std::sqrt(squares / static_cast<double>(count)));
+}
+
+bool ChangePointDetector::Update(double mean, double stddev) {
+    ++windows_seen_;
+
+    if (!has_reference_ || !std::isfinite(mean) || !std::isfinite(stddev)) {
+        Select(mean, stddev);
+        return true;
+    }
+
+    ++since_selected_;
+    if (config_.max_interval > 0 && since_selected_ >= config_.max_interval) {
+        Select(mean, stddev);
+        return true;
+    }
+
+    const double drift = config_.drift;
+    const double z_mean = (mean - reference_mean_) / reference_scale_;
+    const double z_scale = std::log2(std::max(stddev, static_cast<double>(config_.min_scale))) -
+                           reference_log_scale_;
+
+    mean_high_ = std::max(0.0, mean_high_ + z_mean - drift);
+    mean_low_ = std::max(0.0, mean_low_ - z_mean - drift);
+    scale_high_ = std::max(0.0, scale_high_ + z_scale - drift);
+    scale_low_ = std::max(0.0, scale_low_ - z_scale - drift);
+
+    const double threshold = config_.threshold;
+    if (mean_high_ > threshold || mean_low_ > threshold ||
+        scale_high_ > threshold || scale_low_ > threshold) {
+        Select(mean, stddev);
+        return true;
+    }
+    return false;
+}
+
+void ChangePointDetector::Reset() {
+    has_reference_ = false;
+    mean_high_ = mean_low_ = scale_high_ = scale_low_ = 0.0;
+    since_selected_ = 0;
+    windows_seen_ = 0;
+    windows_selected_ = 0;
+}
+
+void ChangePointDetector::Select(double mean, double stddev) {
+    ++windows_selected_;
+    since_selected_ = 0;
+    mean_high_ = mean_low_ = scale_high_ = scale_low_ = 0.0;
+
+    // A non-finite window cannot serve as a reference; the next finite
+    // window is selected in its place
+    has_reference_ = std::isfinite(mean) && std::isfinite(stddev);
+    if (has_reference_) {
+        reference_mean_ = mean;
+        reference_scale_ = std::max(stddev, static_cast<double>(config_.min_scale));
+        reference_log_scale_ = std::log2(reference_scale_);
+    }
+}
+
+} // namespace dpan
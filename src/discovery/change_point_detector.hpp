@@ -0,0 +1,95 @@
+// File: src/discovery/change_point_detector.hpp
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dpan {
+
+/// ChangePointDetector - Decides which sliding windows are worth a pattern
+///
+/// Overlapping windows of a stationary signal yield near-identical patterns.
+/// The detector keeps the mean and standard deviation of the last window it
+/// selected as a reference and runs two-sided CUSUM tests on every later
+/// window:
+///   mean: z = (mean - ref_mean) / max(ref_std, min_scale)
+///   scale: z = log2(max(std, min_scale) / max(ref_std, min_scale))
+/// Each test accumulates S+ = max(0, S+ + z - drift) and
+/// S- = max(0, S- - z - drift). A window is selected when any sum exceeds
+/// threshold, when max_interval windows have passed since the last
+/// selection (heartbeat), or when its statistics are not finite. The first
+/// window is always selected. Selecting a window makes it the new reference
+/// and clears the sums.
+///
+/// A shift of d reference deviations is therefore selected after about
+/// threshold / (d - drift) windows; shifts below drift are ignored until
+/// the heartbeat.
+///
+/// Thread-safety: Not thread-safe; one instance per stream.
+class ChangePointDetector {
+public:
+    /// Configuration for change-point detection
+    struct Config {
+        /// CUSUM decision threshold
+        float threshold{4.0f};
+
+        /// Per-window allowance subtracted from every statistic
+        float drift{0.5f};
+
+        /// Select at least every max_interval windows (0 = no heartbeat)
+        size_t max_interval{32};
+
+        /// Floor for deviations, so flat signals do not divide by zero
+        float min_scale{1e-6f};
+    };
+
+    /// Constructor
+    /// @param config Detection configuration
+    /// @throws std::invalid_argument if threshold or min_scale is not
+    ///         positive or drift is negative
+    explicit ChangePointDetector(const Config& config);
+
+    /// Consider the next window
+    /// @param samples Window samples
+    /// @param count Number of samples (> 0)
+    /// @return true if the window should be extracted
+    bool Update(const float* samples, size_t count);
+
+    /// Consider the next window given its statistics
+    /// @return true if the window should be extracted
+    bool Update(double mean, double stddev);
+
+    /// Forget the reference and restart as before the first window
+    void Reset();
+
+    /// Windows considered since construction or Reset
+    uint64_t GetWindowsSeen() const { return windows_seen_; }
+
+    /// Windows selected since construction or Reset
+    uint64_t GetWindowsSelected() const { return windows_selected_; }
+
+    /// Get configuration
+    const Config& GetConfig() const { return config_; }
+
+private:
+    void Select(double mean, double stddev);
+
+    Config config_;
+
+    bool has_reference_{false};
+    double reference_mean_{0.0};
+    double reference_scale_{1.0};
+    double reference_log_scale_{0.0};
+
+    // CUSUM sums of the mean and scale statistics
+    double mean_high_{0.0};
+    double mean_low_{0.0};
+    double scale_high_{0.0};
+    double scale_low_{0.0};
+
+    size_t since_selected_{0};
+    uint64_t windows_seen_{0};
+    uint64_t windows_selected_{0};
+};
+
+} // namespace dpan
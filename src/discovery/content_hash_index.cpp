@@ -0,0 +1,112 @@
+// File: src/discovery/content_hash_index.cpp
+#include "content_hash_index.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace dpan {
+
+uint64_t ContentHashIndex::SourceHash(const std::vector<uint8_t>& bytes) {
+    return SourceHash(InputView::Bytes(bytes.data(), bytes.size(), DataModality::UNKNOWN));
+}
+
+uint64_t ContentHashIndex::SourceHash(const InputView& input) {
+    uint64_t hash = 14695981039346656037ULL;
+    size_t size = 0;
+    input.ForEachByteRun([&](const uint8_t* bytes, size_t run) {
+        for (size_t i = 0; i < run; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        size += run;
+    });
+    hash ^= size;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+uint64_t ContentHashIndex::KeyOf(const PatternData& data, uint64_t source_hash) {
+    uint64_t hash = data.ContentHash();
+    if (source_hash != 0) {
+        hash ^= source_hash + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+void ContentHashIndex::Add(PatternID id, const PatternData& data, uint64_t source_hash) {
+    uint64_t hash = KeyOf(data, source_hash);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    RemoveUnlocked(id);
+    ids_by_hash_[hash].push_back(id);
+    hash_by_id_[id] = hash;
+}
+
+bool ContentHashIndex::Remove(PatternID id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool present = hash_by_id_.count(id) > 0;
+    RemoveUnlocked(id);
+    return present;
+}
+
+void ContentHashIndex::RemoveUnlocked(PatternID id) {
+    auto it = hash_by_id_.find(id);
+    if (it == hash_by_id_.end()) {
+        return;
+    }
+
+    auto bucket = ids_by_hash_.find(it->second);
+    if (bucket != ids_by_hash_.end()) {
+        auto& ids = bucket->second;
+        ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        if (ids.empty()) {
+            ids_by_hash_.erase(bucket);
+        }
+    }
+    hash_by_id_.erase(it);
+}
+
+std::vector<PatternID> ContentHashIndex::Lookup(const PatternData& data,
+                                                uint64_t source_hash) const {
+    uint64_t hash = KeyOf(data, source_hash);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_by_hash_.find(hash);
+    if (it == ids_by_hash_.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+void ContentHashIndex::Rebuild(PatternDatabase& database) {
+    QueryOptions options;
+    options.max_results = std::numeric_limits<size_t>::max();
+
+    std::unordered_map<uint64_t, std::vector<PatternID>> ids_by_hash;
+    std::unordered_map<PatternID, uint64_t> hash_by_id;
+    for (const auto& id : database.FindAll(options)) {
+        auto node_opt = database.Retrieve(id);
+        if (!node_opt) {
+            continue;
+        }
+        uint64_t hash = node_opt->GetData().ContentHash();
+        ids_by_hash[hash].push_back(id);
+        hash_by_id[id] = hash;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ids_by_hash_ = std::move(ids_by_hash);
+    hash_by_id_ = std::move(hash_by_id);
+}
+
+void ContentHashIndex::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ids_by_hash_.clear();
+    hash_by_id_.clear();
+}
+
+size_t ContentHashIndex::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hash_by_id_.size();
+}
+
+} // namespace dpan
@@ -0,0 +1,80 @@
+// File: src/discovery/content_hash_index.hpp
+#pragma once
+
+#include "core/input_view.hpp"
+#include "core/pattern_data.hpp"
+#include "storage/pattern_database.hpp"
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace dpan {
+
+/// ContentHashIndex - Maps encoded pattern content to pattern IDs
+///
+/// Lets the matcher resolve an exact repeat of stored data without any
+/// similarity computation. Keys are PatternData::ContentHash() values; since
+/// several patterns may hold identical data and hashes may collide, every
+/// key maps to a list of IDs and callers confirm a hit against the stored
+/// data.
+///
+/// Extracted features are lossy (e.g. text windows are reduced to character
+/// frequencies), so different inputs can encode to identical data. Callers
+/// that know the raw bytes a pattern came from pass SourceHash(bytes) along
+/// with the data; such entries are then only found by a repeat of the same
+/// source. Entries indexed without a source (including everything loaded by
+/// Rebuild) are keyed on the data alone.
+///
+/// The index is kept in step by the components that create, update and
+/// delete patterns. Entries may go stale through writes that bypass them,
+/// so a failed confirmation should be reported back through Add or Remove.
+///
+/// Thread-safety: All methods are thread-safe.
+class ContentHashIndex {
+public:
+    /// Hash of the raw bytes a pattern was extracted from
+    static uint64_t SourceHash(const std::vector<uint8_t>& bytes);
+
+    /// Hash of the payload bytes behind a typed input view; equals
+    /// SourceHash(bytes) for a view of the same bytes
+    static uint64_t SourceHash(const InputView& input);
+
+    /// Index key of a pattern's data
+    /// @param data Encoded pattern data
+    /// @param source_hash SourceHash() of the raw input, or 0 for data only
+    static uint64_t KeyOf(const PatternData& data, uint64_t source_hash = 0);
+
+    /// Index a pattern's data, replacing any previous entry for the ID
+    /// @param id Pattern ID
+    /// @param data Encoded pattern data
+    /// @param source_hash SourceHash() of the raw input, or 0 for data only
+    void Add(PatternID id, const PatternData& data, uint64_t source_hash = 0);
+
+    /// Drop a pattern
+    /// @return true if the pattern was indexed
+    bool Remove(PatternID id);
+
+    /// Patterns indexed under the same key as the given data
+    /// @param data Encoded pattern data
+    /// @param source_hash SourceHash() of the raw input, or 0 for data only
+    std::vector<PatternID> Lookup(const PatternData& data, uint64_t source_hash = 0) const;
+
+    /// Re-index every pattern in a database
+    void Rebuild(PatternDatabase& database);
+
+    /// Remove all entries
+    void Clear();
+
+    /// Number of indexed patterns
+    size_t Size() const;
+
+private:
+    void RemoveUnlocked(PatternID id);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, std::vector<PatternID>> ids_by_hash_;
+    std::unordered_map<PatternID, uint64_t> hash_by_id_;
+};
+
+} // namespace dpan
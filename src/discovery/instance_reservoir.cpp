@@ -0,0 +1,143 @@
+// File: src/discovery/instance_reservoir.cpp
+#include "discovery/instance_reservoir.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace dpan {
+
+namespace {
+
+uint64_t SplitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+} // anonymous namespace
+
+InstanceReservoir::InstanceReservoir(const Config& config) : config_(config) {
+    if (config_.capacity == 0) {
+        throw std::invalid_argument("capacity must be greater than 0");
+    }
+}
+
+bool InstanceReservoir::Add(PatternID id, const FeatureVector& instance) {
+    const size_t dim = instance.Dimension();
+    if (dim == 0) {
+        return false;
+    }
+    const float* values = instance.Data().data();
+    for (size_t d = 0; d < dim; ++d) {
+        if (!std::isfinite(values[d])) {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = entries_.try_emplace(id);
+    Entry& entry = it->second;
+    if (inserted) {
+        entry.dimension = dim;
+        entry.rng_state = config_.seed ^ (id.value() * 0xD1B54A32D192ED03ULL);
+        entry.samples.reserve(config_.capacity * dim);
+        entry.mean.assign(dim, 0.0);
+        bytes_ += FootprintOf(entry);
+    } else if (entry.dimension != dim) {
+        return false;
+    }
+
+    // Welford: squared deviation grows by (x - old mean) . (x - new mean)
+    ++entry.seen;
+    const double inv_count = 1.0 / static_cast<double>(entry.seen);
+    double deviation = 0.0;
+    for (size_t d = 0; d < dim; ++d) {
+        const double x = values[d];
+        const double before = x - entry.mean[d];
+        entry.mean[d] += before * inv_count;
+        deviation += before * (x - entry.mean[d]);
+    }
+    entry.squared_deviation += deviation;
+
+    // Algorithm R: the k-th instance replaces a random slot with
+    // probability capacity / k
+    if (entry.seen <= config_.capacity) {
+        const size_t reserved = entry.samples.capacity();
+        entry.samples.insert(entry.samples.end(), values, values + dim);
+        bytes_ += (entry.samples.capacity() - reserved) * sizeof(float);
+        return true;
+    }
+    const size_t slot = static_cast<size_t>(SplitMix64(entry.rng_state) % entry.seen);
+    if (slot < config_.capacity) {
+        std::copy(values, values + dim,
+                  entry.samples.begin() + static_cast<std::ptrdiff_t>(slot * dim));
+    }
+    return true;
+}
+
+std::vector<FeatureVector> InstanceReservoir::GetInstances(PatternID id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return {};
+    }
+
+    const Entry& entry = it->second;
+    std::vector<FeatureVector> instances;
+    instances.reserve(entry.samples.size() / entry.dimension);
+    for (size_t offset = 0; offset < entry.samples.size(); offset += entry.dimension) {
+        instances.emplace_back(std::vector<float>(
+            entry.samples.begin() + static_cast<std::ptrdiff_t>(offset),
+            entry.samples.begin() + static_cast<std::ptrdiff_t>(offset + entry.dimension)));
+    }
+    return instances;
+}
+
+std::optional<InstanceReservoir::Summary> InstanceReservoir::GetSummary(PatternID id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+
+    const Entry& entry = it->second;
+    Summary summary;
+    summary.count = entry.seen;
+    summary.mean.assign(entry.mean.begin(), entry.mean.end());
+    summary.variance = static_cast<float>(
+        std::max(0.0, entry.squared_deviation) / static_cast<double>(entry.seen));
+    return summary;
+}
+
+void InstanceReservoir::Remove(PatternID id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it != entries_.end()) {
+        bytes_ -= FootprintOf(it->second);
+        entries_.erase(it);
+    }
+}
+
+void InstanceReservoir::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    bytes_ = 0;
+}
+
+size_t InstanceReservoir::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t InstanceReservoir::GetMemoryBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+size_t InstanceReservoir::FootprintOf(const Entry& entry) {
+    return sizeof(Entry) + entry.samples.capacity() * sizeof(float) +
+           entry.mean.capacity() * sizeof(double);
+}
+
+} // namespace dpan
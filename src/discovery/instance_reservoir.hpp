@@ -0,0 +1,103 @@
+// File: src/discovery/instance_reservoir.hpp
+#pragma once
+
+#include "core/types.hpp"
+#include "core/pattern_data.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace dpan {
+
+/// InstanceReservoir - Bounded sample of the instances each pattern matched
+///
+/// Splitting a pattern needs the inputs it has absorbed, which patterns do
+/// not retain. This side store keeps, per pattern:
+/// - a uniform reservoir sample (Algorithm R) of at most capacity feature
+///   vectors, stored in one flat buffer sized on the pattern's first
+///   instance, and
+/// - running sufficient statistics of every instance seen (count, mean and
+///   total squared deviation, Welford's update), so centroids and variance
+///   cover the whole stream, not only the sample.
+///
+/// Memory per pattern is capacity x dimension floats plus dimension doubles,
+/// however many instances arrive. After a pattern's first instance, Add
+/// does not allocate. Sampling is deterministic for a given seed, pattern
+/// and instance sequence.
+///
+/// Thread-safety: All methods are thread-safe.
+class InstanceReservoir {
+public:
+    /// Configuration for instance sampling
+    struct Config {
+        /// Instances sampled per pattern
+        size_t capacity{16};
+
+        /// Seed of the per-pattern sampling streams
+        uint64_t seed{0x9E3779B97F4A7C15ULL};
+    };
+
+    /// Statistics of every instance recorded for a pattern
+    struct Summary {
+        uint64_t count{0};          ///< Instances recorded
+        std::vector<float> mean;    ///< Mean instance
+        float variance{0.0f};       ///< Mean squared distance from the mean
+    };
+
+    /// Constructor
+    /// @param config Sampling configuration
+    /// @throws std::invalid_argument if capacity is 0
+    explicit InstanceReservoir(const Config& config);
+
+    /// Record an instance matched by a pattern
+    /// @param id Pattern that matched
+    /// @param instance Features of the matched input
+    /// @return false if the instance is empty, has non-finite values or a
+    ///         dimension different from the pattern's earlier instances
+    bool Add(PatternID id, const FeatureVector& instance);
+
+    /// Sampled instances of a pattern (at most capacity, in no particular order)
+    std::vector<FeatureVector> GetInstances(PatternID id) const;
+
+    /// Statistics of all recorded instances, or nullopt if none
+    std::optional<Summary> GetSummary(PatternID id) const;
+
+    /// Forget a pattern's instances
+    void Remove(PatternID id);
+
+    /// Forget all instances
+    void Clear();
+
+    /// Number of patterns with recorded instances
+    size_t Size() const;
+
+    /// Heap bytes held by sample buffers and statistics (kept as a running
+    /// total, so this does not walk the entries)
+    size_t GetMemoryBytes() const;
+
+    /// Get configuration
+    const Config& GetConfig() const { return config_; }
+
+private:
+    struct Entry {
+        size_t dimension{0};
+        uint64_t seen{0};
+        uint64_t rng_state{0};
+        std::vector<float> samples;   // Sampled instances, row-major
+        std::vector<double> mean;
+        double squared_deviation{0.0};
+    };
+
+    /// Bytes an entry accounts for in GetMemoryBytes()
+    static size_t FootprintOf(const Entry& entry);
+
+    Config config_;
+    mutable std::mutex mutex_;
+    std::unordered_map<PatternID, Entry> entries_;
+    size_t bytes_{0};  ///< Sum of FootprintOf over entries_
+};
+
+} // namespace dpan
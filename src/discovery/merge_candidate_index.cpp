@@ -0,0 +1,234 @@
+// File: src/discovery/merge_candidate_index.cpp
+#include "discovery/merge_candidate_index.hpp"
+#include "similarity/kmeans_clusterer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace dpan {
+
+MergeCandidateIndex::MergeCandidateIndex(const Config& config)
+    : config_(config) {
+    if (config_.num_projections == 0) {
+        throw std::invalid_argument("num_projections must be greater than 0");
+    }
+}
+
+MergeCandidateIndex::Slabs& MergeCandidateIndex::SlabsFor(size_t dimension) {
+    auto it = slabs_.find(dimension);
+    if (it != slabs_.end()) {
+        return it->second;
+    }
+
+    Slabs slabs;
+    slabs.directions.resize(config_.num_projections * dimension);
+    slabs.ordered.resize(config_.num_projections);
+
+    std::mt19937_64 rng(config_.seed ^ (dimension * 0x9E3779B97F4A7C15ULL));
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    for (size_t p = 0; p < config_.num_projections; ++p) {
+        float* row = slabs.directions.data() + p * dimension;
+        double norm = 0.0;
+        for (size_t d = 0; d < dimension; ++d) {
+            row[d] = dist(rng);
+            norm += static_cast<double>(row[d]) * row[d];
+        }
+        const float scale = norm > 0.0 ? static_cast<float>(1.0 / std::sqrt(norm)) : 0.0f;
+        for (size_t d = 0; d < dimension; ++d) {
+            row[d] *= scale;
+        }
+    }
+    return slabs_.emplace(dimension, std::move(slabs)).first->second;
+}
+
+void MergeCandidateIndex::Upsert(PatternID id, PatternType type, const FeatureVector& features) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    UpsertUnlocked(id, type, features);
+}
+
+void MergeCandidateIndex::UpsertUnlocked(PatternID id, PatternType type,
+                                         const FeatureVector& features) {
+    RemoveUnlocked(id);
+
+    // Non-finite values have no place in the orderings (and no neighbors)
+    const size_t dim = features.Dimension();
+    for (size_t d = 0; d < dim; ++d) {
+        if (!std::isfinite(features[d])) {
+            return;
+        }
+    }
+    Slabs& slabs = SlabsFor(dim);
+
+    Entry entry;
+    entry.type = type;
+    entry.features.assign(features.Data().begin(), features.Data().end());
+    entry.projections.resize(config_.num_projections);
+    for (size_t p = 0; p < config_.num_projections; ++p) {
+        const float* row = slabs.directions.data() + p * dim;
+        float projection = 0.0f;
+        for (size_t d = 0; d < dim; ++d) {
+            projection += row[d] * entry.features[d];
+        }
+        entry.projections[p] = projection;
+        slabs.ordered[p].emplace(projection, id);
+    }
+    entries_.emplace(id, std::move(entry));
+}
+
+bool MergeCandidateIndex::Remove(PatternID id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool indexed = entries_.count(id) > 0;
+    RemoveUnlocked(id);
+    return indexed;
+}
+
+void MergeCandidateIndex::RemoveUnlocked(PatternID id) {
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return;
+    }
+
+    Slabs& slabs = slabs_.at(it->second.features.size());
+    for (size_t p = 0; p < config_.num_projections; ++p) {
+        auto range = slabs.ordered[p].equal_range(it->second.projections[p]);
+        for (auto node = range.first; node != range.second; ++node) {
+            if (node->second == id) {
+                slabs.ordered[p].erase(node);
+                break;
+            }
+        }
+    }
+    entries_.erase(it);
+}
+
+bool MergeCandidateIndex::Contains(PatternID id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.count(id) > 0;
+}
+
+std::vector<MergeCandidateIndex::Neighbor> MergeCandidateIndex::Neighbors(
+        PatternID id, size_t k, float min_similarity) const {
+    std::vector<Neighbor> neighbors;
+    if (k == 0) {
+        return neighbors;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto query_it = entries_.find(id);
+    if (query_it == entries_.end()) {
+        return neighbors;
+    }
+    const Entry& query = query_it->second;
+    const size_t dim = query.features.size();
+    const Slabs& slabs = slabs_.at(dim);
+
+    // Radius of the similarity threshold, widened slightly so float
+    // rounding in the projections cannot exclude a boundary pattern
+    float radius = std::numeric_limits<float>::infinity();
+    if (min_similarity > 0.0f) {
+        radius = (1.0f / min_similarity - 1.0f) * 1.0001f + 1e-6f;
+    }
+
+    // Walk the thinnest slab; counting stops once it exceeds the best so far
+    size_t best = 0;
+    size_t best_count = std::numeric_limits<size_t>::max();
+    for (size_t p = 0; p < config_.num_projections && std::isfinite(radius); ++p) {
+        const auto& ordered = slabs.ordered[p];
+        auto node = ordered.lower_bound(query.projections[p] - radius);
+        auto end = ordered.upper_bound(query.projections[p] + radius);
+        size_t count = 0;
+        for (; node != end && count < best_count; ++node) {
+            ++count;
+        }
+        if (count < best_count) {
+            best = p;
+            best_count = count;
+        }
+    }
+
+    const auto& ordered = slabs.ordered[best];
+    auto node = std::isfinite(radius) ? ordered.lower_bound(query.projections[best] - radius)
+                                      : ordered.begin();
+    auto end = std::isfinite(radius) ? ordered.upper_bound(query.projections[best] + radius)
+                                     : ordered.end();
+    for (; node != end; ++node) {
+        const PatternID candidate = node->second;
+        if (candidate == id) {
+            continue;
+        }
+        const Entry& entry = entries_.at(candidate);
+        if (entry.type != query.type) {
+            continue;
+        }
+
+        float distance = std::sqrt(SquaredEuclideanDistance(
+            query.features.data(), entry.features.data(), dim));
+        float similarity = 1.0f / (1.0f + distance);
+        if (similarity >= min_similarity) {
+            neighbors.push_back({candidate, similarity});
+        }
+    }
+
+    std::sort(neighbors.begin(), neighbors.end(), [](const Neighbor& a, const Neighbor& b) {
+        return a.similarity != b.similarity ? a.similarity > b.similarity : a.id < b.id;
+    });
+    if (neighbors.size() > k) {
+        neighbors.resize(k);
+    }
+    return neighbors;
+}
+
+std::vector<PatternID> MergeCandidateIndex::Rebuild(PatternDatabase& database) {
+    QueryOptions unbounded;
+    unbounded.max_results = std::numeric_limits<size_t>::max();
+    auto ids = database.FindAll(unbounded);
+
+    std::vector<PatternID> indexed;
+    indexed.reserve(ids.size());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    slabs_.clear();
+    entries_.clear();
+    for (PatternID id : ids) {
+        if (auto node = database.Retrieve(id)) {
+            UpsertUnlocked(id, node->GetType(), node->GetData().GetFeatures());
+            if (entries_.count(id) > 0) {
+                indexed.push_back(id);
+            }
+        }
+    }
+    return indexed;
+}
+
+void MergeCandidateIndex::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slabs_.clear();
+    entries_.clear();
+}
+
+size_t MergeCandidateIndex::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t MergeCandidateIndex::GetMemoryBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Ordered-map nodes: key, value and three tree links plus color
+    constexpr size_t kNodeBytes = sizeof(float) + sizeof(PatternID) + 4 * sizeof(void*);
+
+    size_t bytes = 0;
+    for (const auto& [dimension, slabs] : slabs_) {
+        bytes += slabs.directions.capacity() * sizeof(float);
+    }
+    for (const auto& [id, entry] : entries_) {
+        bytes += sizeof(Entry) + sizeof(PatternID) +
+                 (entry.features.capacity() + entry.projections.capacity()) * sizeof(float) +
+                 config_.num_projections * kNodeBytes;
+    }
+    return bytes;
+}
+
+} // namespace dpan
@@ -0,0 +1,124 @@
+// File: src/discovery/merge_candidate_index.hpp
+#pragma once
+
+#include "core/pattern_node.hpp"
+#include "storage/pattern_database.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace dpan {
+
+/// MergeCandidateIndex - Nearest stored patterns by Euclidean distance
+///
+/// Generates merge candidates without comparing every pair of patterns.
+/// Merging compares similarity 1 / (1 + distance) with a threshold (see
+/// PatternRefiner::ShouldMerge), so the neighbors worth checking lie within
+/// radius 1 / threshold - 1 of a pattern.
+///
+/// Each pattern's features are projected onto num_projections fixed random
+/// unit directions, and every direction keeps the patterns ordered by
+/// projection. Projection onto a unit vector never increases distance, so
+/// every pattern within the radius lies in the slab [p - radius, p + radius]
+/// around the query's projection p on every direction. A query walks the
+/// thinnest of those slabs and measures exact distances only there: the
+/// result is exact, and its cost follows the number of patterns near the
+/// query rather than the total. Directions are drawn per feature dimension
+/// from the seed.
+///
+/// Memory per pattern is its features, num_projections floats and one
+/// ordered-map node per direction. Queries decode nothing and do not touch
+/// the database.
+///
+/// Thread-safety: All methods are thread-safe.
+class MergeCandidateIndex {
+public:
+    /// Configuration for the index
+    struct Config {
+        /// Random directions patterns are ordered along (>= 1)
+        size_t num_projections{4};
+
+        /// Seed of the directions
+        uint64_t seed{0x5EED5EEDULL};
+    };
+
+    /// Indexed pattern near a query pattern
+    struct Neighbor {
+        PatternID id;
+        float similarity{0.0f};  ///< 1 / (1 + Euclidean distance)
+    };
+
+    /// Constructor
+    /// @param config Index configuration
+    /// @throws std::invalid_argument if num_projections is 0
+    explicit MergeCandidateIndex(const Config& config);
+
+    /// Index a pattern, replacing any previous entry for its ID
+    ///
+    /// Patterns with non-finite features are dropped instead.
+    /// @param id Pattern ID
+    /// @param type Pattern type (only patterns of equal type are neighbors)
+    /// @param features Decoded features
+    void Upsert(PatternID id, PatternType type, const FeatureVector& features);
+
+    /// Drop a pattern
+    /// @return true if the pattern was indexed
+    bool Remove(PatternID id);
+
+    /// Check whether a pattern is indexed
+    bool Contains(PatternID id) const;
+
+    /// Nearest indexed patterns to an indexed pattern
+    ///
+    /// Only patterns of the same type and feature dimension are neighbors.
+    /// With min_similarity <= 0 every such pattern is measured.
+    ///
+    /// @param id Query pattern (excluded from the result)
+    /// @param k Maximum number of neighbors
+    /// @param min_similarity Drop neighbors below this similarity
+    /// @return Up to k neighbors, most similar first (empty if id is not indexed)
+    std::vector<Neighbor> Neighbors(PatternID id, size_t k, float min_similarity) const;
+
+    /// Re-index every pattern in a database
+    /// @return IDs of the indexed patterns
+    std::vector<PatternID> Rebuild(PatternDatabase& database);
+
+    /// Remove all entries
+    void Clear();
+
+    /// Number of indexed patterns
+    size_t Size() const;
+
+    /// Heap bytes held by features and orderings (approximate)
+    size_t GetMemoryBytes() const;
+
+    /// Get configuration
+    const Config& GetConfig() const { return config_; }
+
+private:
+    struct Entry {
+        PatternType type{PatternType::ATOMIC};
+        std::vector<float> features;
+        std::vector<float> projections;  ///< One per direction
+    };
+
+    /// Directions and orderings of the patterns of one feature dimension
+    struct Slabs {
+        std::vector<float> directions;   ///< num_projections x dimension, unit rows
+        std::vector<std::multimap<float, PatternID>> ordered;
+    };
+
+    Slabs& SlabsFor(size_t dimension);
+    void UpsertUnlocked(PatternID id, PatternType type, const FeatureVector& features);
+    void RemoveUnlocked(PatternID id);
+
+    Config config_;
+    mutable std::mutex mutex_;
+    std::unordered_map<size_t, Slabs> slabs_;
+    std::unordered_map<PatternID, Entry> entries_;
+};
+
+} // namespace dpan
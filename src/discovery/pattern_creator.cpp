@@ -2,6 +2,7 @@
 #include "pattern_creator.hpp"
 #include <stdexcept>
 #include <algorithm>
+#include <limits>
 
 namespace dpan {
 
@@ -43,9 +44,61 @@ PatternID PatternCreator::CreatePattern(
         throw std::runtime_error("Failed to store pattern in database");
     }
 
+    if (content_index_) {
+        content_index_->Add(new_id, node.GetData());
+    }
+
     return new_id;
 }
 
+std::vector<PatternID> PatternCreator::CreatePatternsBatch(
+    const std::vector<PatternData>& data,
+    const std::vector<float>& initial_confidences,
+    PatternType type) {
+
+    if (data.size() != initial_confidences.size()) {
+        throw std::invalid_argument("CreatePatternsBatch requires one confidence per pattern");
+    }
+    for (float confidence : initial_confidences) {
+        if (confidence < 0.0f || confidence > 1.0f) {
+            throw std::invalid_argument("initial_confidence must be in range [0.0, 1.0]");
+        }
+    }
+    if (data.empty()) {
+        return {};
+    }
+
+    // One ID scan for the whole batch
+    uint64_t next_id = GeneratePatternID().value();
+
+    std::vector<PatternNode> nodes;
+    std::vector<PatternID> ids;
+    nodes.reserve(data.size());
+    ids.reserve(data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        PatternID id(next_id++);
+        PatternNode node(id, data[i], type);
+        node.SetActivationThreshold(default_activation_threshold_);
+        node.SetConfidenceScore(initial_confidences[i]);
+        InitializeStatistics(node);
+
+        nodes.push_back(std::move(node));
+        ids.push_back(id);
+    }
+
+    if (database_->StoreBatch(nodes) != nodes.size()) {
+        throw std::runtime_error("Failed to store pattern batch in database");
+    }
+
+    if (content_index_) {
+        for (size_t i = 0; i < ids.size(); ++i) {
+            content_index_->Add(ids[i], data[i]);
+        }
+    }
+
+    return ids;
+}
+
 PatternID PatternCreator::CreateCompositePattern(
     const std::vector<PatternID>& sub_patterns,
     const PatternData& composite_data) {
@@ -84,6 +137,10 @@ PatternID PatternCreator::CreateCompositePattern(
         throw std::runtime_error("Failed to store composite pattern in database");
     }
 
+    if (content_index_) {
+        content_index_->Add(composite_id, node.GetData());
+    }
+
     return composite_id;
 }
 
@@ -125,6 +182,10 @@ PatternID PatternCreator::CreateMetaPattern(
         throw std::runtime_error("Failed to store meta-pattern in database");
     }
 
+    if (content_index_) {
+        content_index_->Add(meta_id, node.GetData());
+    }
+
     return meta_id;
 }
 
@@ -154,8 +215,10 @@ void PatternCreator::InitializeStatistics(PatternNode& node) {
 }
 
 PatternID PatternCreator::GeneratePatternID() {
-    // Get all existing pattern IDs
-    auto all_ids = database_->FindAll();
+    // Get all existing pattern IDs (the default query stops at 100)
+    QueryOptions options;
+    options.max_results = std::numeric_limits<size_t>::max();
+    auto all_ids = database_->FindAll(options);
 
     if (all_ids.empty()) {
         return PatternID(1);  // Start from 1
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "core/pattern_node.hpp"
+#include "discovery/content_hash_index.hpp"
 #include "storage/pattern_database.hpp"
 #include <memory>
 #include <vector>
@@ -29,6 +30,19 @@ public:
         float initial_confidence = 0.5f
     );
 
+    /// Create several atomic patterns with a single StoreBatch
+    /// @param data Pattern data, one entry per pattern
+    /// @param initial_confidences Initial confidence per pattern [0, 1]
+    /// @param type Pattern type (default: ATOMIC)
+    /// @return Created pattern IDs (consecutive, in input order)
+    /// @throws std::invalid_argument if the sizes differ or a confidence is out of range
+    /// @throws std::runtime_error if the batch could not be stored
+    std::vector<PatternID> CreatePatternsBatch(
+        const std::vector<PatternData>& data,
+        const std::vector<float>& initial_confidences,
+        PatternType type = PatternType::ATOMIC
+    );
+
     /// Create a composite pattern from sub-patterns
     /// @param sub_patterns IDs of sub-patterns that compose this pattern
     /// @param composite_data Data representing the composite pattern
@@ -55,6 +69,9 @@ public:
     /// @param confidence Initial confidence [0, 1]
     void SetInitialConfidence(float confidence);
 
+    /// Register created patterns in a content hash index (null to stop)
+    void SetContentIndex(std::shared_ptr<ContentHashIndex> index) { content_index_ = std::move(index); }
+
     /// Get default activation threshold
     float GetInitialActivationThreshold() const { return default_activation_threshold_; }
 
@@ -63,6 +80,7 @@ public:
 
 private:
     std::shared_ptr<PatternDatabase> database_;
+    std::shared_ptr<ContentHashIndex> content_index_;
     float default_activation_threshold_{0.5f};
     float default_initial_confidence_{0.5f};
 
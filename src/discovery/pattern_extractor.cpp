@@ -1,13 +1,228 @@
 // File: src/discovery/pattern_extractor.cpp
 #include "pattern_extractor.hpp"
+#include "discovery/spectral_extractor.hpp"
+#include "discovery/tile_extractor.hpp"
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstring>
+#include <deque>
+#include <iterator>
 #include <numeric>
 #include <stdexcept>
 
 namespace dpan {
 
+namespace {
+
+/// Sum of term(i) over i in [k * stride, k * stride + length) for every
+/// window k. The running sum is sampled at window starts and ends, so each
+/// term is evaluated once however much the windows overlap.
+template <typename Term>
+void SlidingSums(size_t windows, size_t stride, size_t length, Term term,
+                 std::vector<double>& out) {
+    out.assign(windows, 0.0);
+    std::vector<double> at_start(windows, 0.0);
+    double cumulative = 0.0;
+    size_t position = 0;
+
+    auto advance = [&](size_t to) {
+        // Independent partial sums keep the adds from serializing
+        double partial[4] = {0.0, 0.0, 0.0, 0.0};
+        for (; position + 4 <= to; position += 4) {
+            partial[0] += term(position);
+            partial[1] += term(position + 1);
+            partial[2] += term(position + 2);
+            partial[3] += term(position + 3);
+        }
+        for (; position < to; ++position) {
+            partial[0] += term(position);
+        }
+        cumulative += (partial[0] + partial[1]) + (partial[2] + partial[3]);
+    };
+
+    size_t next_start = 0;
+    for (size_t k = 0; k < windows; ++k) {
+        const size_t end = k * stride + length;
+        while (next_start < windows && next_start * stride <= end) {
+            advance(next_start * stride);
+            at_start[next_start++] = cumulative;
+        }
+        advance(end);
+        out[k] = cumulative - at_start[k];
+    }
+}
+
+/// k-th smallest (0-based) value in the union of sorted runs
+float KthOfRuns(const std::vector<std::pair<const float*, const float*>>& runs, size_t k) {
+    auto count_not_greater = [&runs](float value) {
+        size_t total = 0;
+        for (const auto& run : runs) {
+            total += static_cast<size_t>(std::upper_bound(run.first, run.second, value) - run.first);
+        }
+        return total;
+    };
+
+    // The answer is, in the run that holds it, the first element with more
+    // than k values at or below it; other runs can only offer larger ones
+    float best = 0.0f;
+    bool found = false;
+    for (const auto& run : runs) {
+        const float* lo = run.first;
+        const float* hi = run.second;
+        while (lo < hi) {
+            const float* mid = lo + (hi - lo) / 2;
+            if (count_not_greater(*mid) > k) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        if (lo != run.second && (!found || *lo < best)) {
+            best = *lo;
+            found = true;
+        }
+    }
+    return best;
+}
+
+uint64_t MixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/// Map a well-spread key to [0, dimension): Fibonacci hashing followed by
+/// a multiply-shift range reduction instead of a division
+uint32_t HashBucket(uint64_t key, size_t dimension) {
+    return static_cast<uint32_t>((((key * 0x9e3779b97f4a7c15ULL) >> 32) * dimension) >> 32);
+}
+
+/// Word bytes: ASCII letters and digits, and any non-ASCII byte
+constexpr std::array<bool, 256> MakeWordByteTable() {
+    std::array<bool, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        table[c] = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                   (c >= '0' && c <= '9') || c >= 0x80;
+    }
+    return table;
+}
+constexpr std::array<bool, 256> kWordBytes = MakeWordByteTable();
+
+/// Hash of a word's case-folded bytes, folded in 8 bytes at a time
+class WordHasher {
+public:
+    void Add(uint8_t c) {
+        c = static_cast<uint8_t>(c | (static_cast<uint8_t>(c - 'A') < 26 ? 0x20 : 0));
+        packed_ |= static_cast<uint64_t>(c) << shift_;
+        shift_ += 8;
+        ++length_;
+        if (shift_ == 64) {
+            hash_ = MixHash(hash_ ^ packed_);
+            packed_ = 0;
+            shift_ = 0;
+        }
+    }
+
+    uint64_t Finish() const { return MixHash(hash_ ^ packed_ ^ (length_ << 56)); }
+
+private:
+    uint64_t hash_{0xcbf29ce484222325ULL};
+    uint64_t packed_{0};
+    uint64_t length_{0};
+    unsigned shift_{0};
+};
+
+uint64_t WordHash(const uint8_t* bytes, size_t start, size_t end) {
+    WordHasher hasher;
+    for (size_t i = start; i < end; ++i) {
+        hasher.Add(bytes[i]);
+    }
+    return hasher.Finish();
+}
+
+/// Bucket of a word n-gram given its word hashes in order
+template <typename HashAt>
+uint32_t WordNGramBucket(size_t n, HashAt hash_at, size_t dimension) {
+    uint64_t h = 0x632be59bd9b4e019ULL;
+    for (size_t w = 0; w < n; ++w) {
+        h = MixHash(h + hash_at(w));
+    }
+    return HashBucket(h, dimension);
+}
+
+/// Rolling hash of the last n bytes shifted in. Up to 8 bytes are packed
+/// into the key itself; longer n-grams use a polynomial hash.
+class RollingNGramHash {
+public:
+    explicit RollingNGramHash(size_t n)
+        : n_(n),
+          packed_(n <= 8),
+          mask_(n >= 8 ? ~0ULL : (1ULL << (8 * n)) - 1) {
+        for (size_t i = 1; i < n; ++i) {
+            leading_power_ *= kBase;
+        }
+    }
+
+    /// Shift in bytes[position]; afterwards Key() covers
+    /// bytes[position - n + 1 .. position]
+    void Push(const uint8_t* bytes, size_t position) {
+        if (packed_) {
+            key_ = ((key_ << 8) | bytes[position]) & mask_;
+        } else {
+            if (position >= n_) {
+                key_ -= (bytes[position - n_] + 1ULL) * leading_power_;
+            }
+            key_ = key_ * kBase + bytes[position] + 1;
+        }
+    }
+
+    uint64_t Key() const { return key_ + n_; }
+
+private:
+    static constexpr uint64_t kBase = 0x100000001b3ULL;
+    size_t n_;
+    bool packed_;
+    uint64_t mask_;
+    uint64_t leading_power_{1};
+    uint64_t key_{0};
+};
+
+/// Spectral front end for AUDIO windows of window_size samples. Each thread
+/// keeps the last one it built and rebuilds it only when the settings
+/// change, so chunks and streamed windows reuse FFT tables and buffers.
+SpectralExtractor& ThreadSpectralExtractor(const PatternExtractor::Config& config,
+                                           size_t window_size) {
+    SpectralExtractor::Config spectral;
+    spectral.sample_rate = config.audio_sample_rate;
+    spectral.frame_size = window_size;
+    spectral.mel_bands = config.audio_mel_bands;
+    spectral.log_compress = true;
+    spectral.mfcc_coefficients =
+        config.audio_features == PatternExtractor::AudioFeatures::MFCC ?
+        config.audio_mfcc_coefficients : 0;
+    spectral.feature_dimension = config.feature_dimension;
+
+    thread_local std::unique_ptr<SpectralExtractor> cached;
+    if (cached) {
+        const SpectralExtractor::Config& current = cached->GetConfig();
+        if (current.sample_rate == spectral.sample_rate &&
+            current.frame_size == spectral.frame_size &&
+            current.mel_bands == spectral.mel_bands &&
+            current.mfcc_coefficients == spectral.mfcc_coefficients &&
+            current.feature_dimension == spectral.feature_dimension) {
+            return *cached;
+        }
+    }
+    cached = std::make_unique<SpectralExtractor>(spectral);
+    return *cached;
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // PatternExtractor Implementation
 // ============================================================================
@@ -22,27 +237,75 @@ PatternExtractor::PatternExtractor(const Config& config) : config_(config) {
     if (config_.feature_dimension == 0) {
         throw std::invalid_argument("feature_dimension must be greater than 0");
     }
+    if (config_.text_features == TextFeatures::HASHED_NGRAMS &&
+        config_.char_ngram_size == 0 && config_.word_ngram_size == 0) {
+        throw std::invalid_argument("HASHED_NGRAMS needs a character or word n-gram size");
+    }
+    if (config_.audio_features != AudioFeatures::STATISTICAL) {
+        if (!(config_.audio_sample_rate > 0.0)) {
+            throw std::invalid_argument("audio_sample_rate must be positive");
+        }
+        if (config_.audio_mel_bands == 0) {
+            throw std::invalid_argument("audio_mel_bands must be greater than 0");
+        }
+        if (config_.audio_features == AudioFeatures::MFCC &&
+            (config_.audio_mfcc_coefficients == 0 ||
+             config_.audio_mfcc_coefficients > config_.audio_mel_bands)) {
+            throw std::invalid_argument("audio_mfcc_coefficients must be in [1, audio_mel_bands]");
+        }
+    }
+    if (config_.window_selection == WindowSelection::CHANGE_POINTS) {
+        ChangePointDetector validate(config_.change_points);  // Throws if invalid
+    }
 }
 
 std::vector<PatternData> PatternExtractor::Extract(const std::vector<uint8_t>& raw_input) const {
-    if (raw_input.empty()) {
+    return Extract(InputView::Bytes(raw_input.data(), raw_input.size(), config_.modality));
+}
+
+std::vector<PatternData> PatternExtractor::Extract(const InputView& input) const {
+    if (input.Empty() || input.data == nullptr) {
         return {};
     }
 
-    if (raw_input.size() < config_.min_pattern_size) {
+    switch (input.type) {
+        case SampleType::FLOAT32:
+            // Windows read the caller's samples in place
+            return ExtractSamples(static_cast<const float*>(input.data), input.count,
+                                  input.modality);
+
+        case SampleType::PCM16: {
+            const auto* pcm = static_cast<const int16_t*>(input.data);
+            std::vector<float> samples(input.count);
+            for (size_t i = 0; i < input.count; ++i) {
+                samples[i] = static_cast<float>(pcm[i]) * (1.0f / 32768.0f);
+            }
+            return ExtractSamples(samples.data(), samples.size(), input.modality);
+        }
+
+        case SampleType::IMAGE_U8:
+            return ExtractTiles(input);
+
+        case SampleType::BYTES:
+            break;
+    }
+
+    const auto* raw_input = static_cast<const uint8_t*>(input.data);
+    const size_t size = input.count;
+    if (size < config_.min_pattern_size) {
         return {};
     }
 
-    // Route to modality-specific extraction
+    // Raw bytes: route on the configured modality
     switch (config_.modality) {
         case DataModality::NUMERIC:
-            return ExtractNumeric(raw_input);
+            return ExtractNumeric(raw_input, size);
         case DataModality::IMAGE:
-            return ExtractImage(raw_input);
+            return ExtractImage(raw_input, size);
         case DataModality::AUDIO:
-            return ExtractAudio(raw_input);
+            return ExtractAudio(raw_input, size);
         case DataModality::TEXT:
-            return ExtractText(raw_input);
+            return ExtractText(raw_input, size);
         default:
             throw std::runtime_error("Unsupported modality");
     }
@@ -126,15 +389,70 @@ PatternData PatternExtractor::Abstract(const PatternData& pattern) const {
     return PatternData::FromFeatures(features, pattern.GetModality());
 }
 
+std::optional<PatternData> PatternExtractor::ExtractWindow(const float* samples,
+                                                          size_t count) const {
+    if (config_.modality == DataModality::AUDIO &&
+        config_.audio_features != AudioFeatures::STATISTICAL) {
+        auto patterns = ExtractSpectralRun(samples, count, count, 0);
+        if (patterns.empty()) {
+            return std::nullopt;
+        }
+        return std::move(patterns.front());
+    }
+
+    FeatureVector features = ComputeStatisticalFeatures(samples, count);
+
+    if (config_.modality == DataModality::NUMERIC || config_.modality == DataModality::AUDIO) {
+        // Filter by energy (noise detection)
+        if (ComputeEnergy(samples, count) <= config_.noise_threshold) {
+            return std::nullopt;
+        }
+    }
+
+    return PatternData::FromFeatures(features, config_.modality);
+}
+
+PatternData PatternExtractor::ExtractTextWindow(const uint8_t* bytes, size_t count) const {
+    if (config_.text_features == TextFeatures::HASHED_NGRAMS) {
+        return ExtractHashedTextRun(bytes, count, count, 0).front();
+    }
+
+    // Compute text features (character frequency, etc.)
+    std::vector<float> char_freq(256, 0.0f);
+    for (size_t i = 0; i < count; ++i) {
+        char_freq[bytes[i]] += 1.0f;
+    }
+
+    // Normalize frequencies
+    float total = static_cast<float>(count);
+    for (float& freq : char_freq) {
+        freq /= total;
+    }
+
+    // Downsample to target feature dimension
+    std::vector<float> features;
+    features.reserve(config_.feature_dimension);
+    size_t bin_size = 256 / config_.feature_dimension;
+    for (size_t j = 0; j < config_.feature_dimension; ++j) {
+        float sum = 0.0f;
+        for (size_t k = 0; k < bin_size && j * bin_size + k < 256; ++k) {
+            sum += char_freq[j * bin_size + k];
+        }
+        features.push_back(sum);
+    }
+
+    return PatternData::FromFeatures(FeatureVector(features), DataModality::TEXT);
+}
+
 // ============================================================================
 // Modality-Specific Extraction
 // ============================================================================
 
-std::vector<PatternData> PatternExtractor::ExtractNumeric(const std::vector<uint8_t>& raw_input) const {
+std::vector<PatternData> PatternExtractor::ExtractNumeric(const uint8_t* raw_input, size_t size) const {
     std::vector<PatternData> patterns;
 
     // Convert bytes to floats
-    std::vector<float> numeric_data = BytesToFloats(raw_input);
+    std::vector<float> numeric_data = BytesToFloats(raw_input, size);
 
     if (numeric_data.size() < config_.min_pattern_size / sizeof(float)) {
         return patterns;
@@ -147,63 +465,55 @@ std::vector<PatternData> PatternExtractor::ExtractNumeric(const std::vector<uint
     );
     size_t stride = window_size / 2;  // 50% overlap
 
-    for (size_t i = 0; i + window_size <= numeric_data.size(); i += stride) {
-        std::vector<float> window(
-            numeric_data.begin() + i,
-            numeric_data.begin() + i + window_size
-        );
-
-        // Compute features for this window
-        FeatureVector features = ComputeStatisticalFeatures(window);
-
-        // Filter by energy (noise detection)
-        float energy = ComputeEnergy(window);
-        if (energy > config_.noise_threshold) {
-            patterns.push_back(PatternData::FromFeatures(features, DataModality::NUMERIC));
-        }
-    }
-
-    return patterns;
+    return ExtractSampleWindows(numeric_data.data(), numeric_data.size(),
+                                window_size, stride, config_.modality);
 }
 
-std::vector<PatternData> PatternExtractor::ExtractImage(const std::vector<uint8_t>& raw_input) const {
+std::vector<PatternData> PatternExtractor::ExtractImage(const uint8_t* raw_input, size_t size) const {
     std::vector<PatternData> patterns;
 
     // Simple image feature extraction
     // Assume raw_input contains pixel values (0-255)
 
-    if (raw_input.size() < config_.min_pattern_size) {
+    if (size < config_.min_pattern_size) {
         return patterns;
     }
 
+    if (config_.image_width > 0) {
+        // Known geometry: whole rows form a 2-D image
+        const size_t row_size = config_.image_width * std::max<size_t>(1, config_.image_channels);
+        const size_t height = size / row_size;
+        if (height == 0) {
+            return patterns;
+        }
+        return ExtractTiles(InputView::Image(raw_input, config_.image_width, height, 0,
+                                             std::max<size_t>(1, config_.image_channels)));
+    }
+
     // Extract patches using sliding window
-    size_t patch_size = std::min(
-        config_.max_pattern_size,
-        raw_input.size()
-    );
+    size_t patch_size = std::min(config_.max_pattern_size, size);
     size_t stride = patch_size / 2;
+    size_t windows = stride > 0 ? (size - patch_size) / stride + 1 : 1;
 
-    for (size_t i = 0; i + patch_size <= raw_input.size(); i += stride) {
-        std::vector<uint8_t> patch(
-            raw_input.begin() + i,
-            raw_input.begin() + i + patch_size
-        );
-
-        // Compute image features (simple statistical approach)
-        std::vector<float> float_patch = BytesToFloats(patch);
-        FeatureVector features = ComputeStatisticalFeatures(float_patch);
-
-        patterns.push_back(PatternData::FromFeatures(features, DataModality::IMAGE));
-    }
+    return ExtractWindowChunks(windows, [&](size_t first, size_t last) {
+        std::vector<PatternData> chunk;
+        chunk.reserve(last - first);
+        for (size_t k = first; k < last; ++k) {
+            // Compute image features (simple statistical approach)
+            std::vector<float> float_patch = BytesToFloats(raw_input + k * stride, patch_size);
+            FeatureVector features = ComputeStatisticalFeatures(float_patch);
 
-    return patterns;
+            chunk.push_back(PatternData::FromFeatures(features, DataModality::IMAGE));
+        }
+        return chunk;
+    });
 }
 
-std::vector<PatternData> PatternExtractor::ExtractAudio(const std::vector<uint8_t>& raw_input) const {
+std::vector<PatternData> PatternExtractor::ExtractAudio(const uint8_t* raw_input, size_t size) const {
     std::vector<PatternData> patterns;
 
     // Convert to audio samples (assuming float encoding)
-    std::vector<float> samples = BytesToFloats(raw_input);
+    std::vector<float> samples = BytesToFloats(raw_input, size);
 
     if (samples.size() < config_.min_pattern_size / sizeof(float)) {
         return patterns;
@@ -216,73 +526,549 @@ std::vector<PatternData> PatternExtractor::ExtractAudio(const std::vector<uint8_
     );
     size_t hop_size = frame_size / 4;  // 75% overlap for audio
 
-    for (size_t i = 0; i + frame_size <= samples.size(); i += hop_size) {
-        std::vector<float> frame(
-            samples.begin() + i,
-            samples.begin() + i + frame_size
-        );
+    return ExtractSampleWindows(samples.data(), samples.size(), frame_size, hop_size,
+                                config_.modality);
+}
+
+std::vector<PatternData> PatternExtractor::ExtractText(const uint8_t* raw_input, size_t size) const {
+    std::vector<PatternData> patterns;
+
+    if (size < config_.min_pattern_size) {
+        return patterns;
+    }
+
+    // Extract text n-grams/chunks
+    size_t chunk_size = std::min(config_.max_pattern_size, size);
+    size_t stride = chunk_size / 2;
+    size_t windows = stride > 0 ? (size - chunk_size) / stride + 1 : 1;
+
+    if (config_.text_features == TextFeatures::HASHED_NGRAMS) {
+        return ExtractWindowChunks(windows, [&](size_t first, size_t last) {
+            return ExtractHashedTextRun(raw_input + first * stride,
+                                        (last - first - 1) * stride + chunk_size,
+                                        chunk_size, stride);
+        });
+    }
+
+    return ExtractWindowChunks(windows, [&](size_t first, size_t last) {
+        std::vector<PatternData> chunk;
+        chunk.reserve(last - first);
+        for (size_t k = first; k < last; ++k) {
+            chunk.push_back(ExtractTextWindow(raw_input + k * stride, chunk_size));
+        }
+        return chunk;
+    });
+}
+
+std::vector<PatternData> PatternExtractor::ExtractHashedTextRun(const uint8_t* bytes,
+                                                                size_t size,
+                                                                size_t window_size,
+                                                                size_t stride) const {
+    struct Word {
+        size_t start;
+        size_t end;            ///< One past the last byte
+        uint64_t hash;
+        uint32_t ngram_bucket; ///< Bucket of the n-gram starting here, once known
+    };
+
+    const size_t dim = config_.feature_dimension;
+    const size_t char_n = config_.char_ngram_size;
+    const size_t word_n = config_.word_ngram_size;
+
+    // N-grams enter a window once they end inside it and leave once it
+    // starts past them, so each is hashed and counted once per run. Only
+    // the n-grams of the current window are kept: character buckets in a
+    // ring, words in a vector whose consumed front is dropped now and then.
+    std::vector<uint32_t> counts(dim, 0);
+
+    RollingNGramHash char_hash(std::max<size_t>(char_n, 1));
+    size_t ring_size = 1;
+    while (ring_size <= window_size) {
+        ring_size <<= 1;
+    }
+    std::vector<uint32_t> char_ring(char_n > 0 ? ring_size : 0);
+    size_t char_added = 0, char_removed = 0, char_hashed_to = 0;
+
+    std::vector<Word> words;
+    size_t word_base = 0;  // Index of words.front()
+    size_t word_scan = 0;  // Next byte to tokenize
+    size_t word_added = 0, word_removed = 0;
+    size_t first_word = 0;  // First word ending after the window start
+    std::vector<uint64_t> edge_hashes;
+    std::vector<uint32_t> edge_buckets;
+    auto word_at = [&](size_t index) -> Word& { return words[index - word_base]; };
+
+    const size_t windows = stride > 0 ? (size - window_size) / stride + 1 : 1;
+    std::vector<PatternData> patterns;
+    patterns.reserve(windows);
+
+    for (size_t k = 0; k < windows; ++k) {
+        const size_t start = k * stride;
+        const size_t end = start + window_size;
+
+        if (char_n > 0) {
+            for (; char_removed < start; ++char_removed) {
+                if (char_removed < char_added) {
+                    --counts[char_ring[char_removed & (ring_size - 1)]];
+                }
+            }
+            char_added = std::max(char_added, char_removed);
+            for (; char_added + char_n <= end; ++char_added) {
+                for (; char_hashed_to < char_added + char_n; ++char_hashed_to) {
+                    char_hash.Push(bytes, char_hashed_to);
+                }
+                uint32_t bucket = HashBucket(char_hash.Key(), dim);
+                char_ring[char_added & (ring_size - 1)] = bucket;
+                ++counts[bucket];
+            }
+        }
+
+        edge_buckets.clear();
+        if (word_n > 0) {
+            // Tokenize every word that starts before the window end
+            while (word_scan < size) {
+                while (word_scan < size && !kWordBytes[bytes[word_scan]]) {
+                    ++word_scan;
+                }
+                if (word_scan >= end) {
+                    break;
+                }
+                const size_t word_start = word_scan;
+                WordHasher hasher;
+                for (; word_scan < size && kWordBytes[bytes[word_scan]]; ++word_scan) {
+                    hasher.Add(bytes[word_scan]);
+                }
+                words.push_back({word_start, word_scan, hasher.Finish(), 0});
+                const size_t total = word_base + words.size();
+                if (total >= word_n) {
+                    const size_t first = total - word_n;
+                    word_at(first).ngram_bucket = WordNGramBucket(
+                        word_n, [&](size_t w) { return word_at(first + w).hash; }, dim);
+                }
+            }
+            const size_t past_word = word_base + words.size();  // First word starting at or after end
+            const size_t ngrams = past_word >= word_n ? past_word - word_n + 1 : 0;
+
+            for (; word_removed < ngrams && word_at(word_removed).start < start; ++word_removed) {
+                if (word_removed < word_added) {
+                    --counts[word_at(word_removed).ngram_bucket];
+                }
+            }
+            word_added = std::max(word_added, word_removed);
+            for (; word_added < ngrams && word_at(word_added + word_n - 1).end <= end;
+                 ++word_added) {
+                ++counts[word_at(word_added).ngram_bucket];
+            }
+
+            // The window cuts the words it starts or ends inside; n-grams
+            // that contain such a cut word are hashed for this window only
+            while (first_word < past_word && word_at(first_word).end <= start) {
+                ++first_word;
+            }
+            const bool cut_first = first_word < past_word && word_at(first_word).start < start;
+            const bool cut_last = first_word < past_word && word_at(past_word - 1).end > end;
+            auto token_hash = [&](size_t w) {
+                const Word& word = word_at(w);
+                if ((w == first_word && cut_first) || (w + 1 == past_word && cut_last)) {
+                    return WordHash(bytes, std::max(word.start, start), std::min(word.end, end));
+                }
+                return word.hash;
+            };
+            auto add_ngram = [&](size_t first) {
+                edge_hashes.clear();
+                for (size_t w = first; w < first + word_n; ++w) {
+                    edge_hashes.push_back(token_hash(w));
+                }
+                edge_buckets.push_back(WordNGramBucket(
+                    word_n, [&](size_t w) { return edge_hashes[w]; }, dim));
+            };
+
+            const size_t tokens = past_word - first_word;
+            bool head_reaches_last = false;
+            if (cut_first && tokens >= word_n) {
+                add_ngram(first_word);
+                head_reaches_last = cut_last && tokens == word_n;
+            }
+            if (cut_last && tokens >= word_n && !head_reaches_last) {
+                add_ngram(past_word - word_n);
+            }
+
+            // Words before both the window and the pending n-grams are done
+            const size_t done = std::min(first_word, word_removed) - word_base;
+            if (done >= 1024 && done * 2 >= words.size()) {
+                words.erase(words.begin(), words.begin() + static_cast<std::ptrdiff_t>(done));
+                word_base += done;
+            }
+        }
+        for (uint32_t bucket : edge_buckets) {
+            ++counts[bucket];
+        }
 
-        // Compute spectral features
-        FeatureVector features = ComputeStatisticalFeatures(frame);
+        std::vector<float> features(dim);
+        double norm = 0.0;
+        for (size_t d = 0; d < dim; ++d) {
+            const uint32_t count = counts[d];
+            features[d] = static_cast<float>(count);
+            norm += static_cast<double>(count) * count;
+        }
+        if (norm > 0.0) {
+            const float scale = static_cast<float>(1.0 / std::sqrt(norm));
+            for (float& value : features) {
+                value *= scale;
+            }
+        }
+        patterns.push_back(PatternData::FromFeatures(FeatureVector(std::move(features)),
+                                                     DataModality::TEXT));
 
-        // Check energy
-        float energy = ComputeEnergy(frame);
-        if (energy > config_.noise_threshold) {
-            patterns.push_back(PatternData::FromFeatures(features, DataModality::AUDIO));
+        for (uint32_t bucket : edge_buckets) {
+            --counts[bucket];
         }
     }
 
     return patterns;
 }
 
-std::vector<PatternData> PatternExtractor::ExtractText(const std::vector<uint8_t>& raw_input) const {
+std::vector<PatternData> PatternExtractor::ExtractSamples(const float* samples, size_t count,
+                                                          DataModality modality) const {
+    if (modality == DataModality::TEXT) {
+        throw std::invalid_argument("TEXT input must be given as bytes");
+    }
+    if (count * sizeof(float) < config_.min_pattern_size) {
+        return {};
+    }
+
+    // Same windowing as float-encoded byte input
+    size_t window_size = std::min(config_.max_pattern_size / sizeof(float), count);
+    size_t stride = modality == DataModality::AUDIO ? window_size / 4 : window_size / 2;
+
+    return ExtractSampleWindows(samples, count, window_size, stride, modality);
+}
+
+std::vector<PatternData> PatternExtractor::ExtractTiles(const InputView& image) const {
+    if (image.count < config_.min_pattern_size) {
+        return {};
+    }
+
+    // Square tiles with about max_pattern_size pixels each
+    TileExtractor::Config tiling;
+    tiling.tile_size = std::max<size_t>(
+        1, static_cast<size_t>(std::sqrt(static_cast<double>(config_.max_pattern_size))));
+    tiling.pyramid_levels = std::max<size_t>(1, config_.image_pyramid_levels);
+    tiling.feature_dimension = config_.feature_dimension;
+    TileExtractor tiler(tiling);
+
     std::vector<PatternData> patterns;
+    for (auto& tile : tiler.Extract(image)) {
+        patterns.push_back(PatternData::FromFeatures(tile.features, DataModality::IMAGE));
+    }
+    return patterns;
+}
+
+std::vector<PatternData> PatternExtractor::ExtractSampleWindows(
+    const float* samples,
+    size_t count,
+    size_t window_size,
+    size_t stride,
+    DataModality modality) const {
+
+    if (window_size == 0 || window_size > count) {
+        return {};
+    }
+
+    size_t windows = stride > 0 ? (count - window_size) / stride + 1 : 1;
+
+    if (config_.window_selection == WindowSelection::CHANGE_POINTS &&
+        (modality == DataModality::NUMERIC || modality == DataModality::AUDIO)) {
+        // Selection depends on every earlier window, so it runs serially;
+        // only the selected windows are extracted, one at a time
+        ChangePointDetector detector(config_.change_points);
+        std::vector<size_t> selected;
+        for (size_t k = 0; k < windows; ++k) {
+            if (detector.Update(samples + k * stride, window_size)) {
+                selected.push_back(k);
+            }
+        }
+        return ExtractWindowChunks(selected.size(), [&](size_t first, size_t last) {
+            std::vector<PatternData> chunk;
+            for (size_t i = first; i < last; ++i) {
+                auto single = ExtractWindowRun(samples + selected[i] * stride, window_size,
+                                               window_size, 0, modality);
+                std::move(single.begin(), single.end(), std::back_inserter(chunk));
+            }
+            return chunk;
+        });
+    }
+
+    // A chunk of windows [first, last) reads only the samples it covers
+    return ExtractWindowChunks(windows, [&](size_t first, size_t last) {
+        return ExtractWindowRun(samples + first * stride,
+                                (last - first - 1) * stride + window_size,
+                                window_size, stride, modality);
+    });
+}
 
-    if (raw_input.size() < config_.min_pattern_size) {
+std::vector<PatternData> PatternExtractor::ExtractWindowRun(
+    const float* samples,
+    size_t count,
+    size_t window_size,
+    size_t stride,
+    DataModality modality) const {
+
+    if (modality == DataModality::AUDIO &&
+        config_.audio_features != AudioFeatures::STATISTICAL) {
+        return ExtractSpectralRun(samples, count, window_size, stride);
+    }
+
+    std::vector<PatternData> patterns;
+    size_t windows = stride > 0 ? (count - window_size) / stride + 1 : 1;
+    const bool filter_noise = modality == DataModality::NUMERIC ||
+                              modality == DataModality::AUDIO;
+
+    // Overlapping windows share most of their work: compute them together
+    std::vector<float> features;
+    std::vector<float> energies;
+    if (config_.rolling_features && stride > 0 && windows > 1 &&
+        ComputeRollingFeatures(samples, count, window_size, stride, features, energies)) {
+        const size_t dim = config_.feature_dimension;
+        for (size_t k = 0; k < windows; ++k) {
+            if (filter_noise && energies[k] <= config_.noise_threshold) {
+                continue;
+            }
+            std::vector<float> row(features.begin() + static_cast<std::ptrdiff_t>(k * dim),
+                                   features.begin() + static_cast<std::ptrdiff_t>((k + 1) * dim));
+            patterns.push_back(PatternData::FromFeatures(FeatureVector(std::move(row)), modality));
+        }
         return patterns;
     }
 
-    // Extract text n-grams/chunks
-    size_t chunk_size = std::min(config_.max_pattern_size, raw_input.size());
-    size_t stride = chunk_size / 2;
+    for (size_t k = 0; k < windows; ++k) {
+        // Features and noise filtering straight from the sample buffer
+        const float* window = samples + k * stride;
+        if (filter_noise && ComputeEnergy(window, window_size) <= config_.noise_threshold) {
+            continue;
+        }
+        patterns.push_back(PatternData::FromFeatures(
+            ComputeStatisticalFeatures(window, window_size), modality));
+    }
 
-    for (size_t i = 0; i + chunk_size <= raw_input.size(); i += stride) {
-        std::vector<uint8_t> chunk(
-            raw_input.begin() + i,
-            raw_input.begin() + i + chunk_size
-        );
+    return patterns;
+}
+
+std::vector<PatternData> PatternExtractor::ExtractSpectralRun(
+    const float* samples,
+    size_t count,
+    size_t window_size,
+    size_t stride) const {
+
+    std::vector<PatternData> patterns;
+    if (window_size == 0 || window_size > count) {
+        return patterns;
+    }
+
+    SpectralExtractor& spectral = ThreadSpectralExtractor(config_, window_size);
+    size_t windows = stride > 0 ? (count - window_size) / stride + 1 : 1;
+    for (size_t k = 0; k < windows; ++k) {
+        const float* window = samples + k * stride;
+        if (ComputeEnergy(window, window_size) <= config_.noise_threshold) {
+            continue;
+        }
+        std::vector<float> features(config_.feature_dimension);
+        spectral.ComputeFrame(window, features.data());
+        patterns.push_back(PatternData::FromFeatures(FeatureVector(std::move(features)),
+                                                     DataModality::AUDIO));
+    }
+
+    return patterns;
+}
+
+std::vector<PatternData> PatternExtractor::ExtractWindowChunks(
+    size_t windows,
+    const std::function<std::vector<PatternData>(size_t, size_t)>& extract) const {
+
+    const size_t chunk = std::max<size_t>(1, config_.parallel_chunk_windows);
+    if (config_.parallel_min_windows == 0 || windows < config_.parallel_min_windows ||
+        windows <= chunk) {
+        return extract(0, windows);
+    }
+
+    // Each chunk fills its own slot, so the order never depends on scheduling
+    const size_t chunks = (windows + chunk - 1) / chunk;
+    std::vector<std::vector<PatternData>> results(chunks);
+    WorkerPool& pool = config_.worker_pool ? *config_.worker_pool : WorkerPool::Shared();
+    pool.ParallelFor(chunks, [&](size_t c) {
+        results[c] = extract(c * chunk, std::min(windows, (c + 1) * chunk));
+    });
 
-        // Compute text features (character frequency, etc.)
-        std::vector<float> char_freq(256, 0.0f);
-        for (uint8_t byte : chunk) {
-            char_freq[byte] += 1.0f;
+    std::vector<PatternData> patterns;
+    patterns.reserve(windows);
+    for (auto& result : results) {
+        std::move(result.begin(), result.end(), std::back_inserter(patterns));
+    }
+    return patterns;
+}
+
+bool PatternExtractor::ComputeRollingFeatures(const float* data, size_t count,
+                                              size_t window_size, size_t stride,
+                                              std::vector<float>& features,
+                                              std::vector<float>& energies) const {
+    // Non-finite samples would poison every later window's running sums
+    double shift = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(data[i])) {
+            return false;
         }
+        shift += data[i];
+    }
+    shift /= static_cast<double>(count);
+
+    const size_t windows = (count - window_size) / stride + 1;
+    const size_t dim = config_.feature_dimension;
+    const double n = static_cast<double>(window_size);
+    features.assign(windows * dim, 0.0f);
+    energies.assign(windows, 0.0f);
+
+    // Moments are accumulated around the global mean to limit cancellation
+    std::vector<double> sum1, sum2, sum3, crossings, lag_sum;
+    SlidingSums(windows, stride, window_size,
+                [&](size_t i) { return data[i] - shift; }, sum1);
+    SlidingSums(windows, stride, window_size,
+                [&](size_t i) { double y = data[i] - shift; return y * y; }, sum2);
+    SlidingSums(windows, stride, window_size,
+                [&](size_t i) { double y = data[i] - shift; return y * y * y; }, sum3);
+    SlidingSums(windows, stride, window_size - 1,
+                [&](size_t i) {
+                    return (data[i] >= 0) != (data[i + 1] >= 0) ? 1.0 : 0.0;
+                }, crossings);
+
+    double global_variance = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double y = data[i] - shift;
+        global_variance += y * y;
+    }
+    global_variance /= static_cast<double>(count);
 
-        // Normalize frequencies
-        float total = static_cast<float>(chunk.size());
-        for (float& freq : char_freq) {
-            freq /= total;
+    // Autocorrelation features, one lag per column
+    for (size_t f = 10; f < dim; ++f) {
+        size_t lag = f - 10;
+        if (lag >= window_size / 2) {
+            break;  // Remaining columns stay zero, as in the direct path
+        }
+        SlidingSums(windows, stride, window_size - lag,
+                    [&](size_t i) { return static_cast<double>(data[i]) * data[i + lag]; },
+                    lag_sum);
+        for (size_t k = 0; k < windows; ++k) {
+            features[k * dim + f] = static_cast<float>(lag_sum[k] / (window_size - lag));
         }
+    }
 
-        // Downsample to target feature dimension
-        std::vector<float> features;
-        features.reserve(config_.feature_dimension);
-        size_t bin_size = 256 / config_.feature_dimension;
-        for (size_t j = 0; j < config_.feature_dimension; ++j) {
-            float sum = 0.0f;
-            for (size_t k = 0; k < bin_size && j * bin_size + k < 256; ++k) {
-                sum += char_freq[j * bin_size + k];
+    // Quartiles: windows are unions of blocks of gcd(window, stride)
+    // samples, so each block is sorted once and the quartiles are selected
+    // across the window's sorted runs
+    const size_t block = std::gcd(window_size, stride);
+    const size_t runs_per_window = window_size / block;
+    const bool use_runs = runs_per_window <= 8;
+    std::vector<float> sorted_blocks;
+    std::vector<std::pair<const float*, const float*>> runs;
+    std::vector<float> scratch;
+    if (use_runs) {
+        const size_t covered = (windows - 1) * stride + window_size;
+        sorted_blocks.assign(data, data + covered);
+        for (size_t b = 0; b < covered; b += block) {
+            std::sort(sorted_blocks.begin() + static_cast<std::ptrdiff_t>(b),
+                      sorted_blocks.begin() + static_cast<std::ptrdiff_t>(b + block));
+        }
+        runs.resize(runs_per_window);
+    }
+
+    std::deque<size_t> min_queue;  // Increasing values
+    std::deque<size_t> max_queue;  // Decreasing values
+    size_t added = 0;
+
+    for (size_t k = 0; k < windows; ++k) {
+        const size_t start = k * stride;
+        const size_t end = start + window_size;
+
+        for (; added < end; ++added) {
+            while (!min_queue.empty() && data[min_queue.back()] >= data[added]) {
+                min_queue.pop_back();
+            }
+            min_queue.push_back(added);
+            while (!max_queue.empty() && data[max_queue.back()] <= data[added]) {
+                max_queue.pop_back();
             }
-            features.push_back(sum);
+            max_queue.push_back(added);
+        }
+        while (min_queue.front() < start) {
+            min_queue.pop_front();
+        }
+        while (max_queue.front() < start) {
+            max_queue.pop_front();
         }
 
-        patterns.push_back(PatternData::FromFeatures(
-            FeatureVector(features),
-            DataModality::TEXT
-        ));
+        float* row = features.data() + k * dim;
+        const double mean_y = sum1[k] / n;
+        const double variance = sum2[k] / n - mean_y * mean_y;
+
+        if (!(variance > 1e-6 * global_variance)) {
+            // Nearly constant window: running sums cannot resolve its spread
+            FeatureVector direct = ComputeStatisticalFeatures(data + start, window_size);
+            std::copy(direct.Data().begin(), direct.Data().end(), row);
+            energies[k] = ComputeEnergy(data + start, window_size);
+            continue;
+        }
+
+        const double std_dev = std::sqrt(variance);
+        double skewness = 0.0;
+        if (std_dev > 1e-10) {
+            double central3 = sum3[k] / n - 3.0 * mean_y * (sum2[k] / n) +
+                              2.0 * mean_y * mean_y * mean_y;
+            skewness = central3 / (std_dev * std_dev * std_dev);
+        }
+
+        double energy = sum2[k] / n + 2.0 * shift * mean_y + shift * shift;
+        float threshold = config_.noise_threshold;
+        if (std::abs(energy - threshold) <= 1e-5 * std::max<double>(threshold, energy)) {
+            // Too close to the noise threshold to trust the rounding
+            energy = ComputeEnergy(data + start, window_size);
+        }
+        energies[k] = static_cast<float>(energy);
+
+        float quartiles[3];
+        const size_t ranks[3] = {window_size / 4, window_size / 2, 3 * window_size / 4};
+        if (use_runs) {
+            for (size_t r = 0; r < runs_per_window; ++r) {
+                const float* first = sorted_blocks.data() + start + r * block;
+                runs[r] = {first, first + block};
+            }
+            for (size_t q = 0; q < 3; ++q) {
+                quartiles[q] = KthOfRuns(runs, ranks[q]);
+            }
+        } else {
+            scratch.assign(data + start, data + end);
+            for (size_t q = 0; q < 3; ++q) {
+                std::nth_element(scratch.begin(),
+                                 scratch.begin() + static_cast<std::ptrdiff_t>(ranks[q]),
+                                 scratch.end());
+                quartiles[q] = scratch[ranks[q]];
+            }
+        }
+
+        const float base[10] = {
+            static_cast<float>(shift + mean_y),
+            static_cast<float>(std_dev),
+            data[min_queue.front()],
+            data[max_queue.front()],
+            static_cast<float>(skewness),
+            static_cast<float>(energy),
+            static_cast<float>(crossings[k] / n),
+            quartiles[0],
+            quartiles[1],
+            quartiles[2],
+        };
+        std::copy(base, base + std::min<size_t>(dim, 10), row);
     }
 
-    return patterns;
+    return true;
 }
 
 // ============================================================================
@@ -321,7 +1107,11 @@ FeatureVector PatternExtractor::NormalizeFeatures(const FeatureVector& features)
 }
 
 FeatureVector PatternExtractor::ComputeStatisticalFeatures(const std::vector<float>& data) const {
-    if (data.empty()) {
+    return ComputeStatisticalFeatures(data.data(), data.size());
+}
+
+FeatureVector PatternExtractor::ComputeStatisticalFeatures(const float* data, size_t count) const {
+    if (count == 0) {
         return FeatureVector(std::vector<float>(config_.feature_dimension, 0.0f));
     }
 
@@ -329,49 +1119,49 @@ FeatureVector PatternExtractor::ComputeStatisticalFeatures(const std::vector<flo
     features.reserve(config_.feature_dimension);
 
     // Basic statistics
-    float sum = std::accumulate(data.begin(), data.end(), 0.0f);
-    float mean = sum / data.size();
+    float sum = std::accumulate(data, data + count, 0.0f);
+    float mean = sum / count;
     features.push_back(mean);
 
     // Variance and standard deviation
     float variance = 0.0f;
-    for (float value : data) {
-        float diff = value - mean;
+    for (size_t i = 0; i < count; ++i) {
+        float diff = data[i] - mean;
         variance += diff * diff;
     }
-    variance /= data.size();
+    variance /= count;
     features.push_back(std::sqrt(variance));
 
     // Min and max
-    features.push_back(*std::min_element(data.begin(), data.end()));
-    features.push_back(*std::max_element(data.begin(), data.end()));
+    features.push_back(*std::min_element(data, data + count));
+    features.push_back(*std::max_element(data, data + count));
 
     // Skewness approximation
     float skewness = 0.0f;
     float std_dev = std::sqrt(variance);
     if (std_dev > 1e-10f) {
-        for (float value : data) {
-            float z = (value - mean) / std_dev;
+        for (size_t i = 0; i < count; ++i) {
+            float z = (data[i] - mean) / std_dev;
             skewness += z * z * z;
         }
-        skewness /= data.size();
+        skewness /= count;
     }
     features.push_back(skewness);
 
     // Energy
-    features.push_back(ComputeEnergy(data));
+    features.push_back(ComputeEnergy(data, count));
 
     // Zero-crossing rate
     size_t zero_crossings = 0;
-    for (size_t i = 1; i < data.size(); ++i) {
+    for (size_t i = 1; i < count; ++i) {
         if ((data[i-1] >= 0 && data[i] < 0) || (data[i-1] < 0 && data[i] >= 0)) {
             zero_crossings++;
         }
     }
-    features.push_back(static_cast<float>(zero_crossings) / data.size());
+    features.push_back(static_cast<float>(zero_crossings) / count);
 
     // Percentiles (quartiles)
-    std::vector<float> sorted_data = data;
+    std::vector<float> sorted_data(data, data + count);
     std::sort(sorted_data.begin(), sorted_data.end());
 
     size_t q1_idx = sorted_data.size() / 4;
@@ -386,12 +1176,12 @@ FeatureVector PatternExtractor::ComputeStatisticalFeatures(const std::vector<flo
     while (features.size() < config_.feature_dimension) {
         // Add autocorrelation-like features if we need more
         size_t lag = features.size() - 10;
-        if (lag < data.size() / 2) {
+        if (lag < count / 2) {
             float autocorr = 0.0f;
-            for (size_t i = 0; i + lag < data.size(); ++i) {
+            for (size_t i = 0; i + lag < count; ++i) {
                 autocorr += data[i] * data[i + lag];
             }
-            features.push_back(autocorr / (data.size() - lag));
+            features.push_back(autocorr / (count - lag));
         } else {
             features.push_back(0.0f);
         }
@@ -427,21 +1217,23 @@ std::vector<std::vector<uint8_t>> PatternExtractor::SlidingWindowExtract(
 }
 
 std::vector<float> PatternExtractor::BytesToFloats(const std::vector<uint8_t>& bytes) const {
+    return BytesToFloats(bytes.data(), bytes.size());
+}
+
+std::vector<float> PatternExtractor::BytesToFloats(const uint8_t* bytes, size_t size) const {
     std::vector<float> floats;
 
     // If size is multiple of 4, interpret as float array
-    if (bytes.size() % sizeof(float) == 0) {
-        floats.reserve(bytes.size() / sizeof(float));
-        for (size_t i = 0; i + sizeof(float) <= bytes.size(); i += sizeof(float)) {
-            float value;
-            std::memcpy(&value, &bytes[i], sizeof(float));
-            floats.push_back(value);
+    if (size % sizeof(float) == 0) {
+        floats.resize(size / sizeof(float));
+        if (size > 0) {
+            std::memcpy(floats.data(), bytes, size);
         }
     } else {
         // Otherwise, normalize bytes to [0, 1] range
-        floats.reserve(bytes.size());
-        for (uint8_t byte : bytes) {
-            floats.push_back(static_cast<float>(byte) / 255.0f);
+        floats.reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            floats.push_back(static_cast<float>(bytes[i]) / 255.0f);
         }
     }
 
@@ -449,16 +1241,20 @@ std::vector<float> PatternExtractor::BytesToFloats(const std::vector<uint8_t>& b
 }
 
 float PatternExtractor::ComputeEnergy(const std::vector<float>& signal) const {
-    if (signal.empty()) {
+    return ComputeEnergy(signal.data(), signal.size());
+}
+
+float PatternExtractor::ComputeEnergy(const float* signal, size_t count) const {
+    if (count == 0) {
         return 0.0f;
     }
 
     float energy = 0.0f;
-    for (float value : signal) {
-        energy += value * value;
+    for (size_t i = 0; i < count; ++i) {
+        energy += signal[i] * signal[i];
     }
 
-    return energy / signal.size();
+    return energy / count;
 }
 
 } // namespace dpan
@@ -1,9 +1,14 @@
 // File: src/discovery/pattern_extractor.hpp
 #pragma once
 
+#include "core/input_view.hpp"
 #include "core/pattern_data.hpp"
+#include "core/worker_pool.hpp"
+#include "discovery/change_point_detector.hpp"
+#include <functional>
 #include <vector>
 #include <memory>
+#include <optional>
 #include <cstdint>
 
 namespace dpan {
@@ -17,6 +22,38 @@ namespace dpan {
 /// - Text: N-grams, semantic features
 class PatternExtractor {
 public:
+    /// Features of TEXT windows
+    enum class TextFeatures {
+        /// Byte frequencies, downsampled to feature_dimension bins
+        CHARACTER_HISTOGRAM,
+        /// Counts of character and word n-grams hashed into
+        /// feature_dimension buckets, L2-normalized. Words are runs of ASCII
+        /// letters and digits (or non-ASCII bytes) within the window,
+        /// case-folded.
+        HASHED_NGRAMS
+    };
+
+    /// Features of AUDIO windows
+    enum class AudioFeatures {
+        /// Time-domain statistics, as for NUMERIC windows
+        STATISTICAL,
+        /// Log mel filterbank energies (see SpectralExtractor)
+        MEL_SPECTRUM,
+        /// Mel-frequency cepstral coefficients
+        MFCC
+    };
+
+    /// Which NUMERIC / AUDIO windows are extracted
+    enum class WindowSelection {
+        /// Every window
+        ALL,
+        /// Windows whose statistics changed since the last selected one,
+        /// plus a heartbeat (see ChangePointDetector); the detector runs
+        /// over all windows in order, then only the selected ones are
+        /// extracted
+        CHANGE_POINTS
+    };
+
     /// Configuration for pattern extraction
     struct Config {
         /// Data modality for extraction
@@ -36,10 +73,63 @@ public:
 
         /// Feature dimension for extracted patterns
         size_t feature_dimension{128};
+
+        /// Compute the statistics of overlapping NUMERIC / AUDIO windows
+        /// incrementally (window sums, sliding min/max, rank counts) instead
+        /// of rescanning every window; results match within float tolerance
+        bool rolling_features{true};
+
+        /// Split the windows of one input into chunks of this many windows
+        /// and extract the chunks on a worker pool once the input has at
+        /// least parallel_min_windows windows (0 = always serial). Chunk
+        /// boundaries depend only on these settings, so the output is the
+        /// same whatever the number of threads.
+        size_t parallel_min_windows{128};
+        size_t parallel_chunk_windows{32};
+
+        /// Pool for parallel extraction (null = WorkerPool::Shared())
+        std::shared_ptr<WorkerPool> worker_pool;
+
+        /// Row width in pixels of IMAGE byte input. When set, byte input is
+        /// tiled as a 2-D image like an IMAGE_U8 view; 0 keeps the 1-D
+        /// sliding windows over the byte stream.
+        size_t image_width{0};
+
+        /// Interleaved channels of IMAGE byte input (with image_width)
+        size_t image_channels{1};
+
+        /// Tile pyramid levels for 2-D image extraction (see TileExtractor)
+        size_t image_pyramid_levels{1};
+
+        /// Text feature mode
+        TextFeatures text_features{TextFeatures::CHARACTER_HISTOGRAM};
+
+        /// N-gram lengths for HASHED_NGRAMS, in bytes and in words
+        /// (0 disables that kind)
+        size_t char_ngram_size{3};
+        size_t word_ngram_size{1};
+
+        /// Audio feature mode; spectral modes treat each window as one
+        /// frame, zero-padded to a power-of-two FFT
+        AudioFeatures audio_features{AudioFeatures::STATISTICAL};
+
+        /// Sampling rate in Hz of AUDIO input for the mel scale
+        double audio_sample_rate{16000.0};
+
+        /// Mel filters, and cepstral coefficients kept in MFCC mode
+        size_t audio_mel_bands{40};
+        size_t audio_mfcc_coefficients{13};
+
+        /// Window selection for NUMERIC and AUDIO input
+        WindowSelection window_selection{WindowSelection::ALL};
+
+        /// Detector settings for CHANGE_POINTS
+        ChangePointDetector::Config change_points;
     };
 
     /// Constructor
     /// @param config Extraction configuration
+    /// @throws std::invalid_argument for an invalid configuration
     explicit PatternExtractor(const Config& config);
 
     /// Extract patterns from raw input data
@@ -47,6 +137,35 @@ public:
     /// @return Vector of extracted patterns
     std::vector<PatternData> Extract(const std::vector<uint8_t>& raw_input) const;
 
+    /// Extract patterns from a typed input view
+    ///
+    /// BYTES views behave like Extract(raw bytes) and use the configured
+    /// modality. Typed views are windowed by their own modality and read
+    /// without converting to bytes: FLOAT32 samples are used in place and
+    /// PCM16 samples are scaled to float in one pass. Sample windows hold
+    /// max_pattern_size / 4 samples as for float byte input. Images are
+    /// covered by square 2-D tiles of about max_pattern_size pixels
+    /// (see TileExtractor).
+    /// @param input Input view
+    /// @return Vector of extracted patterns
+    /// @throws std::invalid_argument for a TEXT view that is not BYTES
+    std::vector<PatternData> Extract(const InputView& input) const;
+
+    /// Extract the pattern of one window of samples
+    ///
+    /// This is the per-window step of NUMERIC, AUDIO and IMAGE extraction;
+    /// NUMERIC and AUDIO windows below the noise threshold are dropped.
+    /// @param samples Window samples
+    /// @param count Number of samples
+    /// @return Pattern, or nullopt if the window is filtered as noise
+    std::optional<PatternData> ExtractWindow(const float* samples, size_t count) const;
+
+    /// Extract the pattern of one window of text (see TextFeatures)
+    /// @param bytes Window bytes
+    /// @param count Number of bytes (> 0)
+    /// @return Pattern with TEXT modality
+    PatternData ExtractTextWindow(const uint8_t* bytes, size_t count) const;
+
     /// Extract feature vector from pattern data
     /// @param pattern Pattern to extract features from
     /// @return Feature vector representation
@@ -72,16 +191,66 @@ private:
     Config config_;
 
     /// Modality-specific extraction methods
-    std::vector<PatternData> ExtractNumeric(const std::vector<uint8_t>& raw_input) const;
-    std::vector<PatternData> ExtractImage(const std::vector<uint8_t>& raw_input) const;
-    std::vector<PatternData> ExtractAudio(const std::vector<uint8_t>& raw_input) const;
-    std::vector<PatternData> ExtractText(const std::vector<uint8_t>& raw_input) const;
+    std::vector<PatternData> ExtractNumeric(const uint8_t* raw_input, size_t size) const;
+    std::vector<PatternData> ExtractImage(const uint8_t* raw_input, size_t size) const;
+    std::vector<PatternData> ExtractAudio(const uint8_t* raw_input, size_t size) const;
+    std::vector<PatternData> ExtractText(const uint8_t* raw_input, size_t size) const;
+
+    /// HASHED_NGRAMS features of every window [k * stride, k * stride + window_size);
+    /// n-grams are hashed once and counted incrementally as windows slide
+    std::vector<PatternData> ExtractHashedTextRun(const uint8_t* bytes, size_t size,
+                                                  size_t window_size, size_t stride) const;
+
+    /// Typed-view extraction
+    std::vector<PatternData> ExtractSamples(const float* samples, size_t count,
+                                            DataModality modality) const;
+    std::vector<PatternData> ExtractTiles(const InputView& image) const;
+
+    /// Extract overlapping sample windows; NUMERIC and AUDIO windows below
+    /// the noise threshold are dropped
+    std::vector<PatternData> ExtractSampleWindows(const float* samples,
+                                                  size_t count,
+                                                  size_t window_size,
+                                                  size_t stride,
+                                                  DataModality modality) const;
+
+    /// ExtractSampleWindows for one chunk, on the calling thread
+    std::vector<PatternData> ExtractWindowRun(const float* samples,
+                                              size_t count,
+                                              size_t window_size,
+                                              size_t stride,
+                                              DataModality modality) const;
+
+    /// Spectral features of every AUDIO window; windows below the noise
+    /// threshold are dropped
+    std::vector<PatternData> ExtractSpectralRun(const float* samples,
+                                                size_t count,
+                                                size_t window_size,
+                                                size_t stride) const;
+
+    /// Call extract(first, last) on fixed chunks of the window range
+    /// [0, windows), in parallel above the configured threshold
+    /// @return Patterns of all chunks in window order
+    std::vector<PatternData> ExtractWindowChunks(
+        size_t windows,
+        const std::function<std::vector<PatternData>(size_t, size_t)>& extract) const;
+
+    /// Statistical features of every window [k * stride, k * stride + window_size)
+    /// computed incrementally
+    /// @param features Output, windows x feature_dimension (row-major)
+    /// @param energies Output, energy of each window
+    /// @return false if the samples contain non-finite values (use the direct path)
+    bool ComputeRollingFeatures(const float* data, size_t count,
+                                size_t window_size, size_t stride,
+                                std::vector<float>& features,
+                                std::vector<float>& energies) const;
 
     /// Normalize features to [0, 1] range
     FeatureVector NormalizeFeatures(const FeatureVector& features) const;
 
     /// Compute statistical features from numeric data
     FeatureVector ComputeStatisticalFeatures(const std::vector<float>& data) const;
+    FeatureVector ComputeStatisticalFeatures(const float* data, size_t count) const;
 
     /// Detect patterns using sliding window
     std::vector<std::vector<uint8_t>> SlidingWindowExtract(
@@ -91,9 +260,11 @@ private:
 
     /// Convert raw bytes to float values (for numeric processing)
     std::vector<float> BytesToFloats(const std::vector<uint8_t>& bytes) const;
+    std::vector<float> BytesToFloats(const uint8_t* bytes, size_t size) const;
 
     /// Compute signal energy (for noise detection)
     float ComputeEnergy(const std::vector<float>& signal) const;
+    float ComputeEnergy(const float* signal, size_t count) const;
 };
 
 } // namespace dpan
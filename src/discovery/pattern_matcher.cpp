@@ -1,11 +1,42 @@
 // File: src/discovery/pattern_matcher.cpp
 #include "pattern_matcher.hpp"
 #include <algorithm>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_set>
 
 namespace dpan {
 
+namespace {
+
+void ValidateConfig(const PatternMatcher::Config& config) {
+    if (config.similarity_threshold < 0.0f || config.similarity_threshold > 1.0f) {
+        throw std::invalid_argument("similarity_threshold must be in range [0.0, 1.0]");
+    }
+    if (config.strong_match_threshold < config.weak_match_threshold) {
+        throw std::invalid_argument("strong_match_threshold must be >= weak_match_threshold");
+    }
+    if (config.search_mode == PatternMatcher::SearchMode::SKETCH_RERANK) {
+        BinarySketchIndex::Config sketch_config;
+        sketch_config.num_bits = config.sketch_bits;
+        if (!sketch_config.IsValid()) {
+            throw std::invalid_argument("sketch_bits must be a multiple of 64 in [64, 1024]");
+        }
+        if (config.rerank_depth == 0) {
+            throw std::invalid_argument("rerank_depth must be positive");
+        }
+    }
+}
+
+QueryOptions AllPatterns() {
+    QueryOptions options;
+    options.max_results = std::numeric_limits<size_t>::max();
+    return options;
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // PatternMatcher Implementation
 // ============================================================================
@@ -22,11 +53,10 @@ PatternMatcher::PatternMatcher(
     if (!metric_) {
         throw std::invalid_argument("PatternMatcher requires non-null metric");
     }
-    if (config_.similarity_threshold < 0.0f || config_.similarity_threshold > 1.0f) {
-        throw std::invalid_argument("similarity_threshold must be in range [0.0, 1.0]");
-    }
-    if (config_.strong_match_threshold < config_.weak_match_threshold) {
-        throw std::invalid_argument("strong_match_threshold must be >= weak_match_threshold");
+    ValidateConfig(config_);
+    search_ = std::make_shared<SimilaritySearch>(database_, metric_);
+    if (config_.search_mode == SearchMode::SKETCH_RERANK) {
+        BuildSketches();
     }
 }
 
@@ -37,13 +67,17 @@ PatternMatcher::PatternMatcher(
 }
 
 void PatternMatcher::SetConfig(const Config& config) {
-    if (config.similarity_threshold < 0.0f || config.similarity_threshold > 1.0f) {
-        throw std::invalid_argument("similarity_threshold must be in range [0.0, 1.0]");
-    }
-    if (config.strong_match_threshold < config.weak_match_threshold) {
-        throw std::invalid_argument("strong_match_threshold must be >= weak_match_threshold");
-    }
+    ValidateConfig(config);
+
+    std::unique_lock<std::shared_mutex> lock(sketch_mutex_);
+    bool rebuild = config.search_mode == SearchMode::SKETCH_RERANK &&
+                   (!sketches_ || sketches_->GetConfig().num_bits != config.sketch_bits);
     config_ = config;
+    if (config.search_mode != SearchMode::SKETCH_RERANK) {
+        sketches_.reset();
+    } else if (rebuild) {
+        BuildSketches();
+    }
 }
 
 void PatternMatcher::SetMetric(std::shared_ptr<SimilarityMetric> metric) {
@@ -51,16 +85,95 @@ void PatternMatcher::SetMetric(std::shared_ptr<SimilarityMetric> metric) {
         throw std::invalid_argument("PatternMatcher requires non-null metric");
     }
     metric_ = metric;
+    search_ = std::make_shared<SimilaritySearch>(database_, metric_);
+}
+
+void PatternMatcher::SetSearch(std::shared_ptr<SimilaritySearch> search) {
+    if (!search) {
+        throw std::invalid_argument("PatternMatcher requires non-null search");
+    }
+    if (search->GetDatabase() != database_) {
+        throw std::invalid_argument("Search must use the matcher's database");
+    }
+    metric_ = search->GetMetric();
+    search_ = std::move(search);
 }
 
 std::vector<PatternMatcher::Match> PatternMatcher::FindMatches(const PatternData& candidate) const {
+    if (config_.search_mode == SearchMode::EXHAUSTIVE) {
+        auto results = search_->RangeSearch(candidate, config_.similarity_threshold,
+                                             config_.max_matches);
+        const SimilaritySearch::Stats search_stats = search_->GetLastSearchStats();
+
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.queries++;
+        stats_.patterns_scanned += search_stats.patterns_evaluated;
+        stats_.patterns_scored += search_stats.patterns_evaluated - search_stats.patterns_pruned;
+        return ToMatches(results);
+    }
+
+    std::vector<PatternID> candidates;
+    size_t scanned = 0;
+    {
+        std::shared_lock<std::shared_mutex> lock(sketch_mutex_);
+        candidates = sketches_->Nearest(candidate.GetFeatures(), config_.rerank_depth);
+        scanned = sketches_->Size();
+    }
+
+    bool sample_recall = false;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.queries++;
+        stats_.patterns_scanned += scanned;
+        stats_.patterns_scored += candidates.size();
+        sample_recall = config_.recall_sample_interval > 0 &&
+                        stats_.queries % config_.recall_sample_interval == 0;
+    }
+
+    auto matches = ScoreCandidates(candidate, candidates);
+
+    if (sample_recall) {
+        auto expected = ScoreCandidates(candidate, database_->FindAll(AllPatterns()));
+        std::unordered_set<PatternID> found;
+        for (const auto& match : matches) {
+            found.insert(match.id);
+        }
+
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.recall_samples++;
+        stats_.recall_expected += expected.size();
+        for (const auto& match : expected) {
+            stats_.recall_found += found.count(match.id);
+        }
+    }
+
+    return matches;
+}
+
+std::vector<PatternMatcher::Match> PatternMatcher::ToMatches(
+    const std::vector<SearchResult>& results) const {
+
     std::vector<Match> matches;
+    matches.reserve(results.size());
+    for (const auto& result : results) {
+        auto node_opt = database_->Retrieve(result.pattern_id);
+        if (!node_opt) {
+            continue;
+        }
+        matches.emplace_back(result.pattern_id, result.similarity,
+                             ComputeConfidence(result.similarity, *node_opt));
+    }
+    return matches;
+}
+
+std::vector<PatternMatcher::Match> PatternMatcher::ScoreCandidates(
+    const PatternData& candidate,
+    const std::vector<PatternID>& ids) const {
 
-    // Get all pattern IDs from database
-    auto all_ids = database_->FindAll();
+    std::vector<Match> matches;
 
     // Compute similarity for each pattern
-    for (const auto& pattern_id : all_ids) {
+    for (const auto& pattern_id : ids) {
         auto node_opt = database_->Retrieve(pattern_id);
         if (!node_opt) {
             continue;
@@ -94,10 +207,111 @@ std::vector<PatternMatcher::Match> PatternMatcher::FindMatches(const PatternData
     return matches;
 }
 
+void PatternMatcher::BuildSketches() {
+    BinarySketchIndex::Config sketch_config;
+    sketch_config.num_bits = config_.sketch_bits;
+    sketches_ = std::make_unique<BinarySketchIndex>(sketch_config);
+
+    for (const auto& id : database_->FindAll(AllPatterns())) {
+        auto node_opt = database_->Retrieve(id);
+        if (node_opt) {
+            sketches_->Upsert(id, node_opt->GetData().GetFeatures());
+        }
+    }
+}
+
+void PatternMatcher::NotifyPatternChanged(PatternID id) {
+    search_->NotifyPatternChanged(id);
+
+    std::unique_lock<std::shared_mutex> lock(sketch_mutex_);
+    if (!sketches_) {
+        return;
+    }
+
+    auto node_opt = database_->Retrieve(id);
+    if (node_opt) {
+        sketches_->Upsert(id, node_opt->GetData().GetFeatures());
+    } else {
+        sketches_->Remove(id);
+    }
+}
+
+PatternMatcher::SearchStats PatternMatcher::GetSearchStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+void PatternMatcher::ResetSearchStats() {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_ = SearchStats{};
+}
+
+std::optional<PatternMatcher::Match> PatternMatcher::FindExactDuplicate(
+    const PatternData& candidate, uint64_t source_hash) const {
+
+    if (!content_index_) {
+        return std::nullopt;
+    }
+
+    for (const auto& id : content_index_->Lookup(candidate, source_hash)) {
+        auto node_opt = database_->Retrieve(id);
+        if (!node_opt) {
+            content_index_->Remove(id);
+            continue;
+        }
+        if (!(node_opt->GetData() == candidate)) {
+            // Changed behind the index's back (or a hash collision); the
+            // entry was found under this source, so re-key it with it
+            content_index_->Add(id, node_opt->GetData(), source_hash);
+            continue;
+        }
+        return Match(id, 1.0f, ComputeConfidence(1.0f, *node_opt));
+    }
+    return std::nullopt;
+}
+
 PatternMatcher::MatchDecision PatternMatcher::MakeDecision(const PatternData& candidate) const {
-    // Find matches
+    return Decide(FindMatches(candidate));
+}
+
+PatternMatcher::Evaluation PatternMatcher::Evaluate(const PatternData& candidate) const {
     auto matches = FindMatches(candidate);
+    auto decision = Decide(matches);
+    return Evaluation(std::move(matches), std::move(decision));
+}
+
+std::vector<PatternMatcher::Evaluation> PatternMatcher::EvaluateBatch(
+    const std::vector<PatternData>& candidates) const {
+
+    std::vector<Evaluation> evaluations;
+    evaluations.reserve(candidates.size());
+
+    if (config_.search_mode != SearchMode::EXHAUSTIVE || candidates.size() <= 1) {
+        for (const auto& candidate : candidates) {
+            evaluations.push_back(Evaluate(candidate));
+        }
+        return evaluations;
+    }
+
+    auto results = search_->RangeSearchBatch(candidates, config_.similarity_threshold,
+                                              config_.max_matches);
+    const SimilaritySearch::Stats search_stats = search_->GetLastSearchStats();
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.queries += candidates.size();
+        stats_.patterns_scanned += search_stats.patterns_evaluated;
+        stats_.patterns_scored += search_stats.patterns_evaluated - search_stats.patterns_pruned;
+    }
+
+    for (const auto& result : results) {
+        auto matches = ToMatches(result);
+        auto decision = Decide(matches);
+        evaluations.emplace_back(std::move(matches), std::move(decision));
+    }
+    return evaluations;
+}
 
+PatternMatcher::MatchDecision PatternMatcher::Decide(const std::vector<Match>& matches) const {
     // No matches found - create new pattern
     if (matches.empty()) {
         return MatchDecision(
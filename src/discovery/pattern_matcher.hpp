@@ -3,8 +3,13 @@
 
 #include "core/pattern_node.hpp"
 #include "similarity/similarity_metric.hpp"
+#include "discovery/content_hash_index.hpp"
+#include "similarity/binary_sketch_index.hpp"
+#include "similarity/similarity_search.hpp"
 #include "storage/pattern_database.hpp"
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -15,6 +20,12 @@ namespace dpan {
 /// about pattern creation, update, or merging.
 class PatternMatcher {
 public:
+    /// How FindMatches selects the patterns scored with the metric
+    enum class SearchMode {
+        EXHAUSTIVE,     ///< Range search over all stored patterns (exact scores)
+        SKETCH_RERANK   ///< Rank by binary sketch Hamming distance, score the nearest
+    };
+
     /// Configuration for pattern matching
     struct Config {
         /// Similarity threshold for considering a match (0.0 to 1.0)
@@ -34,6 +45,35 @@ public:
 
         /// Minimum confidence for decision making
         float min_confidence{0.5f};
+
+        /// Candidate selection strategy
+        SearchMode search_mode{SearchMode::EXHAUSTIVE};
+
+        /// Sketch length in bits for SKETCH_RERANK (multiple of 64, 64-1024)
+        size_t sketch_bits{128};
+
+        /// Number of sketch candidates re-ranked with the metric
+        size_t rerank_depth{256};
+
+        /// In SKETCH_RERANK mode, also run the exhaustive search on every
+        /// Nth query and record the recall of the sketch results (0 = never)
+        size_t recall_sample_interval{0};
+    };
+
+    /// Search statistics (cumulative)
+    struct SearchStats {
+        size_t queries{0};              ///< FindMatches calls
+        size_t patterns_scanned{0};     ///< Sketches compared (or patterns scored, exhaustive)
+        size_t patterns_scored{0};      ///< Metric evaluations
+        size_t recall_samples{0};       ///< Queries checked against the exhaustive search
+        size_t recall_expected{0};      ///< Exhaustive matches in sampled queries
+        size_t recall_found{0};         ///< Of those, also returned by the sketch search
+
+        /// Fraction of exhaustive matches found in sampled queries (1 if none sampled)
+        float Recall() const {
+            return recall_expected == 0 ? 1.0f
+                : static_cast<float>(recall_found) / static_cast<float>(recall_expected);
+        }
     };
 
     /// Match result containing pattern ID, similarity, and confidence
@@ -69,6 +109,16 @@ public:
             : decision(dec), existing_id(id), confidence(conf), reasoning(std::move(reason)) {}
     };
 
+    /// Matches and the decision derived from them
+    struct Evaluation {
+        std::vector<Match> matches;   ///< Sorted by similarity (highest first)
+        MatchDecision decision;       ///< Decision based on matches
+
+        /// Constructor
+        Evaluation(std::vector<Match> matches_, MatchDecision decision_)
+            : matches(std::move(matches_)), decision(std::move(decision_)) {}
+    };
+
     /// Constructor with configuration
     /// @param database Pattern database to search
     /// @param metric Similarity metric to use
@@ -92,11 +142,39 @@ public:
     /// @return Vector of matches sorted by similarity (highest first)
     std::vector<Match> FindMatches(const PatternData& candidate) const;
 
+    /// Find a stored pattern holding exactly the candidate's data
+    ///
+    /// Uses the content hash index set with SetContentIndex; no similarity
+    /// is computed. Index entries that no longer match the stored data are
+    /// repaired along the way.
+    /// @param candidate Pattern data to look up
+    /// @param source_hash ContentHashIndex::SourceHash() of the raw input the
+    ///        candidate was extracted from, or 0 to match on the data alone
+    /// @return Match with similarity 1, or nullopt (always without an index)
+    std::optional<Match> FindExactDuplicate(const PatternData& candidate,
+                                            uint64_t source_hash = 0) const;
+
     /// Make a decision about what to do with a candidate pattern
     /// @param candidate Pattern data to make decision for
     /// @return Decision with reasoning
     MatchDecision MakeDecision(const PatternData& candidate) const;
 
+    /// Find matches and make the decision from a single search
+    ///
+    /// Equivalent to calling FindMatches and MakeDecision, at the cost of one.
+    /// @param candidate Pattern data to evaluate
+    /// @return Matches and decision
+    Evaluation Evaluate(const PatternData& candidate) const;
+
+    /// Evaluate several candidates (e.g. all windows of one input)
+    ///
+    /// In EXHAUSTIVE mode the candidates share one pass over the database,
+    /// so each stored pattern is decoded once for the whole batch. All
+    /// candidates are evaluated against the database as it is on entry.
+    /// @param candidates Pattern data to evaluate
+    /// @return One evaluation per candidate, in order
+    std::vector<Evaluation> EvaluateBatch(const std::vector<PatternData>& candidates) const;
+
     /// Get current configuration
     const Config& GetConfig() const { return config_; }
 
@@ -106,11 +184,57 @@ public:
     /// Set similarity metric
     void SetMetric(std::shared_ptr<SimilarityMetric> metric);
 
+    /// Share a search engine (and whatever index it maintains) for
+    /// EXHAUSTIVE range queries
+    /// @param search Search over the same database; its metric replaces ours
+    /// @throws std::invalid_argument if search is null or uses another database
+    void SetSearch(std::shared_ptr<SimilaritySearch> search);
+
+    /// Report a pattern that was stored, updated or deleted
+    ///
+    /// Re-sketches it (or drops it once it no longer exists) and passes the
+    /// change on to the range search (see SimilaritySearch::NotifyPatternChanged).
+    /// Sketch searches only read the index, so every change made after the
+    /// matcher was configured must be reported here.
+    void NotifyPatternChanged(PatternID id);
+
+    /// Use a content hash index for FindExactDuplicate (null to disable)
+    void SetContentIndex(std::shared_ptr<ContentHashIndex> index) { content_index_ = std::move(index); }
+
+    /// Get cumulative search statistics
+    SearchStats GetSearchStats() const;
+
+    /// Reset search statistics
+    void ResetSearchStats();
+
 private:
     std::shared_ptr<PatternDatabase> database_;
     std::shared_ptr<SimilarityMetric> metric_;
+    std::shared_ptr<SimilaritySearch> search_;
+    std::shared_ptr<ContentHashIndex> content_index_;
     Config config_;
 
+    /// Sketches of stored patterns (SKETCH_RERANK only); searches share the
+    /// lock, NotifyPatternChanged and SetConfig take it exclusively
+    mutable std::shared_mutex sketch_mutex_;
+    std::unique_ptr<BinarySketchIndex> sketches_;
+
+    mutable std::mutex stats_mutex_;
+    mutable SearchStats stats_;
+
+    /// Decide from matches sorted by similarity
+    MatchDecision Decide(const std::vector<Match>& matches) const;
+
+    /// Attach confidences to search results
+    std::vector<Match> ToMatches(const std::vector<SearchResult>& results) const;
+
+    /// Score candidates with the metric and keep the best max_matches
+    std::vector<Match> ScoreCandidates(const PatternData& candidate,
+                                       const std::vector<PatternID>& ids) const;
+
+    /// Sketch every stored pattern (sketch_mutex_ must be held exclusively)
+    void BuildSketches();
+
     /// Compute confidence score for a match
     float ComputeConfidence(float similarity, const PatternNode& node) const;
 };
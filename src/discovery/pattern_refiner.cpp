@@ -1,5 +1,6 @@
 // File: src/discovery/pattern_refiner.cpp
 #include "pattern_refiner.hpp"
+#include "similarity/kmeans_clusterer.hpp"
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
@@ -41,11 +42,18 @@ bool PatternRefiner::UpdatePattern(PatternID id, const PatternData& new_data) {
         updated_node.AddSubPattern(sub_id);
     }
 
+    // New content: advance the generation so cached similarities go stale
+    updated_node.SetGeneration(node.GetGeneration() + 1);
+
     // Update the pattern in database
     return database_->Update(updated_node);
 }
 
-void PatternRefiner::AdjustConfidence(PatternID id, bool matched_correctly) {
+void PatternRefiner::AdjustConfidence(PatternID id, bool matched_correctly, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
     // Retrieve pattern
     auto node_opt = database_->Retrieve(id);
     if (!node_opt.has_value()) {
@@ -57,7 +65,8 @@ void PatternRefiner::AdjustConfidence(PatternID id, bool matched_correctly) {
     float current_confidence = node.GetConfidenceScore();
 
     // Adjust confidence
-    float adjustment = matched_correctly ? confidence_adjustment_rate_ : -confidence_adjustment_rate_;
+    float adjustment = (matched_correctly ? confidence_adjustment_rate_ : -confidence_adjustment_rate_) *
+                       static_cast<float>(count);
     float new_confidence = std::clamp(current_confidence + adjustment, 0.0f, 1.0f);
 
     node.SetConfidenceScore(new_confidence);
@@ -66,6 +75,12 @@ void PatternRefiner::AdjustConfidence(PatternID id, bool matched_correctly) {
     database_->Update(std::move(node));
 }
 
+void PatternRefiner::RecordInstance(PatternID id, const PatternData& instance) {
+    if (instance_reservoir_) {
+        instance_reservoir_->Add(id, instance.GetFeatures());
+    }
+}
+
 PatternRefiner::SplitResult PatternRefiner::SplitPattern(
     PatternID id,
     size_t num_clusters) {
@@ -85,12 +100,6 @@ PatternRefiner::SplitResult PatternRefiner::SplitPattern(
 
     const auto& node = node_opt.value();
 
-    // For demonstration, we'll create a simplified splitting approach
-    // In a real implementation, you would collect actual pattern instances/activations
-    // Here we'll create synthetic instances based on the pattern's feature vector
-
-    std::vector<PatternData> instances;
-
     // Get the pattern's data
     const auto& pattern_data = node.GetData();
     const auto& features = pattern_data.GetFeatures();
@@ -99,22 +108,41 @@ PatternRefiner::SplitResult PatternRefiner::SplitPattern(
         return result;
     }
 
-    // Create synthetic variations for splitting
-    // In practice, these would be actual recorded activations
-    // For now, create num_clusters variations by perturbing the original features
-    for (size_t i = 0; i < num_clusters; ++i) {
-        std::vector<float> perturbed_values;
-        float perturbation = (static_cast<float>(i) / num_clusters) - 0.5f; // Range: -0.5 to +0.5
-
-        for (size_t dim = 0; dim < features.Dimension(); ++dim) {
-            perturbed_values.push_back(features[dim] + perturbation);
+    // Prefer the instances the pattern actually matched
+    std::vector<PatternData> instances;
+    bool recorded = false;
+    if (instance_reservoir_) {
+        auto summary = instance_reservoir_->GetSummary(id);
+        if (summary && summary->count >= std::max(num_clusters, min_instances_for_split_)) {
+            for (auto& instance : instance_reservoir_->GetInstances(id)) {
+                if (instance.Dimension() == features.Dimension()) {
+                    instances.push_back(PatternData::FromFeatures(
+                        std::move(instance), pattern_data.GetModality()));
+                }
+            }
+            recorded = instances.size() >= num_clusters;
+            if (!recorded) {
+                instances.clear();
+            }
         }
+    }
 
-        FeatureVector perturbed_features(perturbed_values);
-        instances.push_back(PatternData::FromFeatures(perturbed_features, pattern_data.GetModality()));
+    // Without recorded instances, perturb the pattern's features into
+    // num_clusters synthetic variations
+    if (!recorded) {
+        for (size_t i = 0; i < num_clusters; ++i) {
+            std::vector<float> perturbed_values;
+            float perturbation = (static_cast<float>(i) / num_clusters) - 0.5f; // Range: -0.5 to +0.5
+
+            for (size_t dim = 0; dim < features.Dimension(); ++dim) {
+                perturbed_values.push_back(features[dim] + perturbation);
+            }
+
+            FeatureVector perturbed_features(perturbed_values);
+            instances.push_back(PatternData::FromFeatures(perturbed_features, pattern_data.GetModality()));
+        }
     }
 
-    // Cluster the synthetic instances
     auto clusters = ClusterInstances(instances, num_clusters);
 
     if (clusters.empty()) {
@@ -139,11 +167,23 @@ PatternRefiner::SplitResult PatternRefiner::SplitPattern(
             // Store new pattern
             if (database_->Store(new_node)) {
                 result.new_pattern_ids.push_back(new_id);
+
+                // Sub-patterns start from the instances they were built from
+                if (recorded) {
+                    for (const auto& instance : cluster) {
+                        instance_reservoir_->Add(new_id, instance.GetFeatures());
+                    }
+                }
             }
         }
     }
 
     result.success = !result.new_pattern_ids.empty();
+
+    // The split used up the pattern's evidence; collect afresh
+    if (result.success && recorded) {
+        instance_reservoir_->Remove(id);
+    }
     return result;
 }
 
@@ -243,10 +283,16 @@ bool PatternRefiner::NeedsSplitting(PatternID id) const {
         return false;
     }
 
-    // For this implementation, we'll use a simple heuristic:
-    // A pattern needs splitting if it has low confidence
-    // In practice, you would collect activation instances and compute variance
+    // Recorded instances show directly whether the pattern is too general
+    if (instance_reservoir_) {
+        auto summary = instance_reservoir_->GetSummary(id);
+        if (summary && summary->count >= std::max<size_t>(1, min_instances_for_split_)) {
+            return summary->variance > variance_threshold_;
+        }
+    }
 
+    // Otherwise use a simple heuristic: a pattern needs splitting if it has
+    // low confidence
     const auto& node = node_opt.value();
     float confidence = node.GetConfidenceScore();
 
@@ -272,14 +318,18 @@ bool PatternRefiner::ShouldMerge(PatternID id1, PatternID id2) const {
     }
 
     // Compute similarity between patterns
-    const auto& data1 = node1.GetData();
-    const auto& data2 = node2.GetData();
+    auto compute = [&]() {
+        float distance = ComputeDistance(node1.GetData(), node2.GetData());
 
-    float distance = ComputeDistance(data1, data2);
+        // Convert distance to similarity (inverse relationship)
+        // If distance is small, similarity is high
+        return 1.0f / (1.0f + distance);
+    };
 
-    // Convert distance to similarity (inverse relationship)
-    // If distance is small, similarity is high
-    float similarity = 1.0f / (1.0f + distance);
+    float similarity = similarity_cache_
+        ? similarity_cache_->GetOrCompute(node1, node2, "PatternRefiner.distance",
+                                          true, "PatternRefiner", compute)
+        : compute();
 
     return similarity >= merge_similarity_threshold_;
 }
@@ -321,9 +371,6 @@ std::vector<std::vector<PatternData>> PatternRefiner::ClusterInstances(
         return {};
     }
 
-    // For simplicity, use a basic k-means-like approach
-    // In practice, you'd use a more sophisticated clustering algorithm
-
     std::vector<std::vector<PatternData>> clusters(num_clusters);
 
     // If we have fewer instances than clusters, put each in its own cluster
@@ -334,28 +381,32 @@ std::vector<std::vector<PatternData>> PatternRefiner::ClusterInstances(
         return clusters;
     }
 
-    // Initialize centroids (use first k instances)
-    std::vector<PatternData> centroids;
-    for (size_t i = 0; i < num_clusters && i < instances.size(); ++i) {
-        centroids.push_back(instances[i]);
-    }
-
-    // Simple k-means iteration (just one iteration for simplicity)
+    // Features are decoded once into a contiguous matrix
+    const size_t n = instances.size();
+    const size_t dim = instances[0].GetFeatures().Dimension();
+    std::vector<float> points;
+    points.reserve(n * dim);
     for (const auto& instance : instances) {
-        // Find closest centroid
-        size_t closest_cluster = 0;
-        float min_distance = std::numeric_limits<float>::max();
-
-        for (size_t i = 0; i < centroids.size(); ++i) {
-            float dist = ComputeDistance(instance, centroids[i]);
-            if (dist < min_distance) {
-                min_distance = dist;
-                closest_cluster = i;
-            }
+        FeatureVector features = instance.GetFeatures();
+        if (features.Dimension() != dim) {
+            throw std::invalid_argument("All instances must have same feature dimension");
         }
+        points.insert(points.end(), features.Data().begin(), features.Data().end());
+    }
+    if (dim == 0) {
+        clusters[0] = instances;
+        return clusters;
+    }
+
+    KMeansClusterer::Config config;
+    config.num_clusters = num_clusters;
+    config.algorithm = KMeansClusterer::Algorithm::LLOYD;  // Reservoir-sized inputs
+    config.max_iterations = 25;
+    config.tolerance = 0.0f;
+    auto result = KMeansClusterer(config).Run(points.data(), n, dim);
 
-        // Assign to closest cluster
-        clusters[closest_cluster].push_back(instance);
+    for (size_t i = 0; i < n; ++i) {
+        clusters[result.assignments[i]].push_back(instances[i]);
     }
 
     return clusters;
@@ -440,20 +491,14 @@ float PatternRefiner::ComputeDistance(const PatternData& data1, const PatternDat
 }
 
 PatternID PatternRefiner::GenerateNewPatternID() const {
-    // Get all existing pattern IDs
-    auto all_ids = database_->FindAll();
-
-    if (all_ids.empty()) {
-        return PatternID(1);
-    }
-
-    // Find maximum ID
-    uint64_t max_id = 0;
-    for (const auto& id : all_ids) {
-        max_id = std::max(max_id, id.value());
-    }
-
-    return PatternID(max_id + 1);
+    // Process-wide counter, skipping IDs already stored (by PatternCreator
+    // or a reopened database); the counter only grows, so each stored ID
+    // is skipped at most once
+    PatternID id = PatternID::Generate();
+    while (database_->Exists(id)) {
+        id = PatternID::Generate();
+    }
+    return id;
 }
 
 } // namespace dpan
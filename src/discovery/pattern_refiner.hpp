@@ -3,6 +3,8 @@
 
 #include "core/pattern_node.hpp"
 #include "storage/pattern_database.hpp"
+#include "similarity/pairwise_similarity_cache.hpp"
+#include "discovery/instance_reservoir.hpp"
 #include <memory>
 #include <vector>
 
@@ -42,9 +44,24 @@ public:
     /// Adjust confidence based on match results
     /// @param id Pattern ID
     /// @param matched_correctly true if pattern matched correctly, false if it was a mismatch
-    void AdjustConfidence(PatternID id, bool matched_correctly);
+    /// @param count Number of match results to apply at once (one database update)
+    void AdjustConfidence(PatternID id, bool matched_correctly, size_t count = 1);
+
+    /// Record an input that was matched to an existing pattern
+    ///
+    /// Kept in the instance reservoir (if one is set) for NeedsSplitting and
+    /// SplitPattern.
+    /// @param id Pattern the input matched
+    /// @param instance Matched input
+    void RecordInstance(PatternID id, const PatternData& instance);
 
     /// Split a pattern into multiple sub-patterns
+    ///
+    /// With at least max(num_clusters, min_instances_for_split) recorded
+    /// instances the sampled instances are clustered with k-means, each
+    /// sub-pattern starts from its cluster's instances, and the pattern's
+    /// own instances are cleared. Otherwise the pattern's features are
+    /// perturbed into num_clusters synthetic instances.
     /// @param id Pattern ID to split
     /// @param num_clusters Number of clusters to create (default: 2)
     /// @return SplitResult containing new pattern IDs
@@ -56,6 +73,12 @@ public:
     MergeResult MergePatterns(const std::vector<PatternID>& pattern_ids);
 
     /// Check if pattern needs splitting
+    ///
+    /// With at least min_instances_for_split recorded instances, a pattern
+    /// needs splitting when their variance (mean squared distance from
+    /// their mean) exceeds the variance threshold. Without that evidence,
+    /// low confidence (< 0.3) is taken as a sign of an overly general
+    /// pattern.
     /// @param id Pattern ID to check
     /// @return true if pattern should be split
     bool NeedsSplitting(PatternID id) const;
@@ -94,8 +117,28 @@ public:
     /// Get confidence adjustment rate
     float GetConfidenceAdjustmentRate() const { return confidence_adjustment_rate_; }
 
+    /// Share a pairwise similarity cache used by ShouldMerge
+    /// @param cache Cache instance (nullptr disables caching)
+    void SetSimilarityCache(std::shared_ptr<PairwiseSimilarityCache> cache) {
+        similarity_cache_ = std::move(cache);
+    }
+
+    /// Get the shared pairwise similarity cache (may be null)
+    std::shared_ptr<PairwiseSimilarityCache> GetSimilarityCache() const { return similarity_cache_; }
+
+    /// Share a store of matched instances
+    /// @param reservoir Reservoir instance (nullptr disables recording)
+    void SetInstanceReservoir(std::shared_ptr<InstanceReservoir> reservoir) {
+        instance_reservoir_ = std::move(reservoir);
+    }
+
+    /// Get the instance reservoir (may be null)
+    std::shared_ptr<InstanceReservoir> GetInstanceReservoir() const { return instance_reservoir_; }
+
 private:
     std::shared_ptr<PatternDatabase> database_;
+    std::shared_ptr<PairwiseSimilarityCache> similarity_cache_;
+    std::shared_ptr<InstanceReservoir> instance_reservoir_;
 
     // Splitting criteria
     float variance_threshold_{0.5f};
@@ -107,7 +150,8 @@ private:
     // Confidence adjustment
     float confidence_adjustment_rate_{0.1f};  // How much to adjust per update
 
-    /// Cluster pattern instances for splitting
+    /// Cluster pattern instances for splitting with KMeansClusterer
+    /// (k-means++ seeding with a fixed seed, Lloyd iterations)
     /// @param instances Pattern data instances
     /// @param num_clusters Number of clusters to create
     /// @return Vector of clusters, each containing pattern data instances
@@ -132,7 +176,7 @@ private:
     /// @return Distance value
     float ComputeDistance(const PatternData& data1, const PatternData& data2) const;
 
-    /// Generate a new unique pattern ID
+    /// Generate a new unique pattern ID without scanning the database
     /// @return New pattern ID
     PatternID GenerateNewPatternID() const;
 };
@@ -0,0 +1,256 @@
+// File: src/discovery/spectral_extractor.cpp
+#include "discovery/spectral_extractor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace dpan {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+double HzToMel(double hz) {
+    return 2595.0 * std::log10(1.0 + hz / 700.0);
+}
+
+double MelToHz(double mel) {
+    return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0);
+}
+
+} // anonymous namespace
+
+SpectralExtractor::SpectralExtractor(const Config& config) : config_(config) {
+    if (config_.frame_size == 0) {
+        throw std::invalid_argument("frame_size must be greater than 0");
+    }
+    if (config_.mel_bands == 0) {
+        throw std::invalid_argument("mel_bands must be greater than 0");
+    }
+    if (config_.feature_dimension == 0) {
+        throw std::invalid_argument("feature_dimension must be greater than 0");
+    }
+    if (config_.mfcc_coefficients > config_.mel_bands) {
+        throw std::invalid_argument("mfcc_coefficients cannot exceed mel_bands");
+    }
+    if (!(config_.sample_rate > 0.0)) {
+        throw std::invalid_argument("sample_rate must be positive");
+    }
+    const double nyquist = config_.sample_rate / 2.0;
+    if (config_.max_frequency == 0.0) {
+        config_.max_frequency = nyquist;
+    }
+    if (config_.min_frequency < 0.0 || config_.max_frequency > nyquist ||
+        config_.min_frequency >= config_.max_frequency) {
+        throw std::invalid_argument("frequency range must lie within [0, sample_rate / 2]");
+    }
+
+    fft_size_ = 4;
+    while (fft_size_ < config_.frame_size) {
+        fft_size_ <<= 1;
+    }
+    half_size_ = fft_size_ / 2;
+
+    window_.resize(config_.frame_size);
+    for (size_t i = 0; i < config_.frame_size; ++i) {
+        window_[i] = static_cast<float>(
+            0.5 - 0.5 * std::cos(2.0 * kPi * static_cast<double>(i) /
+                                 static_cast<double>(config_.frame_size)));
+    }
+
+    size_t bits = 0;
+    while ((size_t{1} << bits) < half_size_) {
+        ++bits;
+    }
+    bit_reverse_.resize(half_size_);
+    for (size_t n = 0; n < half_size_; ++n) {
+        size_t reversed = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            reversed |= ((n >> b) & 1) << (bits - 1 - b);
+        }
+        bit_reverse_[n] = reversed;
+    }
+
+    // Stage with butterflies of span `half` uses exp(-pi i j / half), j < half
+    for (size_t half = 1; half < half_size_; half <<= 1) {
+        for (size_t j = 0; j < half; ++j) {
+            const double angle = -kPi * static_cast<double>(j) / static_cast<double>(half);
+            twiddle_re_.push_back(static_cast<float>(std::cos(angle)));
+            twiddle_im_.push_back(static_cast<float>(std::sin(angle)));
+        }
+    }
+
+    split_re_.resize(half_size_ + 1);
+    split_im_.resize(half_size_ + 1);
+    for (size_t k = 0; k <= half_size_; ++k) {
+        const double angle = -2.0 * kPi * static_cast<double>(k) / static_cast<double>(fft_size_);
+        split_re_[k] = static_cast<float>(std::cos(angle));
+        split_im_[k] = static_cast<float>(std::sin(angle));
+    }
+
+    BuildFilterbank();
+
+    if (config_.mfcc_coefficients > 0) {
+        const size_t bands = config_.mel_bands;
+        dct_.resize(config_.mfcc_coefficients * bands);
+        for (size_t k = 0; k < config_.mfcc_coefficients; ++k) {
+            const double scale = std::sqrt((k == 0 ? 1.0 : 2.0) / static_cast<double>(bands));
+            for (size_t b = 0; b < bands; ++b) {
+                dct_[k * bands + b] = static_cast<float>(
+                    scale * std::cos(kPi * static_cast<double>(k) *
+                                     (static_cast<double>(b) + 0.5) / static_cast<double>(bands)));
+            }
+        }
+    }
+
+    padded_.assign(fft_size_, 0.0f);
+    re_.resize(half_size_);
+    im_.resize(half_size_);
+    power_.resize(half_size_ + 1);
+    mel_.resize(config_.mel_bands);
+}
+
+void SpectralExtractor::BuildFilterbank() {
+    const size_t bands = config_.mel_bands;
+    const double low_mel = HzToMel(config_.min_frequency);
+    const double high_mel = HzToMel(config_.max_frequency);
+
+    std::vector<double> edges(bands + 2);
+    for (size_t i = 0; i < edges.size(); ++i) {
+        edges[i] = MelToHz(low_mel + (high_mel - low_mel) * static_cast<double>(i) /
+                                         static_cast<double>(bands + 1));
+    }
+
+    const double bin_hz = config_.sample_rate / static_cast<double>(fft_size_);
+    bands_.resize(bands);
+    for (size_t b = 0; b < bands; ++b) {
+        const double low = edges[b];
+        const double center = edges[b + 1];
+        const double high = edges[b + 2];
+
+        MelBand band{0, band_weights_.size(), 0};
+        for (size_t k = 0; k <= half_size_; ++k) {
+            const double hz = static_cast<double>(k) * bin_hz;
+            if (hz <= low || hz >= high) {
+                continue;
+            }
+            const double weight = hz <= center ? (hz - low) / (center - low)
+                                               : (high - hz) / (high - center);
+            if (band.weight_count == 0) {
+                band.first_bin = k;
+            }
+            band_weights_.push_back(static_cast<float>(weight));
+            ++band.weight_count;
+        }
+        bands_[b] = band;
+    }
+}
+
+void SpectralExtractor::ComputePowerSpectrum(const float* frame) {
+    // Windowed frame; the zero padding past frame_size is never written
+    for (size_t i = 0; i < config_.frame_size; ++i) {
+        padded_[i] = frame[i] * window_[i];
+    }
+
+    // Even samples as real parts, odd samples as imaginary parts
+    float* re = re_.data();
+    float* im = im_.data();
+    for (size_t n = 0; n < half_size_; ++n) {
+        const size_t slot = bit_reverse_[n];
+        re[slot] = padded_[2 * n];
+        im[slot] = padded_[2 * n + 1];
+    }
+
+    // In-place radix-2 decimation in time
+    size_t offset = 0;
+    for (size_t half = 1; half < half_size_; offset += half, half <<= 1) {
+        const float* wr = twiddle_re_.data() + offset;
+        const float* wi = twiddle_im_.data() + offset;
+        for (size_t start = 0; start < half_size_; start += 2 * half) {
+            for (size_t j = 0; j < half; ++j) {
+                const size_t a = start + j;
+                const size_t b = a + half;
+                const float tr = re[b] * wr[j] - im[b] * wi[j];
+                const float ti = re[b] * wi[j] + im[b] * wr[j];
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+
+    // Split the packed transform into the spectra of the even and odd
+    // samples and combine them: X_k = E_k + exp(-2 pi i k / N) O_k
+    const float scale = 1.0f / static_cast<float>(fft_size_);
+    for (size_t k = 0; k <= half_size_; ++k) {
+        const size_t p = k == half_size_ ? 0 : k;
+        const size_t q = k == 0 ? 0 : half_size_ - k;
+        const float even_re = 0.5f * (re[p] + re[q]);
+        const float even_im = 0.5f * (im[p] - im[q]);
+        const float odd_re = 0.5f * (im[p] + im[q]);
+        const float odd_im = -0.5f * (re[p] - re[q]);
+        const float x_re = even_re + split_re_[k] * odd_re - split_im_[k] * odd_im;
+        const float x_im = even_im + split_re_[k] * odd_im + split_im_[k] * odd_re;
+        power_[k] = (x_re * x_re + x_im * x_im) * scale;
+    }
+}
+
+void SpectralExtractor::ComputeFrame(const float* frame, float* features) {
+    ComputePowerSpectrum(frame);
+
+    const size_t bands = config_.mel_bands;
+    const bool take_log = config_.log_compress || config_.mfcc_coefficients > 0;
+    for (size_t b = 0; b < bands; ++b) {
+        const MelBand& band = bands_[b];
+        const float* weights = band_weights_.data() + band.weight_offset;
+        const float* bins = power_.data() + band.first_bin;
+        float energy = 0.0f;
+        for (size_t i = 0; i < band.weight_count; ++i) {
+            energy += weights[i] * bins[i];
+        }
+        mel_[b] = take_log ? std::log(std::max(energy, 1e-10f)) : energy;
+    }
+
+    const float* values = mel_.data();
+    size_t produced = bands;
+    if (config_.mfcc_coefficients > 0) {
+        // Coefficients go straight to the output
+        produced = std::min(config_.mfcc_coefficients, config_.feature_dimension);
+        for (size_t k = 0; k < produced; ++k) {
+            const float* row = dct_.data() + k * bands;
+            float sum = 0.0f;
+            for (size_t b = 0; b < bands; ++b) {
+                sum += row[b] * mel_[b];
+            }
+            features[k] = sum;
+        }
+        values = features;
+    }
+
+    const size_t copied = std::min(produced, config_.feature_dimension);
+    if (values != features) {
+        std::copy(values, values + copied, features);
+    }
+    std::fill(features + copied, features + config_.feature_dimension, 0.0f);
+}
+
+std::vector<FeatureVector> SpectralExtractor::Extract(const float* samples, size_t count) {
+    std::vector<FeatureVector> frames;
+    if (samples == nullptr || count < config_.frame_size) {
+        return frames;
+    }
+
+    const size_t hop = config_.hop_size > 0 ?
+        config_.hop_size : std::max<size_t>(1, config_.frame_size / 4);
+    const size_t windows = (count - config_.frame_size) / hop + 1;
+    frames.reserve(windows);
+    for (size_t k = 0; k < windows; ++k) {
+        std::vector<float> features(config_.feature_dimension);
+        ComputeFrame(samples + k * hop, features.data());
+        frames.emplace_back(std::move(features));
+    }
+    return frames;
+}
+
+} // namespace dpan
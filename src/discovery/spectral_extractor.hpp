@@ -0,0 +1,123 @@
+// File: src/discovery/spectral_extractor.hpp
+#pragma once
+
+#include "core/pattern_data.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace dpan {
+
+/// SpectralExtractor - Mel spectrum and MFCC features of audio frames
+///
+/// Each frame is multiplied by a periodic Hann window, zero-padded to the
+/// next power of two and transformed with a real FFT (a complex radix-2 FFT
+/// of half the size plus a split step). The power spectrum |X_k|^2 / fft_size
+/// is pooled by triangular filters equally spaced on the mel scale
+/// (HTK: mel = 2595 log10(1 + f / 700)), optionally log-compressed and
+/// decorrelated with an orthonormal DCT-II into MFCCs.
+///
+/// Everything that depends only on the configuration (bit reversal,
+/// twiddles, window, filterbank, DCT matrix) is computed once in the
+/// constructor, and per-frame work runs in member scratch buffers, so
+/// ComputeFrame does not allocate.
+///
+/// Features are the mel energies (or MFCCs), zero-padded or truncated to
+/// feature_dimension. Bands narrower than one FFT bin receive no energy;
+/// choose fewer bands for short frames.
+///
+/// Thread-safety: Not thread-safe; scratch buffers are reused across frames.
+/// Use one instance per thread.
+class SpectralExtractor {
+public:
+    /// Configuration for spectral extraction
+    struct Config {
+        /// Sampling rate in Hz
+        double sample_rate{16000.0};
+
+        /// Samples per frame (the FFT size is the next power of two)
+        size_t frame_size{400};
+
+        /// Samples between frame starts in Extract (0 = frame_size / 4)
+        size_t hop_size{0};
+
+        /// Number of mel filters
+        size_t mel_bands{40};
+
+        /// Filterbank range in Hz (max_frequency 0 = Nyquist)
+        double min_frequency{0.0};
+        double max_frequency{0.0};
+
+        /// Take the natural log of the mel energies (floored at 1e-10)
+        bool log_compress{true};
+
+        /// DCT coefficients kept as MFCCs (0 = output mel energies); MFCCs
+        /// are always computed from log energies
+        size_t mfcc_coefficients{0};
+
+        /// Length of each frame's feature vector
+        size_t feature_dimension{128};
+    };
+
+    /// Constructor
+    /// @param config Spectral configuration
+    /// @throws std::invalid_argument if frame_size, mel_bands or
+    ///         feature_dimension is 0, mfcc_coefficients exceeds mel_bands,
+    ///         or the frequency range is empty or above Nyquist
+    explicit SpectralExtractor(const Config& config);
+
+    /// Compute the features of one frame
+    /// @param frame frame_size samples
+    /// @param features Output, feature_dimension values
+    void ComputeFrame(const float* frame, float* features);
+
+    /// Extract every complete frame [k * hop, k * hop + frame_size)
+    /// @param samples Audio samples
+    /// @param count Number of samples
+    /// @return Feature vectors in frame order (empty if count < frame_size)
+    std::vector<FeatureVector> Extract(const float* samples, size_t count);
+
+    /// Power spectrum of the last computed frame (fft_size / 2 + 1 bins)
+    const std::vector<float>& GetPowerSpectrum() const { return power_; }
+
+    /// Transform length
+    size_t GetFFTSize() const { return fft_size_; }
+
+    /// Get current configuration
+    const Config& GetConfig() const { return config_; }
+
+private:
+    /// Triangular mel filter over bins [first_bin, first_bin + weight_count)
+    struct MelBand {
+        size_t first_bin;
+        size_t weight_offset;
+        size_t weight_count;
+    };
+
+    void BuildFilterbank();
+
+    /// Window, pack and transform a frame into power_
+    void ComputePowerSpectrum(const float* frame);
+
+    Config config_;
+    size_t fft_size_{0};
+    size_t half_size_{0};  // Complex transform length
+
+    std::vector<float> window_;                // frame_size Hann coefficients
+    std::vector<size_t> bit_reverse_;          // half_size_ permutation
+    std::vector<float> twiddle_re_;            // Per stage, stages concatenated
+    std::vector<float> twiddle_im_;
+    std::vector<float> split_re_;              // exp(-2 pi i k / fft_size)
+    std::vector<float> split_im_;
+    std::vector<MelBand> bands_;
+    std::vector<float> band_weights_;
+    std::vector<float> dct_;                   // mfcc_coefficients x mel_bands
+
+    // Per-frame scratch
+    std::vector<float> padded_;
+    std::vector<float> re_;
+    std::vector<float> im_;
+    std::vector<float> power_;
+    std::vector<float> mel_;
+};
+
+} // namespace dpan
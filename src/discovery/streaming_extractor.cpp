@@ -0,0 +1,156 @@
+// File: src/discovery/streaming_extractor.cpp
+#include "streaming_extractor.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace dpan {
+
+// ============================================================================
+// StreamingExtractor Implementation
+// ============================================================================
+
+StreamingExtractor::StreamingExtractor(const Config& config)
+    : config_(config),
+      extractor_(config.extraction),
+      text_(config.extraction.modality == DataModality::TEXT),
+      bytes_per_sample_(text_ || config.format == SampleFormat::UINT8 ? 1 : sizeof(float)) {
+
+    window_size_ = config_.extraction.max_pattern_size / bytes_per_sample_;
+    if (window_size_ == 0) {
+        throw std::invalid_argument("max_pattern_size must hold at least one sample");
+    }
+    if (window_size_ * bytes_per_sample_ < config_.extraction.min_pattern_size) {
+        throw std::invalid_argument("Streaming window is smaller than min_pattern_size");
+    }
+
+    if (config_.hop_samples > 0) {
+        hop_size_ = config_.hop_samples;
+    } else {
+        // Same overlap as Extract: 75% for audio, 50% otherwise
+        size_t divisor = config_.extraction.modality == DataModality::AUDIO ? 4 : 2;
+        hop_size_ = std::max<size_t>(1, window_size_ / divisor);
+    }
+
+    const DataModality modality = config_.extraction.modality;
+    if (config_.extraction.window_selection ==
+            PatternExtractor::WindowSelection::CHANGE_POINTS &&
+        (modality == DataModality::NUMERIC || modality == DataModality::AUDIO)) {
+        detector_.emplace(config_.extraction.change_points);
+    }
+
+    Reset();
+}
+
+void StreamingExtractor::Reset() {
+    if (text_) {
+        bytes_.Reset(window_size_);
+    } else {
+        samples_.Reset(window_size_);
+    }
+    partial_size_ = 0;
+    samples_consumed_ = 0;
+    next_window_start_ = 0;
+    windows_emitted_ = 0;
+    patterns_emitted_ = 0;
+    if (detector_) {
+        detector_->Reset();
+    }
+}
+
+void StreamingExtractor::Feed(const uint8_t* data, size_t size,
+                              const WindowCallback& on_window) {
+    size_t i = 0;
+
+    if (bytes_per_sample_ == 1) {
+        for (; i < size; ++i) {
+            PushSample(static_cast<float>(data[i]) / 255.0f, data[i], on_window);
+        }
+        return;
+    }
+
+    // Complete a float split across the previous chunk boundary
+    while (partial_size_ > 0 && i < size) {
+        partial_[partial_size_++] = data[i++];
+        if (partial_size_ == sizeof(float)) {
+            float value;
+            std::memcpy(&value, partial_, sizeof(float));
+            partial_size_ = 0;
+            PushSample(value, 0, on_window);
+        }
+    }
+
+    for (; i + sizeof(float) <= size; i += sizeof(float)) {
+        float value;
+        std::memcpy(&value, data + i, sizeof(float));
+        PushSample(value, 0, on_window);
+    }
+
+    // Keep the tail for the next chunk
+    for (; i < size; ++i) {
+        partial_[partial_size_++] = data[i];
+    }
+}
+
+void StreamingExtractor::PushSample(float sample, uint8_t byte,
+                                    const WindowCallback& on_window) {
+    if (text_) {
+        bytes_.Push(byte);
+    } else {
+        samples_.Push(sample);
+    }
+    ++samples_consumed_;
+
+    if (samples_consumed_ != next_window_start_ + window_size_) {
+        return;
+    }
+
+    WindowView view;
+    view.size = window_size_;
+    view.start = next_window_start_;
+    if (text_) {
+        view.bytes = bytes_.Last(window_size_);
+    } else {
+        view.samples = samples_.Last(window_size_);
+    }
+
+    next_window_start_ += hop_size_;
+    ++windows_emitted_;
+    on_window(view);
+}
+
+std::vector<PatternData> StreamingExtractor::Push(const uint8_t* data, size_t size) {
+    std::vector<PatternData> patterns;
+    Feed(data, size, [this, &patterns](const WindowView& window) {
+        if (detector_ && !detector_->Update(window.samples, window.size)) {
+            return;
+        }
+        auto pattern = ExtractWindow(window);
+        if (pattern) {
+            patterns.push_back(std::move(*pattern));
+            ++patterns_emitted_;
+        }
+    });
+    return patterns;
+}
+
+std::optional<PatternData> StreamingExtractor::ExtractWindow(const WindowView& window) const {
+    if (window.bytes) {
+        return extractor_.ExtractTextWindow(window.bytes, window.size);
+    }
+    return extractor_.ExtractWindow(window.samples, window.size);
+}
+
+double StreamingExtractor::GetPatternsPerSecond(double sample_rate) const {
+    if (samples_consumed_ == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(patterns_emitted_) * sample_rate /
+           static_cast<double>(samples_consumed_);
+}
+
+size_t StreamingExtractor::GetBufferBytes() const {
+    return samples_.data.capacity() * sizeof(float) + bytes_.data.capacity();
+}
+
+} // namespace dpan
@@ -0,0 +1,170 @@
+// File: src/discovery/streaming_extractor.hpp
+#pragma once
+
+#include "discovery/pattern_extractor.hpp"
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace dpan {
+
+/// StreamingExtractor - Incremental pattern extraction over a byte stream
+///
+/// Accepts input in arbitrary chunks and emits fixed-size windows as soon
+/// as they complete, so unbounded sensor or audio feeds can be processed
+/// with constant memory. Samples are kept in a mirrored ring buffer (each
+/// sample is written twice, capacity apart), which makes the most recent
+/// window contiguous: windows are handed out as views into the ring, never
+/// copied.
+///
+/// Window size and hop follow PatternExtractor::Extract for an input of at
+/// least max_pattern_size bytes: max_pattern_size bytes per window, a hop
+/// of half a window (a quarter for AUDIO). Unlike Extract, which guesses
+/// the sample encoding from the input length, the stream encoding is set
+/// explicitly; TEXT streams are always treated as bytes.
+///
+/// With WindowSelection::CHANGE_POINTS, Push runs the change-point detector
+/// over every NUMERIC / AUDIO window in stream order and extracts only the
+/// windows it selects, matching batch Extract over the same samples.
+///
+/// Thread-safety: Not thread-safe; use one instance per stream.
+class StreamingExtractor {
+public:
+    /// Encoding of NUMERIC / AUDIO / IMAGE samples in the stream
+    enum class SampleFormat {
+        FLOAT32,  ///< Native-endian 32-bit floats
+        UINT8     ///< Bytes, scaled to [0, 1]
+    };
+
+    /// Configuration for streaming extraction
+    struct Config {
+        /// Modality, window size (max_pattern_size), noise threshold and
+        /// feature dimension
+        PatternExtractor::Config extraction;
+
+        /// Sample encoding (ignored for TEXT)
+        SampleFormat format{SampleFormat::FLOAT32};
+
+        /// Samples between window starts (0 = modality default)
+        size_t hop_samples{0};
+    };
+
+    /// A completed window; only valid during the callback
+    struct WindowView {
+        const float* samples{nullptr};   ///< Decoded samples (null for TEXT)
+        const uint8_t* bytes{nullptr};   ///< Raw bytes (TEXT only)
+        size_t size{0};                  ///< Samples (or bytes) in the window
+        uint64_t start{0};               ///< Stream position of the first sample
+    };
+
+    using WindowCallback = std::function<void(const WindowView&)>;
+
+    /// Constructor
+    /// @param config Streaming configuration
+    /// @throws std::invalid_argument if a window would hold no complete
+    ///         sample or be smaller than min_pattern_size
+    explicit StreamingExtractor(const Config& config);
+
+    /// Consume a chunk, invoking a callback for every window it completes
+    /// @param data Chunk bytes (a sample may be split across chunks)
+    /// @param size Chunk size in bytes
+    /// @param on_window Called in stream order with a view of each window
+    void Feed(const uint8_t* data, size_t size, const WindowCallback& on_window);
+
+    /// Consume a chunk and extract the windows it completes
+    /// @param data Chunk bytes
+    /// @param size Chunk size in bytes
+    /// @return Patterns of the completed windows (noise-filtered as in Extract)
+    std::vector<PatternData> Push(const uint8_t* data, size_t size);
+
+    /// Consume a chunk and extract the windows it completes
+    std::vector<PatternData> Push(const std::vector<uint8_t>& chunk) {
+        return Push(chunk.data(), chunk.size());
+    }
+
+    /// Extract the pattern of a window view
+    /// @return Pattern, or nullopt if the window is filtered as noise
+    std::optional<PatternData> ExtractWindow(const WindowView& window) const;
+
+    /// Forget all buffered input and restart at stream position 0
+    void Reset();
+
+    /// Samples per window
+    size_t GetWindowSize() const { return window_size_; }
+
+    /// Samples between window starts
+    size_t GetHopSize() const { return hop_size_; }
+
+    /// Samples consumed so far
+    uint64_t GetSamplesConsumed() const { return samples_consumed_; }
+
+    /// Windows emitted so far
+    uint64_t GetWindowsEmitted() const { return windows_emitted_; }
+
+    /// Patterns returned by Push so far
+    uint64_t GetPatternsEmitted() const { return patterns_emitted_; }
+
+    /// Patterns returned by Push per second of consumed input
+    /// @param sample_rate Samples per second of the stream
+    /// @return Patterns per input second (0 before any input)
+    double GetPatternsPerSecond(double sample_rate) const;
+
+    /// Heap bytes held by the ring buffer (independent of stream length)
+    size_t GetBufferBytes() const;
+
+    /// Get configuration
+    const Config& GetConfig() const { return config_; }
+
+private:
+    /// Ring buffer storing every element at i and i + capacity so that any
+    /// run of up to capacity most recent elements is contiguous
+    template <typename T>
+    struct MirroredRing {
+        std::vector<T> data;
+        size_t capacity{0};
+        size_t head{0};  ///< Next write position in [0, capacity)
+
+        void Reset(size_t new_capacity) {
+            data.assign(2 * new_capacity, T{});
+            capacity = new_capacity;
+            head = 0;
+        }
+
+        void Push(T value) {
+            data[head] = value;
+            data[head + capacity] = value;
+            head = head + 1 == capacity ? 0 : head + 1;
+        }
+
+        /// Pointer to the last n elements written (n <= capacity)
+        const T* Last(size_t n) const {
+            return data.data() + head + capacity - n;
+        }
+    };
+
+    /// Append one decoded sample and emit the window it completes, if any
+    void PushSample(float sample, uint8_t byte, const WindowCallback& on_window);
+
+    Config config_;
+    PatternExtractor extractor_;
+    bool text_;
+    size_t bytes_per_sample_;
+    size_t window_size_;
+    size_t hop_size_;
+
+    std::optional<ChangePointDetector> detector_;  ///< CHANGE_POINTS only
+
+    MirroredRing<float> samples_;   ///< Non-TEXT streams
+    MirroredRing<uint8_t> bytes_;   ///< TEXT streams
+
+    uint8_t partial_[sizeof(float)]{};  ///< Bytes of a sample split across chunks
+    size_t partial_size_{0};
+
+    uint64_t samples_consumed_{0};
+    uint64_t next_window_start_{0};
+    uint64_t windows_emitted_{0};
+    uint64_t patterns_emitted_{0};
+};
+
+} // namespace dpan
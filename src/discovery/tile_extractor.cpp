@@ -0,0 +1,178 @@
+// File: src/discovery/tile_extractor.cpp
+#include "discovery/tile_extractor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace dpan {
+
+TileExtractor::TileExtractor(const Config& config) : config_(config) {
+    if (config_.tile_size == 0) {
+        throw std::invalid_argument("tile_size must be greater than 0");
+    }
+    if (config_.pyramid_levels == 0) {
+        throw std::invalid_argument("pyramid_levels must be greater than 0");
+    }
+    if (config_.feature_dimension == 0) {
+        throw std::invalid_argument("feature_dimension must be greater than 0");
+    }
+}
+
+std::vector<TileExtractor::Tile> TileExtractor::Extract(const InputView& image) {
+    if (image.type != SampleType::IMAGE_U8) {
+        throw std::invalid_argument("TileExtractor requires an IMAGE_U8 view");
+    }
+    if (image.Empty() || image.data == nullptr) {
+        return {};
+    }
+
+    std::vector<Placement> placements = PlaceTiles(image.width, image.height);
+    const size_t per_tile = image.channels * kFeaturesPerChannel;
+    std::vector<float> values(placements.size() * per_tile);
+
+    const double scale = 1.0 / 255.0;
+    for (size_t c = 0; c < image.channels; ++c) {
+        BuildIntegrals(image, c);
+
+        for (size_t t = 0; t < placements.size(); ++t) {
+            const Placement& tile = placements[t];
+            const double n = static_cast<double>(tile.size * tile.size);
+            const double mean = static_cast<double>(
+                RectSum(sum_, tile.x, tile.y, tile.size, tile.size)) / n;
+            const double mean_sq = static_cast<double>(
+                RectSum(sum_sq_, tile.x, tile.y, tile.size, tile.size)) / n;
+            const double gradient = static_cast<double>(
+                RectSum(gradient_, tile.x, tile.y, tile.size, tile.size)) / n;
+
+            // Quadrant means; a 1-pixel tile has empty quadrants
+            const size_t half = tile.size / 2;
+            const size_t rest = tile.size - half;
+            auto quadrant = [&](size_t qx, size_t qy, size_t w, size_t h) {
+                if (w == 0 || h == 0) {
+                    return mean;
+                }
+                return static_cast<double>(RectSum(sum_, qx, qy, w, h)) /
+                       static_cast<double>(w * h);
+            };
+
+            float* out = values.data() + t * per_tile + c * kFeaturesPerChannel;
+            out[0] = static_cast<float>(mean * scale);
+            out[1] = static_cast<float>(std::sqrt(std::max(0.0, mean_sq - mean * mean)) * scale);
+            out[2] = static_cast<float>(gradient * scale * scale);
+            out[3] = static_cast<float>(quadrant(tile.x, tile.y, half, half) * scale);
+            out[4] = static_cast<float>(quadrant(tile.x + half, tile.y, rest, half) * scale);
+            out[5] = static_cast<float>(quadrant(tile.x, tile.y + half, half, rest) * scale);
+            out[6] = static_cast<float>(quadrant(tile.x + half, tile.y + half, rest, rest) * scale);
+        }
+    }
+
+    std::vector<Tile> tiles;
+    tiles.reserve(placements.size());
+    const size_t copied = std::min(per_tile, config_.feature_dimension);
+    for (size_t t = 0; t < placements.size(); ++t) {
+        std::vector<float> features(config_.feature_dimension, 0.0f);
+        std::copy(values.begin() + static_cast<std::ptrdiff_t>(t * per_tile),
+                  values.begin() + static_cast<std::ptrdiff_t>(t * per_tile + copied),
+                  features.begin());
+
+        Tile tile;
+        tile.level = placements[t].level;
+        tile.x = placements[t].x;
+        tile.y = placements[t].y;
+        tile.size = placements[t].size;
+        tile.features = FeatureVector(std::move(features));
+        tiles.push_back(std::move(tile));
+    }
+
+    return tiles;
+}
+
+std::vector<TileExtractor::Placement> TileExtractor::PlaceTiles(size_t width,
+                                                                size_t height) const {
+    std::vector<Placement> placements;
+    if (width == 0 || height == 0) {
+        return placements;
+    }
+
+    const size_t base_stride = config_.stride > 0 ?
+        config_.stride : std::max<size_t>(1, config_.tile_size / 2);
+
+    for (size_t level = 0; level < config_.pyramid_levels; ++level) {
+        size_t size = config_.tile_size << level;
+        size_t step = base_stride << level;
+        if (size > width || size > height) {
+            if (level > 0) {
+                break;  // Coarser levels no longer fit
+            }
+            // Small frame: one level of tiles as large as fits
+            size = std::min(width, height);
+            step = std::max<size_t>(1, size / 2);
+        }
+
+        for (size_t y = 0; y + size <= height; y += step) {
+            for (size_t x = 0; x + size <= width; x += step) {
+                placements.push_back({level, x, y, size});
+            }
+        }
+    }
+
+    return placements;
+}
+
+void TileExtractor::BuildIntegrals(const InputView& image, size_t channel) {
+    const size_t width = image.width;
+    const size_t height = image.height;
+    const size_t channels = image.channels;
+    const auto* base = static_cast<const uint8_t*>(image.data) + channel;
+
+    integral_width_ = width + 1;
+    const size_t cells = integral_width_ * (height + 1);
+    sum_.resize(cells);
+    sum_sq_.resize(cells);
+    gradient_.resize(cells);
+
+    // Only the top row and left column need clearing; the rest is written
+    std::fill(sum_.begin(), sum_.begin() + static_cast<std::ptrdiff_t>(integral_width_), 0);
+    std::fill(sum_sq_.begin(), sum_sq_.begin() + static_cast<std::ptrdiff_t>(integral_width_), 0);
+    std::fill(gradient_.begin(), gradient_.begin() + static_cast<std::ptrdiff_t>(integral_width_), 0);
+    for (size_t y = 1; y <= height; ++y) {
+        sum_[y * integral_width_] = 0;
+        sum_sq_[y * integral_width_] = 0;
+        gradient_[y * integral_width_] = 0;
+    }
+
+    for (size_t y = 0; y < height; ++y) {
+        const uint8_t* row = base + y * image.row_stride;
+        const uint8_t* below = y + 1 < height ? row + image.row_stride : nullptr;
+        const size_t above_index = y * integral_width_ + 1;
+        const size_t index = above_index + integral_width_;
+
+        // Running row sums added to the integral row above
+        uint64_t row_sum = 0;
+        uint64_t row_sq = 0;
+        uint64_t row_gradient = 0;
+        for (size_t x = 0; x < width; ++x) {
+            const int value = row[x * channels];
+            const int dx = x + 1 < width ? row[(x + 1) * channels] - value : 0;
+            const int dy = below != nullptr ? below[x * channels] - value : 0;
+
+            row_sum += static_cast<uint64_t>(value);
+            row_sq += static_cast<uint64_t>(value * value);
+            row_gradient += static_cast<uint64_t>(dx * dx + dy * dy);
+
+            sum_[index + x] = sum_[above_index + x] + row_sum;
+            sum_sq_[index + x] = sum_sq_[above_index + x] + row_sq;
+            gradient_[index + x] = gradient_[above_index + x] + row_gradient;
+        }
+    }
+}
+
+uint64_t TileExtractor::RectSum(const std::vector<uint64_t>& integral,
+                                size_t x, size_t y, size_t w, size_t h) const {
+    const size_t top = y * integral_width_;
+    const size_t bottom = (y + h) * integral_width_;
+    return integral[bottom + x + w] - integral[top + x + w] -
+           integral[bottom + x] + integral[top + x];
+}
+
+} // namespace dpan
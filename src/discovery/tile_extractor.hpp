@@ -0,0 +1,101 @@
+// File: src/discovery/tile_extractor.hpp
+#pragma once
+
+#include "core/input_view.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dpan {
+
+/// TileExtractor - 2-D tile features over image frames
+///
+/// Covers an image with square tiles and describes each one by per-channel
+/// statistics. For every channel the frame is summarized once in integral
+/// images of pixel values, squared values and squared gradients, so each
+/// tile costs O(1) per feature however large it is. Pyramid levels reuse the
+/// same integral images: level l tiles are tile_size << l pixels wide and
+/// move by stride << l.
+///
+/// Features per channel, values scaled to [0, 1]:
+///   mean, standard deviation, gradient energy (mean of gx^2 + gy^2 over
+///   forward differences), and the means of the four tile quadrants.
+/// Channels are concatenated, then zero-padded or truncated to
+/// feature_dimension.
+///
+/// Thread-safety: Not thread-safe; integral image buffers are reused
+/// across frames. Use one instance per thread.
+class TileExtractor {
+public:
+    /// Configuration for tile extraction
+    struct Config {
+        /// Edge of level-0 tiles in pixels; clamped to the image for small
+        /// frames
+        size_t tile_size{16};
+
+        /// Pixels between level-0 tile origins (0 = tile_size / 2)
+        size_t stride{0};
+
+        /// Number of pyramid levels (1 = level 0 only)
+        size_t pyramid_levels{1};
+
+        /// Length of each tile's feature vector
+        size_t feature_dimension{128};
+    };
+
+    /// Features of one tile
+    struct Tile {
+        size_t level{0};
+        size_t x{0};     ///< Left edge in pixels
+        size_t y{0};     ///< Top edge in pixels
+        size_t size{0};  ///< Edge length in pixels
+        FeatureVector features;
+    };
+
+    /// Features per channel before padding
+    static constexpr size_t kFeaturesPerChannel = 7;
+
+    /// Constructor
+    /// @param config Tiling configuration
+    /// @throws std::invalid_argument if tile_size, pyramid_levels or
+    ///         feature_dimension is 0
+    explicit TileExtractor(const Config& config);
+
+    /// Extract tiles of every pyramid level, ordered by level, then row,
+    /// then column
+    /// @param image IMAGE_U8 view (row padding is skipped)
+    /// @return Tiles (empty if the image is empty)
+    /// @throws std::invalid_argument if the view is not an image
+    std::vector<Tile> Extract(const InputView& image);
+
+    /// Get current configuration
+    const Config& GetConfig() const { return config_; }
+
+private:
+    /// Tile geometry before features are filled in
+    struct Placement {
+        size_t level;
+        size_t x;
+        size_t y;
+        size_t size;
+    };
+
+    std::vector<Placement> PlaceTiles(size_t width, size_t height) const;
+
+    /// Build the integral images of one channel
+    void BuildIntegrals(const InputView& image, size_t channel);
+
+    /// Sum of an integral image over [x, x + w) x [y, y + h)
+    uint64_t RectSum(const std::vector<uint64_t>& integral,
+                     size_t x, size_t y, size_t w, size_t h) const;
+
+    Config config_;
+
+    // (width + 1) x (height + 1) integral images of the current channel
+    size_t integral_width_{0};
+    std::vector<uint64_t> sum_;
+    std::vector<uint64_t> sum_sq_;
+    std::vector<uint64_t> gradient_;
+};
+
+} // namespace dpan
@@ -161,6 +161,11 @@ void SelfAttention::SetSimilarityMetric(std::shared_ptr<SimilarityMetric> metric
     similarity_metric_ = metric;
 }
 
+void SelfAttention::SetSimilarityCache(std::shared_ptr<PairwiseSimilarityCache> cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    similarity_cache_ = cache;
+}
+
 void SelfAttention::SetAssociationMatrix(AssociationMatrix* matrix) {
     std::lock_guard<std::mutex> lock(mutex_);
     association_matrix_ = matrix;
@@ -505,14 +510,22 @@ float SelfAttention::GetSimilarity(
     if (similarity_metric_) {
         const auto& pattern1 = pattern1_opt.value();
         const auto& pattern2 = pattern2_opt.value();
-        auto data1 = pattern1.GetData();
-        auto data2 = pattern2.GetData();
 
-        // Get feature vectors for similarity computation
-        auto features1 = data1.GetFeatures();
-        auto features2 = data2.GetFeatures();
+        auto compute = [&]() {
+            // Get feature vectors for similarity computation
+            auto features1 = pattern1.GetData().GetFeatures();
+            auto features2 = pattern2.GetData().GetFeatures();
+
+            return similarity_metric_->ComputeFromFeatures(features1, features2);
+        };
+
+        if (similarity_cache_) {
+            return similarity_cache_->GetOrCompute(
+                pattern1, pattern2, similarity_metric_->GetName(),
+                similarity_metric_->IsSymmetric(), "SelfAttention", compute);
+        }
 
-        return similarity_metric_->ComputeFromFeatures(features1, features2);
+        return compute();
     }
 
     // Otherwise, use simple data-based similarity (cosine similarity)
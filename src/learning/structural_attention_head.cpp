@@ -236,16 +236,15 @@ std::vector<float> StructuralAttentionHead::ComputeStructuralScores(
         return scores;
     }
 
-    // Get query pattern and its sub-patterns
-    auto query_pattern_opt = pattern_db_->Retrieve(query);
-    if (!query_pattern_opt) {
+    // Get the query's sub-patterns (the database answers from its
+    // hierarchy index where it has one, without cloning nodes)
+    if (!pattern_db_->Exists(query)) {
         LogDebug("WARNING: Query pattern not found: " + query.ToString());
         scores.resize(candidates.size(), 1.0f / candidates.size());
         return scores;
     }
 
-    const auto& query_pattern = *query_pattern_opt;
-    auto query_subpatterns = query_pattern.GetSubPatterns();
+    auto query_subpatterns = pattern_db_->GetSubPatterns(query);
     bool query_is_composite = !query_subpatterns.empty();
 
     // Compute structural score for each candidate
@@ -265,9 +264,8 @@ std::vector<float> StructuralAttentionHead::ComputeStructuralScores(
                 ++cache_misses_;
 
                 // Compute structural score
-                auto candidate_pattern_opt = pattern_db_->Retrieve(candidate_id);
-                if (candidate_pattern_opt) {
-                    auto candidate_subpatterns = candidate_pattern_opt->GetSubPatterns();
+                if (pattern_db_->Exists(candidate_id)) {
+                    auto candidate_subpatterns = pattern_db_->GetSubPatterns(candidate_id);
                     bool candidate_is_composite = !candidate_subpatterns.empty();
 
                     // Handle different pattern type combinations
@@ -300,9 +298,8 @@ std::vector<float> StructuralAttentionHead::ComputeStructuralScores(
             }
         } else {
             // No caching - always compute
-            auto candidate_pattern_opt = pattern_db_->Retrieve(candidate_id);
-            if (candidate_pattern_opt) {
-                auto candidate_subpatterns = candidate_pattern_opt->GetSubPatterns();
+            if (pattern_db_->Exists(candidate_id)) {
+                auto candidate_subpatterns = pattern_db_->GetSubPatterns(candidate_id);
                 bool candidate_is_composite = !candidate_subpatterns.empty();
 
                 // Handle different pattern type combinations
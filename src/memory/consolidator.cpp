@@ -1,9 +1,11 @@
 // File: src/memory/consolidator.cpp
 #include "memory/consolidator.hpp"
+#include "similarity/kmeans_clusterer.hpp"
 #include <algorithm>
 #include <queue>
 #include <stdexcept>
 #include <cmath>
+#include <iterator>
 
 namespace dpan {
 
@@ -197,9 +199,7 @@ MemoryConsolidator::HierarchyResult MemoryConsolidator::FormHierarchies(
                 auto opt_p2 = pattern_db.Retrieve(cluster[j]);
 
                 if (opt_p1 && opt_p2) {
-                    float sim = similarity_metric.Compute(
-                        opt_p1->GetData(), opt_p2->GetData()
-                    );
+                    float sim = PairSimilarity(*opt_p1, *opt_p2, similarity_metric);
                     avg_similarity += sim;
                     pair_count++;
                 }
@@ -321,9 +321,7 @@ std::vector<std::tuple<PatternID, PatternID, float>> MemoryConsolidator::FindMer
             }
 
             // Calculate similarity
-            float similarity = similarity_metric.Compute(
-                opt_p1->GetData(), opt_p2->GetData()
-            );
+            float similarity = PairSimilarity(*opt_p1, *opt_p2, similarity_metric);
 
             // Check merge threshold
             if (similarity >= config_.merge_similarity_threshold) {
@@ -341,6 +339,25 @@ std::vector<std::tuple<PatternID, PatternID, float>> MemoryConsolidator::FindMer
     return candidates;
 }
 
+float MemoryConsolidator::PairSimilarity(
+    const PatternNode& p1,
+    const PatternNode& p2,
+    const SimilarityMetric& similarity_metric
+) const {
+    auto compute = [&]() {
+        return similarity_metric.Compute(p1.GetData(), p2.GetData());
+    };
+
+    if (!similarity_cache_) {
+        return compute();
+    }
+
+    return similarity_cache_->GetOrCompute(
+        p1, p2, similarity_metric.GetName(), similarity_metric.IsSymmetric(),
+        "MemoryConsolidator", compute
+    );
+}
+
 bool MemoryConsolidator::MergeTwoPatterns(
     PatternID old_pattern,
     PatternID new_pattern,
@@ -353,6 +370,9 @@ bool MemoryConsolidator::MergeTwoPatterns(
     // Remove old pattern (or mark as merged)
     if (!config_.preserve_original_patterns) {
         pattern_db.Delete(old_pattern);
+        if (similarity_cache_) {
+            similarity_cache_->Invalidate(old_pattern);
+        }
     }
 
     return transferred > 0 || true;  // Consider successful even if no associations
@@ -367,26 +387,21 @@ std::vector<std::vector<PatternID>> MemoryConsolidator::FindClusters(
         return {};  // Not enough patterns to cluster
     }
 
-    // Build similarity matrix
-    std::unordered_map<std::pair<PatternID, PatternID>, float, PatternPairHash> similarity_matrix;
-
-    for (size_t i = 0; i < patterns.size(); ++i) {
-        for (size_t j = i + 1; j < patterns.size(); ++j) {
-            auto opt_p1 = pattern_db.Retrieve(patterns[i]);
-            auto opt_p2 = pattern_db.Retrieve(patterns[j]);
-
-            if (opt_p1 && opt_p2) {
-                float sim = similarity_metric.Compute(
-                    opt_p1->GetData(), opt_p2->GetData()
-                );
-                similarity_matrix[{patterns[i], patterns[j]}] = sim;
-                similarity_matrix[{patterns[j], patterns[i]}] = sim;
-            }
-        }
+    std::vector<std::optional<PatternNode>> nodes;
+    nodes.reserve(patterns.size());
+    for (PatternID id : patterns) {
+        nodes.push_back(pattern_db.Retrieve(id));
     }
 
-    // Perform greedy clustering
-    return GreedyClustering(patterns, similarity_matrix);
+    // Perform greedy clustering within each partition
+    std::vector<std::vector<PatternID>> clusters;
+    for (const auto& partition : PartitionByFeatures(nodes)) {
+        auto partition_clusters = GreedyClustering(patterns, nodes, partition, similarity_metric);
+        clusters.insert(clusters.end(),
+                        std::make_move_iterator(partition_clusters.begin()),
+                        std::make_move_iterator(partition_clusters.end()));
+    }
+    return clusters;
 }
 
 PatternID MemoryConsolidator::CreateClusterParent(
@@ -541,25 +556,94 @@ PatternData MemoryConsolidator::CalculateCentroid(
     return PatternData::FromFeatures(centroid_features, centroid.GetModality());
 }
 
+std::vector<std::vector<size_t>> MemoryConsolidator::PartitionByFeatures(
+    const std::vector<std::optional<PatternNode>>& nodes
+) const {
+    std::vector<size_t> all(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        all[i] = i;
+    }
+    const size_t partition_size = config_.cluster_partition_size;
+    if (partition_size == 0 || nodes.size() <= partition_size) {
+        return {all};
+    }
+
+    // Missing patterns never reach the similarity threshold; they only
+    // seed clusters of their own
+    std::vector<size_t> present;
+    std::vector<size_t> missing;
+    std::vector<float> points;
+    size_t dimension = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (!nodes[i]) {
+            missing.push_back(i);
+            continue;
+        }
+        FeatureVector features = nodes[i]->GetData().GetFeatures();
+        if (present.empty()) {
+            dimension = features.Dimension();
+        }
+        if (features.Dimension() != dimension || dimension == 0) {
+            return {all};  // No common feature space to partition in
+        }
+        points.insert(points.end(), features.Data().begin(), features.Data().end());
+        present.push_back(i);
+    }
+
+    std::vector<std::vector<size_t>> partitions;
+    const size_t k = (present.size() + partition_size - 1) / partition_size;
+    if (k <= 1) {
+        partitions.push_back(present);
+    } else {
+        KMeansClusterer::Config kmeans_config;
+        kmeans_config.num_clusters = k;
+        kmeans_config.max_iterations = 20;
+        auto result = KMeansClusterer(kmeans_config).Run(points.data(), present.size(), dimension);
+
+        partitions.resize(k);
+        for (size_t p = 0; p < present.size(); ++p) {
+            partitions[result.assignments[p]].push_back(present[p]);
+        }
+        partitions.erase(std::remove_if(partitions.begin(), partitions.end(),
+                                        [](const auto& partition) { return partition.empty(); }),
+                         partitions.end());
+    }
+    if (!missing.empty()) {
+        partitions.push_back(std::move(missing));
+    }
+    return partitions;
+}
+
 std::vector<std::vector<PatternID>> MemoryConsolidator::GreedyClustering(
     const std::vector<PatternID>& patterns,
-    const std::unordered_map<std::pair<PatternID, PatternID>, float, PatternPairHash>& similarity_matrix
+    const std::vector<std::optional<PatternNode>>& nodes,
+    const std::vector<size_t>& members,
+    const SimilarityMetric& similarity_metric
 ) {
     std::vector<std::vector<PatternID>> clusters;
     std::unordered_set<PatternID> assigned;
 
-    for (PatternID seed : patterns) {
-        if (assigned.count(seed) > 0) {
+    // Each (candidate, member) pair is evaluated at most once: a member
+    // belongs to the one cluster being grown while it is compared
+    auto similarity = [&](size_t a, size_t b) {
+        if (a > b) {
+            std::swap(a, b);
+        }
+        return PairSimilarity(*nodes[a], *nodes[b], similarity_metric);
+    };
+
+    for (size_t seed : members) {
+        if (assigned.count(patterns[seed]) > 0) {
             continue;  // Already in a cluster
         }
 
         // Start new cluster with seed
-        std::vector<PatternID> cluster = {seed};
-        assigned.insert(seed);
+        std::vector<size_t> cluster = {seed};
+        assigned.insert(patterns[seed]);
 
         // Greedily add similar patterns
-        for (PatternID candidate : patterns) {
-            if (assigned.count(candidate) > 0) {
+        for (size_t candidate : members) {
+            if (assigned.count(patterns[candidate]) > 0) {
                 continue;  // Already assigned
             }
 
@@ -571,11 +655,12 @@ std::vector<std::vector<PatternID>> MemoryConsolidator::GreedyClustering(
             float avg_similarity = 0.0f;
             size_t count = 0;
 
-            for (PatternID member : cluster) {
-                auto it = similarity_matrix.find({candidate, member});
-                if (it != similarity_matrix.end()) {
-                    avg_similarity += it->second;
-                    count++;
+            if (nodes[candidate]) {
+                for (size_t member : cluster) {
+                    if (nodes[member]) {
+                        avg_similarity += similarity(candidate, member);
+                        count++;
+                    }
                 }
             }
 
@@ -586,13 +671,18 @@ std::vector<std::vector<PatternID>> MemoryConsolidator::GreedyClustering(
             // Add if similar enough
             if (avg_similarity >= config_.cluster_similarity_threshold) {
                 cluster.push_back(candidate);
-                assigned.insert(candidate);
+                assigned.insert(patterns[candidate]);
             }
         }
 
         // Only keep cluster if it meets minimum size
         if (cluster.size() >= config_.min_cluster_size) {
-            clusters.push_back(cluster);
+            std::vector<PatternID> ids;
+            ids.reserve(cluster.size());
+            for (size_t index : cluster) {
+                ids.push_back(patterns[index]);
+            }
+            clusters.push_back(std::move(ids));
         }
     }
 
@@ -6,6 +6,9 @@
 #include "storage/pattern_database.hpp"
 #include "association/association_matrix.hpp"
 #include "similarity/similarity_metric.hpp"
+#include "similarity/pairwise_similarity_cache.hpp"
+#include <memory>
+#include <optional>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -34,6 +37,7 @@ public:
         float cluster_similarity_threshold{0.7f};  // Similarity for clustering
         size_t min_cluster_size{3};                // Minimum patterns in cluster
         size_t max_cluster_size{50};               // Maximum patterns in cluster
+        size_t cluster_partition_size{256};        // Patterns per k-means partition (0 = compare all pairs)
         bool enable_hierarchy_formation{true};     // Enable clustering
 
         // Association compression settings
@@ -171,6 +175,11 @@ public:
     );
 
     /// Find clusters of related patterns
+    ///
+    /// Each pattern is retrieved once. Above cluster_partition_size
+    /// patterns, candidates are first grouped by KMeansClusterer over their
+    /// features and only pairs within a group are compared, so the number
+    /// of similarity evaluations grows linearly with the pattern count.
     /// @param patterns List of pattern IDs to cluster
     /// @param pattern_db Pattern database
     /// @param similarity_metric Similarity metric
@@ -223,6 +232,16 @@ public:
     /// Get current configuration
     const Config& GetConfig() const { return config_; }
 
+    /// Share a pairwise similarity cache so unchanged pairs are not
+    /// re-scored across consolidation cycles
+    /// @param cache Cache instance (nullptr disables caching)
+    void SetSimilarityCache(std::shared_ptr<PairwiseSimilarityCache> cache) {
+        similarity_cache_ = std::move(cache);
+    }
+
+    /// Get the shared pairwise similarity cache (may be null)
+    std::shared_ptr<PairwiseSimilarityCache> GetSimilarityCache() const { return similarity_cache_; }
+
     // ========================================================================
     // Statistics
     // ========================================================================
@@ -246,6 +265,7 @@ public:
 private:
     Config config_;
     Statistics stats_;
+    std::shared_ptr<PairwiseSimilarityCache> similarity_cache_;
 
     // ========================================================================
     // Helper Methods
@@ -255,6 +275,13 @@ private:
     /// @throws std::invalid_argument if invalid
     void ValidateConfig() const;
 
+    /// Similarity of two patterns, served from the shared cache when set
+    float PairSimilarity(
+        const PatternNode& p1,
+        const PatternNode& p2,
+        const SimilarityMetric& similarity_metric
+    ) const;
+
     /// Transfer associations from old pattern to new pattern
     /// @param old_pattern Source pattern
     /// @param new_pattern Destination pattern
@@ -275,13 +302,25 @@ private:
         PatternDatabase& pattern_db
     );
 
+    /// Split patterns into groups of about cluster_partition_size by
+    /// k-means over their features; clusters are only formed within a group
+    /// @param nodes Retrieved patterns (nullopt if missing)
+    /// @return Groups of indices into nodes, each in input order
+    std::vector<std::vector<size_t>> PartitionByFeatures(
+        const std::vector<std::optional<PatternNode>>& nodes
+    ) const;
+
     /// Greedy clustering algorithm
     /// @param patterns Patterns to cluster
-    /// @param similarity_matrix Pairwise similarity matrix
+    /// @param nodes Retrieved patterns, parallel to patterns
+    /// @param members Indices of the patterns to consider, in seed order
+    /// @param similarity_metric Similarity metric
     /// @return Clusters of pattern IDs
     std::vector<std::vector<PatternID>> GreedyClustering(
         const std::vector<PatternID>& patterns,
-        const std::unordered_map<std::pair<PatternID, PatternID>, float, PatternPairHash>& similarity_matrix
+        const std::vector<std::optional<PatternNode>>& nodes,
+        const std::vector<size_t>& members,
+        const SimilarityMetric& similarity_metric
     );
 };
 
@@ -1,6 +1,8 @@
 // File: src/memory/interference.cpp
 #include "memory/interference.hpp"
 #include "similarity/similarity_metric.hpp"
+#include "similarity/pairwise_similarity_cache.hpp"
+#include "core/pattern_node.hpp"
 #include <algorithm>
 #include <stdexcept>
 
@@ -41,6 +43,10 @@ void InterferenceCalculator::SetSimilarityMetric(std::shared_ptr<SimilarityMetri
     similarity_metric_ = metric;
 }
 
+void InterferenceCalculator::SetSimilarityCache(std::shared_ptr<PairwiseSimilarityCache> cache) {
+    similarity_cache_ = cache;
+}
+
 float InterferenceCalculator::CalculateInterference(
     const FeatureVector& target_features,
     const FeatureVector& source_features,
@@ -56,13 +62,53 @@ float InterferenceCalculator::CalculateInterference(
         return 0.0f;
     }
 
-    // Check if similar enough to interfere
-    if (!AreSimilarEnough(target_features, source_features)) {
+    // Compute similarity once for both the threshold check and the product
+    float similarity = similarity_metric_->ComputeFromFeatures(target_features, source_features);
+
+    return InterferenceFromSimilarity(similarity, source_strength);
+}
+
+float InterferenceCalculator::CalculateInterference(
+    const PatternNode& target,
+    const PatternNode& source,
+    float source_strength
+) const {
+    if (!similarity_cache_) {
+        return CalculateInterference(
+            target.GetData().GetFeatures(), source.GetData().GetFeatures(), source_strength
+        );
+    }
+
+    // Validate inputs
+    if (source_strength < 0.0f || source_strength > 1.0f) {
         return 0.0f;
     }
 
-    // Compute similarity
-    float similarity = similarity_metric_->ComputeFromFeatures(target_features, source_features);
+    if (!similarity_metric_) {
+        return 0.0f;
+    }
+
+    float similarity = similarity_cache_->GetOrCompute(
+        target, source, similarity_metric_->GetName(), similarity_metric_->IsSymmetric(),
+        "InterferenceCalculator",
+        [&]() {
+            return similarity_metric_->ComputeFromFeatures(
+                target.GetData().GetFeatures(), source.GetData().GetFeatures()
+            );
+        }
+    );
+
+    return InterferenceFromSimilarity(similarity, source_strength);
+}
+
+float InterferenceCalculator::InterferenceFromSimilarity(
+    float similarity,
+    float source_strength
+) const {
+    // Check if similar enough to interfere
+    if (similarity < config_.similarity_threshold) {
+        return 0.0f;
+    }
 
     // I(target, source) = similarity × strength(source)
     float interference = similarity * source_strength;
@@ -92,16 +138,4 @@ float InterferenceCalculator::ApplyInterference(
     return std::max(0.0f, std::min(new_strength, original_strength));
 }
 
-bool InterferenceCalculator::AreSimilarEnough(
-    const FeatureVector& f1,
-    const FeatureVector& f2
-) const {
-    if (!similarity_metric_) {
-        return false;
-    }
-
-    float similarity = similarity_metric_->ComputeFromFeatures(f1, f2);
-    return similarity >= config_.similarity_threshold;
-}
-
 } // namespace dpan
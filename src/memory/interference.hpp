@@ -10,6 +10,7 @@ namespace dpan {
 // Forward declarations
 class PatternNode;
 class SimilarityMetric;
+class PairwiseSimilarityCache;
 
 /**
  * @brief Models memory interference between similar patterns
@@ -54,6 +55,24 @@ public:
         float source_strength
     ) const;
 
+    /**
+     * @brief Calculate interference between two stored patterns
+     *
+     * Same as the feature overload, but the similarity is looked up in the
+     * shared pairwise similarity cache (if one is set) so repeated passes over
+     * unchanged patterns do not recompute it.
+     *
+     * @param target Target pattern
+     * @param source Source pattern
+     * @param source_strength Strength of source pattern [0.0, 1.0]
+     * @return Interference amount [0.0, 1.0]
+     */
+    float CalculateInterference(
+        const PatternNode& target,
+        const PatternNode& source,
+        float source_strength
+    ) const;
+
     /**
      * @brief Apply interference effect to pattern strength
      *
@@ -74,11 +93,16 @@ public:
     void SetSimilarityMetric(std::shared_ptr<SimilarityMetric> metric);
     std::shared_ptr<SimilarityMetric> GetSimilarityMetric() const { return similarity_metric_; }
 
+    void SetSimilarityCache(std::shared_ptr<PairwiseSimilarityCache> cache);
+    std::shared_ptr<PairwiseSimilarityCache> GetSimilarityCache() const { return similarity_cache_; }
+
 private:
     Config config_;
     std::shared_ptr<SimilarityMetric> similarity_metric_;
+    std::shared_ptr<PairwiseSimilarityCache> similarity_cache_;
 
-    bool AreSimilarEnough(const FeatureVector& f1, const FeatureVector& f2) const;
+    /// I = similarity × strength, zero below the similarity threshold
+    float InterferenceFromSimilarity(float similarity, float source_strength) const;
 };
 
 } // namespace dpan
@@ -63,10 +63,17 @@ void MemoryManager::Initialize(
             similarity_metric
         );
     }
+    SetSimilarityCache(similarity_cache_);
 
     is_initialized_ = true;
 }
 
+void MemoryManager::SetSimilarityCache(std::shared_ptr<PairwiseSimilarityCache> cache) {
+    similarity_cache_ = std::move(cache);
+    memory_consolidator_.SetSimilarityCache(similarity_cache_);
+    interference_calculator_.SetSimilarityCache(similarity_cache_);
+}
+
 void MemoryManager::SetConfig(const Config& config) {
     if (!config.IsValid()) {
         throw std::invalid_argument("Invalid MemoryManager configuration");
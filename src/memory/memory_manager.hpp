@@ -251,6 +251,22 @@ public:
     SleepConsolidator* GetSleepConsolidator() { return sleep_consolidator_.get(); }
     const SleepConsolidator* GetSleepConsolidator() const { return sleep_consolidator_.get(); }
 
+    /**
+     * @brief Share a pattern-pair similarity cache
+     *
+     * Installed on the memory consolidator and the interference calculator,
+     * now and on every later Initialize(). Pass PatternEngine's cache so
+     * scores are shared with the refiner.
+     *
+     * @param cache Cache to use (nullptr disables caching)
+     */
+    void SetSimilarityCache(std::shared_ptr<PairwiseSimilarityCache> cache);
+
+    /**
+     * @brief Get the shared similarity cache (nullptr if none)
+     */
+    std::shared_ptr<PairwiseSimilarityCache> GetSimilarityCache() const { return similarity_cache_; }
+
 private:
     Config config_;
 
@@ -274,6 +290,7 @@ private:
     // Forgetting mechanisms
     std::unique_ptr<IDecayFunction> decay_function_;
     InterferenceCalculator interference_calculator_;
+    std::shared_ptr<PairwiseSimilarityCache> similarity_cache_;
 
     // Statistics
     mutable std::mutex stats_mutex_;
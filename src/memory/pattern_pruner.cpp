@@ -87,7 +87,8 @@ PatternPruner::PruneResult PatternPruner::PrunePatterns(
         const auto& pattern = *pattern_opt;
 
         // Check if safe to prune
-        if (!IsSafeToPrune(pattern_id, pattern, assoc_matrix, utility)) {
+        if (!IsSafeToPrune(pattern_id, pattern, assoc_matrix, utility) ||
+            (config_.keep_sub_patterns && IsSubPattern(pattern_id, pattern_db))) {
             result.patterns_kept_safe++;
             continue;
         }
@@ -226,6 +227,10 @@ bool PatternPruner::HasStrongAssociations(
     return false;
 }
 
+bool PatternPruner::IsSubPattern(PatternID id, PatternDatabase& pattern_db) const {
+    return !pattern_db.GetParentPatterns(id).empty();
+}
+
 // ============================================================================
 // Pattern Merging
 // ============================================================================
@@ -23,6 +23,7 @@
 //   - Don't prune if pattern is hub (>50 strong associations)
 //   - Don't prune if recently created (<24 hours)
 //   - Don't prune if has strong associations (>0.7 strength)
+//   - Don't prune if a composite or meta pattern lists it as a sub-pattern
 
 #pragma once
 
@@ -63,6 +64,9 @@ public:
         /// Maximum number of patterns to process in one batch
         size_t max_prune_batch{1000};
 
+        /// Keep patterns that other patterns list as sub-patterns
+        bool keep_sub_patterns{true};
+
         /// Validate configuration
         bool IsValid() const;
     };
@@ -166,6 +170,16 @@ public:
     /// @return true if pattern has strong associations
     bool HasStrongAssociations(PatternID id, const AssociationMatrix& assoc_matrix) const;
 
+    /// Check if other patterns list this pattern as a sub-pattern
+    ///
+    /// Answered from the database's parent index; pruning such a pattern
+    /// would leave its parents with a dangling sub-pattern link.
+    ///
+    /// @param id Pattern ID
+    /// @param pattern_db Pattern database
+    /// @return true if the pattern has at least one parent
+    bool IsSubPattern(PatternID id, PatternDatabase& pattern_db) const;
+
     // ========================================================================
     // Pattern Merging
     // ========================================================================
@@ -218,6 +218,20 @@ std::optional<MemoryTier> TierManager::GetPatternTier(PatternID id) const {
     return std::nullopt;
 }
 
+std::vector<PatternID> TierManager::GetPatternsInTier(MemoryTier tier) const {
+    std::vector<PatternID> ids;
+    {
+        std::shared_lock<std::shared_mutex> lock(location_mutex_);
+        for (const auto& [id, location] : pattern_locations_) {
+            if (location == tier) {
+                ids.push_back(id);
+            }
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
 // ============================================================================
 // Tier Transitions
 // ============================================================================
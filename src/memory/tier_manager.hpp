@@ -140,6 +140,14 @@ public:
     /// @return Current tier, or nullopt if not tracked
     std::optional<MemoryTier> GetPatternTier(PatternID id) const;
 
+    /// Get all patterns currently located in a tier
+    ///
+    /// Suitable as PatternFilter::allowed_ids to restrict a search to a tier.
+    ///
+    /// @param tier Tier to list
+    /// @return Pattern IDs in ascending order
+    std::vector<PatternID> GetPatternsInTier(MemoryTier tier) const;
+
     /// Store pattern in specified tier
     ///
     /// @param pattern Pattern to store
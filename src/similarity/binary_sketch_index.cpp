@@ -0,0 +1,175 @@
+// File: src/similarity/binary_sketch_index.cpp
+#include "similarity/binary_sketch_index.hpp"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+namespace dpan {
+
+namespace {
+
+inline uint32_t PopCount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_popcountll(word));
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<uint32_t>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+} // anonymous namespace
+
+BinarySketchIndex::BinarySketchIndex()
+    : BinarySketchIndex(Config()) {
+}
+
+BinarySketchIndex::BinarySketchIndex(const Config& config)
+    : config_(config) {
+    if (!config_.IsValid()) {
+        throw std::invalid_argument("Invalid BinarySketchIndex configuration");
+    }
+    num_words_ = config_.num_bits / 64;
+}
+
+const std::vector<float>& BinarySketchIndex::ProjectionsFor(size_t dimension) const {
+    std::lock_guard<std::mutex> lock(projections_mutex_);
+    auto it = projections_.find(dimension);
+    if (it != projections_.end()) {
+        return it->second;
+    }
+
+    std::mt19937_64 rng(config_.seed ^ (dimension * 0x9E3779B97F4A7C15ULL));
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+
+    std::vector<float> directions(config_.num_bits * dimension);
+    for (auto& v : directions) {
+        v = dist(rng);
+    }
+    return projections_.emplace(dimension, std::move(directions)).first->second;
+}
+
+void BinarySketchIndex::SketchInto(const FeatureVector& features, uint64_t* out) const {
+    std::fill(out, out + num_words_, 0ULL);
+
+    const size_t dim = features.Dimension();
+    if (dim == 0) {
+        return;
+    }
+
+    const float* values = features.Data().data();
+    const float* row = ProjectionsFor(dim).data();
+    for (size_t bit = 0; bit < config_.num_bits; ++bit, row += dim) {
+        float dot = 0.0f;
+        for (size_t i = 0; i < dim; ++i) {
+            dot += row[i] * values[i];
+        }
+        if (dot >= 0.0f) {
+            out[bit / 64] |= 1ULL << (bit % 64);
+        }
+    }
+}
+
+std::vector<uint64_t> BinarySketchIndex::Sketch(const FeatureVector& features) const {
+    std::vector<uint64_t> words(num_words_);
+    SketchInto(features, words.data());
+    return words;
+}
+
+uint32_t BinarySketchIndex::HammingDistance(const uint64_t* a, const uint64_t* b,
+                                            size_t num_words) {
+    uint32_t distance = 0;
+    for (size_t w = 0; w < num_words; ++w) {
+        distance += PopCount(a[w] ^ b[w]);
+    }
+    return distance;
+}
+
+void BinarySketchIndex::Upsert(PatternID id, const FeatureVector& features) {
+    auto it = slot_of_.find(id);
+    size_t slot;
+    if (it != slot_of_.end()) {
+        slot = it->second;
+    } else {
+        slot = ids_.size();
+        slot_of_[id] = slot;
+        ids_.push_back(id);
+        dimensions_.push_back(0);
+        words_.resize(words_.size() + num_words_);
+    }
+
+    dimensions_[slot] = static_cast<uint32_t>(features.Dimension());
+    SketchInto(features, words_.data() + slot * num_words_);
+}
+
+bool BinarySketchIndex::Remove(PatternID id) {
+    auto it = slot_of_.find(id);
+    if (it == slot_of_.end()) {
+        return false;
+    }
+
+    size_t slot = it->second;
+    size_t last = ids_.size() - 1;
+    slot_of_.erase(it);
+
+    // Keep the array dense: move the last slot into the hole
+    if (slot != last) {
+        ids_[slot] = ids_[last];
+        dimensions_[slot] = dimensions_[last];
+        std::copy(words_.begin() + static_cast<std::ptrdiff_t>(last * num_words_),
+                  words_.begin() + static_cast<std::ptrdiff_t>((last + 1) * num_words_),
+                  words_.begin() + static_cast<std::ptrdiff_t>(slot * num_words_));
+        slot_of_[ids_[slot]] = slot;
+    }
+
+    ids_.pop_back();
+    dimensions_.pop_back();
+    words_.resize(words_.size() - num_words_);
+    return true;
+}
+
+void BinarySketchIndex::Clear() {
+    words_.clear();
+    ids_.clear();
+    dimensions_.clear();
+    slot_of_.clear();
+}
+
+std::vector<PatternID> BinarySketchIndex::Nearest(const FeatureVector& features,
+                                                  size_t depth) const {
+    std::vector<PatternID> result;
+    if (depth == 0 || ids_.empty()) {
+        return result;
+    }
+
+    std::vector<uint64_t> query(num_words_);
+    SketchInto(features, query.data());
+    const uint32_t query_dim = static_cast<uint32_t>(features.Dimension());
+    const uint32_t incomparable = static_cast<uint32_t>(config_.num_bits) + 1;
+
+    // (distance, slot) packed so ties break on slot order
+    std::vector<uint64_t> ranked(ids_.size());
+    const uint64_t* signature = words_.data();
+    for (size_t slot = 0; slot < ids_.size(); ++slot, signature += num_words_) {
+        uint32_t distance = dimensions_[slot] == query_dim
+            ? HammingDistance(query.data(), signature, num_words_)
+            : incomparable;
+        ranked[slot] = (static_cast<uint64_t>(distance) << 32) | slot;
+    }
+
+    size_t count = std::min(depth, ranked.size());
+    if (count < ranked.size()) {
+        std::nth_element(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(count),
+                         ranked.end());
+    }
+    std::sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(count));
+
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(ids_[ranked[i] & 0xFFFFFFFFULL]);
+    }
+    return result;
+}
+
+} // namespace dpan
@@ -0,0 +1,103 @@
+// File: src/similarity/binary_sketch_index.hpp
+#pragma once
+
+#include "core/types.hpp"
+#include "core/pattern_data.hpp"
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace dpan {
+
+/// BinarySketchIndex: Sign-random-projection sketches for coarse candidate search
+///
+/// Each pattern is reduced to a num_bits signature whose bit b is the sign of
+/// the projection of its features onto a fixed Gaussian direction. The
+/// Hamming distance between two signatures estimates the angle between the
+/// vectors, so a popcount scan over the dense signature array ranks
+/// candidates for an exact re-rank at a fraction of the cost of the metric.
+///
+/// Projections are generated deterministically per feature dimension from
+/// the seed. Signatures of vectors with different dimensions are not
+/// comparable; such patterns rank after all comparable ones.
+///
+/// Thread-safety: Const members may run concurrently with each other;
+/// Upsert, Remove and Clear need exclusive access.
+class BinarySketchIndex {
+public:
+    /// Configuration for the index
+    struct Config {
+        /// Signature length in bits (multiple of 64, 64-1024)
+        size_t num_bits{128};
+
+        /// Seed for the projection directions
+        uint64_t seed{0x5EED5EEDULL};
+
+        bool IsValid() const {
+            return num_bits >= 64 && num_bits <= 1024 && num_bits % 64 == 0;
+        }
+    };
+
+    /// Construct with default configuration
+    BinarySketchIndex();
+
+    /// Construct with custom configuration
+    /// @throws std::invalid_argument if config is invalid
+    explicit BinarySketchIndex(const Config& config);
+
+    /// Get configuration
+    const Config& GetConfig() const { return config_; }
+
+    /// Insert or replace the signature of a pattern
+    void Upsert(PatternID id, const FeatureVector& features);
+
+    /// Remove a pattern
+    /// @return true if the pattern was indexed
+    bool Remove(PatternID id);
+
+    /// Check whether a pattern is indexed
+    bool Contains(PatternID id) const { return slot_of_.count(id) > 0; }
+
+    /// Remove everything (projections are kept)
+    void Clear();
+
+    /// Number of indexed patterns
+    size_t Size() const { return ids_.size(); }
+
+    /// Pattern stored in a slot
+    PatternID IdAt(size_t slot) const { return ids_[slot]; }
+
+    /// Compute the signature of a feature vector
+    /// @return num_bits / 64 words
+    std::vector<uint64_t> Sketch(const FeatureVector& features) const;
+
+    /// Rank indexed patterns by Hamming distance to a query
+    /// @param features Query features
+    /// @param depth Maximum number of candidates to return
+    /// @return Up to depth pattern IDs, nearest signature first
+    std::vector<PatternID> Nearest(const FeatureVector& features, size_t depth) const;
+
+    /// Hamming distance between two signatures of num_words words
+    static uint32_t HammingDistance(const uint64_t* a, const uint64_t* b, size_t num_words);
+
+private:
+    const std::vector<float>& ProjectionsFor(size_t dimension) const;
+    void SketchInto(const FeatureVector& features, uint64_t* out) const;
+
+    Config config_;
+    size_t num_words_;
+
+    /// Row-major num_bits x dimension Gaussian directions, per dimension
+    /// (generated on first use; entries are never erased, so references stay valid)
+    mutable std::mutex projections_mutex_;
+    mutable std::unordered_map<size_t, std::vector<float>> projections_;
+
+    /// Dense signature array: slot i occupies words [i * num_words_, (i + 1) * num_words_)
+    std::vector<uint64_t> words_;
+    std::vector<PatternID> ids_;
+    std::vector<uint32_t> dimensions_;
+    std::unordered_map<PatternID, size_t> slot_of_;
+};
+
+} // namespace dpan
@@ -21,6 +21,88 @@ float ContextVectorSimilarity::ComputeFromFeatures(const FeatureVector& a, const
     return a.CosineSimilarity(b);
 }
 
+std::vector<float> ContextVectorSimilarity::ComputeBoundSummary(const FeatureVector& features) const {
+    const auto& data = features.Data();
+    size_t num_blocks = std::max<size_t>(1, (data.size() + kBoundBlockSize - 1) / kBoundBlockSize);
+
+    std::vector<float> summary(1 + num_blocks, 0.0f);
+    summary[0] = static_cast<float>(data.size());
+    summary[1] = features.Norm();
+
+    // Suffix norms, accumulated from the back
+    float suffix_sq = 0.0f;
+    for (size_t block = num_blocks - 1; block >= 1; --block) {
+        size_t begin = block * kBoundBlockSize;
+        size_t end = std::min(begin + kBoundBlockSize, data.size());
+        for (size_t i = begin; i < end; ++i) {
+            suffix_sq += data[i] * data[i];
+        }
+        summary[1 + block] = std::sqrt(suffix_sq);
+    }
+
+    return summary;
+}
+
+float ContextVectorSimilarity::UpperBoundFromSummaries(const std::vector<float>& summary_a,
+                                                       const std::vector<float>& summary_b) const {
+    if (summary_a.size() < 2 || summary_b.size() < 2 || summary_a[0] != summary_b[0]) {
+        return 1.0f;
+    }
+
+    // Cosine similarity is defined as 0 when either vector is zero
+    if (summary_a[1] == 0.0f || summary_b[1] == 0.0f) {
+        return 0.0f;
+    }
+    return 1.0f;
+}
+
+float ContextVectorSimilarity::ComputeFromFeaturesBounded(const FeatureVector& a,
+                                                          const std::vector<float>& summary_a,
+                                                          const FeatureVector& b,
+                                                          const std::vector<float>& summary_b,
+                                                          float threshold) const {
+    const size_t dim = a.Dimension();
+    if (dim != b.Dimension() || summary_a.size() < 2 || summary_a.size() != summary_b.size() ||
+        summary_a[0] != static_cast<float>(dim) || summary_b[0] != static_cast<float>(dim)) {
+        return ComputeFromFeatures(a, b);
+    }
+
+    float norm_product = summary_a[1] * summary_b[1];
+    if (norm_product == 0.0f) {
+        return 0.0f;
+    }
+
+    // Slack keeps the bound conservative under float rounding
+    constexpr float kRelativeSlack = 1e-4f;
+    constexpr float kAbsoluteSlack = 1e-5f;
+
+    const auto& data_a = a.Data();
+    const auto& data_b = b.Data();
+    const size_t num_blocks = summary_a.size() - 1;
+
+    // Same summation order as FeatureVector::DotProduct, so a completed
+    // evaluation is bit-identical to CosineSimilarity
+    float dot = 0.0f;
+    for (size_t block = 0; block < num_blocks; ++block) {
+        size_t begin = block * kBoundBlockSize;
+        size_t end = std::min(begin + kBoundBlockSize, dim);
+        for (size_t i = begin; i < end; ++i) {
+            dot += data_a[i] * data_b[i];
+        }
+
+        if (block + 1 < num_blocks) {
+            // |remaining dot| <= |a_tail| * |b_tail|
+            float tail = summary_a[block + 2] * summary_b[block + 2];
+            float bound = (dot + tail * (1.0f + kRelativeSlack)) / norm_product + kAbsoluteSlack;
+            if (bound < threshold) {
+                return bound;
+            }
+        }
+    }
+
+    return dot / norm_product;
+}
+
 float ContextVectorSimilarity::ComputeFromContext(const ContextVector& a, const ContextVector& b) const {
     return CosineSimilarity(a, b);
 }
@@ -31,6 +31,23 @@ public:
     std::string GetName() const override { return "ContextVector"; }
     bool IsSymmetric() const override { return true; }
 
+    /// Summary layout: [dimension, norm of elements from k * kBoundBlockSize
+    /// onward for each block k]
+    std::vector<float> ComputeBoundSummary(const FeatureVector& features) const override;
+    float UpperBoundFromSummaries(const std::vector<float>& summary_a,
+                                  const std::vector<float>& summary_b) const override;
+
+    /// Accumulates the dot product block by block and stops once the
+    /// Cauchy-Schwarz bound on the remaining blocks cannot reach threshold
+    float ComputeFromFeaturesBounded(const FeatureVector& a,
+                                     const std::vector<float>& summary_a,
+                                     const FeatureVector& b,
+                                     const std::vector<float>& summary_b,
+                                     float threshold) const override;
+
+    /// Number of elements between partial-sum bound checks
+    static constexpr size_t kBoundBlockSize = 16;
+
 private:
     /// Compute cosine similarity between sparse vectors
     static float CosineSimilarity(const ContextVector& a, const ContextVector& b);
@@ -209,6 +226,7 @@ public:
 
     std::string GetName() const override { return "Metadata"; }
     bool IsSymmetric() const override { return true; }
+    bool ComputesFromFeatures() const override { return true; }
 
     /// Add a contextual metric with weight
     void AddMetric(std::shared_ptr<SimilarityMetric> metric, float weight);
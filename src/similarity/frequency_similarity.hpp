@@ -68,6 +68,7 @@ public:
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "Spectral"; }
     bool IsSymmetric() const override { return true; }
+    bool ComputesFromFeatures() const override { return true; }
 
 private:
     bool normalize_;
@@ -98,6 +99,7 @@ public:
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "Autocorrelation"; }
     bool IsSymmetric() const override { return true; }
+    bool ComputesFromFeatures() const override { return true; }
 
 private:
     size_t max_lag_;
@@ -133,6 +135,7 @@ public:
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "FrequencyBand"; }
     bool IsSymmetric() const override { return true; }
+    bool ComputesFromFeatures() const override { return true; }
 
 private:
     size_t num_bands_;
@@ -164,6 +167,7 @@ public:
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "Phase"; }
     bool IsSymmetric() const override { return true; }
+    bool ComputesFromFeatures() const override { return true; }
 
 private:
     /// Compute phase coherence between two complex spectra
@@ -1,46 +1,180 @@
 // File: src/similarity/geometric_similarity.cpp
 #include "geometric_similarity.hpp"
 #include <algorithm>
+#include <cstring>
 #include <limits>
 #include <cmath>
 
 namespace dpan {
 
+// ============================================================================
+// Spatial Index Cache
+// ============================================================================
+
+SpatialIndexCache::SpatialIndexCache(size_t capacity)
+    : cache_1d_(capacity), cache_2d_(capacity) {}
+
+template<size_t N>
+std::shared_ptr<const PointSetIndex<N>> SpatialIndexCache::GetOrBuild(const FeatureVector& features) {
+    static_assert(N == 1 || N == 2, "SpatialIndexCache supports 1-D and 2-D point sets");
+
+    auto& cache = [this]() -> auto& {
+        if constexpr (N == 1) {
+            return cache_1d_;
+        } else {
+            return cache_2d_;
+        }
+    }();
+
+    uint64_t key = HashFeatures(features);
+    size_t num_points = features.Dimension() / N;
+
+    auto cached = cache.Get(key);
+    if (cached && *cached) {
+        // Verify the entry really was built from these features
+        const auto& points = (*cached)->GetPointSet().points;
+        if (points.size() == num_points &&
+            std::memcmp(points.data(), features.Data().data(),
+                        num_points * N * sizeof(float)) == 0) {
+            return *cached;
+        }
+    }
+
+    auto index = std::make_shared<const PointSetIndex<N>>(PointSet<N>::FromFeatureVector(features));
+    cache.Put(key, index);
+    return index;
+}
+
+template std::shared_ptr<const PointSetIndex<1>> SpatialIndexCache::GetOrBuild<1>(const FeatureVector&);
+template std::shared_ptr<const PointSetIndex<2>> SpatialIndexCache::GetOrBuild<2>(const FeatureVector&);
+
+uint64_t SpatialIndexCache::Hits() const {
+    return cache_1d_.Hits() + cache_2d_.Hits();
+}
+
+uint64_t SpatialIndexCache::Misses() const {
+    return cache_1d_.Misses() + cache_2d_.Misses();
+}
+
+void SpatialIndexCache::Clear() {
+    cache_1d_.Clear();
+    cache_2d_.Clear();
+}
+
+uint64_t SpatialIndexCache::HashFeatures(const FeatureVector& features) {
+    const auto& data = features.Data();
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    size_t length = data.size() * sizeof(float);
+
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash ^ static_cast<uint64_t>(data.size());
+}
+
+namespace {
+
+/// Distance beyond which a bounded evaluation may stop. The slack keeps
+/// float rounding from abandoning a candidate that reaches the threshold.
+float AbandonDistance(const SimilarityMetric& metric, float threshold) {
+    float distance = metric.SimilarityToDistance(threshold);
+    if (std::isinf(distance)) {
+        return distance;
+    }
+    return distance * (1.0f + 1e-4f) + 1e-5f;
+}
+
+/// Similarity for a distance produced by a bounded evaluation
+float BoundedSimilarity(float distance, float abandon_above, float threshold) {
+    float similarity = std::isinf(distance) ? 0.0f : 1.0f / (1.0f + distance);
+    if (distance > abandon_above) {
+        // Distance may be partial; only promise a value below threshold
+        return std::min(similarity,
+                        std::nextafter(threshold, -std::numeric_limits<float>::infinity()));
+    }
+    return similarity;
+}
+
+/// Largest change of 1 / (1 + distance) when every coordinate of one point
+/// set moves by at most max_error, for distances that move by at most the
+/// largest point displacement. 1 / (1 + d) is 1-Lipschitz for d >= 0; the
+/// slack covers float rounding in both evaluations.
+float PointSetPerturbation(const FeatureVector& query, float max_error) {
+    if (!std::isfinite(max_error)) {
+        return std::numeric_limits<float>::infinity();
+    }
+    size_t dim = query.Dimension();
+    float displacement = (dim >= 2 && dim % 2 == 0) ? max_error * std::sqrt(2.0f) : max_error;
+    return displacement * (1.0f + 1e-4f) + 1e-5f;
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // Hausdorff Similarity
 // ============================================================================
 
+HausdorffSimilarity::HausdorffSimilarity(std::shared_ptr<SpatialIndexCache> index_cache)
+    : index_cache_(index_cache ? std::move(index_cache) : std::make_shared<SpatialIndexCache>()) {}
+
 template<size_t N>
-float HausdorffSimilarity::ComputeHausdorff(const PointSet<N>& a, const PointSet<N>& b) {
+float HausdorffSimilarity::ComputeHausdorff(const PointSetIndex<N>& a, const PointSetIndex<N>& b,
+                                            float abandon_above) {
     if (a.Size() == 0 || b.Size() == 0) {
         return std::numeric_limits<float>::infinity();
     }
 
     // Hausdorff distance: max(directed_hausdorff(a,b), directed_hausdorff(b,a))
+    //
+    // Works on squared distances and carries the running maximum across
+    // both directions. A nearest-neighbour query is abandoned as soon as it
+    // finds a point within the current maximum, since it can no longer
+    // raise it.
+    float max_sq = 0.0f;
+    const float abandon_sq = abandon_above * abandon_above;
 
     // Directed Hausdorff from a to b
-    float max_min_dist_ab = 0.0f;
-    for (const auto& point_a : a.points) {
-        float min_dist = std::numeric_limits<float>::infinity();
-        for (const auto& point_b : b.points) {
-            float dist = point_a.DistanceTo(point_b);
-            min_dist = std::min(min_dist, dist);
+    for (const auto& point_a : a.GetPointSet().points) {
+        max_sq = std::max(max_sq, b.NearestSquaredDistance(point_a, max_sq));
+        if (max_sq > abandon_sq) {
+            return std::sqrt(max_sq);
         }
-        max_min_dist_ab = std::max(max_min_dist_ab, min_dist);
     }
 
     // Directed Hausdorff from b to a
-    float max_min_dist_ba = 0.0f;
-    for (const auto& point_b : b.points) {
-        float min_dist = std::numeric_limits<float>::infinity();
-        for (const auto& point_a : a.points) {
-            float dist = point_b.DistanceTo(point_a);
-            min_dist = std::min(min_dist, dist);
+    for (const auto& point_b : b.GetPointSet().points) {
+        max_sq = std::max(max_sq, a.NearestSquaredDistance(point_b, max_sq));
+        if (max_sq > abandon_sq) {
+            return std::sqrt(max_sq);
         }
-        max_min_dist_ba = std::max(max_min_dist_ba, min_dist);
     }
 
-    return std::max(max_min_dist_ab, max_min_dist_ba);
+    return std::sqrt(max_sq);
+}
+
+template<size_t N>
+void HausdorffSimilarity::AppendBounds(const FeatureVector& features, std::vector<float>& summary) {
+    const auto& data = features.Data();
+    size_t num_points = data.size() / N;
+
+    float lower[N];
+    float upper[N];
+    for (size_t d = 0; d < N; ++d) {
+        lower[d] = std::numeric_limits<float>::infinity();
+        upper[d] = -std::numeric_limits<float>::infinity();
+    }
+
+    for (size_t i = 0; i < num_points; ++i) {
+        for (size_t d = 0; d < N; ++d) {
+            lower[d] = std::min(lower[d], data[i * N + d]);
+            upper[d] = std::max(upper[d], data[i * N + d]);
+        }
+    }
+
+    summary.insert(summary.end(), lower, lower + N);
+    summary.insert(summary.end(), upper, upper + N);
 }
 
 float HausdorffSimilarity::Compute(const PatternData& a, const PatternData& b) const {
@@ -52,64 +186,125 @@ float HausdorffSimilarity::ComputeFromFeatures(const FeatureVector& a, const Fea
         return 0.0f;
     }
 
+    float distance = ComputeDistance(a, b, std::numeric_limits<float>::infinity());
+
+    // Convert distance to similarity: similarity = 1.0 / (1.0 + distance)
+    if (std::isinf(distance)) {
+        return 0.0f;
+    }
+    return 1.0f / (1.0f + distance);
+}
+
+float HausdorffSimilarity::ComputeFromFeaturesBounded(const FeatureVector& a,
+                                                      const std::vector<float>& /*summary_a*/,
+                                                      const FeatureVector& b,
+                                                      const std::vector<float>& /*summary_b*/,
+                                                      float threshold) const {
+    if (a.Dimension() == 0 || b.Dimension() == 0) {
+        return 0.0f;
+    }
+
+    float abandon_above = AbandonDistance(*this, threshold);
+    return BoundedSimilarity(ComputeDistance(a, b, abandon_above), abandon_above, threshold);
+}
+
+float HausdorffSimilarity::PerturbationBound(const FeatureVector& query,
+                                              const FeatureVector& /*approx*/,
+                                              float max_error) const {
+    return PointSetPerturbation(query, max_error);
+}
+
+std::vector<float> HausdorffSimilarity::ComputeBoundSummary(const FeatureVector& features) const {
+    size_t dim = features.Dimension();
+    if (dim == 0) {
+        return {};
+    }
+
+    std::vector<float> summary{static_cast<float>(dim)};
+    if (dim >= 2 && dim % 2 == 0) {
+        AppendBounds<2>(features, summary);
+    } else {
+        AppendBounds<1>(features, summary);
+    }
+    return summary;
+}
+
+float HausdorffSimilarity::UpperBoundFromSummaries(const std::vector<float>& summary_a,
+                                                   const std::vector<float>& summary_b) const {
+    // Boxes are only comparable when both vectors yield the same point layout
+    if (summary_a.size() < 3 || summary_a.size() != summary_b.size() ||
+        summary_a[0] != summary_b[0]) {
+        return 1.0f;
+    }
+
+    // The point on a box face furthest from the other box's matching face
+    // is at least that gap away from every point of the other set
+    float lower_bound = 0.0f;
+    for (size_t i = 1; i < summary_a.size(); ++i) {
+        lower_bound = std::max(lower_bound, std::abs(summary_a[i] - summary_b[i]));
+    }
+
+    return DistanceToSimilarity(lower_bound * (1.0f - 1e-4f));
+}
+
+float HausdorffSimilarity::ComputeDistance(const FeatureVector& a, const FeatureVector& b,
+                                           float abandon_above) const {
     // Determine point dimensionality based on feature vector size
     // For simplicity, use 2D points if dimension is even and >= 2
     // Otherwise use 1D points
     size_t dim = a.Dimension();
 
-    float distance;
     if (dim >= 2 && dim % 2 == 0) {
         // Use 2D points
-        auto points_a = PointSet<2>::FromFeatureVector(a);
-        auto points_b = PointSet<2>::FromFeatureVector(b);
-        distance = ComputeHausdorff(points_a, points_b);
-    } else {
-        // Use 1D points
-        auto points_a = PointSet<1>::FromFeatureVector(a);
-        auto points_b = PointSet<1>::FromFeatureVector(b);
-        distance = ComputeHausdorff(points_a, points_b);
+        auto index_a = index_cache_->GetOrBuild<2>(a);
+        auto index_b = index_cache_->GetOrBuild<2>(b);
+        return ComputeHausdorff(*index_a, *index_b, abandon_above);
     }
 
-    // Convert distance to similarity: similarity = 1.0 / (1.0 + distance)
-    if (std::isinf(distance)) {
-        return 0.0f;
-    }
-    return 1.0f / (1.0f + distance);
+    // Use 1D points
+    auto index_a = index_cache_->GetOrBuild<1>(a);
+    auto index_b = index_cache_->GetOrBuild<1>(b);
+    return ComputeHausdorff(*index_a, *index_b, abandon_above);
 }
 
 // ============================================================================
 // Chamfer Similarity
 // ============================================================================
 
+ChamferSimilarity::ChamferSimilarity(std::shared_ptr<SpatialIndexCache> index_cache)
+    : index_cache_(index_cache ? std::move(index_cache) : std::make_shared<SpatialIndexCache>()) {}
+
 template<size_t N>
-float ChamferSimilarity::ComputeChamfer(const PointSet<N>& a, const PointSet<N>& b) {
+float ChamferSimilarity::ComputeChamfer(const PointSetIndex<N>& a, const PointSetIndex<N>& b,
+                                        float abandon_above) {
     if (a.Size() == 0 || b.Size() == 0) {
         return std::numeric_limits<float>::infinity();
     }
 
     // Chamfer distance: average of directed chamfer distances
+    //
+    // All terms are non-negative, so the partial sums are lower bounds on
+    // the final distance and can be checked against abandon_above.
 
     // Directed Chamfer from a to b
+    const float limit_ab = 2.0f * abandon_above * a.Size();
     float sum_ab = 0.0f;
-    for (const auto& point_a : a.points) {
-        float min_dist = std::numeric_limits<float>::infinity();
-        for (const auto& point_b : b.points) {
-            float dist = point_a.DistanceTo(point_b);
-            min_dist = std::min(min_dist, dist);
+    for (const auto& point_a : a.GetPointSet().points) {
+        sum_ab += std::sqrt(b.NearestSquaredDistance(point_a));
+        if (sum_ab > limit_ab) {
+            return sum_ab / a.Size() / 2.0f;
         }
-        sum_ab += min_dist;
     }
     float avg_ab = sum_ab / a.Size();
 
     // Directed Chamfer from b to a
+    const float limit_ba = (2.0f * abandon_above - avg_ab) * b.Size();
     float sum_ba = 0.0f;
-    for (const auto& point_b : b.points) {
-        float min_dist = std::numeric_limits<float>::infinity();
-        for (const auto& point_a : a.points) {
-            float dist = point_b.DistanceTo(point_a);
-            min_dist = std::min(min_dist, dist);
+    for (const auto& point_b : b.GetPointSet().points) {
+        sum_ba += std::sqrt(a.NearestSquaredDistance(point_b));
+        if (sum_ba > limit_ba) {
+            return (avg_ab + sum_ba / b.Size()) / 2.0f;
         }
-        sum_ba += min_dist;
     }
     float avg_ba = sum_ba / b.Size();
 
@@ -125,18 +320,7 @@ float ChamferSimilarity::ComputeFromFeatures(const FeatureVector& a, const Featu
         return 0.0f;
     }
 
-    size_t dim = a.Dimension();
-
-    float distance;
-    if (dim >= 2 && dim % 2 == 0) {
-        auto points_a = PointSet<2>::FromFeatureVector(a);
-        auto points_b = PointSet<2>::FromFeatureVector(b);
-        distance = ComputeChamfer(points_a, points_b);
-    } else {
-        auto points_a = PointSet<1>::FromFeatureVector(a);
-        auto points_b = PointSet<1>::FromFeatureVector(b);
-        distance = ComputeChamfer(points_a, points_b);
-    }
+    float distance = ComputeDistance(a, b, std::numeric_limits<float>::infinity());
 
     if (std::isinf(distance)) {
         return 0.0f;
@@ -144,12 +328,51 @@ float ChamferSimilarity::ComputeFromFeatures(const FeatureVector& a, const Featu
     return 1.0f / (1.0f + distance);
 }
 
+float ChamferSimilarity::ComputeFromFeaturesBounded(const FeatureVector& a,
+                                                    const std::vector<float>& /*summary_a*/,
+                                                    const FeatureVector& b,
+                                                    const std::vector<float>& /*summary_b*/,
+                                                    float threshold) const {
+    if (a.Dimension() == 0 || b.Dimension() == 0) {
+        return 0.0f;
+    }
+
+    float abandon_above = AbandonDistance(*this, threshold);
+    return BoundedSimilarity(ComputeDistance(a, b, abandon_above), abandon_above, threshold);
+}
+
+float ChamferSimilarity::PerturbationBound(const FeatureVector& query,
+                                            const FeatureVector& /*approx*/,
+                                            float max_error) const {
+    return PointSetPerturbation(query, max_error);
+}
+
+float ChamferSimilarity::ComputeDistance(const FeatureVector& a, const FeatureVector& b,
+                                         float abandon_above) const {
+    size_t dim = a.Dimension();
+
+    if (dim >= 2 && dim % 2 == 0) {
+        auto index_a = index_cache_->GetOrBuild<2>(a);
+        auto index_b = index_cache_->GetOrBuild<2>(b);
+        return ComputeChamfer(*index_a, *index_b, abandon_above);
+    }
+
+    auto index_a = index_cache_->GetOrBuild<1>(a);
+    auto index_b = index_cache_->GetOrBuild<1>(b);
+    return ComputeChamfer(*index_a, *index_b, abandon_above);
+}
+
 // ============================================================================
 // Modified Hausdorff Similarity
 // ============================================================================
 
+ModifiedHausdorffSimilarity::ModifiedHausdorffSimilarity(std::shared_ptr<SpatialIndexCache> index_cache)
+    : index_cache_(index_cache ? std::move(index_cache) : std::make_shared<SpatialIndexCache>()) {}
+
 template<size_t N>
-float ModifiedHausdorffSimilarity::ComputeModifiedHausdorff(const PointSet<N>& a, const PointSet<N>& b) {
+float ModifiedHausdorffSimilarity::ComputeModifiedHausdorff(const PointSetIndex<N>& a,
+                                                            const PointSetIndex<N>& b,
+                                                            float abandon_above) {
     if (a.Size() == 0 || b.Size() == 0) {
         return std::numeric_limits<float>::infinity();
     }
@@ -157,26 +380,24 @@ float ModifiedHausdorffSimilarity::ComputeModifiedHausdorff(const PointSet<N>& a
     // Modified Hausdorff: average of minimum distances instead of maximum
 
     // From a to b
+    const float limit_ab = abandon_above * a.Size();
     float sum_ab = 0.0f;
-    for (const auto& point_a : a.points) {
-        float min_dist = std::numeric_limits<float>::infinity();
-        for (const auto& point_b : b.points) {
-            float dist = point_a.DistanceTo(point_b);
-            min_dist = std::min(min_dist, dist);
+    for (const auto& point_a : a.GetPointSet().points) {
+        sum_ab += std::sqrt(b.NearestSquaredDistance(point_a));
+        if (sum_ab > limit_ab) {
+            return sum_ab / a.Size();
         }
-        sum_ab += min_dist;
     }
     float avg_ab = sum_ab / a.Size();
 
     // From b to a
+    const float limit_ba = abandon_above * b.Size();
     float sum_ba = 0.0f;
-    for (const auto& point_b : b.points) {
-        float min_dist = std::numeric_limits<float>::infinity();
-        for (const auto& point_a : a.points) {
-            float dist = point_b.DistanceTo(point_a);
-            min_dist = std::min(min_dist, dist);
+    for (const auto& point_b : b.GetPointSet().points) {
+        sum_ba += std::sqrt(a.NearestSquaredDistance(point_b));
+        if (sum_ba > limit_ba) {
+            return std::max(avg_ab, sum_ba / b.Size());
         }
-        sum_ba += min_dist;
     }
     float avg_ba = sum_ba / b.Size();
 
@@ -192,18 +413,7 @@ float ModifiedHausdorffSimilarity::ComputeFromFeatures(const FeatureVector& a, c
         return 0.0f;
     }
 
-    size_t dim = a.Dimension();
-
-    float distance;
-    if (dim >= 2 && dim % 2 == 0) {
-        auto points_a = PointSet<2>::FromFeatureVector(a);
-        auto points_b = PointSet<2>::FromFeatureVector(b);
-        distance = ComputeModifiedHausdorff(points_a, points_b);
-    } else {
-        auto points_a = PointSet<1>::FromFeatureVector(a);
-        auto points_b = PointSet<1>::FromFeatureVector(b);
-        distance = ComputeModifiedHausdorff(points_a, points_b);
-    }
+    float distance = ComputeDistance(a, b, std::numeric_limits<float>::infinity());
 
     if (std::isinf(distance)) {
         return 0.0f;
@@ -211,6 +421,40 @@ float ModifiedHausdorffSimilarity::ComputeFromFeatures(const FeatureVector& a, c
     return 1.0f / (1.0f + distance);
 }
 
+float ModifiedHausdorffSimilarity::ComputeFromFeaturesBounded(const FeatureVector& a,
+                                                              const std::vector<float>& /*summary_a*/,
+                                                              const FeatureVector& b,
+                                                              const std::vector<float>& /*summary_b*/,
+                                                              float threshold) const {
+    if (a.Dimension() == 0 || b.Dimension() == 0) {
+        return 0.0f;
+    }
+
+    float abandon_above = AbandonDistance(*this, threshold);
+    return BoundedSimilarity(ComputeDistance(a, b, abandon_above), abandon_above, threshold);
+}
+
+float ModifiedHausdorffSimilarity::PerturbationBound(const FeatureVector& query,
+                                                     const FeatureVector& /*approx*/,
+                                                     float max_error) const {
+    return PointSetPerturbation(query, max_error);
+}
+
+float ModifiedHausdorffSimilarity::ComputeDistance(const FeatureVector& a, const FeatureVector& b,
+                                                   float abandon_above) const {
+    size_t dim = a.Dimension();
+
+    if (dim >= 2 && dim % 2 == 0) {
+        auto index_a = index_cache_->GetOrBuild<2>(a);
+        auto index_b = index_cache_->GetOrBuild<2>(b);
+        return ComputeModifiedHausdorff(*index_a, *index_b, abandon_above);
+    }
+
+    auto index_a = index_cache_->GetOrBuild<1>(a);
+    auto index_b = index_cache_->GetOrBuild<1>(b);
+    return ComputeModifiedHausdorff(*index_a, *index_b, abandon_above);
+}
+
 // ============================================================================
 // Procrustes Similarity
 // ============================================================================
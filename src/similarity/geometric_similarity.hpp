@@ -2,6 +2,11 @@
 #pragma once
 
 #include "similarity_metric.hpp"
+#include "storage/lru_cache.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <vector>
 #include <cmath>
 
@@ -72,6 +77,244 @@ struct PointSet {
     }
 };
 
+/// Squared distance from a query point to the nearest of points [begin, end)
+/// stored as structure-of-arrays (one contiguous array per axis).
+///
+/// Accumulates into kLanes independent minima so the loop is vectorized
+/// by the compiler without requiring -ffast-math.
+template<size_t N>
+inline float MinSquaredDistanceSoA(const float* const* axes, size_t begin, size_t end,
+                                   const Point<N>& query) {
+    constexpr size_t kLanes = 8;
+    float lane_min[kLanes];
+    for (size_t l = 0; l < kLanes; ++l) {
+        lane_min[l] = std::numeric_limits<float>::infinity();
+    }
+
+    size_t i = begin;
+    for (; i + kLanes <= end; i += kLanes) {
+        for (size_t l = 0; l < kLanes; ++l) {
+            float sum = 0.0f;
+            for (size_t d = 0; d < N; ++d) {
+                float diff = query.coords[d] - axes[d][i + l];
+                sum += diff * diff;
+            }
+            lane_min[l] = sum < lane_min[l] ? sum : lane_min[l];
+        }
+    }
+
+    float result = std::numeric_limits<float>::infinity();
+    for (size_t l = 0; l < kLanes; ++l) {
+        result = lane_min[l] < result ? lane_min[l] : result;
+    }
+
+    for (; i < end; ++i) {
+        float sum = 0.0f;
+        for (size_t d = 0; d < N; ++d) {
+            float diff = query.coords[d] - axes[d][i];
+            sum += diff * diff;
+        }
+        result = sum < result ? sum : result;
+    }
+
+    return result;
+}
+
+/// KD-tree over a point set for nearest-neighbour distance queries
+///
+/// Points are reordered so that every leaf covers a contiguous range and
+/// stored as structure-of-arrays; leaves are scanned with
+/// MinSquaredDistanceSoA. Sets no larger than kLeafSize form a single leaf,
+/// which degenerates to a vectorized brute-force scan.
+///
+/// Immutable after construction, so it can be shared between threads.
+template<size_t N>
+class PointSetIndex {
+public:
+    /// Maximum number of points in a leaf
+    static constexpr size_t kLeafSize = 32;
+
+    /// Build the index
+    /// @param set Point set to index (copied)
+    explicit PointSetIndex(const PointSet<N>& set) : source_(set) {
+        if (set.Size() == 0) {
+            return;
+        }
+
+        std::vector<Point<N>> points = set.points;
+        nodes_.reserve(2 * (points.size() / kLeafSize + 1));
+        Build(points, 0, points.size());
+
+        for (size_t d = 0; d < N; ++d) {
+            axes_[d].resize(points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                axes_[d][i] = points[i][d];
+            }
+        }
+    }
+
+    /// Number of indexed points
+    size_t Size() const { return source_.Size(); }
+
+    /// Indexed points in their original order
+    const PointSet<N>& GetPointSet() const { return source_; }
+
+    /// Squared distance from query to the nearest indexed point
+    ///
+    /// If a point with squared distance <= stop_below_sq is found the search
+    /// is abandoned and that distance is returned; the result is then an
+    /// upper bound that is known not to exceed stop_below_sq. Pass a negative
+    /// value to always obtain the exact minimum.
+    ///
+    /// @param query Query point
+    /// @param stop_below_sq Early-abandon bound on the squared distance
+    /// @return Squared nearest distance (infinity if the index is empty)
+    float NearestSquaredDistance(const Point<N>& query, float stop_below_sq = -1.0f) const {
+        float best = std::numeric_limits<float>::infinity();
+        if (nodes_.empty()) {
+            return best;
+        }
+
+        const float* axes[N];
+        for (size_t d = 0; d < N; ++d) {
+            axes[d] = axes_[d].data();
+        }
+
+        // Depth-first traversal, nearer child first; 64 levels is far more
+        // than a balanced tree over any in-memory point set needs
+        uint32_t stack[64];
+        size_t top = 0;
+        stack[top++] = 0;
+
+        while (top > 0) {
+            const Node& node = nodes_[stack[--top]];
+            if (BoxSquaredDistance(node, query) >= best) {
+                continue;
+            }
+
+            if (node.left < 0) {
+                float leaf_best = MinSquaredDistanceSoA<N>(axes, node.begin, node.end, query);
+                if (leaf_best < best) {
+                    best = leaf_best;
+                    if (best <= stop_below_sq) {
+                        return best;
+                    }
+                }
+                continue;
+            }
+
+            const Node& left = nodes_[node.left];
+            const Node& right = nodes_[node.right];
+            bool left_first = BoxSquaredDistance(left, query) <= BoxSquaredDistance(right, query);
+            stack[top++] = static_cast<uint32_t>(left_first ? node.right : node.left);
+            stack[top++] = static_cast<uint32_t>(left_first ? node.left : node.right);
+        }
+
+        return best;
+    }
+
+private:
+    struct Node {
+        float lo[N];
+        float hi[N];
+        uint32_t begin;
+        uint32_t end;
+        int32_t left{-1};
+        int32_t right{-1};
+    };
+
+    PointSet<N> source_;
+    std::vector<float> axes_[N];
+    std::vector<Node> nodes_;
+
+    /// Recursively build the subtree for points[begin, end)
+    int32_t Build(std::vector<Point<N>>& points, size_t begin, size_t end) {
+        int32_t index = static_cast<int32_t>(nodes_.size());
+        nodes_.emplace_back();
+
+        Node node;
+        node.begin = static_cast<uint32_t>(begin);
+        node.end = static_cast<uint32_t>(end);
+        for (size_t d = 0; d < N; ++d) {
+            node.lo[d] = std::numeric_limits<float>::infinity();
+            node.hi[d] = -std::numeric_limits<float>::infinity();
+        }
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t d = 0; d < N; ++d) {
+                node.lo[d] = std::min(node.lo[d], points[i][d]);
+                node.hi[d] = std::max(node.hi[d], points[i][d]);
+            }
+        }
+
+        if (end - begin > kLeafSize) {
+            // Split at the median of the widest axis
+            size_t axis = 0;
+            for (size_t d = 1; d < N; ++d) {
+                if (node.hi[d] - node.lo[d] > node.hi[axis] - node.lo[axis]) {
+                    axis = d;
+                }
+            }
+
+            size_t mid = begin + (end - begin) / 2;
+            std::nth_element(points.begin() + begin, points.begin() + mid, points.begin() + end,
+                [axis](const Point<N>& a, const Point<N>& b) { return a[axis] < b[axis]; });
+
+            node.left = Build(points, begin, mid);
+            node.right = Build(points, mid, end);
+        }
+
+        nodes_[index] = node;
+        return index;
+    }
+
+    /// Squared distance from query to a node's bounding box (0 if inside)
+    static float BoxSquaredDistance(const Node& node, const Point<N>& query) {
+        float sum = 0.0f;
+        for (size_t d = 0; d < N; ++d) {
+            float below = node.lo[d] - query[d];
+            float above = query[d] - node.hi[d];
+            float diff = std::max(0.0f, std::max(below, above));
+            sum += diff * diff;
+        }
+        return sum;
+    }
+};
+
+/// Bounded cache of PointSetIndex instances keyed by feature content
+///
+/// Stored patterns are compared many times during search; caching their
+/// spatial indices means each one is built once rather than per comparison.
+/// Entries are verified against the source features on lookup, so hash
+/// collisions never return a wrong index. Thread-safe.
+class SpatialIndexCache {
+public:
+    /// Constructor
+    /// @param capacity Maximum number of cached indices per dimensionality
+    explicit SpatialIndexCache(size_t capacity = 1024);
+
+    /// Get the index for a feature vector, building and caching it on a miss
+    /// @param features Feature vector interpreted as consecutive N-d points
+    /// @return Shared immutable index
+    template<size_t N>
+    std::shared_ptr<const PointSetIndex<N>> GetOrBuild(const FeatureVector& features);
+
+    /// Number of cache hits
+    uint64_t Hits() const;
+
+    /// Number of cache misses (index builds)
+    uint64_t Misses() const;
+
+    /// Remove all cached indices and reset statistics
+    void Clear();
+
+private:
+    LRUCache<uint64_t, std::shared_ptr<const PointSetIndex<1>>> cache_1d_;
+    LRUCache<uint64_t, std::shared_ptr<const PointSetIndex<2>>> cache_2d_;
+
+    /// FNV-1a hash of the feature values
+    static uint64_t HashFeatures(const FeatureVector& features);
+};
+
 /// Hausdorff Distance
 ///
 /// Measures the maximum distance from any point in one set
@@ -80,19 +323,59 @@ struct PointSet {
 ///
 /// This is converted to similarity by normalization:
 /// similarity = 1.0 / (1.0 + hausdorff_distance)
+///
+/// Nearest-neighbour queries run against cached KD-tree indices, and each
+/// query is abandoned as soon as it cannot raise the running maximum.
 class HausdorffSimilarity : public SimilarityMetric {
 public:
-    HausdorffSimilarity() = default;
+    /// Constructor
+    /// @param index_cache Spatial index cache (a private one is created if null)
+    explicit HausdorffSimilarity(std::shared_ptr<SpatialIndexCache> index_cache = nullptr);
 
     float Compute(const PatternData& a, const PatternData& b) const override;
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "Hausdorff"; }
     bool IsSymmetric() const override { return true; }
     bool IsMetric() const override { return true; }
+    bool ComputesFromFeatures() const override { return true; }
+
+    /// Summary layout: [dimension, per-axis lower bounds, per-axis upper bounds]
+    /// of the point set. Any extreme point of one box lies at least the gap
+    /// between the boxes' faces away from the other set.
+    std::vector<float> ComputeBoundSummary(const FeatureVector& features) const override;
+    float UpperBoundFromSummaries(const std::vector<float>& summary_a,
+                                  const std::vector<float>& summary_b) const override;
+
+    /// Stops as soon as the running maximum exceeds the distance
+    /// corresponding to threshold
+    float ComputeFromFeaturesBounded(const FeatureVector& a,
+                                     const std::vector<float>& summary_a,
+                                     const FeatureVector& b,
+                                     const std::vector<float>& summary_b,
+                                     float threshold) const override;
+
+    /// Moving every point by at most d moves the distance by at most d
+    float PerturbationBound(const FeatureVector& query,
+                            const FeatureVector& approx,
+                            float max_error) const override;
+
+    /// Get the spatial index cache
+    std::shared_ptr<SpatialIndexCache> GetIndexCache() const { return index_cache_; }
 
 private:
+    std::shared_ptr<SpatialIndexCache> index_cache_;
+
+    /// Hausdorff distance between feature vectors (see ComputeHausdorff)
+    float ComputeDistance(const FeatureVector& a, const FeatureVector& b,
+                          float abandon_above) const;
+
+    /// Hausdorff distance; returns a lower bound as soon as it exceeds abandon_above
     template<size_t N>
-    static float ComputeHausdorff(const PointSet<N>& a, const PointSet<N>& b);
+    static float ComputeHausdorff(const PointSetIndex<N>& a, const PointSetIndex<N>& b,
+                                  float abandon_above = std::numeric_limits<float>::infinity());
+
+    template<size_t N>
+    static void AppendBounds(const FeatureVector& features, std::vector<float>& summary);
 };
 
 /// Chamfer Distance
@@ -102,19 +385,49 @@ private:
 /// Lower values = more similar (0.0 = identical)
 ///
 /// Converted to similarity: similarity = 1.0 / (1.0 + chamfer_distance)
+///
+/// Nearest-neighbour queries run against cached KD-tree indices.
 class ChamferSimilarity : public SimilarityMetric {
 public:
-    ChamferSimilarity() = default;
+    /// Constructor
+    /// @param index_cache Spatial index cache (a private one is created if null)
+    explicit ChamferSimilarity(std::shared_ptr<SpatialIndexCache> index_cache = nullptr);
 
     float Compute(const PatternData& a, const PatternData& b) const override;
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "Chamfer"; }
     bool IsSymmetric() const override { return true; }
     bool IsMetric() const override { return false; }  // Chamfer is not a true metric
+    bool ComputesFromFeatures() const override { return true; }
+
+    /// Stops once the partial sums alone exceed the distance
+    /// corresponding to threshold
+    float ComputeFromFeaturesBounded(const FeatureVector& a,
+                                     const std::vector<float>& summary_a,
+                                     const FeatureVector& b,
+                                     const std::vector<float>& summary_b,
+                                     float threshold) const override;
+
+    /// Moving every point by at most d moves each nearest-neighbour
+    /// distance, and so their average, by at most d
+    float PerturbationBound(const FeatureVector& query,
+                            const FeatureVector& approx,
+                            float max_error) const override;
+
+    /// Get the spatial index cache
+    std::shared_ptr<SpatialIndexCache> GetIndexCache() const { return index_cache_; }
 
 private:
+    std::shared_ptr<SpatialIndexCache> index_cache_;
+
+    /// Chamfer distance between feature vectors (see ComputeChamfer)
+    float ComputeDistance(const FeatureVector& a, const FeatureVector& b,
+                          float abandon_above) const;
+
+    /// Chamfer distance; returns a lower bound as soon as it exceeds abandon_above
     template<size_t N>
-    static float ComputeChamfer(const PointSet<N>& a, const PointSet<N>& b);
+    static float ComputeChamfer(const PointSetIndex<N>& a, const PointSetIndex<N>& b,
+                                float abandon_above = std::numeric_limits<float>::infinity());
 };
 
 /// Modified Hausdorff Distance
@@ -123,19 +436,49 @@ private:
 /// Lower values = more similar (0.0 = identical)
 ///
 /// Converted to similarity: similarity = 1.0 / (1.0 + distance)
+///
+/// Nearest-neighbour queries run against cached KD-tree indices.
 class ModifiedHausdorffSimilarity : public SimilarityMetric {
 public:
-    ModifiedHausdorffSimilarity() = default;
+    /// Constructor
+    /// @param index_cache Spatial index cache (a private one is created if null)
+    explicit ModifiedHausdorffSimilarity(std::shared_ptr<SpatialIndexCache> index_cache = nullptr);
 
     float Compute(const PatternData& a, const PatternData& b) const override;
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "ModifiedHausdorff"; }
     bool IsSymmetric() const override { return true; }
     bool IsMetric() const override { return false; }
+    bool ComputesFromFeatures() const override { return true; }
+
+    /// Stops once either directed partial sum exceeds the distance
+    /// corresponding to threshold
+    float ComputeFromFeaturesBounded(const FeatureVector& a,
+                                     const std::vector<float>& summary_a,
+                                     const FeatureVector& b,
+                                     const std::vector<float>& summary_b,
+                                     float threshold) const override;
+
+    /// Moving every point by at most d moves each nearest-neighbour
+    /// distance, and so their average, by at most d
+    float PerturbationBound(const FeatureVector& query,
+                            const FeatureVector& approx,
+                            float max_error) const override;
+
+    /// Get the spatial index cache
+    std::shared_ptr<SpatialIndexCache> GetIndexCache() const { return index_cache_; }
 
 private:
+    std::shared_ptr<SpatialIndexCache> index_cache_;
+
+    /// Modified Hausdorff distance between feature vectors
+    float ComputeDistance(const FeatureVector& a, const FeatureVector& b,
+                          float abandon_above) const;
+
+    /// Modified Hausdorff distance; returns a lower bound as soon as it exceeds abandon_above
     template<size_t N>
-    static float ComputeModifiedHausdorff(const PointSet<N>& a, const PointSet<N>& b);
+    static float ComputeModifiedHausdorff(const PointSetIndex<N>& a, const PointSetIndex<N>& b,
+                                          float abandon_above = std::numeric_limits<float>::infinity());
 };
 
 /// Procrustes Distance
@@ -154,6 +497,7 @@ public:
     std::string GetName() const override { return "Procrustes"; }
     bool IsSymmetric() const override { return true; }
     bool IsMetric() const override { return false; }
+    bool ComputesFromFeatures() const override { return true; }
 
 private:
     template<size_t N>
@@ -0,0 +1,523 @@
+// File: src/similarity/kmeans_clusterer.cpp
+#include "similarity/kmeans_clusterer.hpp"
+#include "core/worker_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace dpan {
+
+namespace {
+
+constexpr size_t kChunkSize = 2048;      // Points per parallel task
+constexpr size_t kMaxPartialSums = 16;   // Partial centroid sums reduced in order
+
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+struct PointMatrix {
+    const float* points;
+    size_t count;
+    size_t dimension;
+
+    const float* Row(size_t i) const { return points + i * dimension; }
+};
+
+/// Run fn(chunk, begin, end) over [0, count) in chunks of chunk_size
+template <typename Fn>
+void ForEachChunk(WorkerPool& pool, size_t count, size_t chunk_size, const Fn& fn) {
+    const size_t chunks = (count + chunk_size - 1) / chunk_size;
+    if (chunks <= 1) {
+        if (count > 0) {
+            fn(size_t{0}, size_t{0}, count);
+        }
+        return;
+    }
+    pool.ParallelFor(chunks, [&](size_t chunk) {
+        fn(chunk, chunk * chunk_size, std::min(count, (chunk + 1) * chunk_size));
+    });
+}
+
+size_t ChunkCount(size_t count, size_t chunk_size) {
+    return std::max<size_t>(1, (count + chunk_size - 1) / chunk_size);
+}
+
+/// Nearest and second-nearest centroid of a point (squared distances)
+struct Nearest {
+    uint32_t cluster{0};
+    float best{kInfinity};
+    float second{kInfinity};
+};
+
+Nearest FindNearest(const float* point, const float* centroids, size_t k, size_t dimension) {
+    Nearest nearest;
+    for (size_t c = 0; c < k; ++c) {
+        float distance = SquaredEuclideanDistance(point, centroids + c * dimension, dimension);
+        if (distance < nearest.best) {
+            nearest.second = nearest.best;
+            nearest.best = distance;
+            nearest.cluster = static_cast<uint32_t>(c);
+        } else if (distance < nearest.second) {
+            nearest.second = distance;
+        }
+    }
+    return nearest;
+}
+
+double UniformUnit(std::mt19937_64& rng) {
+    return static_cast<double>(rng() >> 11) * 0x1.0p-53;
+}
+
+/// Greedy k-means++: each further centroid is the best of a few points
+/// drawn with probability proportional to their squared distance from the
+/// centroids chosen so far, best meaning the lowest total of those distances
+/// once it is added
+/// @param sample Rows to seed from (empty = all points)
+std::vector<float> SeedCentroids(const PointMatrix& matrix, const std::vector<uint32_t>& sample,
+                                 size_t k, std::mt19937_64& rng, WorkerPool& pool,
+                                 uint64_t& distance_computations) {
+    const size_t dim = matrix.dimension;
+    const size_t n = sample.empty() ? matrix.count : sample.size();
+    auto row = [&](size_t i) {
+        return matrix.Row(sample.empty() ? i : sample[i]);
+    };
+    const size_t trials = 2 + static_cast<size_t>(std::log(static_cast<double>(k)));
+    const size_t chunks = ChunkCount(n, kChunkSize);
+
+    std::vector<float> centroids(k * dim);
+    std::vector<float> nearest(n, kInfinity);
+    std::vector<double> chunk_weight(chunks, 0.0);
+    std::vector<size_t> candidates(trials);
+    std::vector<double> candidate_weight(chunks * trials, 0.0);
+
+    // Chunk totals of min(nearest, distance to the centroid at `centroid`),
+    // written back into nearest when update is set
+    auto fold = [&](const float* centroid, bool update, double* weights) {
+        ForEachChunk(pool, n, kChunkSize, [&](size_t chunk, size_t begin, size_t end) {
+            double weight = 0.0;
+            for (size_t i = begin; i < end; ++i) {
+                float distance = std::min(nearest[i], SquaredEuclideanDistance(row(i), centroid, dim));
+                if (update) {
+                    nearest[i] = distance;
+                }
+                weight += distance;
+            }
+            weights[chunk] = weight;
+        });
+        distance_computations += n;
+        double total = 0.0;
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            total += weights[chunk];
+        }
+        return total;
+    };
+
+    // Point drawn with probability proportional to nearest
+    auto draw = [&](double total) {
+        double target = UniformUnit(rng) * total;
+        size_t chunk = 0;
+        while (chunk + 1 < chunks && target >= chunk_weight[chunk]) {
+            target -= chunk_weight[chunk];
+            ++chunk;
+        }
+        const size_t begin = chunk * kChunkSize;
+        const size_t end = std::min(n, begin + kChunkSize);
+        size_t chosen = begin;
+        for (size_t i = begin; i < end; ++i) {
+            if (nearest[i] > 0.0f) {
+                chosen = i;  // Last candidate if rounding runs past the end
+                if (target < nearest[i]) {
+                    break;
+                }
+                target -= nearest[i];
+            }
+        }
+        return chosen;
+    };
+
+    size_t chosen = static_cast<size_t>(rng() % n);
+    for (size_t c = 0; c < k; ++c) {
+        std::copy(row(chosen), row(chosen) + dim, centroids.begin() + static_cast<std::ptrdiff_t>(c * dim));
+        if (c + 1 == k) {
+            break;
+        }
+
+        const double total = fold(centroids.data() + c * dim, true, chunk_weight.data());
+        if (!(total > 0.0)) {
+            // Every point coincides with a centroid; duplicates are unavoidable
+            chosen = static_cast<size_t>(rng() % n);
+            continue;
+        }
+
+        double best_potential = std::numeric_limits<double>::infinity();
+        for (size_t t = 0; t < trials; ++t) {
+            candidates[t] = draw(total);
+        }
+        for (size_t t = 0; t < trials; ++t) {
+            double potential = fold(row(candidates[t]), false, candidate_weight.data() + t * chunks);
+            if (potential < best_potential) {
+                best_potential = potential;
+                chosen = candidates[t];
+            }
+        }
+    }
+    return centroids;
+}
+
+/// Per-cluster sums and counts of the points assigned to each cluster
+struct CentroidSums {
+    CentroidSums(size_t count, size_t k, size_t dimension)
+        : k(k), dimension(dimension),
+          partials(std::min(kMaxPartialSums, ChunkCount(count, kChunkSize))),
+          partial_sums(partials * k * dimension), partial_counts(partials * k),
+          sums(k * dimension), counts(k) {}
+
+    void Compute(const PointMatrix& matrix, const std::vector<uint32_t>& assignments,
+                 WorkerPool& pool) {
+        const size_t n = matrix.count;
+        const size_t stride = k * dimension;
+        auto accumulate = [&](size_t p) {
+            double* sums_p = partial_sums.data() + p * stride;
+            size_t* counts_p = partial_counts.data() + p * k;
+            std::fill(sums_p, sums_p + stride, 0.0);
+            std::fill(counts_p, counts_p + k, size_t{0});
+            for (size_t i = n * p / partials; i < n * (p + 1) / partials; ++i) {
+                const float* point = matrix.Row(i);
+                double* sum = sums_p + assignments[i] * dimension;
+                for (size_t d = 0; d < dimension; ++d) {
+                    sum[d] += point[d];
+                }
+                ++counts_p[assignments[i]];
+            }
+        };
+        if (partials == 1) {
+            accumulate(0);
+        } else {
+            pool.ParallelFor(partials, accumulate);
+        }
+
+        // Reduce in partial order so the result does not depend on threads
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), size_t{0});
+        for (size_t p = 0; p < partials; ++p) {
+            for (size_t j = 0; j < stride; ++j) {
+                sums[j] += partial_sums[p * stride + j];
+            }
+            for (size_t c = 0; c < k; ++c) {
+                counts[c] += partial_counts[p * k + c];
+            }
+        }
+    }
+
+    size_t k;
+    size_t dimension;
+    size_t partials;
+    std::vector<double> partial_sums;
+    std::vector<size_t> partial_counts;
+    std::vector<double> sums;
+    std::vector<size_t> counts;
+};
+
+/// Give each empty cluster the point with the largest distance bound,
+/// taken from a cluster that keeps at least one point
+void ReseedEmptyClusters(const PointMatrix& matrix, CentroidSums& sums,
+                         std::vector<uint32_t>& assignments,
+                         std::vector<float>& upper, std::vector<float>& lower) {
+    const size_t dim = matrix.dimension;
+    for (size_t c = 0; c < sums.counts.size(); ++c) {
+        if (sums.counts[c] > 0) {
+            continue;
+        }
+
+        size_t farthest = matrix.count;
+        float farthest_bound = 0.0f;
+        for (size_t i = 0; i < matrix.count; ++i) {
+            if (upper[i] > farthest_bound && sums.counts[assignments[i]] > 1) {
+                farthest = i;
+                farthest_bound = upper[i];
+            }
+        }
+        if (farthest == matrix.count) {
+            return;  // Every point sits on its centroid
+        }
+
+        const float* point = matrix.Row(farthest);
+        const uint32_t from = assignments[farthest];
+        for (size_t d = 0; d < dim; ++d) {
+            sums.sums[from * dim + d] -= point[d];
+            sums.sums[c * dim + d] = point[d];
+        }
+        --sums.counts[from];
+        sums.counts[c] = 1;
+        assignments[farthest] = static_cast<uint32_t>(c);
+        upper[farthest] = 0.0f;
+        lower[farthest] = 0.0f;
+    }
+}
+
+/// Lloyd iterations, skipping centroid scans Hamerly's bounds rule out
+void RefineExact(const PointMatrix& matrix, bool use_bounds,
+                 const KMeansClusterer::Config& config, WorkerPool& pool,
+                 KMeansClusterer::Result& result) {
+    const size_t n = matrix.count;
+    const size_t dim = matrix.dimension;
+    const size_t k = config.num_clusters;
+    float* centroids = result.centroids.data();
+    auto& assignments = result.assignments;
+
+    // upper: bound on the distance to the assigned centroid
+    // lower: bound on the distance to every other centroid
+    std::vector<float> upper(n);
+    std::vector<float> lower(n);
+    assignments.assign(n, 0);
+    ForEachChunk(pool, n, kChunkSize, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Nearest nearest = FindNearest(matrix.Row(i), centroids, k, dim);
+            assignments[i] = nearest.cluster;
+            upper[i] = std::sqrt(nearest.best);
+            lower[i] = std::sqrt(nearest.second);
+        }
+    });
+    result.distance_computations += static_cast<uint64_t>(n) * k;
+
+    CentroidSums sums(n, k, dim);
+    std::vector<float> previous(k * dim);
+    std::vector<float> shift(k);
+    std::vector<float> half_gap(k);
+    const size_t chunks = ChunkCount(n, kChunkSize);
+    std::vector<size_t> chunk_changed(chunks);
+    std::vector<uint64_t> chunk_distances(chunks);
+
+    for (size_t iteration = 0; iteration < config.max_iterations; ++iteration) {
+        ++result.iterations;
+
+        sums.Compute(matrix, assignments, pool);
+        ReseedEmptyClusters(matrix, sums, assignments, upper, lower);
+
+        std::copy(centroids, centroids + k * dim, previous.begin());
+        size_t farthest_moved = 0;
+        float max_shift = 0.0f;
+        float second_shift = 0.0f;
+        for (size_t c = 0; c < k; ++c) {
+            if (sums.counts[c] > 0) {
+                const double inv_count = 1.0 / static_cast<double>(sums.counts[c]);
+                for (size_t d = 0; d < dim; ++d) {
+                    centroids[c * dim + d] = static_cast<float>(sums.sums[c * dim + d] * inv_count);
+                }
+            }
+            shift[c] = std::sqrt(SquaredEuclideanDistance(previous.data() + c * dim,
+                                                          centroids + c * dim, dim));
+            if (shift[c] > max_shift) {
+                second_shift = max_shift;
+                max_shift = shift[c];
+                farthest_moved = c;
+            } else if (shift[c] > second_shift) {
+                second_shift = shift[c];
+            }
+        }
+        if (max_shift <= config.tolerance) {
+            result.converged = true;
+            break;
+        }
+
+        if (use_bounds) {
+            // A point closer to its centroid than half the gap to the
+            // nearest other centroid cannot be closer to that one
+            std::fill(half_gap.begin(), half_gap.end(), kInfinity);
+            for (size_t a = 0; a < k; ++a) {
+                for (size_t b = a + 1; b < k; ++b) {
+                    float gap = 0.5f * std::sqrt(SquaredEuclideanDistance(
+                        centroids + a * dim, centroids + b * dim, dim));
+                    half_gap[a] = std::min(half_gap[a], gap);
+                    half_gap[b] = std::min(half_gap[b], gap);
+                }
+            }
+        }
+
+        ForEachChunk(pool, n, kChunkSize, [&](size_t chunk, size_t begin, size_t end) {
+            size_t changed = 0;
+            uint64_t distances = 0;
+            for (size_t i = begin; i < end; ++i) {
+                const float* point = matrix.Row(i);
+                const uint32_t assigned = assignments[i];
+                if (use_bounds) {
+                    upper[i] += shift[assigned];
+                    lower[i] -= assigned == farthest_moved ? second_shift : max_shift;
+                    const float bound = std::max(half_gap[assigned], lower[i]);
+                    if (upper[i] <= bound) {
+                        continue;
+                    }
+                    upper[i] = std::sqrt(SquaredEuclideanDistance(point, centroids + assigned * dim, dim));
+                    ++distances;
+                    if (upper[i] <= bound) {
+                        continue;
+                    }
+                }
+
+                Nearest nearest = FindNearest(point, centroids, k, dim);
+                distances += k;
+                if (nearest.cluster != assigned) {
+                    assignments[i] = nearest.cluster;
+                    ++changed;
+                }
+                upper[i] = std::sqrt(nearest.best);
+                lower[i] = std::sqrt(nearest.second);
+            }
+            chunk_changed[chunk] = changed;
+            chunk_distances[chunk] = distances;
+        });
+
+        size_t changed = 0;
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            changed += chunk_changed[chunk];
+            result.distance_computations += chunk_distances[chunk];
+        }
+        if (changed == 0) {
+            // Centroids are already the means of these assignments
+            result.converged = true;
+            break;
+        }
+    }
+}
+
+/// Running-mean centroid updates from random batches
+void RefineMiniBatch(const PointMatrix& matrix, const KMeansClusterer::Config& config,
+                     std::mt19937_64& rng, WorkerPool& pool, KMeansClusterer::Result& result) {
+    const size_t n = matrix.count;
+    const size_t dim = matrix.dimension;
+    const size_t k = config.num_clusters;
+    const size_t batch_size = std::min(config.mini_batch_size, n);
+    float* centroids = result.centroids.data();
+
+    std::vector<uint32_t> batch(batch_size);
+    std::vector<uint32_t> batch_assignments(batch_size);
+    std::vector<uint64_t> seen(k, 0);
+    std::vector<float> previous(k * dim);
+
+    for (size_t iteration = 0; iteration < config.max_iterations; ++iteration) {
+        ++result.iterations;
+
+        for (auto& index : batch) {
+            index = static_cast<uint32_t>(rng() % n);
+        }
+        ForEachChunk(pool, batch_size, kChunkSize, [&](size_t, size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b) {
+                batch_assignments[b] = FindNearest(matrix.Row(batch[b]), centroids, k, dim).cluster;
+            }
+        });
+        result.distance_computations += static_cast<uint64_t>(batch_size) * k;
+
+        // Each centroid is the mean of every batch point it has received
+        std::copy(centroids, centroids + k * dim, previous.begin());
+        for (size_t b = 0; b < batch_size; ++b) {
+            const uint32_t c = batch_assignments[b];
+            const float rate = 1.0f / static_cast<float>(++seen[c]);
+            const float* point = matrix.Row(batch[b]);
+            float* centroid = centroids + c * dim;
+            for (size_t d = 0; d < dim; ++d) {
+                centroid[d] += rate * (point[d] - centroid[d]);
+            }
+        }
+
+        float max_shift = 0.0f;
+        for (size_t c = 0; c < k; ++c) {
+            max_shift = std::max(max_shift, SquaredEuclideanDistance(
+                previous.data() + c * dim, centroids + c * dim, dim));
+        }
+        if (std::sqrt(max_shift) <= config.tolerance) {
+            result.converged = true;
+            break;
+        }
+    }
+
+    result.assignments.assign(n, 0);
+    ForEachChunk(pool, n, kChunkSize, [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            result.assignments[i] = FindNearest(matrix.Row(i), centroids, k, dim).cluster;
+        }
+    });
+    result.distance_computations += static_cast<uint64_t>(n) * k;
+}
+
+} // anonymous namespace
+
+KMeansClusterer::KMeansClusterer(const Config& config) : config_(config) {
+    if (config_.num_clusters == 0) {
+        throw std::invalid_argument("num_clusters must be greater than 0");
+    }
+    if (config_.max_iterations == 0) {
+        throw std::invalid_argument("max_iterations must be greater than 0");
+    }
+    if (config_.mini_batch_size == 0) {
+        throw std::invalid_argument("mini_batch_size must be greater than 0");
+    }
+    if (!(config_.tolerance >= 0.0f)) {
+        throw std::invalid_argument("tolerance cannot be negative");
+    }
+}
+
+KMeansClusterer::Result KMeansClusterer::Run(const float* points, size_t count,
+                                             size_t dimension) const {
+    if (dimension == 0) {
+        throw std::invalid_argument("dimension must be greater than 0");
+    }
+    if (count < config_.num_clusters) {
+        throw std::invalid_argument("Need at least num_clusters points");
+    }
+
+    WorkerPool& pool = config_.worker_pool ? *config_.worker_pool : WorkerPool::Shared();
+    const PointMatrix matrix{points, count, dimension};
+    const size_t k = config_.num_clusters;
+
+    Algorithm algorithm = config_.algorithm;
+    if (algorithm == Algorithm::AUTO) {
+        algorithm = count > config_.mini_batch_threshold ? Algorithm::MINI_BATCH
+                                                         : Algorithm::HAMERLY;
+    }
+
+    Result result;
+    result.dimension = dimension;
+    std::mt19937_64 rng(config_.seed);
+
+    // Mini-batches seed from a sample of a few batches rather than every point
+    std::vector<uint32_t> sample;
+    if (algorithm == Algorithm::MINI_BATCH) {
+        const size_t sample_size = std::max(3 * config_.mini_batch_size, k);
+        if (sample_size < count) {
+            sample.resize(sample_size);
+            for (auto& index : sample) {
+                index = static_cast<uint32_t>(rng() % count);
+            }
+        }
+    }
+    result.centroids = SeedCentroids(matrix, sample, k, rng, pool, result.distance_computations);
+
+    if (algorithm == Algorithm::MINI_BATCH) {
+        RefineMiniBatch(matrix, config_, rng, pool, result);
+    } else {
+        RefineExact(matrix, algorithm == Algorithm::HAMERLY, config_, pool, result);
+    }
+
+    // Sizes and inertia against the final centroids
+    result.cluster_sizes.assign(k, 0);
+    for (uint32_t cluster : result.assignments) {
+        ++result.cluster_sizes[cluster];
+    }
+    std::vector<double> chunk_inertia(ChunkCount(count, kChunkSize), 0.0);
+    ForEachChunk(pool, count, kChunkSize, [&](size_t chunk, size_t begin, size_t end) {
+        double inertia = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            inertia += SquaredEuclideanDistance(matrix.Row(i),
+                                                result.Centroid(result.assignments[i]), dimension);
+        }
+        chunk_inertia[chunk] = inertia;
+    });
+    for (double inertia : chunk_inertia) {
+        result.inertia += inertia;
+    }
+
+    return result;
+}
+
+} // namespace dpan
@@ -0,0 +1,139 @@
+// File: src/similarity/kmeans_clusterer.hpp
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dpan {
+
+class WorkerPool;
+
+/// Squared Euclidean distance between two vectors of the given dimension
+///
+/// Accumulates into kLanes independent sums so the loop is vectorized by
+/// the compiler without requiring -ffast-math.
+inline float SquaredEuclideanDistance(const float* a, const float* b, size_t dimension) {
+    constexpr size_t kLanes = 8;
+    float lanes[kLanes] = {};
+
+    size_t d = 0;
+    for (; d + kLanes <= dimension; d += kLanes) {
+        for (size_t l = 0; l < kLanes; ++l) {
+            float diff = a[d + l] - b[d + l];
+            lanes[l] += diff * diff;
+        }
+    }
+
+    float sum = 0.0f;
+    for (size_t l = 0; l < kLanes; ++l) {
+        sum += lanes[l];
+    }
+    for (; d < dimension; ++d) {
+        float diff = a[d] - b[d];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+/// KMeansClusterer - k-means over a contiguous, row-major point matrix
+///
+/// Centroids are seeded with greedy k-means++ (the best of 2 + ln k
+/// distance-weighted draws per centroid) and refined by one of:
+/// - LLOYD: every point is compared with every centroid each iteration.
+/// - HAMERLY: Lloyd's result, but each point keeps an upper bound on the
+///   distance to its centroid and a lower bound on the distance to any
+///   other one. Points whose bounds prove the assignment cannot change
+///   skip the centroid scan, which after the first few iterations is
+///   nearly all of them. Bounds cost two floats per point.
+/// - MINI_BATCH: centroids follow per-centroid running means of random
+///   batches (Sculley, 2010), then every point is assigned once. Cost is
+///   independent of the number of points, at some loss of quality.
+/// AUTO picks HAMERLY up to mini_batch_threshold points, MINI_BATCH above.
+///
+/// Assignment and seeding passes are split into fixed chunks run on a
+/// WorkerPool. Sums are reduced in chunk order, so results depend only
+/// on the input and seed, not on the number of threads.
+///
+/// Points must be finite. Empty clusters are re-seeded with the point
+/// farthest from its centroid while any point is at a nonzero distance.
+///
+/// Thread-safety: Run may be called concurrently.
+class KMeansClusterer {
+public:
+    /// Refinement algorithm
+    enum class Algorithm {
+        AUTO,
+        LLOYD,
+        HAMERLY,
+        MINI_BATCH,
+    };
+
+    /// Configuration for clustering
+    struct Config {
+        /// Number of clusters (k)
+        size_t num_clusters{8};
+
+        /// Refinement algorithm
+        Algorithm algorithm{Algorithm::AUTO};
+
+        /// Maximum refinement iterations (mini-batch: batches)
+        size_t max_iterations{100};
+
+        /// Converged once no centroid moves further than this in an iteration
+        float tolerance{1e-4f};
+
+        /// AUTO uses mini-batches above this many points
+        size_t mini_batch_threshold{200000};
+
+        /// Points per mini-batch
+        size_t mini_batch_size{4096};
+
+        /// Seed of the seeding and batch sampling
+        uint64_t seed{0x5EED5EEDULL};
+
+        /// Pool for parallel passes (null = WorkerPool::Shared())
+        std::shared_ptr<WorkerPool> worker_pool;
+    };
+
+    /// Clustering of a point matrix
+    struct Result {
+        size_t dimension{0};
+        std::vector<float> centroids;          ///< num_clusters x dimension, row-major
+        std::vector<uint32_t> assignments;     ///< Cluster of each point
+        std::vector<size_t> cluster_sizes;     ///< Points per cluster (may be 0)
+        double inertia{0.0};                   ///< Sum of squared distances to centroids
+        size_t iterations{0};                  ///< Refinement iterations run
+        bool converged{false};                 ///< Stopped before max_iterations
+        uint64_t distance_computations{0};     ///< Point-centroid distances evaluated
+
+        /// Centroid of a cluster (dimension floats)
+        const float* Centroid(size_t cluster) const {
+            return centroids.data() + cluster * dimension;
+        }
+    };
+
+    /// Constructor
+    /// @param config Clustering configuration
+    /// @throws std::invalid_argument if num_clusters, max_iterations or
+    ///         mini_batch_size is 0, or tolerance is negative
+    explicit KMeansClusterer(const Config& config);
+
+    /// Cluster count points of the given dimension
+    /// @param points count x dimension floats, row-major
+    /// @param count Number of points
+    /// @param dimension Floats per point
+    /// @return Centroids and assignments
+    /// @throws std::invalid_argument if dimension is 0 or count is less
+    ///         than num_clusters
+    Result Run(const float* points, size_t count, size_t dimension) const;
+
+    /// Get configuration
+    const Config& GetConfig() const { return config_; }
+
+private:
+    Config config_;
+};
+
+} // namespace dpan
@@ -0,0 +1,256 @@
+// File: src/similarity/pairwise_similarity_cache.cpp
+#include "similarity/pairwise_similarity_cache.hpp"
+#include "core/pattern_node.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace dpan {
+
+PairwiseSimilarityCache::PairwiseSimilarityCache()
+    : PairwiseSimilarityCache(Config()) {
+}
+
+PairwiseSimilarityCache::PairwiseSimilarityCache(const Config& config)
+    : config_(config) {
+    if (!config_.IsValid()) {
+        throw std::invalid_argument("Invalid PairwiseSimilarityCache configuration");
+    }
+
+    // Never create more shards than entries so each shard holds at least one
+    size_t num_shards = std::min(config_.num_shards, config_.capacity);
+    size_t per_shard = config_.capacity / num_shards;
+    size_t remainder = config_.capacity % num_shards;
+
+    shards_.reserve(num_shards);
+    for (size_t i = 0; i < num_shards; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->capacity = per_shard + (i < remainder ? 1 : 0);
+        shards_.push_back(std::move(shard));
+    }
+}
+
+uint64_t PairwiseSimilarityCache::VersionOf(const PatternNode& node) {
+    uint64_t generation = node.GetGeneration();
+    return node.GetData().ContentHash() ^ (generation * 0x9E3779B97F4A7C15ULL);
+}
+
+size_t PairwiseSimilarityCache::KeyHash::operator()(const Key& key) const {
+    size_t h = PatternID::Hash()(key.lo);
+    h ^= PatternID::Hash()(key.hi) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    h ^= std::hash<std::string>()(key.metric) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+PairwiseSimilarityCache::Shard& PairwiseSimilarityCache::ShardFor(const Key& key) {
+    return *shards_[KeyHash()(key) % shards_.size()];
+}
+
+PairwiseSimilarityCache::Counters& PairwiseSimilarityCache::CountersFor(
+    const std::string& consumer) {
+    {
+        std::shared_lock<std::shared_mutex> lock(counters_mutex_);
+        auto it = counters_.find(consumer);
+        if (it != counters_.end()) {
+            return *it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(counters_mutex_);
+    auto& slot = counters_[consumer];
+    if (!slot) {
+        slot = std::make_unique<Counters>();
+    }
+    return *slot;
+}
+
+std::optional<float> PairwiseSimilarityCache::Lookup(
+    PatternID a, uint64_t version_a,
+    PatternID b, uint64_t version_b,
+    const std::string& metric_name,
+    bool symmetric,
+    const std::string& consumer) {
+
+    bool forward = a <= b;
+    Key key{forward ? a : b, forward ? b : a, metric_name};
+    uint64_t version_lo = forward ? version_a : version_b;
+    uint64_t version_hi = forward ? version_b : version_a;
+    size_t slot = (forward || symmetric) ? 0 : 1;
+
+    Counters& counters = CountersFor(consumer);
+    Shard& shard = ShardFor(key);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+        counters.misses.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    const Entry& entry = it->second->second;
+    if (entry.version_lo != version_lo || entry.version_hi != version_hi) {
+        counters.misses.fetch_add(1, std::memory_order_relaxed);
+        counters.stale.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    if (!entry.present[slot]) {
+        counters.misses.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    shard.items.splice(shard.items.begin(), shard.items, it->second);
+    counters.hits.fetch_add(1, std::memory_order_relaxed);
+    return entry.values[slot];
+}
+
+void PairwiseSimilarityCache::Insert(
+    PatternID a, uint64_t version_a,
+    PatternID b, uint64_t version_b,
+    const std::string& metric_name,
+    bool symmetric,
+    float similarity) {
+
+    bool forward = a <= b;
+    Key key{forward ? a : b, forward ? b : a, metric_name};
+    uint64_t version_lo = forward ? version_a : version_b;
+    uint64_t version_hi = forward ? version_b : version_a;
+    size_t slot = (forward || symmetric) ? 0 : 1;
+
+    Shard& shard = ShardFor(key);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it != shard.map.end()) {
+        Entry& entry = it->second->second;
+        if (entry.version_lo != version_lo || entry.version_hi != version_hi) {
+            entry = Entry();
+            entry.version_lo = version_lo;
+            entry.version_hi = version_hi;
+        }
+        entry.values[slot] = similarity;
+        entry.present[slot] = true;
+        shard.items.splice(shard.items.begin(), shard.items, it->second);
+        return;
+    }
+
+    if (shard.items.size() >= shard.capacity) {
+        shard.map.erase(shard.items.back().first);
+        shard.items.pop_back();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Entry entry;
+    entry.version_lo = version_lo;
+    entry.version_hi = version_hi;
+    entry.values[slot] = similarity;
+    entry.present[slot] = true;
+
+    shard.items.emplace_front(key, entry);
+    shard.map.emplace(std::move(key), shard.items.begin());
+}
+
+float PairwiseSimilarityCache::GetOrCompute(
+    const PatternNode& a, const PatternNode& b,
+    const std::string& metric_name,
+    bool symmetric,
+    const std::string& consumer,
+    const std::function<float()>& compute) {
+
+    uint64_t version_a = VersionOf(a);
+    uint64_t version_b = VersionOf(b);
+
+    auto cached = Lookup(a.GetID(), version_a, b.GetID(), version_b,
+                         metric_name, symmetric, consumer);
+    if (cached) {
+        return *cached;
+    }
+
+    // Compute outside any lock; a concurrent miss on the same pair just
+    // stores the same value twice
+    float similarity = compute();
+    Insert(a.GetID(), version_a, b.GetID(), version_b, metric_name, symmetric, similarity);
+    return similarity;
+}
+
+size_t PairwiseSimilarityCache::Invalidate(PatternID id) {
+    size_t removed = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (auto it = shard->items.begin(); it != shard->items.end();) {
+            if (it->first.lo == id || it->first.hi == id) {
+                shard->map.erase(it->first);
+                it = shard->items.erase(it);
+                ++removed;
+            } else {
+                ++it;
+            }
+        }
+    }
+    return removed;
+}
+
+void PairwiseSimilarityCache::Clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->map.clear();
+        shard->items.clear();
+    }
+}
+
+size_t PairwiseSimilarityCache::Size() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total += shard->items.size();
+    }
+    return total;
+}
+
+PairwiseSimilarityCache::ConsumerStats PairwiseSimilarityCache::GetConsumerStats(
+    const std::string& consumer) const {
+    ConsumerStats stats;
+    stats.consumer = consumer;
+
+    std::shared_lock<std::shared_mutex> lock(counters_mutex_);
+    auto it = counters_.find(consumer);
+    if (it != counters_.end()) {
+        stats.hits = it->second->hits.load(std::memory_order_relaxed);
+        stats.misses = it->second->misses.load(std::memory_order_relaxed);
+        stats.stale = it->second->stale.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+std::vector<PairwiseSimilarityCache::ConsumerStats>
+PairwiseSimilarityCache::GetAllConsumerStats() const {
+    std::vector<ConsumerStats> all;
+    {
+        std::shared_lock<std::shared_mutex> lock(counters_mutex_);
+        all.reserve(counters_.size());
+        for (const auto& [name, counters] : counters_) {
+            ConsumerStats stats;
+            stats.consumer = name;
+            stats.hits = counters->hits.load(std::memory_order_relaxed);
+            stats.misses = counters->misses.load(std::memory_order_relaxed);
+            stats.stale = counters->stale.load(std::memory_order_relaxed);
+            all.push_back(std::move(stats));
+        }
+    }
+
+    std::sort(all.begin(), all.end(),
+              [](const ConsumerStats& x, const ConsumerStats& y) {
+                  return x.consumer < y.consumer;
+              });
+    return all;
+}
+
+void PairwiseSimilarityCache::ResetStats() {
+    std::shared_lock<std::shared_mutex> lock(counters_mutex_);
+    for (auto& [name, counters] : counters_) {
+        counters->hits.store(0, std::memory_order_relaxed);
+        counters->misses.store(0, std::memory_order_relaxed);
+        counters->stale.store(0, std::memory_order_relaxed);
+    }
+    evictions_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace dpan
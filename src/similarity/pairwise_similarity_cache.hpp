@@ -0,0 +1,184 @@
+// File: src/similarity/pairwise_similarity_cache.hpp
+#pragma once
+
+#include "core/types.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dpan {
+
+class PatternNode;
+
+/// PairwiseSimilarityCache: Shared, bounded memo of pattern-pair similarities
+///
+/// Maintenance passes (consolidation, merge checks, interference, attention)
+/// keep re-scoring the same pattern pairs even when neither pattern changed.
+/// Entries are keyed by (min id, max id, metric name) and stamped with the
+/// version of both patterns; a lookup whose versions no longer match is a
+/// miss and the entry is recomputed. A pattern's version combines its
+/// PatternNode generation counter with the content hash of its data, so
+/// edits are detected even through backends that do not persist generations.
+///
+/// The cache is split into independently locked LRU shards to keep
+/// contention low when several consumers share one instance. Hit/miss
+/// statistics are tracked per named consumer.
+///
+/// Thread-safety: All methods are thread-safe.
+class PairwiseSimilarityCache {
+public:
+    /// Configuration for the cache
+    struct Config {
+        /// Maximum number of cached pairs across all shards
+        size_t capacity{65536};
+
+        /// Number of independently locked shards
+        size_t num_shards{16};
+
+        bool IsValid() const {
+            return capacity > 0 && num_shards > 0;
+        }
+    };
+
+    /// Per-consumer lookup statistics
+    struct ConsumerStats {
+        std::string consumer;
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t stale{0};  ///< Misses caused by a changed pattern version
+
+        float HitRate() const {
+            uint64_t total = hits + misses;
+            return total == 0 ? 0.0f : static_cast<float>(hits) / static_cast<float>(total);
+        }
+    };
+
+    /// Construct with default configuration
+    PairwiseSimilarityCache();
+
+    /// Construct with custom configuration
+    /// @throws std::invalid_argument if config is invalid
+    explicit PairwiseSimilarityCache(const Config& config);
+
+    /// Version stamp of a pattern as seen by the cache
+    /// @param node Pattern node
+    /// @return Generation counter mixed with the data content hash
+    static uint64_t VersionOf(const PatternNode& node);
+
+    /// Look up a cached similarity
+    /// @param a First pattern and its version
+    /// @param b Second pattern and its version
+    /// @param metric_name Name of the metric that produced the value
+    /// @param symmetric Whether sim(a, b) == sim(b, a) for this metric
+    /// @param consumer Name under which the lookup is counted
+    /// @return Cached similarity, or nullopt on a miss or stale entry
+    std::optional<float> Lookup(PatternID a, uint64_t version_a,
+                                PatternID b, uint64_t version_b,
+                                const std::string& metric_name,
+                                bool symmetric,
+                                const std::string& consumer);
+
+    /// Store a similarity, evicting the least recently used pair of the shard
+    /// if it is full
+    void Insert(PatternID a, uint64_t version_a,
+                PatternID b, uint64_t version_b,
+                const std::string& metric_name,
+                bool symmetric,
+                float similarity);
+
+    /// Return the cached similarity of two nodes or compute and cache it
+    /// @param a First pattern
+    /// @param b Second pattern
+    /// @param metric_name Name of the metric
+    /// @param symmetric Whether the metric is symmetric
+    /// @param consumer Name under which the lookup is counted
+    /// @param compute Invoked on a miss; must return sim(a, b)
+    /// @return Similarity of a to b
+    float GetOrCompute(const PatternNode& a, const PatternNode& b,
+                       const std::string& metric_name,
+                       bool symmetric,
+                       const std::string& consumer,
+                       const std::function<float()>& compute);
+
+    /// Drop every cached pair involving a pattern (e.g. after deletion)
+    /// @return Number of entries removed
+    size_t Invalidate(PatternID id);
+
+    /// Remove all entries (statistics are kept)
+    void Clear();
+
+    /// Number of cached pairs
+    size_t Size() const;
+
+    /// Configured capacity
+    size_t Capacity() const { return config_.capacity; }
+
+    /// Total number of LRU evictions
+    uint64_t Evictions() const { return evictions_.load(std::memory_order_relaxed); }
+
+    /// Statistics for one consumer (zeros if it never looked anything up)
+    ConsumerStats GetConsumerStats(const std::string& consumer) const;
+
+    /// Statistics for every consumer, sorted by name
+    std::vector<ConsumerStats> GetAllConsumerStats() const;
+
+    /// Reset per-consumer statistics and the eviction counter
+    void ResetStats();
+
+private:
+    struct Key {
+        PatternID lo;
+        PatternID hi;
+        std::string metric;
+
+        bool operator==(const Key& other) const {
+            return lo == other.lo && hi == other.hi && metric == other.metric;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    /// Cached value(s) for one unordered pair; index 0 is sim(lo, hi) and
+    /// index 1 is sim(hi, lo) (only distinct for asymmetric metrics)
+    struct Entry {
+        uint64_t version_lo{0};
+        uint64_t version_hi{0};
+        float values[2]{0.0f, 0.0f};
+        bool present[2]{false, false};
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<std::pair<Key, Entry>> items;
+        std::unordered_map<Key, std::list<std::pair<Key, Entry>>::iterator, KeyHash> map;
+        size_t capacity{1};
+    };
+
+    struct Counters {
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> stale{0};
+    };
+
+    Shard& ShardFor(const Key& key);
+    Counters& CountersFor(const std::string& consumer);
+
+    Config config_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<uint64_t> evictions_{0};
+
+    mutable std::shared_mutex counters_mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Counters>> counters_;
+};
+
+} // namespace dpan
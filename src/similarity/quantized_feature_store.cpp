@@ -0,0 +1,305 @@
+// File: src/similarity/quantized_feature_store.cpp
+#include "similarity/quantized_feature_store.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace dpan {
+
+const char* ToString(FeaturePrecision precision) {
+    switch (precision) {
+        case FeaturePrecision::FLOAT32: return "float32";
+        case FeaturePrecision::FLOAT16: return "float16";
+        case FeaturePrecision::BFLOAT16: return "bfloat16";
+        case FeaturePrecision::INT8: return "int8";
+        default: return "unknown";
+    }
+}
+
+namespace {
+
+uint32_t FloatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float BitsToFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Element Conversions
+// ============================================================================
+
+uint16_t QuantizedFeatureStore::FloatToHalf(float value) {
+    uint32_t bits = FloatBits(value);
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    bits &= 0x7FFFFFFFu;
+
+    if (bits >= 0x7F800000u) {
+        // Inf stays inf, NaN stays (quiet) NaN
+        return sign | 0x7C00u | (bits > 0x7F800000u ? 0x0200u : 0u);
+    }
+    if (bits >= 0x477FF000u) {
+        // Rounds past the largest half (65504)
+        return sign | 0x7C00u;
+    }
+    if (bits < 0x38800000u) {
+        // Half subnormal range: value / 2^-24, rounded to nearest even
+        float magnitude = BitsToFloat(bits);
+        return sign | static_cast<uint16_t>(std::nearbyint(magnitude * 16777216.0f));
+    }
+
+    // Normal range: rebias exponent (127 -> 15) and round the mantissa
+    bits += 0x0FFFu + ((bits >> 13) & 1u);
+    return sign | static_cast<uint16_t>((bits - (112u << 23)) >> 13);
+}
+
+float QuantizedFeatureStore::HalfToFloat(uint16_t value) {
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x03FFu;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            return BitsToFloat(sign);
+        }
+        // Subnormal half: exact as float
+        float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+        return sign ? -magnitude : magnitude;
+    }
+    if (exponent == 0x1Fu) {
+        return BitsToFloat(sign | 0x7F800000u | (mantissa << 13));
+    }
+    return BitsToFloat(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+}
+
+uint16_t QuantizedFeatureStore::FloatToBFloat16(float value) {
+    uint32_t bits = FloatBits(value);
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+        return static_cast<uint16_t>((bits >> 16) | 0x0040u);  // Keep NaN quiet
+    }
+    bits += 0x7FFFu + ((bits >> 16) & 1u);
+    return static_cast<uint16_t>(bits >> 16);
+}
+
+float QuantizedFeatureStore::BFloat16ToFloat(uint16_t value) {
+    return BitsToFloat(static_cast<uint32_t>(value) << 16);
+}
+
+size_t QuantizedFeatureStore::BytesPerElement(FeaturePrecision precision) {
+    switch (precision) {
+        case FeaturePrecision::FLOAT32: return 4;
+        case FeaturePrecision::FLOAT16: return 2;
+        case FeaturePrecision::BFLOAT16: return 2;
+        case FeaturePrecision::INT8: return 1;
+        default: return 4;
+    }
+}
+
+// ============================================================================
+// Store
+// ============================================================================
+
+QuantizedFeatureStore::QuantizedFeatureStore(FeaturePrecision precision)
+    : precision_(precision) {
+}
+
+void QuantizedFeatureStore::Upsert(PatternID id, const FeatureVector& features) {
+    auto it = slot_of_.find(id);
+    if (it != slot_of_.end()) {
+        Slot& slot = slots_[it->second];
+        if (slot.dimension == features.Dimension()) {
+            // Same size: overwrite in place
+            Encode(features, slot);
+            return;
+        }
+        dead_bytes_ += slot.dimension * BytesPerElement(precision_);
+        slot.offset = codes_.size();
+        slot.dimension = static_cast<uint32_t>(features.Dimension());
+        codes_.resize(codes_.size() + slot.dimension * BytesPerElement(precision_));
+        Encode(features, slot);
+        CompactIfSparse();
+        return;
+    }
+
+    Slot slot;
+    slot.id = id;
+    slot.offset = codes_.size();
+    slot.dimension = static_cast<uint32_t>(features.Dimension());
+    codes_.resize(codes_.size() + slot.dimension * BytesPerElement(precision_));
+    Encode(features, slot);
+
+    slot_of_[id] = slots_.size();
+    slots_.push_back(slot);
+}
+
+bool QuantizedFeatureStore::Remove(PatternID id) {
+    auto it = slot_of_.find(id);
+    if (it == slot_of_.end()) {
+        return false;
+    }
+
+    size_t index = it->second;
+    dead_bytes_ += slots_[index].dimension * BytesPerElement(precision_);
+    slot_of_.erase(it);
+
+    if (index + 1 != slots_.size()) {
+        slots_[index] = slots_.back();
+        slot_of_[slots_[index].id] = index;
+    }
+    slots_.pop_back();
+
+    CompactIfSparse();
+    return true;
+}
+
+void QuantizedFeatureStore::Clear() {
+    slots_.clear();
+    slot_of_.clear();
+    codes_.clear();
+    dead_bytes_ = 0;
+}
+
+void QuantizedFeatureStore::ShrinkToFit() {
+    dead_bytes_ = codes_.size();  // Force a full compaction
+    CompactIfSparse();
+    codes_.shrink_to_fit();
+    slots_.shrink_to_fit();
+}
+
+size_t QuantizedFeatureStore::MemoryUsageBytes() const {
+    size_t map_bytes = slot_of_.size() * (sizeof(PatternID) + sizeof(size_t) + 2 * sizeof(void*)) +
+                       slot_of_.bucket_count() * sizeof(void*);
+    return codes_.capacity() + slots_.capacity() * sizeof(Slot) + map_bytes;
+}
+
+void QuantizedFeatureStore::Encode(const FeatureVector& features, Slot& slot) {
+    const float* values = features.Data().data();
+    uint8_t* dst = codes_.data() + slot.offset;
+    const size_t n = slot.dimension;
+    slot.max_error = 0.0f;
+    if (n == 0) {
+        slot.scale = 0.0f;
+        return;
+    }
+
+    auto track_error = [&slot](float value, float decoded) {
+        float error = std::isfinite(value) ? std::abs(value - decoded)
+                                           : std::numeric_limits<float>::infinity();
+        slot.max_error = std::max(slot.max_error, error);
+    };
+
+    switch (precision_) {
+        case FeaturePrecision::FLOAT32:
+            std::memcpy(dst, values, n * sizeof(float));
+            for (size_t i = 0; i < n; ++i) {
+                track_error(values[i], values[i]);
+            }
+            break;
+
+        case FeaturePrecision::FLOAT16:
+            for (size_t i = 0; i < n; ++i) {
+                uint16_t code = FloatToHalf(values[i]);
+                std::memcpy(dst + 2 * i, &code, sizeof(code));
+                track_error(values[i], HalfToFloat(code));
+            }
+            break;
+
+        case FeaturePrecision::BFLOAT16:
+            for (size_t i = 0; i < n; ++i) {
+                uint16_t code = FloatToBFloat16(values[i]);
+                std::memcpy(dst + 2 * i, &code, sizeof(code));
+                track_error(values[i], BFloat16ToFloat(code));
+            }
+            break;
+
+        case FeaturePrecision::INT8: {
+            float max_abs = 0.0f;
+            for (size_t i = 0; i < n; ++i) {
+                max_abs = std::max(max_abs, std::abs(values[i]));
+            }
+            slot.scale = (max_abs > 0.0f && std::isfinite(max_abs)) ? max_abs / 127.0f : 0.0f;
+            float inverse = slot.scale > 0.0f ? 1.0f / slot.scale : 0.0f;
+            for (size_t i = 0; i < n; ++i) {
+                float q = std::clamp(std::nearbyint(values[i] * inverse), -127.0f, 127.0f);
+                dst[i] = static_cast<uint8_t>(static_cast<int8_t>(q));
+                track_error(values[i], q * slot.scale);
+            }
+            break;
+        }
+    }
+}
+
+void QuantizedFeatureStore::Decode(size_t index, float* out) const {
+    const Slot& slot = slots_[index];
+    const uint8_t* src = codes_.data() + slot.offset;
+    const size_t n = slot.dimension;
+    if (n == 0) {
+        return;
+    }
+
+    switch (precision_) {
+        case FeaturePrecision::FLOAT32:
+            std::memcpy(out, src, n * sizeof(float));
+            break;
+
+        case FeaturePrecision::FLOAT16:
+            for (size_t i = 0; i < n; ++i) {
+                uint16_t code;
+                std::memcpy(&code, src + 2 * i, sizeof(code));
+                out[i] = HalfToFloat(code);
+            }
+            break;
+
+        case FeaturePrecision::BFLOAT16:
+            for (size_t i = 0; i < n; ++i) {
+                uint16_t code;
+                std::memcpy(&code, src + 2 * i, sizeof(code));
+                out[i] = BFloat16ToFloat(code);
+            }
+            break;
+
+        case FeaturePrecision::INT8:
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = static_cast<float>(static_cast<int8_t>(src[i])) * slot.scale;
+            }
+            break;
+    }
+}
+
+void QuantizedFeatureStore::Decode(size_t index, FeatureVector& out) const {
+    auto& data = out.Data();
+    data.resize(slots_[index].dimension);
+    Decode(index, data.data());
+}
+
+void QuantizedFeatureStore::CompactIfSparse() {
+    if (dead_bytes_ * 2 <= codes_.size()) {
+        return;
+    }
+
+    const size_t element_bytes = BytesPerElement(precision_);
+    std::vector<uint8_t> compacted;
+    compacted.reserve(codes_.size() - dead_bytes_);
+
+    for (Slot& slot : slots_) {
+        size_t bytes = slot.dimension * element_bytes;
+        size_t offset = compacted.size();
+        compacted.insert(compacted.end(),
+                         codes_.begin() + static_cast<std::ptrdiff_t>(slot.offset),
+                         codes_.begin() + static_cast<std::ptrdiff_t>(slot.offset + bytes));
+        slot.offset = offset;
+    }
+
+    codes_ = std::move(compacted);
+    dead_bytes_ = 0;
+}
+
+} // namespace dpan
@@ -0,0 +1,117 @@
+// File: src/similarity/quantized_feature_store.hpp
+#pragma once
+
+#include "core/types.hpp"
+#include "core/pattern_data.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dpan {
+
+/// Element precision of a feature search layout
+enum class FeaturePrecision : uint8_t {
+    FLOAT32 = 0,   ///< Full precision (4 bytes/element)
+    FLOAT16 = 1,   ///< IEEE half precision (2 bytes/element)
+    BFLOAT16 = 2,  ///< bfloat16: float32 exponent, 7-bit mantissa (2 bytes/element)
+    INT8 = 3,      ///< Symmetric int8 with a per-vector scale (1 byte/element)
+};
+
+const char* ToString(FeaturePrecision precision);
+
+/// QuantizedFeatureStore: Compact, contiguous copy of pattern features
+///
+/// Holds one encoded vector per pattern in a single byte arena so a search
+/// can stream features at reduced precision instead of decompressing every
+/// PatternData. Decoding always produces float32, so metrics accumulate in
+/// float32 regardless of the storage precision.
+///
+/// Slots are dense: removing a pattern moves the last slot into its place.
+/// The arena is compacted once more than half of it is unused.
+///
+/// Thread-safety: Not thread-safe; callers synchronize.
+class QuantizedFeatureStore {
+public:
+    /// Construct an empty store
+    /// @param precision Element precision of the encoded vectors
+    explicit QuantizedFeatureStore(FeaturePrecision precision);
+
+    /// Get element precision
+    FeaturePrecision GetPrecision() const { return precision_; }
+
+    /// Insert or replace the features of a pattern
+    void Upsert(PatternID id, const FeatureVector& features);
+
+    /// Remove a pattern
+    /// @return true if the pattern was stored
+    bool Remove(PatternID id);
+
+    /// Check whether a pattern is stored
+    bool Contains(PatternID id) const { return slot_of_.count(id) > 0; }
+
+    /// Remove everything
+    void Clear();
+
+    /// Number of stored vectors
+    size_t Size() const { return slots_.size(); }
+
+    /// Release spare arena capacity (e.g. after a bulk load)
+    void ShrinkToFit();
+
+    /// Approximate heap footprint in bytes
+    size_t MemoryUsageBytes() const;
+
+    /// Pattern stored in a slot
+    PatternID IdAt(size_t slot) const { return slots_[slot].id; }
+
+    /// Dimension of the vector in a slot
+    size_t DimensionAt(size_t slot) const { return slots_[slot].dimension; }
+
+    /// Largest absolute difference between a decoded element of a slot and
+    /// the value it was encoded from (infinity for non-finite inputs)
+    float ErrorAt(size_t slot) const { return slots_[slot].max_error; }
+
+    /// Decode a slot into float32
+    /// @param slot Slot index (< Size())
+    /// @param out Destination with room for DimensionAt(slot) floats
+    void Decode(size_t slot, float* out) const;
+
+    /// Decode a slot into a FeatureVector (resized as needed)
+    void Decode(size_t slot, FeatureVector& out) const;
+
+    /// Bytes used per element for a precision
+    static size_t BytesPerElement(FeaturePrecision precision);
+
+    /// float32 -> IEEE half, round to nearest even
+    static uint16_t FloatToHalf(float value);
+
+    /// IEEE half -> float32 (exact)
+    static float HalfToFloat(uint16_t value);
+
+    /// float32 -> bfloat16, round to nearest even
+    static uint16_t FloatToBFloat16(float value);
+
+    /// bfloat16 -> float32 (exact)
+    static float BFloat16ToFloat(uint16_t value);
+
+private:
+    struct Slot {
+        PatternID id;
+        size_t offset{0};
+        uint32_t dimension{0};
+        float scale{1.0f};  ///< INT8 dequantization scale
+        float max_error{0.0f};
+    };
+
+    void Encode(const FeatureVector& features, Slot& slot);
+    void CompactIfSparse();
+
+    FeaturePrecision precision_;
+    std::vector<Slot> slots_;
+    std::unordered_map<PatternID, size_t> slot_of_;
+    std::vector<uint8_t> codes_;
+    size_t dead_bytes_{0};
+};
+
+} // namespace dpan
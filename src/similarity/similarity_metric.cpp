@@ -1,6 +1,9 @@
 // File: src/similarity/similarity_metric.cpp
 #include "similarity/similarity_metric.hpp"
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
 #include <numeric>
 
 namespace dpan {
@@ -35,6 +38,180 @@ std::vector<float> SimilarityMetric::ComputeBatchFromFeatures(
     return results;
 }
 
+std::vector<float> SimilarityMetric::ComputeBoundSummary(const FeatureVector& /*features*/) const {
+    return {};
+}
+
+float SimilarityMetric::UpperBoundFromSummaries(const std::vector<float>& /*summary_a*/,
+                                                const std::vector<float>& /*summary_b*/) const {
+    return 1.0f;
+}
+
+float SimilarityMetric::ComputeFromFeaturesBounded(const FeatureVector& a,
+                                                   const std::vector<float>& /*summary_a*/,
+                                                   const FeatureVector& b,
+                                                   const std::vector<float>& /*summary_b*/,
+                                                   float /*threshold*/) const {
+    return ComputeFromFeatures(a, b);
+}
+
+float SimilarityMetric::PerturbationBound(const FeatureVector& /*query*/,
+                                         const FeatureVector& /*approx*/,
+                                         float /*max_error*/) const {
+    return std::numeric_limits<float>::infinity();
+}
+
+float SimilarityMetric::SimilarityToDistance(float similarity) const {
+    if (similarity <= 0.0f) {
+        return std::numeric_limits<float>::infinity();
+    }
+    if (similarity >= 1.0f) {
+        return 0.0f;
+    }
+    return 1.0f / similarity - 1.0f;
+}
+
+float SimilarityMetric::DistanceToSimilarity(float distance) const {
+    if (std::isinf(distance)) {
+        return 0.0f;
+    }
+    return 1.0f / (1.0f + std::max(distance, 0.0f));
+}
+
+// ============================================================================
+// MetricCascade Implementation
+// ============================================================================
+
+void MetricCascade::AddMetric(const std::string& name) {
+    names_.push_back(name);
+    counters_.push_back(std::make_unique<Counters>());
+}
+
+void MetricCascade::Clear() {
+    names_.clear();
+    counters_.clear();
+}
+
+float MetricCascade::Evaluate(const std::vector<float>& weights,
+                              const EvaluateFn& evaluate,
+                              float threshold) const {
+    const size_t count = std::min(weights.size(), counters_.size());
+
+    // Slack keeps float rounding from stopping a candidate that reaches threshold
+    constexpr float kSlack = 1e-5f;
+    const bool can_stop = std::isfinite(threshold) &&
+        std::all_of(weights.begin(), weights.begin() + count, [](float w) { return w >= 0.0f; });
+
+    // Nothing to stop early for: plain weighted sum, unmeasured
+    if (!can_stop) {
+        float total = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            if (weights[i] != 0.0f) {
+                total += evaluate(i, -std::numeric_limits<float>::infinity()) * weights[i];
+            }
+        }
+        return total;
+    }
+
+    // Cheapest cost per unit of weight first: those tighten the bound fastest.
+    // Unmeasured metrics report zero cost and therefore get measured first.
+    std::vector<size_t> order(count);
+    std::vector<double> cost_per_weight(count, 0.0);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = i;
+        uint64_t evaluations = counters_[i]->evaluations.load(std::memory_order_relaxed);
+        if (evaluations > 0 && weights[i] > 0.0f) {
+            double avg_ns = static_cast<double>(counters_[i]->total_ns.load(std::memory_order_relaxed)) /
+                            static_cast<double>(evaluations);
+            cost_per_weight[i] = avg_ns / weights[i];
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&cost_per_weight](size_t a, size_t b) {
+        return cost_per_weight[a] < cost_per_weight[b];
+    });
+
+    float remaining = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        remaining += std::max(weights[i], 0.0f);
+    }
+
+    std::vector<float> similarities(count, 0.0f);
+    float accumulated = 0.0f;
+
+    for (size_t k = 0; k < count; ++k) {
+        const size_t i = order[k];
+        const float weight = weights[i];
+        remaining -= std::max(weight, 0.0f);
+
+        // A zero weight cannot change the sum
+        if (weight == 0.0f) {
+            continue;
+        }
+
+        // Similarity this metric needs for the sum to stay reachable
+        float metric_threshold = -std::numeric_limits<float>::infinity();
+        if (can_stop) {
+            metric_threshold = (threshold - accumulated - remaining - kSlack) / weight;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        float similarity = evaluate(i, metric_threshold);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        counters_[i]->evaluations.fetch_add(1, std::memory_order_relaxed);
+        counters_[i]->total_ns.fetch_add(
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+            std::memory_order_relaxed);
+
+        similarities[i] = similarity;
+        accumulated += weight * similarity;
+
+        if (can_stop && similarity < metric_threshold) {
+            for (size_t rest = k + 1; rest < count; ++rest) {
+                if (weights[order[rest]] != 0.0f) {
+                    counters_[order[rest]]->skipped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            return std::min(accumulated + remaining,
+                            std::nextafter(threshold, -std::numeric_limits<float>::infinity()));
+        }
+    }
+
+    // Registration order, matching a plain weighted sum
+    float total = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        total += similarities[i] * weights[i];
+    }
+    return total;
+}
+
+std::vector<MetricCascade::MetricStats> MetricCascade::GetStats() const {
+    std::vector<MetricStats> stats;
+    stats.reserve(names_.size());
+
+    for (size_t i = 0; i < names_.size(); ++i) {
+        MetricStats entry;
+        entry.name = names_[i];
+        entry.evaluations = counters_[i]->evaluations.load(std::memory_order_relaxed);
+        entry.evaluations_skipped = counters_[i]->skipped.load(std::memory_order_relaxed);
+        if (entry.evaluations > 0) {
+            entry.avg_cost_us = static_cast<double>(counters_[i]->total_ns.load(std::memory_order_relaxed)) /
+                                static_cast<double>(entry.evaluations) / 1000.0;
+        }
+        stats.push_back(entry);
+    }
+
+    return stats;
+}
+
+void MetricCascade::ResetStats() {
+    for (auto& counters : counters_) {
+        counters->evaluations.store(0, std::memory_order_relaxed);
+        counters->skipped.store(0, std::memory_order_relaxed);
+        counters->total_ns.store(0, std::memory_order_relaxed);
+    }
+}
+
 // ============================================================================
 // CompositeMetric Implementation
 // ============================================================================
@@ -49,12 +226,14 @@ void CompositeMetric::AddMetric(std::shared_ptr<SimilarityMetric> metric, float
     }
 
     metrics_.emplace_back(metric, weight);
+    cascade_.AddMetric(metric->GetName());
     NormalizeWeights();
 }
 
 void CompositeMetric::Clear() {
     metrics_.clear();
     normalized_weights_.clear();
+    cascade_.Clear();
 }
 
 size_t CompositeMetric::GetMetricCount() const {
@@ -66,14 +245,25 @@ float CompositeMetric::Compute(const PatternData& a, const PatternData& b) const
         return 0.0f;  // No metrics, return minimum similarity
     }
 
-    float total_similarity = 0.0f;
+    // Decode features once, shared by all feature-based metrics
+    bool any_features = std::any_of(metrics_.begin(), metrics_.end(),
+        [](const auto& pair) { return pair.first->ComputesFromFeatures(); });
+    FeatureVector features_a = any_features ? a.GetFeatures() : FeatureVector();
+    FeatureVector features_b = any_features ? b.GetFeatures() : FeatureVector();
 
+    // Unbounded, so a plain weighted sum in registration order
+    float total = 0.0f;
     for (size_t i = 0; i < metrics_.size(); ++i) {
-        float similarity = metrics_[i].first->Compute(a, b);
-        total_similarity += similarity * normalized_weights_[i];
+        const auto& metric = metrics_[i].first;
+        const float weight = normalized_weights_[i];
+        if (weight == 0.0f) {
+            continue;
+        }
+        total += weight * (metric->ComputesFromFeatures()
+                               ? metric->ComputeFromFeatures(features_a, features_b)
+                               : metric->Compute(a, b));
     }
-
-    return total_similarity;
+    return total;
 }
 
 float CompositeMetric::ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const {
@@ -81,14 +271,52 @@ float CompositeMetric::ComputeFromFeatures(const FeatureVector& a, const Feature
         return 0.0f;
     }
 
-    float total_similarity = 0.0f;
+    return EvaluateFeatures(a, b, -std::numeric_limits<float>::infinity());
+}
+
+float CompositeMetric::ComputeFromFeaturesBounded(const FeatureVector& a,
+                                                  const std::vector<float>& /*summary_a*/,
+                                                  const FeatureVector& b,
+                                                  const std::vector<float>& /*summary_b*/,
+                                                  float threshold) const {
+    if (metrics_.empty()) {
+        return 0.0f;
+    }
+
+    return EvaluateFeatures(a, b,
+                            cascade_enabled_ ? threshold : -std::numeric_limits<float>::infinity());
+}
 
-    for (size_t i = 0; i < metrics_.size(); ++i) {
-        float similarity = metrics_[i].first->ComputeFromFeatures(a, b);
-        total_similarity += similarity * normalized_weights_[i];
+float CompositeMetric::EvaluateFeatures(const FeatureVector& a, const FeatureVector& b,
+                                        float threshold) const {
+    if (!std::isfinite(threshold)) {
+        float total = 0.0f;
+        for (size_t i = 0; i < metrics_.size(); ++i) {
+            if (normalized_weights_[i] != 0.0f) {
+                total += normalized_weights_[i] * metrics_[i].first->ComputeFromFeatures(a, b);
+            }
+        }
+        return total;
     }
 
-    return total_similarity;
+    auto evaluate = [&](size_t i, float metric_threshold) {
+        return metrics_[i].first->ComputeFromFeaturesBounded(a, {}, b, {}, metric_threshold);
+    };
+
+    return cascade_.Evaluate(normalized_weights_, evaluate, threshold);
+}
+
+float CompositeMetric::PerturbationBound(const FeatureVector& query,
+                                         const FeatureVector& approx,
+                                         float max_error) const {
+    float bound = 0.0f;
+    for (size_t i = 0; i < metrics_.size(); ++i) {
+        if (normalized_weights_[i] != 0.0f) {
+            bound += std::abs(normalized_weights_[i]) *
+                     metrics_[i].first->PerturbationBound(query, approx, max_error);
+        }
+    }
+    return bound;
 }
 
 std::vector<float> CompositeMetric::ComputeBatch(
@@ -119,6 +347,11 @@ bool CompositeMetric::IsSymmetric() const {
         [](const auto& pair) { return pair.first->IsSymmetric(); });
 }
 
+bool CompositeMetric::ComputesFromFeatures() const {
+    return std::all_of(metrics_.begin(), metrics_.end(),
+        [](const auto& pair) { return pair.first->ComputesFromFeatures(); });
+}
+
 void CompositeMetric::NormalizeWeights() {
     normalized_weights_.clear();
 
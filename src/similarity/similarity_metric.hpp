@@ -2,6 +2,9 @@
 #pragma once
 
 #include "core/pattern_data.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include <string>
 #include <memory>
@@ -62,6 +65,130 @@ public:
     /// (required for true distance metrics)
     /// @return true if satisfies triangle inequality
     virtual bool IsMetric() const { return false; }
+
+    /// Check if Compute(a, b) equals ComputeFromFeatures(a.GetFeatures(), b.GetFeatures())
+    /// Lets search decode a query once and apply feature-level bounds.
+    /// @return true if Compute only depends on the decoded feature vectors
+    virtual bool ComputesFromFeatures() const { return false; }
+
+    // ========================================================================
+    // Bounds (used by exact search to skip hopeless candidates)
+    // ========================================================================
+
+    /// Compute a cheap summary of a feature vector from which similarity
+    /// can be bounded (e.g. norms, bounding boxes)
+    /// @param features Feature vector to summarize
+    /// @return Metric-specific summary (empty if the metric has no bounds)
+    virtual std::vector<float> ComputeBoundSummary(const FeatureVector& features) const;
+
+    /// Upper bound on ComputeFromFeatures(a, b) using only bound summaries
+    /// @param summary_a Summary of the first vector (may be empty)
+    /// @param summary_b Summary of the second vector (may be empty)
+    /// @return Upper bound on similarity (1.0 if nothing can be inferred)
+    virtual float UpperBoundFromSummaries(const std::vector<float>& summary_a,
+                                          const std::vector<float>& summary_b) const;
+
+    /// Compute similarity, abandoning early once it cannot reach a threshold
+    ///
+    /// Returns exactly ComputeFromFeatures(a, b) whenever that value is
+    /// >= threshold; otherwise returns some value below threshold.
+    /// Default implementation ignores the threshold and the summaries.
+    /// @param a First feature vector
+    /// @param summary_a Bound summary of a (may be empty)
+    /// @param b Second feature vector
+    /// @param summary_b Bound summary of b (may be empty)
+    /// @param threshold Similarity the caller needs to reach
+    /// @return Similarity score, exact if >= threshold
+    virtual float ComputeFromFeaturesBounded(const FeatureVector& a,
+                                             const std::vector<float>& summary_a,
+                                             const FeatureVector& b,
+                                             const std::vector<float>& summary_b,
+                                             float threshold) const;
+
+    /// Bound on how far ComputeFromFeatures(query, x) can be from
+    /// ComputeFromFeatures(query, approx) for any x whose elements each lie
+    /// within max_error of approx
+    ///
+    /// Lets searches over reduced-precision copies of the features rule
+    /// candidates out without losing exactness. Default knows no bound.
+    /// @param query Query feature vector
+    /// @param approx Decoded approximation of the candidate
+    /// @param max_error Largest absolute element error of approx
+    /// @return Largest possible similarity change (infinity if unknown)
+    virtual float PerturbationBound(const FeatureVector& query,
+                                    const FeatureVector& approx,
+                                    float max_error) const;
+
+    /// Convert a similarity to the distance it was derived from
+    /// Only meaningful when IsMetric() is true. Default inverts
+    /// similarity = 1 / (1 + distance).
+    /// @param similarity Similarity score
+    /// @return Distance (infinity for zero similarity)
+    virtual float SimilarityToDistance(float similarity) const;
+
+    /// Convert a distance to similarity (inverse of SimilarityToDistance)
+    /// @param distance Distance value
+    /// @return Similarity score [0.0, 1.0]
+    virtual float DistanceToSimilarity(float distance) const;
+};
+
+/// Cost-ordered evaluation of a weighted sum of metrics
+///
+/// Evaluates metrics cheapest-per-unit-weight first (using measured
+/// evaluation times) and stops once the weighted sum can no longer reach a
+/// threshold, assuming every unevaluated metric could still return 1.0.
+/// Completed sums are accumulated in registration order, so they are
+/// identical to a plain weighted sum.
+///
+/// Assumes constituent similarities never exceed 1.0. Early stopping is
+/// disabled when any weight is negative.
+class MetricCascade {
+public:
+    /// Per-metric evaluation counters
+    struct MetricStats {
+        std::string name;
+        uint64_t evaluations{0};          ///< Times the metric was evaluated
+        uint64_t evaluations_skipped{0};  ///< Times the cascade stopped before it
+        double avg_cost_us{0.0};          ///< Mean evaluation time (microseconds)
+    };
+
+    /// Evaluates metric `index`; may return any value below metric_threshold
+    /// instead of the exact similarity once that threshold is out of reach
+    using EvaluateFn = std::function<float(size_t index, float metric_threshold)>;
+
+    /// Register a metric (in the same order as the weights passed to Evaluate)
+    /// @param name Metric name used in statistics
+    void AddMetric(const std::string& name);
+
+    /// Remove all metrics and counters
+    void Clear();
+
+    /// Evaluate the weighted sum
+    /// @param weights Normalized weights, one per registered metric
+    /// @param evaluate Callback evaluating a single metric
+    /// @param threshold Weighted sum the caller needs to reach; if not finite
+    ///        (or a weight is negative), this is the plain weighted sum and
+    ///        nothing is timed or counted
+    /// @return Exact weighted sum if >= threshold, otherwise a value below threshold
+    float Evaluate(const std::vector<float>& weights,
+                   const EvaluateFn& evaluate,
+                   float threshold) const;
+
+    /// Get counters for every metric, in registration order
+    std::vector<MetricStats> GetStats() const;
+
+    /// Reset all counters (including measured costs)
+    void ResetStats();
+
+private:
+    struct Counters {
+        std::atomic<uint64_t> evaluations{0};
+        std::atomic<uint64_t> skipped{0};
+        std::atomic<uint64_t> total_ns{0};
+    };
+
+    std::vector<std::string> names_;
+    std::vector<std::unique_ptr<Counters>> counters_;
 };
 
 /// Composite metric: weighted combination of multiple metrics
@@ -91,6 +218,18 @@ public:
     /// @return Number of metrics
     size_t GetMetricCount() const;
 
+    /// Enable cascaded evaluation in ComputeFromFeaturesBounded
+    /// Metrics then run in order of measured cost and evaluation stops once
+    /// the weighted sum cannot reach the threshold.
+    /// @param enabled Whether to cascade (default: false)
+    void SetCascadeEnabled(bool enabled) { cascade_enabled_ = enabled; }
+
+    /// Check if cascaded evaluation is enabled
+    bool IsCascadeEnabled() const { return cascade_enabled_; }
+
+    /// Get per-metric cost and skip counters
+    std::vector<MetricCascade::MetricStats> GetMetricStats() const { return cascade_.GetStats(); }
+
     /// Compute weighted average of all constituent metrics
     /// @param a First pattern
     /// @param b Second pattern
@@ -103,6 +242,18 @@ public:
     /// @return Weighted average similarity [0.0, 1.0]
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
 
+    /// Weighted average, cascaded when enabled (see SetCascadeEnabled)
+    float ComputeFromFeaturesBounded(const FeatureVector& a,
+                                     const std::vector<float>& summary_a,
+                                     const FeatureVector& b,
+                                     const std::vector<float>& summary_b,
+                                     float threshold) const override;
+
+    /// Weighted sum of the constituent bounds
+    float PerturbationBound(const FeatureVector& query,
+                            const FeatureVector& approx,
+                            float max_error) const override;
+
     /// Batch computation using weighted average
     /// @param query Query pattern
     /// @param candidates Candidate patterns
@@ -119,6 +270,10 @@ public:
     /// @return true if all metrics are symmetric
     bool IsSymmetric() const override;
 
+    /// Composite is feature-based if all constituent metrics are
+    /// @return true if all metrics compute from features
+    bool ComputesFromFeatures() const override;
+
 private:
     /// List of (metric, weight) pairs
     std::vector<std::pair<std::shared_ptr<SimilarityMetric>, float>> metrics_;
@@ -126,6 +281,13 @@ private:
     /// Normalized weights (sum to 1.0)
     std::vector<float> normalized_weights_;
 
+    /// Cost ordering and counters
+    MetricCascade cascade_;
+    bool cascade_enabled_{false};
+
+    /// Evaluate all metrics on shared features, stopping below threshold
+    float EvaluateFeatures(const FeatureVector& a, const FeatureVector& b, float threshold) const;
+
     /// Recompute normalized weights after adding metrics
     void NormalizeWeights();
 };
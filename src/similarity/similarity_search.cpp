@@ -1,11 +1,34 @@
 // File: src/similarity/similarity_search.cpp
 #include "similarity_search.hpp"
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <numeric>
 #include <stdexcept>
+#include <unordered_set>
 
 namespace dpan {
 
+namespace {
+
+/// Query options covering the whole database (FindAll defaults to 100 IDs)
+QueryOptions AllPatterns() {
+    QueryOptions options;
+    options.max_results = std::numeric_limits<size_t>::max();
+    return options;
+}
+
+/// Candidate IDs for a search: the whole database, or only the patterns the
+/// storage indices report for the declarative filter
+std::vector<PatternID> CandidateIds(PatternDatabase& database, const SearchConfig& config) {
+    if (config.pattern_filter.IsEmpty()) {
+        return database.FindAll(AllPatterns());
+    }
+    return database.FindByFilter(config.pattern_filter, AllPatterns());
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // SimilaritySearch Implementation
 // ============================================================================
@@ -23,6 +46,10 @@ SimilaritySearch::SimilaritySearch(std::shared_ptr<PatternDatabase> database,
 
 std::vector<SearchResult> SimilaritySearch::Search(const PatternData& query,
                                                    const SearchConfig& config) const {
+    if (metric_->ComputesFromFeatures()) {
+        return SearchFeaturesImpl(query.GetFeatures(), config);
+    }
+
     auto similarity_fn = [this, &query](const PatternData& candidate) {
         return metric_->Compute(query, candidate);
     };
@@ -32,11 +59,7 @@ std::vector<SearchResult> SimilaritySearch::Search(const PatternData& query,
 
 std::vector<SearchResult> SimilaritySearch::SearchByFeatures(const FeatureVector& query,
                                                              const SearchConfig& config) const {
-    auto similarity_fn = [this, &query](const PatternData& candidate) {
-        return metric_->ComputeFromFeatures(query, candidate.GetFeatures());
-    };
-
-    return SearchImpl(similarity_fn, config);
+    return SearchFeaturesImpl(query, config);
 }
 
 std::vector<SearchResult> SimilaritySearch::SearchById(PatternID query_id,
@@ -48,6 +71,10 @@ std::vector<SearchResult> SimilaritySearch::SearchById(PatternID query_id,
     }
 
     const PatternData& query_data = query_node_opt->GetData();
+    if (metric_->ComputesFromFeatures()) {
+        return SearchFeaturesImpl(query_data.GetFeatures(), config, query_id);
+    }
+
     auto similarity_fn = [this, &query_data](const PatternData& candidate) {
         return metric_->Compute(query_data, candidate);
     };
@@ -55,6 +82,177 @@ std::vector<SearchResult> SimilaritySearch::SearchById(PatternID query_id,
     return SearchImpl(similarity_fn, config, query_id);
 }
 
+std::vector<SearchResult> SimilaritySearch::RangeSearch(const PatternData& query,
+                                                        float threshold,
+                                                        size_t limit,
+                                                        bool require_exact) const {
+    if (metric_->ComputesFromFeatures() && !require_exact) {
+        std::lock_guard<std::mutex> lock(layout_mutex_);
+        if (layout_) {
+            return RangeLayoutImpl(query.GetFeatures(), threshold, limit);
+        }
+    }
+
+    // Exact scan; with an unbounded limit the running threshold never
+    // rises, so bounds prune exactly the patterns below the range
+    SearchConfig config;
+    config.min_similarity = threshold;
+    config.max_results = limit;
+
+    if (metric_->ComputesFromFeatures()) {
+        if (require_exact) {
+            return ExactFeaturesImpl(query.GetFeatures(), config, PatternID(0));
+        }
+        return SearchFeaturesImpl(query.GetFeatures(), config);
+    }
+
+    auto similarity_fn = [this, &query](const PatternData& candidate) {
+        return metric_->Compute(query, candidate);
+    };
+    return SearchImpl(similarity_fn, config);
+}
+
+std::vector<std::vector<SearchResult>> SimilaritySearch::RangeSearchBatch(
+    const std::vector<PatternData>& queries,
+    float threshold,
+    size_t limit,
+    bool require_exact) const {
+
+    std::vector<std::vector<SearchResult>> results(queries.size());
+    if (queries.size() <= 1) {
+        if (!queries.empty()) {
+            results[0] = RangeSearch(queries[0], threshold, limit, require_exact);
+        }
+        return results;
+    }
+
+    const bool from_features = metric_->ComputesFromFeatures();
+    if (from_features && !require_exact) {
+        std::lock_guard<std::mutex> lock(layout_mutex_);
+        if (layout_) {
+            Stats total;
+            for (size_t q = 0; q < queries.size(); ++q) {
+                results[q] = RangeLayoutImpl(queries[q].GetFeatures(), threshold, limit);
+                total.patterns_evaluated += last_stats_.patterns_evaluated;
+                total.patterns_filtered += last_stats_.patterns_filtered;
+                total.patterns_pruned += last_stats_.patterns_pruned;
+            }
+            last_stats_ = total;
+            return results;
+        }
+    }
+
+    // Reset statistics
+    last_stats_ = Stats{};
+
+    auto all_ids = database_->FindAll(AllPatterns());
+    last_stats_.patterns_evaluated = all_ids.size() * queries.size();
+
+    // Per-query data for the bounded feature path
+    std::vector<FeatureVector> query_features;
+    std::vector<std::vector<float>> query_summaries;
+    std::vector<std::vector<float>> query_pivot_distances;
+    if (from_features) {
+        query_features.reserve(queries.size());
+        for (const auto& query : queries) {
+            query_features.push_back(query.GetFeatures());
+            query_summaries.push_back(metric_->ComputeBoundSummary(query_features.back()));
+            query_pivot_distances.push_back(ComputePivotDistances(query_features.back()));
+        }
+    }
+
+    std::vector<std::priority_queue<SearchResult>> top_k(queries.size());
+    auto threshold_for = [&](size_t q) {
+        if (limit > 0 && top_k[q].size() >= limit) {
+            return std::max(threshold, top_k[q].top().similarity);
+        }
+        return threshold;
+    };
+    auto admit = [&](size_t q, PatternID id, float similarity, float query_threshold) {
+        if (similarity < query_threshold) {
+            if (query_threshold > threshold) {
+                last_stats_.patterns_pruned++;
+            } else {
+                last_stats_.patterns_filtered++;
+            }
+            return;
+        }
+        top_k[q].emplace(id, similarity);
+        if (top_k[q].size() > limit) {
+            top_k[q].pop();
+        }
+    };
+
+    for (const auto& pattern_id : all_ids) {
+        auto node_opt = database_->Retrieve(pattern_id);
+        if (!node_opt) {
+            continue;
+        }
+        const PatternData& data = node_opt->GetData();
+
+        if (!from_features) {
+            for (size_t q = 0; q < queries.size(); ++q) {
+                admit(q, pattern_id, metric_->Compute(queries[q], data), threshold_for(q));
+            }
+            continue;
+        }
+
+        // Cached bounds are used only while the stored content is unchanged
+        const uint64_t content_hash = data.ContentHash();
+        std::shared_ptr<const BoundEntry> entry = CachedBounds(pattern_id);
+        if (entry && entry->content_hash != content_hash) {
+            entry.reset();
+        }
+
+        // Decoded lazily, once, for the first query the bounds cannot rule out
+        FeatureVector features;
+        bool decoded = false;
+        for (size_t q = 0; q < queries.size(); ++q) {
+            float query_threshold = threshold_for(q);
+            if (entry && CanPrune(*entry, query_summaries[q], query_pivot_distances[q],
+                                  query_threshold)) {
+                last_stats_.patterns_pruned++;
+                continue;
+            }
+
+            if (!decoded) {
+                features = data.GetFeatures();
+                decoded = true;
+                if (!entry) {
+                    entry = MakeBoundEntry(content_hash, features);
+                    std::lock_guard<std::mutex> lock(bound_mutex_);
+                    bound_cache_[pattern_id] = entry;
+                }
+            }
+
+            float similarity = metric_->ComputeFromFeaturesBounded(
+                query_features[q], query_summaries[q], features, entry->summary, query_threshold);
+            admit(q, pattern_id, similarity, query_threshold);
+        }
+    }
+
+    std::vector<SearchResult> all_results;
+    for (size_t q = 0; q < queries.size(); ++q) {
+        auto& heap = top_k[q];
+        results[q].reserve(heap.size());
+        while (!heap.empty()) {
+            results[q].push_back(heap.top());
+            heap.pop();
+        }
+        std::reverse(results[q].begin(), results[q].end());
+        all_results.insert(all_results.end(), results[q].begin(), results[q].end());
+    }
+
+    // Update statistics
+    std::sort(all_results.begin(), all_results.end(),
+              [](const SearchResult& a, const SearchResult& b) {
+                  return a.similarity > b.similarity;
+              });
+    UpdateStats(all_results);
+
+    return results;
+}
+
 std::vector<std::vector<SearchResult>> SimilaritySearch::SearchBatch(
     const std::vector<PatternData>& queries,
     const SearchConfig& config) const {
@@ -74,6 +272,170 @@ void SimilaritySearch::SetMetric(std::shared_ptr<SimilarityMetric> metric) {
         throw std::invalid_argument("Metric cannot be null");
     }
     metric_ = metric;
+
+    // Summaries and pivot distances are metric-specific
+    pivots_.clear();
+    pivot_dimension_ = 0;
+    ClearBoundCache();
+}
+
+void SimilaritySearch::BuildPivotIndex(size_t num_pivots) {
+    if (num_pivots > 0 && !metric_->IsMetric()) {
+        throw std::runtime_error("Pivot index requires a metric that satisfies the triangle inequality");
+    }
+
+    pivots_.clear();
+    pivot_dimension_ = 0;
+    ClearBoundCache();
+
+    if (num_pivots == 0) {
+        return;
+    }
+
+    // Decode every pattern once
+    std::vector<PatternID> ids;
+    std::vector<uint64_t> hashes;
+    std::vector<FeatureVector> features;
+
+    for (const auto& pattern_id : database_->FindAll(AllPatterns())) {
+        auto node_opt = database_->Retrieve(pattern_id);
+        if (!node_opt) {
+            continue;
+        }
+
+        FeatureVector pattern_features = node_opt->GetData().GetFeatures();
+        if (pattern_features.Dimension() == 0) {
+            continue;
+        }
+
+        ids.push_back(pattern_id);
+        hashes.push_back(node_opt->GetData().ContentHash());
+        features.push_back(std::move(pattern_features));
+    }
+
+    if (features.empty()) {
+        return;
+    }
+
+    // Farthest-first traversal: each new pivot is the pattern furthest from
+    // all pivots chosen so far. Distances to pivots are kept as they are
+    // computed, so the traversal costs one evaluation per pattern per pivot.
+    pivot_dimension_ = features[0].Dimension();
+    std::vector<float> nearest_pivot(features.size(), std::numeric_limits<float>::infinity());
+    std::vector<std::vector<float>> pivot_distances(features.size());
+
+    size_t next_pivot = 0;
+    while (pivots_.size() < num_pivots) {
+        pivots_.push_back(features[next_pivot]);
+
+        float furthest = 0.0f;
+        size_t furthest_index = features.size();
+
+        for (size_t i = 0; i < features.size(); ++i) {
+            if (features[i].Dimension() != pivot_dimension_) {
+                continue;
+            }
+
+            float distance = metric_->SimilarityToDistance(
+                metric_->ComputeFromFeatures(pivots_.back(), features[i]));
+            pivot_distances[i].push_back(distance);
+            nearest_pivot[i] = std::min(nearest_pivot[i], distance);
+
+            if (std::isfinite(nearest_pivot[i]) && nearest_pivot[i] > furthest) {
+                furthest = nearest_pivot[i];
+                furthest_index = i;
+            }
+        }
+
+        // Stop when every pattern coincides with a pivot
+        if (furthest_index == features.size()) {
+            break;
+        }
+        next_pivot = furthest_index;
+    }
+
+    std::lock_guard<std::mutex> lock(bound_mutex_);
+    for (size_t i = 0; i < features.size(); ++i) {
+        auto entry = std::make_shared<BoundEntry>();
+        entry->content_hash = hashes[i];
+        entry->dimension = features[i].Dimension();
+        entry->summary = metric_->ComputeBoundSummary(features[i]);
+        entry->pivot_distances = std::move(pivot_distances[i]);
+        bound_cache_[ids[i]] = std::move(entry);
+    }
+}
+
+void SimilaritySearch::ClearBoundCache() {
+    std::lock_guard<std::mutex> lock(bound_mutex_);
+    bound_cache_.clear();
+}
+
+void SimilaritySearch::SetStoragePrecision(FeaturePrecision precision, size_t rerank_factor) {
+    if (rerank_factor == 0) {
+        throw std::invalid_argument("rerank_factor must be at least 1");
+    }
+
+    std::lock_guard<std::mutex> lock(layout_mutex_);
+    rerank_factor_ = rerank_factor;
+
+    if (precision == FeaturePrecision::FLOAT32) {
+        layout_.reset();
+        return;
+    }
+
+    if (layout_ && layout_->GetPrecision() == precision) {
+        return;
+    }
+
+    layout_ = std::make_unique<QuantizedFeatureStore>(precision);
+    BuildLayout();
+}
+
+FeaturePrecision SimilaritySearch::GetStoragePrecision() const {
+    std::lock_guard<std::mutex> lock(layout_mutex_);
+    return layout_ ? layout_->GetPrecision() : FeaturePrecision::FLOAT32;
+}
+
+void SimilaritySearch::NotifyPatternChanged(PatternID id) {
+    {
+        std::lock_guard<std::mutex> lock(bound_mutex_);
+        bound_cache_.erase(id);
+    }
+
+    std::lock_guard<std::mutex> lock(layout_mutex_);
+    if (!layout_) {
+        return;
+    }
+
+    auto node_opt = database_->Retrieve(id);
+    if (node_opt) {
+        layout_->Upsert(id, node_opt->GetData().GetFeatures());
+    } else {
+        layout_->Remove(id);
+    }
+}
+
+void SimilaritySearch::RebuildLayout() {
+    std::lock_guard<std::mutex> lock(layout_mutex_);
+    if (layout_) {
+        BuildLayout();
+    }
+}
+
+size_t SimilaritySearch::GetLayoutMemoryBytes() const {
+    std::lock_guard<std::mutex> lock(layout_mutex_);
+    return layout_ ? layout_->MemoryUsageBytes() : 0;
+}
+
+void SimilaritySearch::BuildLayout() {
+    layout_->Clear();
+    for (const auto& id : database_->FindAll(AllPatterns())) {
+        auto node_opt = database_->Retrieve(id);
+        if (node_opt) {
+            layout_->Upsert(id, node_opt->GetData().GetFeatures());
+        }
+    }
+    layout_->ShrinkToFit();
 }
 
 std::vector<SearchResult> SimilaritySearch::SearchImpl(
@@ -87,8 +449,8 @@ std::vector<SearchResult> SimilaritySearch::SearchImpl(
     // Priority queue for top-k results (min-heap)
     std::priority_queue<SearchResult> top_k;
 
-    // Get all pattern IDs
-    auto all_ids = database_->FindAll();
+    // Get candidate pattern IDs
+    auto all_ids = CandidateIds(*database_, config);
     last_stats_.patterns_evaluated = all_ids.size();
 
     for (const auto& pattern_id : all_ids) {
@@ -146,6 +508,352 @@ std::vector<SearchResult> SimilaritySearch::SearchImpl(
     return results;
 }
 
+std::vector<SearchResult> SimilaritySearch::SearchFeaturesImpl(
+    const FeatureVector& query,
+    const SearchConfig& config,
+    PatternID exclude_id) const {
+
+    {
+        std::lock_guard<std::mutex> lock(layout_mutex_);
+        if (layout_) {
+            return SearchLayoutImpl(query, config, exclude_id);
+        }
+    }
+
+    return ExactFeaturesImpl(query, config, exclude_id);
+}
+
+std::vector<SearchResult> SimilaritySearch::ExactFeaturesImpl(
+    const FeatureVector& query,
+    const SearchConfig& config,
+    PatternID exclude_id) const {
+
+    // Reset statistics
+    last_stats_ = Stats{};
+
+    // Priority queue for top-k results (min-heap)
+    std::priority_queue<SearchResult> top_k;
+
+    // Get candidate pattern IDs
+    auto all_ids = CandidateIds(*database_, config);
+    last_stats_.patterns_evaluated = all_ids.size();
+
+    const std::vector<float> query_summary = metric_->ComputeBoundSummary(query);
+    const std::vector<float> query_pivot_distances = ComputePivotDistances(query);
+
+    {
+        // Drop entries of deleted patterns once they dominate the cache
+        std::lock_guard<std::mutex> lock(bound_mutex_);
+        if (config.pattern_filter.IsEmpty() && bound_cache_.size() > 2 * all_ids.size() + 64) {
+            std::unordered_set<PatternID> live(all_ids.begin(), all_ids.end());
+            for (auto it = bound_cache_.begin(); it != bound_cache_.end();) {
+                it = live.count(it->first) ? std::next(it) : bound_cache_.erase(it);
+            }
+        }
+    }
+
+    for (const auto& pattern_id : all_ids) {
+        // Skip excluded pattern (e.g., query pattern)
+        if (!config.include_query && pattern_id == exclude_id) {
+            last_stats_.patterns_filtered++;
+            continue;
+        }
+
+        // A candidate must reach min_similarity and, once top-k is full,
+        // at least tie the current k-th best result
+        float threshold = config.min_similarity;
+        if (config.max_results > 0 && top_k.size() >= config.max_results) {
+            threshold = std::max(threshold, top_k.top().similarity);
+        }
+
+        // Get pattern node
+        auto node_opt = database_->Retrieve(pattern_id);
+        if (!node_opt) {
+            continue;
+        }
+
+        // Apply custom filter if provided
+        if (config.filter && !config.filter(*node_opt)) {
+            last_stats_.patterns_filtered++;
+            continue;
+        }
+
+        const PatternData& data = node_opt->GetData();
+        const uint64_t content_hash = data.ContentHash();
+        std::shared_ptr<const BoundEntry> entry = CachedBounds(pattern_id);
+        if (entry && entry->content_hash != content_hash) {
+            entry.reset();
+        }
+
+        // Cheapest check first: cached bounds, no decoding needed
+        if (entry && CanPrune(*entry, query_summary, query_pivot_distances, threshold)) {
+            last_stats_.patterns_pruned++;
+            continue;
+        }
+
+        FeatureVector features = data.GetFeatures();
+        if (!entry) {
+            entry = MakeBoundEntry(content_hash, features);
+            std::lock_guard<std::mutex> lock(bound_mutex_);
+            bound_cache_[pattern_id] = entry;
+        }
+
+        // Compute similarity, abandoning once it cannot reach threshold
+        float similarity = metric_->ComputeFromFeaturesBounded(
+            query, query_summary, features, entry->summary, threshold);
+
+        if (similarity < threshold) {
+            if (threshold > config.min_similarity) {
+                last_stats_.patterns_pruned++;
+            } else {
+                last_stats_.patterns_filtered++;
+            }
+            continue;
+        }
+
+        // Add to top-k
+        top_k.emplace(pattern_id, similarity);
+
+        // Keep only top-k results
+        if (top_k.size() > config.max_results) {
+            top_k.pop();
+        }
+    }
+
+    // Extract results from priority queue
+    std::vector<SearchResult> results;
+    results.reserve(top_k.size());
+
+    while (!top_k.empty()) {
+        results.push_back(top_k.top());
+        top_k.pop();
+    }
+
+    // Reverse to get highest similarity first
+    std::reverse(results.begin(), results.end());
+
+    // Update statistics
+    UpdateStats(results);
+
+    return results;
+}
+
+std::vector<SearchResult> SimilaritySearch::SearchLayoutImpl(
+    const FeatureVector& query,
+    const SearchConfig& config,
+    PatternID exclude_id) const {
+
+    last_stats_ = Stats{};
+
+    std::unordered_set<PatternID> allowed;
+    const bool restricted = !config.pattern_filter.IsEmpty();
+    if (restricted) {
+        auto ids = CandidateIds(*database_, config);
+        allowed.insert(ids.begin(), ids.end());
+    }
+
+    // Phase 1: score the reduced-precision copies of every candidate
+    std::vector<SearchResult> scored;
+    scored.reserve(layout_->Size());
+    FeatureVector decoded;
+
+    for (size_t slot = 0; slot < layout_->Size(); ++slot) {
+        PatternID pattern_id = layout_->IdAt(slot);
+        if (restricted && !allowed.count(pattern_id)) {
+            continue;
+        }
+        last_stats_.patterns_evaluated++;
+
+        if (!config.include_query && pattern_id == exclude_id) {
+            last_stats_.patterns_filtered++;
+            continue;
+        }
+
+        layout_->Decode(slot, decoded);
+        scored.emplace_back(pattern_id, metric_->ComputeFromFeatures(query, decoded));
+    }
+
+    // Phase 2: walk the candidates best-approximate first and re-rank them
+    // with exact float32 features until rerank_factor_ * max_results have
+    // passed the filter
+    size_t pool_size = config.max_results;
+    if (pool_size > 0 && rerank_factor_ > std::numeric_limits<size_t>::max() / pool_size) {
+        pool_size = std::numeric_limits<size_t>::max();
+    } else {
+        pool_size *= rerank_factor_;
+    }
+
+    auto by_approx = [](const SearchResult& a, const SearchResult& b) {
+        return a.similarity < b.similarity;
+    };
+    std::make_heap(scored.begin(), scored.end(), by_approx);
+
+    std::priority_queue<SearchResult> top_k;
+    size_t admitted = 0;
+    auto remaining = scored.end();
+    while (admitted < pool_size && remaining != scored.begin()) {
+        std::pop_heap(scored.begin(), remaining, by_approx);
+        --remaining;
+        PatternID pattern_id = remaining->pattern_id;
+
+        auto node_opt = database_->Retrieve(pattern_id);
+        if (!node_opt) {
+            continue;
+        }
+
+        if (config.filter && !config.filter(*node_opt)) {
+            last_stats_.patterns_filtered++;
+            continue;
+        }
+        ++admitted;
+
+        float similarity = metric_->ComputeFromFeatures(query, node_opt->GetData().GetFeatures());
+        if (similarity < config.min_similarity) {
+            last_stats_.patterns_filtered++;
+            continue;
+        }
+
+        top_k.emplace(pattern_id, similarity);
+        if (top_k.size() > config.max_results) {
+            top_k.pop();
+        }
+    }
+    last_stats_.patterns_pruned = static_cast<size_t>(remaining - scored.begin());
+
+    std::vector<SearchResult> results;
+    results.reserve(top_k.size());
+    while (!top_k.empty()) {
+        results.push_back(top_k.top());
+        top_k.pop();
+    }
+    std::reverse(results.begin(), results.end());
+
+    UpdateStats(results);
+
+    return results;
+}
+
+std::vector<SearchResult> SimilaritySearch::RangeLayoutImpl(
+    const FeatureVector& query,
+    float threshold,
+    size_t limit) const {
+
+    last_stats_ = Stats{};
+
+    // Phase 1: keep every pattern whose exact similarity could reach the
+    // threshold given the quantization error of its slot
+    std::vector<PatternID> candidates;
+    FeatureVector decoded;
+
+    for (size_t slot = 0; slot < layout_->Size(); ++slot) {
+        layout_->Decode(slot, decoded);
+        float approx = metric_->ComputeFromFeatures(query, decoded);
+        if (approx >= threshold ||
+            approx + metric_->PerturbationBound(query, decoded, layout_->ErrorAt(slot)) >= threshold) {
+            candidates.push_back(layout_->IdAt(slot));
+        }
+    }
+    last_stats_.patterns_evaluated = layout_->Size();
+    last_stats_.patterns_pruned = layout_->Size() - candidates.size();
+
+    // Phase 2: verify with exact float32 features
+    std::priority_queue<SearchResult> top_k;
+    for (const auto& pattern_id : candidates) {
+        auto node_opt = database_->Retrieve(pattern_id);
+        if (!node_opt) {
+            continue;
+        }
+
+        float similarity = metric_->ComputeFromFeatures(query, node_opt->GetData().GetFeatures());
+        if (similarity < threshold) {
+            last_stats_.patterns_filtered++;
+            continue;
+        }
+
+        top_k.emplace(pattern_id, similarity);
+        if (top_k.size() > limit) {
+            top_k.pop();
+        }
+    }
+
+    std::vector<SearchResult> results;
+    results.reserve(top_k.size());
+    while (!top_k.empty()) {
+        results.push_back(top_k.top());
+        top_k.pop();
+    }
+    std::reverse(results.begin(), results.end());
+
+    UpdateStats(results);
+
+    return results;
+}
+
+std::shared_ptr<const SimilaritySearch::BoundEntry> SimilaritySearch::CachedBounds(
+    PatternID id) const {
+
+    std::lock_guard<std::mutex> lock(bound_mutex_);
+    auto it = bound_cache_.find(id);
+    return it != bound_cache_.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<const SimilaritySearch::BoundEntry> SimilaritySearch::MakeBoundEntry(
+    uint64_t content_hash,
+    const FeatureVector& features) const {
+
+    auto entry = std::make_shared<BoundEntry>();
+    entry->content_hash = content_hash;
+    entry->dimension = features.Dimension();
+    entry->summary = metric_->ComputeBoundSummary(features);
+    entry->pivot_distances = ComputePivotDistances(features);
+    return entry;
+}
+
+std::vector<float> SimilaritySearch::ComputePivotDistances(const FeatureVector& features) const {
+    std::vector<float> distances;
+    if (pivots_.empty() || features.Dimension() != pivot_dimension_) {
+        return distances;
+    }
+
+    distances.reserve(pivots_.size());
+    for (const auto& pivot : pivots_) {
+        distances.push_back(metric_->SimilarityToDistance(metric_->ComputeFromFeatures(pivot, features)));
+    }
+    return distances;
+}
+
+bool SimilaritySearch::CanPrune(const BoundEntry& entry,
+                                const std::vector<float>& query_summary,
+                                const std::vector<float>& query_pivot_distances,
+                                float threshold) const {
+    if (metric_->UpperBoundFromSummaries(query_summary, entry.summary) < threshold) {
+        return true;
+    }
+
+    if (query_pivot_distances.empty() ||
+        entry.pivot_distances.size() != query_pivot_distances.size()) {
+        return false;
+    }
+
+    // Triangle inequality: d(q, x) >= |d(q, p) - d(p, x)| for every pivot p
+    float lower_bound = 0.0f;
+    for (size_t i = 0; i < query_pivot_distances.size(); ++i) {
+        float query_distance = query_pivot_distances[i];
+        float entry_distance = entry.pivot_distances[i];
+        if (!std::isfinite(query_distance) || !std::isfinite(entry_distance)) {
+            continue;
+        }
+        lower_bound = std::max(lower_bound, std::abs(query_distance - entry_distance));
+    }
+
+    // Distances went through a similarity round trip; stay conservative
+    lower_bound = lower_bound * (1.0f - 1e-3f) - 1e-5f;
+    if (lower_bound <= 0.0f) {
+        return false;
+    }
+    return metric_->DistanceToSimilarity(lower_bound) < threshold;
+}
+
 void SimilaritySearch::UpdateStats(const std::vector<SearchResult>& results) const {
     last_stats_.results_returned = results.size();
 
@@ -213,11 +921,23 @@ std::vector<SearchResult> ApproximateSearch::Search(const PatternData& query,
     // Compute query bucket
     size_t query_bucket = ComputeBucket(query.GetFeatures());
 
+    // Declarative filters become an allow-list checked before retrieval
+    std::unordered_set<PatternID> allowed;
+    const bool use_allowed = !config.pattern_filter.IsEmpty();
+    if (use_allowed) {
+        auto ids = database_->FindByFilter(config.pattern_filter, AllPatterns());
+        allowed.insert(ids.begin(), ids.end());
+    }
+
     // Search in the query bucket and neighboring buckets
     std::priority_queue<SearchResult> top_k;
 
     // Search in query bucket
     for (const auto& pattern_id : buckets_[query_bucket]) {
+        if (use_allowed && !allowed.count(pattern_id)) {
+            continue;
+        }
+
         auto node_opt = database_->Retrieve(pattern_id);
         if (!node_opt) {
             continue;
@@ -248,6 +968,10 @@ std::vector<SearchResult> ApproximateSearch::Search(const PatternData& query,
 
     for (size_t bucket_id : neighbor_buckets) {
         for (const auto& pattern_id : buckets_[bucket_id]) {
+            if (use_allowed && !allowed.count(pattern_id)) {
+                continue;
+            }
+
             auto node_opt = database_->Retrieve(pattern_id);
             if (!node_opt) {
                 continue;
@@ -315,12 +1039,14 @@ void MultiMetricSearch::AddMetric(std::shared_ptr<SimilarityMetric> metric, floa
     }
 
     metrics_.emplace_back(metric, weight);
+    cascade_.AddMetric(metric->GetName());
     NormalizeWeights();
 }
 
 void MultiMetricSearch::Clear() {
     metrics_.clear();
     normalized_weights_.clear();
+    cascade_.Clear();
 }
 
 std::vector<SearchResult> MultiMetricSearch::Search(const PatternData& query,
@@ -329,10 +1055,15 @@ std::vector<SearchResult> MultiMetricSearch::Search(const PatternData& query,
         return {};
     }
 
+    // Decode the query once for all feature-based metrics
+    bool any_features = std::any_of(metrics_.begin(), metrics_.end(),
+        [](const auto& pair) { return pair.first->ComputesFromFeatures(); });
+    const FeatureVector query_features = any_features ? query.GetFeatures() : FeatureVector();
+
     // Compute combined similarity for all patterns
     std::priority_queue<SearchResult> top_k;
 
-    auto all_ids = database_->FindAll();
+    auto all_ids = CandidateIds(*database_, config);
 
     for (const auto& pattern_id : all_ids) {
         auto node_opt = database_->Retrieve(pattern_id);
@@ -344,18 +1075,37 @@ std::vector<SearchResult> MultiMetricSearch::Search(const PatternData& query,
             continue;
         }
 
-        // Compute weighted combination of similarities
-        float combined_similarity = 0.0f;
-        for (size_t i = 0; i < metrics_.size(); ++i) {
-            float sim = metrics_[i].first->Compute(query, node_opt->GetData());
-            combined_similarity += normalized_weights_[i] * sim;
+        // A candidate must reach min_similarity and, once top-k is full,
+        // at least tie the current k-th best result
+        float threshold = config.min_similarity;
+        if (config.max_results > 0 && top_k.size() >= config.max_results) {
+            threshold = std::max(threshold, top_k.top().similarity);
         }
 
-        if (combined_similarity >= config.min_similarity) {
-            top_k.emplace(pattern_id, combined_similarity);
-            if (top_k.size() > config.max_results) {
-                top_k.pop();
+        const PatternData& candidate = node_opt->GetData();
+        const FeatureVector candidate_features = any_features ? candidate.GetFeatures() : FeatureVector();
+
+        auto evaluate = [&](size_t i, float metric_threshold) {
+            const auto& metric = metrics_[i].first;
+            if (!metric->ComputesFromFeatures()) {
+                return metric->Compute(query, candidate);
             }
+            return metric->ComputeFromFeaturesBounded(query_features, {}, candidate_features, {},
+                                                      metric_threshold);
+        };
+
+        // Compute weighted combination of similarities
+        float combined_similarity = cascade_.Evaluate(
+            normalized_weights_, evaluate,
+            cascade_enabled_ ? threshold : -std::numeric_limits<float>::infinity());
+
+        if (combined_similarity < threshold) {
+            continue;
+        }
+
+        top_k.emplace(pattern_id, combined_similarity);
+        if (top_k.size() > config.max_results) {
+            top_k.pop();
         }
     }
 
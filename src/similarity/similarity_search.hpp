@@ -2,12 +2,16 @@
 #pragma once
 
 #include "similarity_metric.hpp"
+#include "similarity/quantized_feature_store.hpp"
 #include "storage/pattern_database.hpp"
 #include "core/pattern_node.hpp"
 #include <vector>
 #include <memory>
 #include <functional>
+#include <limits>
+#include <mutex>
 #include <queue>
+#include <unordered_map>
 
 namespace dpan {
 
@@ -35,7 +39,12 @@ struct SearchConfig {
     /// Whether to include the query pattern in results
     bool include_query{false};
 
-    /// Optional filter function (returns true if pattern should be included)
+    /// Declarative filter answered by the storage indices before any
+    /// candidate is retrieved (default: no constraint)
+    PatternFilter pattern_filter;
+
+    /// Optional residual filter function (returns true if pattern should be
+    /// included); evaluated on retrieved nodes that passed pattern_filter
     std::function<bool(const PatternNode&)> filter;
 
     /// Default configuration
@@ -63,6 +72,20 @@ struct SearchConfig {
 ///
 /// Provides efficient similarity search over pattern collections.
 /// Supports multiple similarity metrics, filtering, and top-k retrieval.
+///
+/// For feature-based metrics the scan is exact but skips candidates that
+/// provably cannot beat the running threshold (min_similarity, or the k-th
+/// best result once max_results are held):
+/// - metric bound summaries (norms, bounding boxes) cached per pattern
+/// - triangle-inequality bounds from pivot distances (IsMetric() metrics,
+///   after BuildPivotIndex)
+/// - early-abandoned evaluation via ComputeFromFeaturesBounded
+///
+/// With a reduced storage precision (SetStoragePrecision) the scan instead
+/// streams a compact fp16/bf16/int8 copy of the features and re-ranks the
+/// best max_results * rerank_factor candidates that pass the filters with
+/// exact float32 similarities. Returned scores are always exact; recall
+/// depends on the rerank factor.
 class SimilaritySearch {
 public:
     /// Constructor
@@ -92,6 +115,44 @@ public:
     std::vector<SearchResult> SearchById(PatternID query_id,
                                          const SearchConfig& config = SearchConfig::Default()) const;
 
+    /// Find every pattern whose similarity to the query reaches a threshold
+    ///
+    /// With a reduced-precision layout active, the layout is scanned and only
+    /// patterns whose approximate similarity is within the metric's
+    /// PerturbationBound (for that pattern's quantization error) of the
+    /// threshold are retrieved and scored exactly, so the cost beyond the
+    /// in-memory scan grows with the number of near neighbours. Without a
+    /// layout, or with require_exact, the bound-pruned exact scan is used.
+    /// Either way every pattern reaching the threshold is returned, with
+    /// its exact similarity.
+    /// @param query Query pattern data
+    /// @param threshold Minimum similarity (inclusive)
+    /// @param limit Keep at most this many of the most similar patterns
+    /// @param require_exact Bypass approximate indices
+    /// @return Matching patterns (highest similarity first)
+    std::vector<SearchResult> RangeSearch(const PatternData& query,
+                                          float threshold,
+                                          size_t limit = std::numeric_limits<size_t>::max(),
+                                          bool require_exact = false) const;
+
+    /// RangeSearch for several queries in one pass over the database
+    ///
+    /// Each stored pattern is retrieved, and its features decoded, at most
+    /// once for the whole batch instead of once per query. With a
+    /// reduced-precision layout active (and !require_exact) the layout is
+    /// scanned per query. Results equal calling RangeSearch for each query;
+    /// the last search statistics count pattern/query pairs.
+    /// @param queries Query pattern data
+    /// @param threshold Minimum similarity (inclusive)
+    /// @param limit Keep at most this many results per query
+    /// @param require_exact Bypass approximate indices
+    /// @return One result vector per query (highest similarity first)
+    std::vector<std::vector<SearchResult>> RangeSearchBatch(
+        const std::vector<PatternData>& queries,
+        float threshold,
+        size_t limit = std::numeric_limits<size_t>::max(),
+        bool require_exact = false) const;
+
     /// Batch search for multiple queries
     /// @param queries Vector of query patterns
     /// @param config Search configuration
@@ -109,10 +170,55 @@ public:
     /// Get pattern database
     std::shared_ptr<PatternDatabase> GetDatabase() const { return database_; }
 
+    /// Select pivots for triangle-inequality pruning
+    ///
+    /// Picks up to num_pivots patterns by farthest-first traversal and records
+    /// each pattern's distance to them. Patterns stored or changed later get
+    /// their pivot distances on first encounter. Only metrics with
+    /// IsMetric() == true can use pivots.
+    /// @param num_pivots Number of pivots (0 removes the pivot index)
+    /// @throws std::runtime_error if the metric does not satisfy the triangle inequality
+    void BuildPivotIndex(size_t num_pivots = 8);
+
+    /// Get number of pivots in use
+    size_t GetPivotCount() const { return pivots_.size(); }
+
+    /// Drop cached bound summaries and pivot distances
+    void ClearBoundCache();
+
+    /// Report a pattern that was stored, updated or deleted
+    ///
+    /// Drops its cached bounds and re-encodes it in (or removes it from) the
+    /// search layout. Cached bounds are also checked against the content
+    /// hash of the retrieved pattern, so only the layout depends on this.
+    void NotifyPatternChanged(PatternID id);
+
+    /// Select the precision of the feature search layout
+    ///
+    /// FLOAT32 (the default) searches the stored patterns directly. Any other
+    /// precision builds a quantized copy of all features that feature-based
+    /// searches scan first. Patterns stored, updated or deleted afterwards
+    /// must be reported through NotifyPatternChanged; searches never rescan
+    /// the database.
+    /// @param precision Element precision of the layout
+    /// @param rerank_factor Candidates re-ranked exactly per requested result (>= 1)
+    /// @throws std::invalid_argument if rerank_factor is zero
+    void SetStoragePrecision(FeaturePrecision precision, size_t rerank_factor = 4);
+
+    /// Get the precision of the feature search layout
+    FeaturePrecision GetStoragePrecision() const;
+
+    /// Rebuild the search layout from the database (after bulk changes)
+    void RebuildLayout();
+
+    /// Heap bytes held by the search layout (0 at FLOAT32)
+    size_t GetLayoutMemoryBytes() const;
+
     /// Statistics
     struct Stats {
         size_t patterns_evaluated{0};
         size_t patterns_filtered{0};
+        size_t patterns_pruned{0};      ///< Skipped by a bound or abandoned evaluation
         size_t results_returned{0};
         float min_similarity_found{1.0f};
         float max_similarity_found{0.0f};
@@ -123,16 +229,79 @@ public:
     const Stats& GetLastSearchStats() const { return last_stats_; }
 
 private:
+    /// Bound data cached per pattern, valid while the content hash matches
+    struct BoundEntry {
+        uint64_t content_hash{0};
+        size_t dimension{0};
+        std::vector<float> summary;
+        std::vector<float> pivot_distances;
+    };
+
     std::shared_ptr<PatternDatabase> database_;
     std::shared_ptr<SimilarityMetric> metric_;
     mutable Stats last_stats_;
 
+    /// Pivot feature vectors (all of pivot_dimension_)
+    std::vector<FeatureVector> pivots_;
+    size_t pivot_dimension_{0};
+
+    mutable std::mutex bound_mutex_;
+    mutable std::unordered_map<PatternID, std::shared_ptr<const BoundEntry>> bound_cache_;
+
+    /// Reduced-precision search layout (null at FLOAT32)
+    mutable std::mutex layout_mutex_;
+    mutable std::unique_ptr<QuantizedFeatureStore> layout_;
+    size_t rerank_factor_{4};
+
     /// Core search implementation
     std::vector<SearchResult> SearchImpl(
         const std::function<float(const PatternData&)>& similarity_fn,
         const SearchConfig& config,
         PatternID exclude_id = PatternID(0)) const;
 
+    /// Exact search for feature-based metrics with bound-based pruning
+    std::vector<SearchResult> SearchFeaturesImpl(
+        const FeatureVector& query,
+        const SearchConfig& config,
+        PatternID exclude_id = PatternID(0)) const;
+
+    /// Exact bound-pruned scan over stored features
+    std::vector<SearchResult> ExactFeaturesImpl(
+        const FeatureVector& query,
+        const SearchConfig& config,
+        PatternID exclude_id) const;
+
+    /// Two-phase search over the reduced-precision layout
+    std::vector<SearchResult> SearchLayoutImpl(
+        const FeatureVector& query,
+        const SearchConfig& config,
+        PatternID exclude_id) const;
+
+    /// Range query over the reduced-precision layout
+    std::vector<SearchResult> RangeLayoutImpl(
+        const FeatureVector& query,
+        float threshold,
+        size_t limit) const;
+
+    /// Encode every stored pattern into layout_ (layout_mutex_ must be held)
+    void BuildLayout();
+
+    /// Cached bound data of a pattern (null if none)
+    std::shared_ptr<const BoundEntry> CachedBounds(PatternID id) const;
+
+    /// Build bound data for a pattern's decoded features
+    std::shared_ptr<const BoundEntry> MakeBoundEntry(uint64_t content_hash,
+                                                     const FeatureVector& features) const;
+
+    /// Distances from features to each pivot (empty if pivots don't apply)
+    std::vector<float> ComputePivotDistances(const FeatureVector& features) const;
+
+    /// Check whether cached bounds rule a candidate out
+    bool CanPrune(const BoundEntry& entry,
+                  const std::vector<float>& query_summary,
+                  const std::vector<float>& query_pivot_distances,
+                  float threshold) const;
+
     /// Update statistics
     void UpdateStats(const std::vector<SearchResult>& results) const;
 };
@@ -180,6 +349,10 @@ private:
 /// Multi-metric search
 ///
 /// Combines multiple metrics with weights for more sophisticated search.
+/// Query and candidate features are decoded once and shared by all
+/// feature-based metrics. In cascade mode metrics run in order of measured
+/// cost and a candidate is dropped as soon as the weighted sum cannot reach
+/// min_similarity or the current top-k.
 class MultiMetricSearch {
 public:
     /// Constructor
@@ -199,10 +372,24 @@ public:
     /// Get number of metrics
     size_t GetMetricCount() const { return metrics_.size(); }
 
+    /// Enable cascaded evaluation (default: false)
+    void SetCascadeEnabled(bool enabled) { cascade_enabled_ = enabled; }
+
+    /// Check if cascaded evaluation is enabled
+    bool IsCascadeEnabled() const { return cascade_enabled_; }
+
+    /// Get per-metric cost and skip counters, accumulated over all searches
+    std::vector<MetricCascade::MetricStats> GetMetricStats() const { return cascade_.GetStats(); }
+
+    /// Reset per-metric counters
+    void ResetMetricStats() { cascade_.ResetStats(); }
+
 private:
     std::shared_ptr<PatternDatabase> database_;
     std::vector<std::pair<std::shared_ptr<SimilarityMetric>, float>> metrics_;
     std::vector<float> normalized_weights_;
+    MetricCascade cascade_;
+    bool cascade_enabled_{false};
 
     void NormalizeWeights();
 };
@@ -73,6 +73,7 @@ public:
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "Moment"; }
     bool IsSymmetric() const override { return true; }
+    bool ComputesFromFeatures() const override { return true; }
 
 private:
     std::vector<float> weights_;
@@ -104,6 +105,7 @@ public:
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "Histogram"; }
     bool IsSymmetric() const override { return true; }
+    bool ComputesFromFeatures() const override { return true; }
 
 private:
     size_t num_bins_;
@@ -134,6 +136,7 @@ public:
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "KLDivergence"; }
     bool IsSymmetric() const override { return true; }  // Using symmetric KL
+    bool ComputesFromFeatures() const override { return true; }
 
 private:
     size_t num_bins_;
@@ -162,6 +165,7 @@ public:
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "KS"; }
     bool IsSymmetric() const override { return true; }
+    bool ComputesFromFeatures() const override { return true; }
 
 private:
     /// Compute KS statistic
@@ -188,6 +192,7 @@ public:
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "ChiSquare"; }
     bool IsSymmetric() const override { return true; }
+    bool ComputesFromFeatures() const override { return true; }
 
 private:
     size_t num_bins_;
@@ -216,6 +221,7 @@ public:
     float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override;
     std::string GetName() const override { return "EarthMover"; }
     bool IsSymmetric() const override { return true; }
+    bool ComputesFromFeatures() const override { return true; }
 
 private:
     size_t num_bins_;
@@ -0,0 +1,101 @@
+// File: src/storage/indices/hierarchy_index.cpp
+#include "storage/indices/hierarchy_index.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace dpan {
+
+void HierarchyIndex::SetSubPatterns(PatternID parent,
+                                    const std::vector<PatternID>& sub_patterns) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    RemoveParentUnlocked(parent);
+    if (sub_patterns.empty()) {
+        return;
+    }
+
+    auto& children = sub_patterns_[parent];
+    for (PatternID child : sub_patterns) {
+        if (std::find(children.begin(), children.end(), child) != children.end()) {
+            continue;
+        }
+        children.push_back(child);
+        parents_[child].push_back(parent);
+        ++link_count_;
+    }
+}
+
+bool HierarchyIndex::RemoveParent(PatternID parent) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    bool had_links = sub_patterns_.count(parent) > 0;
+    RemoveParentUnlocked(parent);
+    return had_links;
+}
+
+void HierarchyIndex::RemoveParentUnlocked(PatternID parent) {
+    auto it = sub_patterns_.find(parent);
+    if (it == sub_patterns_.end()) {
+        return;
+    }
+
+    for (PatternID child : it->second) {
+        auto parents_it = parents_.find(child);
+        if (parents_it == parents_.end()) {
+            continue;
+        }
+        auto& parents = parents_it->second;
+        parents.erase(std::find(parents.begin(), parents.end(), parent));
+        if (parents.empty()) {
+            parents_.erase(parents_it);
+        }
+    }
+    link_count_ -= it->second.size();
+    sub_patterns_.erase(it);
+}
+
+std::vector<PatternID> HierarchyIndex::GetSubPatterns(PatternID parent) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    auto it = sub_patterns_.find(parent);
+    return it != sub_patterns_.end() ? it->second : std::vector<PatternID>{};
+}
+
+std::vector<PatternID> HierarchyIndex::GetParents(PatternID child) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    auto it = parents_.find(child);
+    return it != parents_.end() ? it->second : std::vector<PatternID>{};
+}
+
+bool HierarchyIndex::HasParents(PatternID child) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return parents_.count(child) > 0;
+}
+
+std::vector<HierarchyEntry> HierarchyIndex::Traverse(const std::vector<PatternID>& roots,
+                                                     HierarchyDirection direction,
+                                                     size_t max_depth) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    const auto& links = direction == HierarchyDirection::ANCESTORS ? parents_ : sub_patterns_;
+    static const std::vector<PatternID> kNone;
+    return TraverseLinks(roots, max_depth, [&](PatternID id) -> const std::vector<PatternID>& {
+        auto it = links.find(id);
+        return it != links.end() ? it->second : kNone;
+    });
+}
+
+size_t HierarchyIndex::Size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return link_count_;
+}
+
+void HierarchyIndex::Clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    sub_patterns_.clear();
+    parents_.clear();
+    link_count_ = 0;
+}
+
+} // namespace dpan
@@ -0,0 +1,130 @@
+// File: src/storage/indices/hierarchy_index.hpp
+#pragma once
+
+#include "core/types.hpp"
+#include <cstddef>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dpan {
+
+/// Direction of a hierarchy traversal
+enum class HierarchyDirection {
+    ANCESTORS,    ///< Patterns that contain the roots, transitively
+    DESCENDANTS   ///< Sub-patterns of the roots, transitively
+};
+
+/// Pattern reached by a hierarchy traversal
+struct HierarchyEntry {
+    PatternID id;
+
+    /// Links from the nearest root (1 = direct parent or sub-pattern)
+    size_t depth{0};
+};
+
+/// Breadth-first walk over pattern links
+///
+/// Each pattern is reported once, at its smallest depth; roots are not
+/// reported, and cycles terminate.
+///
+/// @param roots Starting patterns
+/// @param max_depth Deepest level to report (0 reports nothing)
+/// @param links Callable returning the linked patterns of one pattern
+/// @return Reached patterns in breadth-first order
+template <typename Links>
+std::vector<HierarchyEntry> TraverseLinks(const std::vector<PatternID>& roots,
+                                          size_t max_depth, Links&& links) {
+    std::vector<HierarchyEntry> reached;
+    std::unordered_set<PatternID> visited(roots.begin(), roots.end());
+    std::vector<PatternID> frontier(roots.begin(), roots.end());
+
+    for (size_t depth = 1; depth <= max_depth && !frontier.empty(); ++depth) {
+        std::vector<PatternID> next;
+        for (PatternID id : frontier) {
+            for (PatternID linked : links(id)) {
+                if (visited.insert(linked).second) {
+                    reached.push_back({linked, depth});
+                    next.push_back(linked);
+                }
+            }
+        }
+        frontier = std::move(next);
+    }
+    return reached;
+}
+
+/// Two-way index of sub-pattern links
+///
+/// PatternNode stores only its own sub-patterns, so finding the composite
+/// and meta patterns that contain a pattern means scanning every node.
+/// This index keeps both directions (parent -> sub-patterns and
+/// sub-pattern -> parents) as plain ID lists, so parents, sub-patterns and
+/// whole ancestor/descendant sets are answered without touching any node.
+///
+/// Storage backends update it on every store, update and delete. A link
+/// stays as long as its parent lists it, even if the sub-pattern itself is
+/// deleted.
+///
+/// Thread-safe with a shared mutex (concurrent readers).
+class HierarchyIndex {
+public:
+    /// Default constructor
+    HierarchyIndex() = default;
+
+    /// Replace the sub-patterns of a parent
+    /// @param parent Pattern identifier
+    /// @param sub_patterns Its current sub-patterns (empty removes the parent)
+    void SetSubPatterns(PatternID parent, const std::vector<PatternID>& sub_patterns);
+
+    /// Remove a parent and all its links
+    /// @param parent Pattern identifier
+    /// @return true if the parent had sub-patterns
+    bool RemoveParent(PatternID parent);
+
+    /// Get the sub-patterns of a pattern
+    /// @param parent Pattern identifier
+    /// @return Sub-pattern IDs in the parent's order (empty if none)
+    std::vector<PatternID> GetSubPatterns(PatternID parent) const;
+
+    /// Get the patterns that list a pattern as a sub-pattern
+    /// @param child Pattern identifier
+    /// @return Parent IDs (empty if none)
+    std::vector<PatternID> GetParents(PatternID child) const;
+
+    /// Check whether any pattern lists a pattern as a sub-pattern
+    /// @param child Pattern identifier
+    bool HasParents(PatternID child) const;
+
+    /// Collect ancestors or descendants of a set of patterns
+    /// @param roots Starting patterns
+    /// @param direction ANCESTORS follows parents, DESCENDANTS sub-patterns
+    /// @param max_depth Deepest level to report
+    /// @return Reached patterns in breadth-first order (see TraverseLinks)
+    std::vector<HierarchyEntry> Traverse(const std::vector<PatternID>& roots,
+                                         HierarchyDirection direction,
+                                         size_t max_depth) const;
+
+    /// Get total number of parent -> sub-pattern links
+    size_t Size() const;
+
+    /// Clear all links
+    void Clear();
+
+private:
+    void RemoveParentUnlocked(PatternID parent);
+
+    /// Parent -> sub-patterns, in the parent's order
+    std::unordered_map<PatternID, std::vector<PatternID>> sub_patterns_;
+
+    /// Sub-pattern -> parents
+    std::unordered_map<PatternID, std::vector<PatternID>> parents_;
+
+    size_t link_count_{0};
+
+    /// Mutex for thread safety
+    mutable std::shared_mutex mutex_;
+};
+
+} // namespace dpan
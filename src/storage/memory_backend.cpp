@@ -54,7 +54,8 @@ bool MemoryBackend::Store(const PatternNode& node) {
     }
 
     // Clone the node to preserve all state
-    patterns_.emplace(id, node.Clone());
+    auto inserted = patterns_.emplace(id, node.Clone()).first;
+    IndexNode(inserted->second);
 
     auto end = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
@@ -95,8 +96,10 @@ bool MemoryBackend::Update(const PatternNode& node) {
     }
 
     // Erase and re-insert with cloned node to preserve all state
+    UnindexNode(it->second);
     patterns_.erase(it);
-    patterns_.emplace(id, node.Clone());
+    auto inserted = patterns_.emplace(id, node.Clone()).first;
+    IndexNode(inserted->second);
     return true;
 }
 
@@ -109,6 +112,7 @@ bool MemoryBackend::Delete(PatternID id) {
         return false;
     }
 
+    UnindexNode(it->second);
     patterns_.erase(it);
     return true;
 }
@@ -138,7 +142,9 @@ size_t MemoryBackend::StoreBatch(const std::vector<PatternNode>& nodes) {
             continue;
         }
 
-        patterns_.emplace(id, PatternNode(node.GetID(), node.GetData(), node.GetType()));
+        // Clone the node to preserve all state, as Store does
+        auto inserted = patterns_.emplace(id, node.Clone()).first;
+        IndexNode(inserted->second);
         ++stored_count;
     }
 
@@ -171,6 +177,7 @@ size_t MemoryBackend::DeleteBatch(const std::vector<PatternID>& ids) {
     for (const auto& id : ids) {
         auto it = patterns_.find(id);
         if (it != patterns_.end()) {
+            UnindexNode(it->second);
             patterns_.erase(it);
             ++deleted_count;
         }
@@ -249,6 +256,42 @@ std::vector<PatternID> MemoryBackend::FindAll(const QueryOptions& options) {
     return results;
 }
 
+std::vector<PatternID> MemoryBackend::FindByFilter(
+        const PatternFilter& filter,
+        const QueryOptions& options) {
+    // Shared lock for reading
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    std::vector<PatternID> results;
+
+    // Predicates are checked against the stored nodes in place, so no node
+    // is cloned; an allow-list bounds the work by its own size
+    if (filter.allowed_ids) {
+        for (PatternID id : *filter.allowed_ids) {
+            auto it = patterns_.find(id);
+            if (it != patterns_.end() && filter.Matches(it->second)) {
+                results.push_back(id);
+            }
+        }
+    } else {
+        for (const auto& [id, node] : patterns_) {
+            if (filter.Matches(node)) {
+                results.push_back(id);
+            }
+        }
+    }
+
+    lock.unlock();
+
+    std::sort(results.begin(), results.end());
+    results.erase(std::unique(results.begin(), results.end()), results.end());
+    if (results.size() > options.max_results) {
+        results.resize(options.max_results);
+    }
+
+    return results;
+}
+
 // ============================================================================
 // Statistics and Monitoring
 // ============================================================================
@@ -267,12 +310,8 @@ StorageStats MemoryBackend::GetStats() const {
     StorageStats stats;
     stats.total_patterns = patterns_.size();
 
-    // Estimate memory usage
-    size_t estimated_memory = 0;
-    for (const auto& [id, node] : patterns_) {
-        estimated_memory += node.EstimateMemoryUsage();
-    }
-    stats.memory_usage_bytes = estimated_memory;
+    // Estimated memory usage, maintained on every write
+    stats.memory_usage_bytes = memory_bytes_;
 
     // Disk usage (only if mmap is enabled)
     stats.disk_usage_bytes = config_.use_mmap ? mmap_size_ : 0;
@@ -294,6 +333,49 @@ StorageStats MemoryBackend::GetStats() const {
     return stats;
 }
 
+PatternAggregates MemoryBackend::GetAggregates() {
+    // Shared lock for reading
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    return aggregates_;
+}
+
+std::vector<PatternID> MemoryBackend::GetSubPatterns(PatternID id) {
+    // Shared lock for reading
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    return hierarchy_.GetSubPatterns(id);
+}
+
+std::vector<PatternID> MemoryBackend::GetParentPatterns(PatternID id) {
+    // Shared lock for reading
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    return hierarchy_.GetParents(id);
+}
+
+std::vector<HierarchyEntry> MemoryBackend::TraverseHierarchy(
+        const std::vector<PatternID>& roots,
+        HierarchyDirection direction,
+        size_t max_depth) {
+    // Shared lock for reading
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    return hierarchy_.Traverse(roots, direction, max_depth);
+}
+
+PatternAggregates MemoryBackend::ScanAggregates() {
+    // Shared lock for reading
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    // Stored nodes are read in place, none is cloned
+    PatternAggregates aggregates;
+    for (const auto& [id, node] : patterns_) {
+        aggregates.Add(PatternAggregates::Entry::Of(node));
+    }
+    return aggregates;
+}
+
 // ============================================================================
 // Maintenance Operations
 // ============================================================================
@@ -330,6 +412,7 @@ void MemoryBackend::Clear() {
     std::unique_lock<std::shared_mutex> lock(mutex_);
 
     patterns_.clear();
+    ResetIndices();
 
     // Reset statistics
     total_lookups_.store(0, std::memory_order_relaxed);
@@ -394,11 +477,15 @@ bool MemoryBackend::RestoreSnapshot(const std::string& path) {
         // Clear existing patterns
         patterns_.clear();
         patterns_.reserve(count);
+        ResetIndices();
 
         // Read each pattern
         for (uint64_t i = 0; i < count; ++i) {
             PatternNode node = PatternNode::Deserialize(file);
-            patterns_.emplace(node.GetID(), std::move(node));
+            auto [it, inserted] = patterns_.emplace(node.GetID(), std::move(node));
+            if (inserted) {
+                IndexNode(it->second);
+            }
         }
 
         file.close();
@@ -421,6 +508,26 @@ void MemoryBackend::UpdateStats(uint64_t lookup_time_ns, bool cache_hit) {
     }
 }
 
+void MemoryBackend::IndexNode(const PatternNode& node) {
+    aggregates_.Add(PatternAggregates::Entry::Of(node));
+    memory_bytes_ += node.EstimateMemoryUsage();
+    if (node.HasSubPatterns()) {
+        hierarchy_.SetSubPatterns(node.GetID(), node.GetSubPatterns());
+    }
+}
+
+void MemoryBackend::UnindexNode(const PatternNode& node) {
+    aggregates_.Remove(PatternAggregates::Entry::Of(node));
+    memory_bytes_ -= node.EstimateMemoryUsage();
+    hierarchy_.RemoveParent(node.GetID());
+}
+
+void MemoryBackend::ResetIndices() {
+    aggregates_ = PatternAggregates{};
+    memory_bytes_ = 0;
+    hierarchy_.Clear();
+}
+
 void MemoryBackend::LoadFromMmap() {
     // Open the memory-mapped file
     mmap_fd_ = open(config_.mmap_path.c_str(), O_RDONLY);
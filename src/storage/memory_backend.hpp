@@ -18,6 +18,10 @@ namespace dpan {
 /// - Fast O(1) lookup, insert, delete
 /// - Thread-safe with shared_mutex (multiple readers, single writer)
 /// - Statistics tracking for performance monitoring
+/// - Content totals (GetAggregates) and memory usage maintained on every
+///   write, so statistics are O(1)
+/// - Sub-pattern links indexed in both directions, so parent lookups and
+///   hierarchy traversals clone no nodes
 /// - Optional memory-mapped file persistence
 /// - Snapshot/restore for data backup
 class MemoryBackend : public PatternDatabase {
@@ -72,8 +76,21 @@ public:
 
     std::vector<PatternID> FindAll(const QueryOptions& options) override;
 
+    std::vector<PatternID> FindByFilter(
+        const PatternFilter& filter,
+        const QueryOptions& options) override;
+
     size_t Count() const override;
     StorageStats GetStats() const override;
+    PatternAggregates GetAggregates() override;
+    PatternAggregates ScanAggregates() override;
+
+    std::vector<PatternID> GetSubPatterns(PatternID id) override;
+    std::vector<PatternID> GetParentPatterns(PatternID id) override;
+    std::vector<HierarchyEntry> TraverseHierarchy(
+        const std::vector<PatternID>& roots,
+        HierarchyDirection direction,
+        size_t max_depth) override;
 
     void Flush() override;
     void Compact() override;
@@ -92,6 +109,14 @@ private:
     // Main storage: hash map from PatternID to PatternNode
     std::unordered_map<PatternID, PatternNode> patterns_;
 
+    // Running totals over patterns_, updated under the exclusive lock
+    PatternAggregates aggregates_;
+    size_t memory_bytes_{0};
+
+    // Sub-pattern links of patterns_ in both directions, updated with the
+    // running totals by IndexNode and UnindexNode
+    HierarchyIndex hierarchy_;
+
     // Statistics tracking (atomics for lock-free updates)
     mutable std::atomic<uint64_t> total_lookups_{0};
     mutable std::atomic<uint64_t> cache_hits_{0};
@@ -111,6 +136,18 @@ private:
     /// @param cache_hit Whether this was a cache hit
     void UpdateStats(uint64_t lookup_time_ns, bool cache_hit);
 
+    /// Add a stored node to the running totals and its sub-pattern links to
+    /// the hierarchy index (exclusive lock held)
+    void IndexNode(const PatternNode& node);
+
+    /// Remove a stored node from the running totals and its sub-pattern
+    /// links from the hierarchy index (exclusive lock held)
+    void UnindexNode(const PatternNode& node);
+
+    /// Reset the running totals and the hierarchy index to an empty store
+    /// (exclusive lock held)
+    void ResetIndices();
+
     /// Load patterns from memory-mapped file
     void LoadFromMmap();
 
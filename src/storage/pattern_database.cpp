@@ -1,9 +1,220 @@
 // File: src/storage/pattern_database.cpp
 #include "storage/pattern_database.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
 #include <stdexcept>
 
 namespace dpan {
 
+namespace {
+
+/// Widest timestamps that survive conversion to the clock's tick type
+const Timestamp kEarliest = Timestamp::FromMicros(std::numeric_limits<int64_t>::min() / 1000);
+const Timestamp kLatest = Timestamp::FromMicros(std::numeric_limits<int64_t>::max() / 1000);
+
+std::vector<PatternID> SortedUnique(std::vector<PatternID> ids) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+std::vector<PatternID> Intersect(const std::vector<PatternID>& a, const std::vector<PatternID>& b) {
+    std::vector<PatternID> result;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+    return result;
+}
+
+} // anonymous namespace
+
+bool PatternFilter::Matches(const PatternNode& node) const {
+    if (!types.empty() &&
+        std::find(types.begin(), types.end(), node.GetType()) == types.end()) {
+        return false;
+    }
+
+    Timestamp created = node.GetCreationTime();
+    if ((created_after && created < *created_after) ||
+        (created_before && created > *created_before)) {
+        return false;
+    }
+
+    float confidence = node.GetConfidenceScore();
+    if ((min_confidence && confidence < *min_confidence) ||
+        (max_confidence && confidence > *max_confidence)) {
+        return false;
+    }
+
+    if (!modalities.empty() &&
+        std::find(modalities.begin(), modalities.end(), node.GetData().GetModality()) == modalities.end()) {
+        return false;
+    }
+
+    return true;
+}
+
+PatternAggregates::Entry PatternAggregates::Entry::Of(const PatternNode& node) {
+    Entry entry;
+    entry.type = node.GetType();
+    entry.confidence_units = std::llround(
+        static_cast<double>(node.GetConfidenceScore()) * kConfidenceScale);
+
+    // Size of GetFeatures(), read from the header without decompressing
+    const PatternData& data = node.GetData();
+    entry.feature_bytes = data.IsEmpty()
+        ? 0 : data.GetOriginalSize() / sizeof(float) * sizeof(float);
+    return entry;
+}
+
+void PatternAggregates::Add(const Entry& entry) {
+    ++total_patterns;
+    switch (entry.type) {
+        case PatternType::ATOMIC: ++atomic_patterns; break;
+        case PatternType::COMPOSITE: ++composite_patterns; break;
+        case PatternType::META: ++meta_patterns; break;
+    }
+    confidence_units += entry.confidence_units;
+    feature_bytes += entry.feature_bytes;
+}
+
+void PatternAggregates::Remove(const Entry& entry) {
+    --total_patterns;
+    switch (entry.type) {
+        case PatternType::ATOMIC: --atomic_patterns; break;
+        case PatternType::COMPOSITE: --composite_patterns; break;
+        case PatternType::META: --meta_patterns; break;
+    }
+    confidence_units -= entry.confidence_units;
+    feature_bytes -= entry.feature_bytes;
+}
+
+float PatternAggregates::AverageConfidence() const {
+    if (total_patterns == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(static_cast<double>(confidence_units) / kConfidenceScale /
+                              static_cast<double>(total_patterns));
+}
+
+float PatternAggregates::AverageFeatureBytes() const {
+    if (total_patterns == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(static_cast<double>(feature_bytes) /
+                              static_cast<double>(total_patterns));
+}
+
+bool PatternAggregates::operator==(const PatternAggregates& other) const {
+    return total_patterns == other.total_patterns &&
+           atomic_patterns == other.atomic_patterns &&
+           composite_patterns == other.composite_patterns &&
+           meta_patterns == other.meta_patterns &&
+           confidence_units == other.confidence_units &&
+           feature_bytes == other.feature_bytes;
+}
+
+PatternAggregates PatternDatabase::ScanAggregates() {
+    QueryOptions unbounded;
+    unbounded.max_results = std::numeric_limits<size_t>::max();
+
+    PatternAggregates aggregates;
+    for (PatternID id : FindAll(unbounded)) {
+        if (auto node = Retrieve(id)) {
+            aggregates.Add(PatternAggregates::Entry::Of(*node));
+        }
+    }
+    return aggregates;
+}
+
+std::vector<PatternID> PatternDatabase::GetSubPatterns(PatternID id) {
+    auto node = Retrieve(id);
+    return node ? node->GetSubPatterns() : std::vector<PatternID>{};
+}
+
+std::vector<PatternID> PatternDatabase::GetParentPatterns(PatternID id) {
+    QueryOptions unbounded;
+    unbounded.max_results = std::numeric_limits<size_t>::max();
+
+    std::vector<PatternID> parents;
+    for (PatternID candidate : FindAll(unbounded)) {
+        auto node = Retrieve(candidate);
+        if (!node) {
+            continue;
+        }
+        auto subs = node->GetSubPatterns();
+        if (std::find(subs.begin(), subs.end(), id) != subs.end()) {
+            parents.push_back(candidate);
+        }
+    }
+    return parents;
+}
+
+std::vector<HierarchyEntry> PatternDatabase::TraverseHierarchy(
+        const std::vector<PatternID>& roots,
+        HierarchyDirection direction,
+        size_t max_depth) {
+    return TraverseLinks(roots, max_depth, [&](PatternID id) {
+        return direction == HierarchyDirection::ANCESTORS ? GetParentPatterns(id)
+                                                          : GetSubPatterns(id);
+    });
+}
+
+std::vector<PatternID> PatternDatabase::FindByFilter(
+        const PatternFilter& filter,
+        const QueryOptions& options) {
+    QueryOptions unbounded = options;
+    unbounded.max_results = std::numeric_limits<size_t>::max();
+
+    // Build the candidate set from indexed predicates, intersecting sorted
+    // ID lists so nothing is retrieved yet
+    std::optional<std::vector<PatternID>> candidates;
+    auto narrow = [&](std::vector<PatternID> ids) {
+        ids = SortedUnique(std::move(ids));
+        candidates = candidates ? Intersect(*candidates, ids) : std::move(ids);
+    };
+
+    if (filter.allowed_ids) {
+        narrow(*filter.allowed_ids);
+    }
+    if (filter.created_after || filter.created_before) {
+        narrow(FindByTimeRange(filter.created_after.value_or(kEarliest),
+                               filter.created_before.value_or(kLatest), unbounded));
+    }
+    if (!filter.types.empty()) {
+        std::vector<PatternID> by_type;
+        for (PatternType type : filter.types) {
+            auto ids = FindByType(type, unbounded);
+            by_type.insert(by_type.end(), ids.begin(), ids.end());
+        }
+        narrow(std::move(by_type));
+    }
+    if (!candidates) {
+        narrow(FindAll(unbounded));
+    }
+
+    // Type and time are already decided by the index lookups above
+    PatternFilter residual = filter;
+    residual.types.clear();
+    residual.created_after.reset();
+    residual.created_before.reset();
+
+    std::vector<PatternID> results;
+    for (PatternID id : *candidates) {
+        if (results.size() >= options.max_results) {
+            break;
+        }
+        if (residual.NeedsNodeCheck()) {
+            auto node = Retrieve(id);
+            if (!node || !residual.Matches(*node)) {
+                continue;
+            }
+        }
+        results.push_back(id);
+    }
+    return results;
+}
+
 std::unique_ptr<PatternDatabase> CreatePatternDatabase(const std::string& config_path) {
     // TODO: Implement configuration file parsing and backend selection
     // This will be implemented in Task 2.2.2 (In-Memory Backend) and later tasks
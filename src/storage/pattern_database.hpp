@@ -2,6 +2,7 @@
 #pragma once
 
 #include "core/pattern_node.hpp"
+#include "storage/indices/hierarchy_index.hpp"
 #include <memory>
 #include <vector>
 #include <optional>
@@ -27,6 +28,54 @@ struct StorageStats {
     float cache_hit_rate{0.0f};
 };
 
+/// Content totals over all stored patterns
+///
+/// Backends keep these current on every store, update and delete, so
+/// statistics read them without visiting any pattern. All fields are
+/// integers: removing a pattern subtracts exactly what adding it added, and
+/// the totals never drift however many writes accumulate. Confidence is
+/// summed in fixed point (kConfidenceScale units per 1.0).
+struct PatternAggregates {
+    /// Fixed-point units per 1.0 of confidence
+    static constexpr double kConfidenceScale = 16777216.0;  // 2^24
+
+    /// Contribution of a single pattern
+    struct Entry {
+        PatternType type{PatternType::ATOMIC};
+        int64_t confidence_units{0};
+        size_t feature_bytes{0};
+
+        /// Contribution of a node as currently stored
+        static Entry Of(const PatternNode& node);
+    };
+
+    size_t total_patterns{0};
+    size_t atomic_patterns{0};
+    size_t composite_patterns{0};
+    size_t meta_patterns{0};
+
+    /// Sum of confidence scores in fixed-point units
+    int64_t confidence_units{0};
+
+    /// Sum of decoded feature vector sizes
+    size_t feature_bytes{0};
+
+    /// Add a pattern's contribution
+    void Add(const Entry& entry);
+
+    /// Subtract a contribution previously added
+    void Remove(const Entry& entry);
+
+    /// Mean confidence score (0 if empty)
+    float AverageConfidence() const;
+
+    /// Mean decoded feature vector size in bytes (0 if empty)
+    float AverageFeatureBytes() const;
+
+    bool operator==(const PatternAggregates& other) const;
+    bool operator!=(const PatternAggregates& other) const { return !(*this == other); }
+};
+
 /// Query options for database searches
 struct QueryOptions {
     /// Maximum number of results to return
@@ -45,6 +94,50 @@ struct QueryOptions {
     std::optional<Timestamp> max_timestamp;
 };
 
+/// Declarative pattern predicate that backends can answer from their indices
+///
+/// Unlike a std::function predicate, a PatternFilter lets the backend narrow
+/// the candidate set with indexed lookups (type, creation time, an external
+/// allow-list such as the members of a memory tier) before any node is
+/// retrieved, so a selective filter does not pay for a full scan of clones.
+/// Unset fields match everything.
+struct PatternFilter {
+    /// Accepted pattern types (empty = any type)
+    std::vector<PatternType> types;
+
+    /// Earliest creation time (inclusive)
+    std::optional<Timestamp> created_after;
+
+    /// Latest creation time (inclusive)
+    std::optional<Timestamp> created_before;
+
+    /// Confidence range (inclusive)
+    std::optional<float> min_confidence;
+    std::optional<float> max_confidence;
+
+    /// Accepted data modalities (empty = any modality)
+    std::vector<DataModality> modalities;
+
+    /// Only these patterns are eligible (e.g. TierManager::GetPatternsInTier)
+    std::optional<std::vector<PatternID>> allowed_ids;
+
+    /// Check whether the filter constrains anything
+    bool IsEmpty() const {
+        return types.empty() && !created_after && !created_before &&
+               !min_confidence && !max_confidence && modalities.empty() && !allowed_ids;
+    }
+
+    /// Check whether predicates not covered by storage indices are set
+    bool NeedsNodeCheck() const {
+        return min_confidence || max_confidence || !modalities.empty();
+    }
+
+    /// Evaluate the per-node predicates (everything except allowed_ids)
+    /// @param node Pattern to test
+    /// @return true if the node satisfies type, time, confidence and modality
+    bool Matches(const PatternNode& node) const;
+};
+
 /// Abstract interface for pattern storage backends
 ///
 /// This interface provides a generic API for storing, retrieving, and querying
@@ -132,6 +225,58 @@ public:
     /// @return Vector of all pattern IDs
     virtual std::vector<PatternID> FindAll(const QueryOptions& options = {}) = 0;
 
+    /// Find all patterns satisfying a declarative filter
+    ///
+    /// The default implementation seeds the candidate set from the most
+    /// selective indexed predicate (allowed_ids, FindByTimeRange, FindByType),
+    /// intersects it with the others, and retrieves nodes only when
+    /// confidence or modality must be checked. Backends override this to
+    /// evaluate the filter against their own indices.
+    ///
+    /// @param filter Filter to apply
+    /// @param options Query options (max_results)
+    /// @return Matching pattern IDs in ascending ID order
+    virtual std::vector<PatternID> FindByFilter(
+        const PatternFilter& filter,
+        const QueryOptions& options = {});
+
+    // ========================================================================
+    // Hierarchy Queries
+    // ========================================================================
+
+    /// Get the sub-patterns of a pattern
+    ///
+    /// The default implementation retrieves the node. Backends that keep a
+    /// HierarchyIndex answer without cloning it.
+    ///
+    /// @param id Pattern ID
+    /// @return Sub-pattern IDs (empty if none or not found)
+    virtual std::vector<PatternID> GetSubPatterns(PatternID id);
+
+    /// Get the patterns that list a pattern as a sub-pattern
+    ///
+    /// The default implementation scans every stored pattern. Backends that
+    /// keep a HierarchyIndex answer from it.
+    ///
+    /// @param id Pattern ID (need not be stored itself)
+    /// @return Parent pattern IDs
+    virtual std::vector<PatternID> GetParentPatterns(PatternID id);
+
+    /// Collect the ancestors or descendants of several patterns at once
+    ///
+    /// Each pattern is reported once at its smallest depth; the roots are
+    /// not reported. The default implementation walks GetParentPatterns or
+    /// GetSubPatterns level by level.
+    ///
+    /// @param roots Starting patterns
+    /// @param direction ANCESTORS follows parents, DESCENDANTS sub-patterns
+    /// @param max_depth Deepest level to report (0 reports nothing)
+    /// @return Reached patterns in breadth-first order
+    virtual std::vector<HierarchyEntry> TraverseHierarchy(
+        const std::vector<PatternID>& roots,
+        HierarchyDirection direction,
+        size_t max_depth);
+
     // ========================================================================
     // Statistics and Monitoring
     // ========================================================================
@@ -144,6 +289,22 @@ public:
     /// @return StorageStats structure with current statistics
     virtual StorageStats GetStats() const = 0;
 
+    /// Get content totals over all patterns
+    ///
+    /// Backends that maintain the totals on every write answer in O(1). The
+    /// default implementation falls back to ScanAggregates().
+    ///
+    /// @return Pattern counts by type, confidence and feature size sums
+    virtual PatternAggregates GetAggregates() { return ScanAggregates(); }
+
+    /// Recompute content totals by visiting every pattern
+    ///
+    /// O(n); intended for cross-checking GetAggregates(). The default
+    /// implementation retrieves each ID returned by an unbounded FindAll.
+    ///
+    /// @return Totals over the patterns stored at the time of the scan
+    virtual PatternAggregates ScanAggregates();
+
     // ========================================================================
     // Maintenance Operations
     // ========================================================================
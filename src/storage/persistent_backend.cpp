@@ -3,6 +3,8 @@
 #include <sstream>
 #include <fstream>
 #include <cstring>
+#include <algorithm>
+#include <iterator>
 #include <sys/stat.h>
 
 namespace dpan {
@@ -140,7 +142,12 @@ bool PersistentBackend::Store(const PatternNode& node) {
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
 
-    return rc == SQLITE_DONE;
+    if (rc != SQLITE_DONE) {
+        return false;
+    }
+
+    TrackStored(node);
+    return true;
 }
 
 std::optional<PatternNode> PersistentBackend::Retrieve(PatternID id) {
@@ -213,7 +220,13 @@ bool PersistentBackend::Update(const PatternNode& node) {
     }
 
     // Check if any row was updated
-    return sqlite3_changes(db_) > 0;
+    if (sqlite3_changes(db_) == 0) {
+        return false;
+    }
+
+    TrackDeleted(node.GetID());
+    TrackStored(node);
+    return true;
 }
 
 bool PersistentBackend::Delete(PatternID id) {
@@ -240,7 +253,12 @@ bool PersistentBackend::Delete(PatternID id) {
     }
 
     // Check if any row was deleted
-    return sqlite3_changes(db_) > 0;
+    if (sqlite3_changes(db_) == 0) {
+        return false;
+    }
+
+    TrackDeleted(id);
+    return true;
 }
 
 bool PersistentBackend::Exists(PatternID id) const {
@@ -302,6 +320,7 @@ size_t PersistentBackend::StoreBatch(const std::vector<PatternNode>& nodes) {
         // Execute
         if (sqlite3_step(stmt) == SQLITE_DONE) {
             if (sqlite3_changes(db_) > 0) {
+                TrackStored(node);
                 ++stored_count;
             }
         }
@@ -377,8 +396,9 @@ size_t PersistentBackend::DeleteBatch(const std::vector<PatternID>& ids) {
     for (const auto& id : ids) {
         sqlite3_bind_int64(stmt, 1, id.value());
 
-        if (sqlite3_step(stmt) == SQLITE_DONE) {
-            deleted_count += sqlite3_changes(db_);
+        if (sqlite3_step(stmt) == SQLITE_DONE && sqlite3_changes(db_) > 0) {
+            TrackDeleted(id);
+            ++deleted_count;
         }
 
         sqlite3_reset(stmt);
@@ -474,6 +494,107 @@ std::vector<PatternID> PersistentBackend::FindAll(const QueryOptions& options) {
     return results;
 }
 
+std::vector<PatternID> PersistentBackend::FindByFilter(
+        const PatternFilter& filter,
+        const QueryOptions& options) {
+    // Type and creation time are answered by idx_type / idx_creation_time
+    std::string sql = "SELECT id FROM patterns WHERE 1";
+    if (!filter.types.empty()) {
+        sql += " AND type IN (";
+        for (size_t i = 0; i < filter.types.size(); ++i) {
+            sql += (i == 0) ? "?" : ", ?";
+        }
+        sql += ")";
+    }
+    if (filter.created_after) {
+        sql += " AND creation_time >= ?";
+    }
+    if (filter.created_before) {
+        sql += " AND creation_time <= ?";
+    }
+    sql += " ORDER BY id";
+
+    // Remaining predicates are applied below, so only limit when none remain
+    bool post_filter = filter.allowed_ids.has_value() || filter.NeedsNodeCheck();
+    if (!post_filter) {
+        sql += " LIMIT ?";
+    }
+    sql += ";";
+
+    std::vector<PatternID> candidates;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            return candidates;
+        }
+
+        int param = 1;
+        for (PatternType type : filter.types) {
+            sqlite3_bind_int(stmt, param++, static_cast<int>(type));
+        }
+        if (filter.created_after) {
+            sqlite3_bind_int64(stmt, param++, filter.created_after->ToMicros());
+        }
+        if (filter.created_before) {
+            sqlite3_bind_int64(stmt, param++, filter.created_before->ToMicros());
+        }
+        if (!post_filter) {
+            sqlite3_bind_int64(stmt, param++, options.max_results);
+        }
+
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            uint64_t id_value = sqlite3_column_int64(stmt, 0);
+            candidates.push_back(PatternID(id_value));
+        }
+
+        sqlite3_finalize(stmt);
+    }
+
+    if (!post_filter) {
+        return candidates;
+    }
+
+    if (filter.allowed_ids) {
+        // SQLite orders ids as signed integers; re-sort by PatternID
+        std::sort(candidates.begin(), candidates.end());
+
+        std::vector<PatternID> allowed = *filter.allowed_ids;
+        std::sort(allowed.begin(), allowed.end());
+
+        std::vector<PatternID> narrowed;
+        std::set_intersection(candidates.begin(), candidates.end(),
+                              allowed.begin(), allowed.end(),
+                              std::back_inserter(narrowed));
+        narrowed.erase(std::unique(narrowed.begin(), narrowed.end()), narrowed.end());
+        candidates = std::move(narrowed);
+    }
+
+    // Type and creation time were decided by SQL on the stored (microsecond)
+    // timestamps; re-checking them against the node could disagree
+    PatternFilter residual = filter;
+    residual.types.clear();
+    residual.created_after.reset();
+    residual.created_before.reset();
+
+    std::vector<PatternID> results;
+    for (PatternID id : candidates) {
+        if (results.size() >= options.max_results) {
+            break;
+        }
+        if (residual.NeedsNodeCheck()) {
+            auto node = Retrieve(id);
+            if (!node || !residual.Matches(*node)) {
+                continue;
+            }
+        }
+        results.push_back(id);
+    }
+
+    return results;
+}
+
 // ============================================================================
 // Statistics and Monitoring
 // ============================================================================
@@ -519,6 +640,42 @@ StorageStats PersistentBackend::GetStats() const {
     return stats;
 }
 
+PatternAggregates PersistentBackend::GetAggregates() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    LoadIndicesUnlocked();
+    return aggregates_;
+}
+
+PatternAggregates PersistentBackend::ScanAggregates() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ScanAggregatesUnlocked(nullptr, nullptr);
+}
+
+std::vector<PatternID> PersistentBackend::GetSubPatterns(PatternID id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    LoadIndicesUnlocked();
+    return hierarchy_.GetSubPatterns(id);
+}
+
+std::vector<PatternID> PersistentBackend::GetParentPatterns(PatternID id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    LoadIndicesUnlocked();
+    return hierarchy_.GetParents(id);
+}
+
+std::vector<HierarchyEntry> PersistentBackend::TraverseHierarchy(
+        const std::vector<PatternID>& roots,
+        HierarchyDirection direction,
+        size_t max_depth) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    LoadIndicesUnlocked();
+    return hierarchy_.Traverse(roots, direction, max_depth);
+}
+
 // ============================================================================
 // Maintenance Operations
 // ============================================================================
@@ -549,6 +706,12 @@ void PersistentBackend::Clear() {
 
     ExecuteSQL("DELETE FROM patterns;");
 
+    // The table is known to be empty, so totals and hierarchy need no reload
+    aggregates_ = PatternAggregates{};
+    aggregate_entries_.clear();
+    hierarchy_.Clear();
+    indices_loaded_ = true;
+
     // Reset statistics
     total_reads_.store(0, std::memory_order_relaxed);
     total_writes_.store(0, std::memory_order_relaxed);
@@ -601,6 +764,12 @@ bool PersistentBackend::RestoreSnapshot(const std::string& path) {
     // Clear current database
     ExecuteSQL("DELETE FROM patterns;");
 
+    // Totals and hierarchy are reloaded from the restored table when next requested
+    aggregates_ = PatternAggregates{};
+    aggregate_entries_.clear();
+    hierarchy_.Clear();
+    indices_loaded_ = false;
+
     // Use backup API to restore
     sqlite3_backup* backup = sqlite3_backup_init(db_, "main", backup_db, "main");
     if (!backup) {
@@ -642,6 +811,77 @@ size_t PersistentBackend::GetDatabaseSize() const {
     return 0;
 }
 
+PatternAggregates PersistentBackend::ScanAggregatesUnlocked(
+        std::unordered_map<PatternID, PatternAggregates::Entry>* entries,
+        HierarchyIndex* hierarchy) {
+    PatternAggregates aggregates;
+    if (entries) {
+        entries->clear();
+    }
+    if (hierarchy) {
+        hierarchy->Clear();
+    }
+
+    const char* sql = "SELECT data FROM patterns;";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        return aggregates;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const void* blob_data = sqlite3_column_blob(stmt, 0);
+        int blob_size = sqlite3_column_bytes(stmt, 0);
+
+        std::vector<uint8_t> blob(static_cast<const uint8_t*>(blob_data),
+                                  static_cast<const uint8_t*>(blob_data) + blob_size);
+        PatternNode node = DeserializeNode(blob);
+
+        auto entry = PatternAggregates::Entry::Of(node);
+        aggregates.Add(entry);
+        if (entries) {
+            entries->emplace(node.GetID(), entry);
+        }
+        if (hierarchy && node.HasSubPatterns()) {
+            hierarchy->SetSubPatterns(node.GetID(), node.GetSubPatterns());
+        }
+    }
+
+    sqlite3_finalize(stmt);
+    return aggregates;
+}
+
+void PersistentBackend::LoadIndicesUnlocked() {
+    if (!indices_loaded_) {
+        aggregates_ = ScanAggregatesUnlocked(&aggregate_entries_, &hierarchy_);
+        indices_loaded_ = true;
+    }
+}
+
+void PersistentBackend::TrackStored(const PatternNode& node) {
+    if (!indices_loaded_) {
+        return;
+    }
+    auto entry = PatternAggregates::Entry::Of(node);
+    aggregates_.Add(entry);
+    aggregate_entries_[node.GetID()] = entry;
+    if (node.HasSubPatterns()) {
+        hierarchy_.SetSubPatterns(node.GetID(), node.GetSubPatterns());
+    }
+}
+
+void PersistentBackend::TrackDeleted(PatternID id) {
+    if (!indices_loaded_) {
+        return;
+    }
+    auto it = aggregate_entries_.find(id);
+    if (it != aggregate_entries_.end()) {
+        aggregates_.Remove(it->second);
+        aggregate_entries_.erase(it);
+    }
+    hierarchy_.RemoveParent(id);
+}
+
 void PersistentBackend::BeginTransaction() {
     ExecuteSQL("BEGIN TRANSACTION;");
 }
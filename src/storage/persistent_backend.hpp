@@ -4,6 +4,7 @@
 #include "storage/pattern_database.hpp"
 #include <string>
 #include <mutex>
+#include <unordered_map>
 #include <sqlite3.h>
 
 namespace dpan {
@@ -23,6 +24,9 @@ namespace dpan {
 /// - Write: < 5ms average
 /// - Handles millions of patterns efficiently
 /// - Disk space efficient with compression
+/// - Content totals (GetAggregates) and sub-pattern links read from the
+///   table once, then kept current by every write at the cost of a small
+///   per-pattern entry
 class PersistentBackend : public PatternDatabase {
 public:
     /// Configuration for PersistentBackend
@@ -83,8 +87,21 @@ public:
 
     std::vector<PatternID> FindAll(const QueryOptions& options) override;
 
+    std::vector<PatternID> FindByFilter(
+        const PatternFilter& filter,
+        const QueryOptions& options) override;
+
     size_t Count() const override;
     StorageStats GetStats() const override;
+    PatternAggregates GetAggregates() override;
+    PatternAggregates ScanAggregates() override;
+
+    std::vector<PatternID> GetSubPatterns(PatternID id) override;
+    std::vector<PatternID> GetParentPatterns(PatternID id) override;
+    std::vector<HierarchyEntry> TraverseHierarchy(
+        const std::vector<PatternID>& roots,
+        HierarchyDirection direction,
+        size_t max_depth) override;
 
     void Flush() override;
     void Compact() override;
@@ -107,6 +124,15 @@ private:
     mutable std::atomic<uint64_t> total_reads_{0};
     mutable std::atomic<uint64_t> total_writes_{0};
 
+    // Content totals, each pattern's contribution to them and the
+    // sub-pattern links. Loaded from the table on the first GetAggregates
+    // or hierarchy query, then updated by every write so Update and Delete
+    // can subtract the old contribution without reading the stored row.
+    PatternAggregates aggregates_;
+    std::unordered_map<PatternID, PatternAggregates::Entry> aggregate_entries_;
+    HierarchyIndex hierarchy_;
+    bool indices_loaded_{false};
+
     // ========================================================================
     // Helper Methods
     // ========================================================================
@@ -134,6 +160,25 @@ private:
     /// Get database file size in bytes
     size_t GetDatabaseSize() const;
 
+    /// Recompute content totals from the table (mutex held)
+    /// @param entries If non-null, receives each pattern's contribution
+    /// @param hierarchy If non-null, receives each pattern's sub-patterns
+    PatternAggregates ScanAggregatesUnlocked(
+        std::unordered_map<PatternID, PatternAggregates::Entry>* entries,
+        HierarchyIndex* hierarchy);
+
+    /// Load the content totals and the hierarchy index unless already
+    /// loaded (mutex held)
+    void LoadIndicesUnlocked();
+
+    /// Account for a stored or updated node in the totals and the hierarchy
+    /// index once they are loaded (mutex held)
+    void TrackStored(const PatternNode& node);
+
+    /// Drop a removed pattern from the totals and the hierarchy index once
+    /// they are loaded (mutex held)
+    void TrackDeleted(PatternID id);
+
     /// Internal count helper - assumes mutex is already locked
     size_t CountUnlocked() const;
 
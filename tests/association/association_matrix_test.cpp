@@ -3,6 +3,8 @@
 #include <gtest/gtest.h>
 #include <thread>
 #include <chrono>
+#include <map>
+#include <random>
 
 namespace dpan {
 namespace {
@@ -484,6 +486,134 @@ TEST(AssociationMatrixTest, PropagateActivationMinThreshold) {
     EXPECT_EQ(p2, results[0].pattern);
 }
 
+// ============================================================================
+// Snapshot Tests
+// ============================================================================
+
+std::map<PatternID, float> ToMap(const std::vector<AssociationMatrix::ActivationResult>& results) {
+    std::map<PatternID, float> map;
+    for (const auto& result : results) {
+        map[result.pattern] = result.activation;
+    }
+    return map;
+}
+
+TEST(AssociationMatrixTest, SnapshotLaysOutRowsInOutgoingOrder) {
+    AssociationMatrix matrix;
+    PatternID p1(1), p2(2), p3(3);
+
+    matrix.AddAssociation(AssociationEdge(p1, p2, AssociationType::CAUSAL, 0.5f));
+    matrix.AddAssociation(AssociationEdge(p1, p3, AssociationType::CAUSAL, 0.6f));
+    matrix.AddAssociation(AssociationEdge(p2, p3, AssociationType::CAUSAL, 0.7f));
+
+    auto snapshot = matrix.GetSnapshot();
+    ASSERT_NE(nullptr, snapshot);
+    EXPECT_EQ(3u, snapshot->GetPatternCount());
+    EXPECT_EQ(3u, snapshot->GetAssociationCount());
+    EXPECT_EQ(4u, snapshot->GetOffsets().size());
+    EXPECT_EQ(AssociationSnapshot::kNotFound, snapshot->IndexOf(PatternID(4)));
+
+    uint32_t row = snapshot->IndexOf(p1);
+    ASSERT_NE(AssociationSnapshot::kNotFound, row);
+    size_t begin = snapshot->GetOffsets()[row];
+    ASSERT_EQ(begin + 2, snapshot->GetOffsets()[row + 1]);
+    EXPECT_EQ(p2, snapshot->PatternAt(snapshot->GetTargets()[begin]));
+    EXPECT_FLOAT_EQ(0.6f, snapshot->GetStrengths()[begin + 1]);
+
+    // A pattern that is only a target has an empty row
+    uint32_t sink = snapshot->IndexOf(p3);
+    EXPECT_EQ(snapshot->GetOffsets()[sink], snapshot->GetOffsets()[sink + 1]);
+
+    auto outgoing = matrix.GetOutgoingStrengths(p1);
+    ASSERT_EQ(2u, outgoing.size());
+    EXPECT_EQ(p3, outgoing[1].first);
+    EXPECT_FLOAT_EQ(0.6f, outgoing[1].second);
+}
+
+TEST(AssociationMatrixTest, HeldSnapshotIsUnchangedByMutations) {
+    AssociationMatrix matrix;
+    PatternID p1(1), p2(2), p3(3);
+    matrix.AddAssociation(AssociationEdge(p1, p2, AssociationType::CAUSAL, 0.5f));
+
+    auto before = matrix.GetSnapshot();
+    matrix.StrengthenAssociation(p1, p2, 0.25f);
+
+    auto patched = matrix.GetSnapshot();
+    EXPECT_FLOAT_EQ(0.5f, before->GetOutgoing(p1)[0].second);
+    EXPECT_FLOAT_EQ(0.75f, patched->GetOutgoing(p1)[0].second);
+
+    matrix.AddAssociation(AssociationEdge(p2, p3, AssociationType::CAUSAL, 0.4f));
+    matrix.RemoveAssociation(p1, p2);
+
+    auto rebuilt = matrix.GetSnapshot();
+    EXPECT_EQ(1u, before->GetAssociationCount());
+    EXPECT_EQ(1u, patched->GetAssociationCount());
+    EXPECT_TRUE(rebuilt->GetOutgoing(p1).empty());
+    EXPECT_EQ(1u, rebuilt->GetOutgoing(p2).size());
+}
+
+TEST(AssociationMatrixTest, SnapshotPropagationMatchesEdgeTraversal) {
+    // Identical mutations on a matrix with and one without the snapshot;
+    // propagation must agree exactly across patches, rebuilds and decay
+    AssociationMatrix::Config plain_config;
+    plain_config.enable_snapshot = false;
+    AssociationMatrix plain(plain_config);
+    AssociationMatrix matrix;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint64_t> pattern_dist(1, 200);
+    std::uniform_real_distribution<float> strength_dist(0.05f, 1.0f);
+
+    auto random_edge = [&]() {
+        return AssociationEdge(PatternID(pattern_dist(rng)), PatternID(pattern_dist(rng)),
+                               AssociationType::CAUSAL, strength_dist(rng));
+    };
+    for (int i = 0; i < 1000; ++i) {
+        auto edge = random_edge();
+        plain.AddAssociation(edge);
+        matrix.AddAssociation(edge);
+    }
+
+    std::shared_ptr<const AssociationSnapshot> held;
+    for (int round = 0; round < 40; ++round) {
+        PatternID source(pattern_dist(rng));
+        PatternID target(pattern_dist(rng));
+        switch (round % 5) {
+            case 0: {
+                auto edge = random_edge();
+                plain.AddAssociation(edge);
+                matrix.AddAssociation(edge);
+                break;
+            }
+            case 1:
+                plain.StrengthenAssociation(source, target, 0.3f);
+                matrix.StrengthenAssociation(source, target, 0.3f);
+                break;
+            case 2:
+                held = matrix.GetSnapshot();  // Later patches must copy
+                plain.WeakenAssociation(source, target, 0.2f);
+                matrix.WeakenAssociation(source, target, 0.2f);
+                break;
+            case 3:
+                plain.ApplyDecayAll(std::chrono::seconds(1));
+                matrix.ApplyDecayAll(std::chrono::seconds(1));
+                break;
+            default:
+                plain.RemoveAssociation(source, target);
+                matrix.RemoveAssociation(source, target);
+                break;
+        }
+
+        for (int query = 0; query < 5; ++query) {
+            PatternID start(pattern_dist(rng));
+            auto expected = ToMap(plain.PropagateActivation(start, 1.0f, 3, 0.01f));
+            EXPECT_EQ(expected, ToMap(matrix.PropagateActivation(start, 1.0f, 3, 0.01f)));
+            EXPECT_EQ(expected, ToMap(matrix.GetSnapshot()->PropagateActivation(start, 1.0f, 3, 0.01f)));
+            EXPECT_EQ(plain.GetOutgoingStrengths(start), matrix.GetOutgoingStrengths(start));
+        }
+    }
+}
+
 // ============================================================================
 // Serialization Tests
 // ============================================================================
@@ -580,3 +580,39 @@ TEST(CategoricalLearnerTest, AllIdenticalFeatures) {
         }
     }
 }
+
+TEST(CategoricalLearnerTest, ClusteringIsDeterministicForSeed) {
+    CategoricalLearner::Config config;
+    config.num_clusters = 3;
+    CategoricalLearner first(config);
+    CategoricalLearner second(config);
+
+    // Same patterns, inserted in opposite orders
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> value(0.0f, 10.0f);
+    std::vector<FeatureVector> features;
+    for (uint64_t id = 1; id <= 60; ++id) {
+        features.push_back(CreateFeatureVector({value(rng), value(rng), value(rng)}));
+        first.AddPattern(PatternID(id), features.back());
+    }
+    for (uint64_t id = 60; id >= 1; --id) {
+        second.AddPattern(PatternID(id), features[id - 1]);
+    }
+
+    ASSERT_TRUE(first.ComputeClusters());
+    ASSERT_TRUE(second.ComputeClusters());
+    for (uint64_t id = 1; id <= 60; ++id) {
+        EXPECT_EQ(first.GetClusterID(PatternID(id)), second.GetClusterID(PatternID(id)));
+    }
+}
+
+TEST(CategoricalLearnerTest, ComputeClustersRejectsMixedDimensions) {
+    CategoricalLearner::Config config;
+    config.num_clusters = 2;
+    CategoricalLearner learner(config);
+
+    learner.AddPattern(PatternID(1), CreateFeatureVector({1.0f, 2.0f}));
+    learner.AddPattern(PatternID(2), CreateFeatureVector({1.0f, 2.0f, 3.0f}));
+
+    EXPECT_THROW(learner.ComputeClusters(), std::invalid_argument);
+}
@@ -495,6 +495,84 @@ TEST(ScalabilityBenchmark, LargeScaleMatrix_100k_Associations) {
     EXPECT_LT(query_elapsed, 100.0); // Queries should be fast
 }
 
+TEST(ScalabilityBenchmark, PropagateActivation_1M_Associations) {
+    // 100k patterns x 10 random successors, propagated from the same sources
+    // through the edge objects and through the CSR snapshot
+    const size_t kPatterns = 100000;
+    const size_t kDegree = 10;
+    const size_t kQueries = 1000;
+
+    std::vector<PatternID> patterns;
+    patterns.reserve(kPatterns);
+    for (size_t i = 0; i < kPatterns; ++i) {
+        patterns.push_back(PatternID(i + 1));
+    }
+
+    auto fill = [&](AssociationMatrix& matrix) {
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<size_t> target_dist(0, kPatterns - 1);
+        std::uniform_real_distribution<float> strength_dist(0.2f, 0.9f);
+        for (size_t i = 0; i < kPatterns; ++i) {
+            for (size_t j = 0; j < kDegree; ++j) {
+                matrix.AddAssociation(AssociationEdge(patterns[i], patterns[target_dist(rng)],
+                                                      AssociationType::CATEGORICAL,
+                                                      strength_dist(rng)));
+            }
+        }
+    };
+
+    auto run_queries = [&](const AssociationMatrix& matrix, size_t& reached) {
+        reached = 0;
+        BenchmarkTimer timer;
+        for (size_t i = 0; i < kQueries; ++i) {
+            auto results = matrix.PropagateActivation(patterns[(i * 97) % kPatterns], 1.0f, 3);
+            reached += results.size();
+        }
+        return timer.ElapsedMs();
+    };
+
+    size_t edges_reached = 0;
+    double edges_elapsed = 0.0;
+    size_t edges_count = 0;
+    {
+        AssociationMatrix::Config config;
+        config.enable_snapshot = false;
+        AssociationMatrix matrix(config);
+        fill(matrix);
+        edges_count = matrix.GetAssociationCount();
+        edges_elapsed = run_queries(matrix, edges_reached);
+    }
+
+    size_t snapshot_reached = 0;
+    double snapshot_elapsed = 0.0;
+    double build_elapsed = 0.0;
+    {
+        AssociationMatrix matrix;
+        fill(matrix);
+
+        BenchmarkTimer build_timer;
+        auto snapshot = matrix.GetSnapshot();
+        build_elapsed = build_timer.ElapsedMs();
+        EXPECT_EQ(edges_count, snapshot->GetAssociationCount());
+        snapshot.reset();
+
+        snapshot_elapsed = run_queries(matrix, snapshot_reached);
+    }
+
+    std::cout << "PropagateActivation (" << edges_count << " associations, "
+              << kQueries << " queries):" << std::endl;
+    std::cout << "  Edge traversal: " << edges_elapsed << "ms, "
+              << (kQueries / edges_elapsed) * 1000.0 << " ops/sec" << std::endl;
+    std::cout << "  CSR snapshot:   " << snapshot_elapsed << "ms, "
+              << (kQueries / snapshot_elapsed) * 1000.0 << " ops/sec" << std::endl;
+    std::cout << "  Snapshot build: " << build_elapsed << "ms" << std::endl;
+    std::cout << "  Speedup: " << edges_elapsed / snapshot_elapsed << "x" << std::endl;
+
+    EXPECT_GT(edges_count, 990000u);
+    EXPECT_EQ(edges_reached, snapshot_reached);
+    EXPECT_LT(snapshot_elapsed, edges_elapsed);
+}
+
 TEST(ScalabilityBenchmark, LargeScaleTracker_100k_Activations) {
     CoOccurrenceTracker::Config config;
     config.window_size = std::chrono::seconds(60);
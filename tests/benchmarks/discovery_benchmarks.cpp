@@ -0,0 +1,657 @@
+// File: tests/benchmarks/discovery_benchmarks.cpp
+//
+// Performance benchmarks for Discovery module
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include "core/pattern_engine.hpp"
+#include "discovery/pattern_extractor.hpp"
+#include "discovery/pattern_matcher.hpp"
+#include "discovery/spectral_extractor.hpp"
+#include "discovery/tile_extractor.hpp"
+#include "storage/memory_backend.hpp"
+#include <thread>
+
+using namespace dpan;
+using namespace std::chrono;
+
+// ============================================================================
+// Benchmark Helper
+// ============================================================================
+
+struct BenchmarkTimer {
+    using TimePoint = high_resolution_clock::time_point;
+    TimePoint start;
+
+    BenchmarkTimer() : start(high_resolution_clock::now()) {}
+
+    double ElapsedMs() const {
+        auto end = high_resolution_clock::now();
+        return duration_cast<duration<double, std::milli>>(end - start).count();
+    }
+};
+
+// Cosine similarity on raw features, clamped to [0, 1]
+class FeatureCosineSimilarity : public SimilarityMetric {
+public:
+    float Compute(const PatternData& a, const PatternData& b) const override {
+        return ComputeFromFeatures(a.GetFeatures(), b.GetFeatures());
+    }
+
+    float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override {
+        return std::max(0.0f, a.CosineSimilarity(b));
+    }
+
+    std::string GetName() const override { return "FeatureCosine"; }
+    bool ComputesFromFeatures() const override { return true; }
+};
+
+// Clustered database: vectors scattered around a few shared centres
+std::shared_ptr<PatternDatabase> CreateClusteredDatabase(size_t count, size_t dim,
+                                                         size_t num_clusters, float noise) {
+    auto db = std::make_shared<MemoryBackend>(MemoryBackend::Config{});
+    std::mt19937 rng(42);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+
+    std::vector<std::vector<float>> centres(num_clusters, std::vector<float>(dim));
+    for (auto& centre : centres) {
+        for (auto& v : centre) {
+            v = dist(rng) * 10.0f;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        std::vector<float> values = centres[i % num_clusters];
+        for (auto& v : values) {
+            v += dist(rng) * noise;
+        }
+        PatternData data = PatternData::FromFeatures(FeatureVector(values), DataModality::NUMERIC);
+        db->Store(PatternNode(PatternID(i + 1), data, PatternType::ATOMIC));
+    }
+    return db;
+}
+
+// ============================================================================
+// Pattern Extractor Benchmarks
+// ============================================================================
+
+TEST(PatternExtractorBenchmark, RollingFeatures_1MSamples) {
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.5f);
+    std::vector<float> values(1000000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = std::sin(static_cast<float>(i) * 0.01f) + noise(rng);
+    }
+    std::vector<uint8_t> raw(values.size() * sizeof(float));
+    std::memcpy(raw.data(), values.data(), raw.size());
+
+    for (DataModality modality : {DataModality::NUMERIC, DataModality::AUDIO}) {
+        PatternExtractor::Config config;
+        config.modality = modality;
+        config.max_pattern_size = 4096;  // 1024-sample windows
+        config.feature_dimension = 64;
+
+        config.rolling_features = false;
+        PatternExtractor direct(config);
+        BenchmarkTimer direct_timer;
+        auto direct_patterns = direct.Extract(raw);
+        double direct_elapsed = direct_timer.ElapsedMs();
+
+        config.rolling_features = true;
+        PatternExtractor rolling(config);
+        BenchmarkTimer rolling_timer;
+        auto rolling_patterns = rolling.Extract(raw);
+        double rolling_elapsed = rolling_timer.ElapsedMs();
+
+        double mb = static_cast<double>(raw.size()) / (1024.0 * 1024.0);
+        std::cout << "Extract " << (modality == DataModality::AUDIO ? "AUDIO" : "NUMERIC")
+                  << " 1M samples, " << direct_patterns.size() << " windows: direct "
+                  << (mb / direct_elapsed * 1000.0) << " MB/s, rolling "
+                  << (mb / rolling_elapsed * 1000.0) << " MB/s" << std::endl;
+
+        EXPECT_EQ(direct_patterns.size(), rolling_patterns.size());
+        EXPECT_LT(rolling_elapsed, direct_elapsed);
+    }
+}
+
+TEST(PatternExtractorBenchmark, ParallelWindows_SpeedupVsWindowCount) {
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::mt19937 rng(4);
+    std::normal_distribution<float> noise(0.0f, 0.5f);
+
+    PatternExtractor::Config config;
+    config.modality = DataModality::AUDIO;
+    config.max_pattern_size = 4096;  // 1024-sample windows, 256-sample hop
+    config.feature_dimension = 64;
+
+    std::cout << "Parallel extraction on " << threads << " hardware threads" << std::endl;
+    for (size_t windows : {64u, 256u, 1024u, 4096u, 16384u}) {
+        std::vector<float> values((windows - 1) * 256 + 1024);
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = std::sin(static_cast<float>(i) * 0.01f) + noise(rng);
+        }
+        auto view = InputView::Floats(values.data(), values.size(), DataModality::AUDIO);
+        const size_t repeats = std::max<size_t>(1, 16384 / windows);
+
+        config.parallel_min_windows = 0;
+        PatternExtractor serial(config);
+        BenchmarkTimer serial_timer;
+        size_t serial_count = 0;
+        for (size_t r = 0; r < repeats; ++r) {
+            serial_count = serial.Extract(view).size();
+        }
+        double serial_elapsed = serial_timer.ElapsedMs();
+
+        config.parallel_min_windows = 128;
+        PatternExtractor parallel(config);
+        BenchmarkTimer parallel_timer;
+        size_t parallel_count = 0;
+        for (size_t r = 0; r < repeats; ++r) {
+            parallel_count = parallel.Extract(view).size();
+        }
+        double parallel_elapsed = parallel_timer.ElapsedMs();
+
+        std::cout << "  " << windows << " windows: serial "
+                  << (serial_elapsed / repeats) << " ms, parallel "
+                  << (parallel_elapsed / repeats) << " ms, speed-up "
+                  << (serial_elapsed / parallel_elapsed) << "x" << std::endl;
+
+        EXPECT_EQ(serial_count, parallel_count);
+    }
+}
+
+TEST(PatternExtractorBenchmark, ImageTiles_1080p) {
+    const size_t width = 1920;
+    const size_t height = 1080;
+    std::mt19937 rng(6);
+    std::uniform_int_distribution<int> value(0, 255);
+    std::vector<uint8_t> rgb(width * height * 3);
+    for (auto& pixel : rgb) {
+        pixel = static_cast<uint8_t>(value(rng));
+    }
+    const double megapixels = static_cast<double>(width * height) / 1e6;
+
+    for (size_t channels : {1u, 3u}) {
+        TileExtractor::Config config;
+        config.tile_size = 16;
+        config.pyramid_levels = 3;
+        config.feature_dimension = 32;
+        TileExtractor tiler(config);
+
+        auto view = InputView::Image(rgb.data(), width, height, width * 3, channels);
+        const int frames = 5;
+        size_t tiles = 0;
+        BenchmarkTimer timer;
+        for (int frame = 0; frame < frames; ++frame) {
+            tiles = tiler.Extract(view).size();
+        }
+        double elapsed = timer.ElapsedMs();
+
+        std::cout << "Tile " << channels << "-channel 1080p, 3 levels, " << tiles
+                  << " tiles: " << (megapixels * frames / elapsed * 1000.0)
+                  << " MP/s" << std::endl;
+        EXPECT_GT(tiles, 0u);
+    }
+
+    // The 1-D byte-window path over the same grayscale frame, for reference
+    std::vector<uint8_t> gray(rgb.begin(), rgb.begin() + static_cast<std::ptrdiff_t>(width * height));
+    PatternExtractor::Config config;
+    config.modality = DataModality::IMAGE;
+    config.max_pattern_size = 256;
+    config.feature_dimension = 32;
+    PatternExtractor windows(config);
+    BenchmarkTimer window_timer;
+    size_t window_count = windows.Extract(gray).size();
+    double window_elapsed = window_timer.ElapsedMs();
+
+    std::cout << "1-D windows 1080p, " << window_count << " windows: "
+              << (megapixels / window_elapsed * 1000.0) << " MP/s" << std::endl;
+}
+
+TEST(PatternExtractorBenchmark, SpectralAudio_RealTimeFactor) {
+    // Ten minutes of 16 kHz noisy tones
+    const double sample_rate = 16000.0;
+    const size_t count = static_cast<size_t>(sample_rate * 600);
+    std::mt19937 rng(8);
+    std::normal_distribution<float> noise(0.0f, 0.2f);
+    std::vector<float> audio(count);
+    for (size_t i = 0; i < count; ++i) {
+        const double t = static_cast<double>(i) / sample_rate;
+        audio[i] = static_cast<float>(0.5 * std::sin(2.0 * 3.14159265358979 * 440.0 * t)) +
+                   noise(rng);
+    }
+    const double seconds = static_cast<double>(count) / sample_rate;
+
+    // Speech front end: 25 ms frames every 10 ms, 40 mel bands, 13 MFCCs
+    SpectralExtractor::Config config;
+    config.sample_rate = sample_rate;
+    config.frame_size = 400;
+    config.hop_size = 160;
+    config.mfcc_coefficients = 13;
+    config.feature_dimension = 13;
+    SpectralExtractor extractor(config);
+
+    std::vector<float> features(config.feature_dimension);
+    size_t frames = 0;
+    BenchmarkTimer timer;
+    for (size_t start = 0; start + config.frame_size <= count; start += config.hop_size) {
+        extractor.ComputeFrame(audio.data() + start, features.data());
+        ++frames;
+    }
+    double elapsed = timer.ElapsedMs();
+
+    std::cout << "MFCC frames, " << frames << " frames of 400 samples: "
+              << (elapsed * 1000.0 / static_cast<double>(frames)) << " us/frame, "
+              << (seconds / elapsed * 1000.0) << "x real time" << std::endl;
+    EXPECT_GT(seconds / elapsed * 1000.0, 100.0);
+
+    // Through PatternExtractor: 2500-sample windows with a quarter hop
+    PatternExtractor::Config extraction;
+    extraction.modality = DataModality::AUDIO;
+    extraction.audio_features = PatternExtractor::AudioFeatures::MFCC;
+    extraction.feature_dimension = 13;
+    PatternExtractor patterns(extraction);
+    BenchmarkTimer extract_timer;
+    size_t windows = patterns.Extract(
+        InputView::Floats(audio.data(), audio.size(), DataModality::AUDIO)).size();
+    double extract_elapsed = extract_timer.ElapsedMs();
+
+    std::cout << "PatternExtractor MFCC, " << windows << " windows: "
+              << (seconds / extract_elapsed * 1000.0) << "x real time" << std::endl;
+}
+
+TEST(PatternExtractorBenchmark, HashedTextNGrams_TrainingData) {
+    // The training corpus, repeated to 16 MB
+    std::string corpus;
+    for (const auto& entry : std::filesystem::directory_iterator(DPAN_TRAINING_DATA_DIR)) {
+        std::ifstream file(entry.path(), std::ios::binary);
+        corpus.append(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    ASSERT_FALSE(corpus.empty());
+    std::vector<uint8_t> text;
+    while (text.size() < 16 * 1024 * 1024) {
+        text.insert(text.end(), corpus.begin(), corpus.end());
+    }
+    const double mb = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+
+    // Settings of the CLI
+    PatternExtractor::Config config;
+    config.modality = DataModality::TEXT;
+    config.min_pattern_size = 1;
+    config.max_pattern_size = 1000;
+    config.feature_dimension = 64;
+    config.parallel_min_windows = 0;  // Per-core throughput
+
+    // Best of three runs, so first-touch allocation does not dominate
+    auto best_of_three = [&text](const PatternExtractor& extractor, size_t& windows) {
+        double best = 0.0;
+        for (int run = 0; run < 3; ++run) {
+            BenchmarkTimer timer;
+            windows = extractor.Extract(text).size();
+            double elapsed = timer.ElapsedMs();
+            best = run == 0 ? elapsed : std::min(best, elapsed);
+        }
+        return best;
+    };
+
+    size_t histogram_windows = 0;
+    double histogram_elapsed = best_of_three(PatternExtractor(config), histogram_windows);
+
+    config.text_features = PatternExtractor::TextFeatures::HASHED_NGRAMS;
+    for (size_t word_n : {1u, 2u}) {
+        config.word_ngram_size = word_n;
+        size_t hashed_windows = 0;
+        double hashed_elapsed = best_of_three(PatternExtractor(config), hashed_windows);
+
+        std::cout << "Text " << mb << " MB, " << hashed_windows << " windows: histogram "
+                  << (mb / histogram_elapsed * 1000.0) << " MB/s, hashed 3-gram + "
+                  << word_n << "-word " << (mb / hashed_elapsed * 1000.0) << " MB/s"
+                  << std::endl;
+        EXPECT_EQ(histogram_windows, hashed_windows);
+    }
+
+    // The CLI feeds one line at a time
+    std::vector<std::vector<uint8_t>> lines;
+    std::istringstream stream(corpus);
+    for (std::string line; std::getline(stream, line);) {
+        if (!line.empty()) {
+            lines.emplace_back(line.begin(), line.end());
+        }
+    }
+    config.word_ngram_size = 1;
+    PatternExtractor hashed(config);
+    const int rounds = 20000;
+    size_t line_bytes = 0;
+    BenchmarkTimer line_timer;
+    for (int round = 0; round < rounds; ++round) {
+        for (const auto& line : lines) {
+            line_bytes += line.size();
+            hashed.Extract(line);
+        }
+    }
+    double line_elapsed = line_timer.ElapsedMs();
+    std::cout << "Hashed per-line extraction: "
+              << (static_cast<double>(rounds * lines.size()) / line_elapsed) << "k lines/s, "
+              << (static_cast<double>(line_bytes) / (1024.0 * 1024.0) / line_elapsed * 1000.0)
+              << " MB/s" << std::endl;
+}
+
+// ============================================================================
+// Pattern Matcher Benchmarks
+// ============================================================================
+
+TEST(PatternMatcherBenchmark, SketchRerankVsExhaustive_20000x64) {
+    auto db = CreateClusteredDatabase(20000, 64, 200, 6.0f);
+    auto metric = std::make_shared<FeatureCosineSimilarity>();
+
+    std::mt19937 rng(5);
+    std::normal_distribution<float> noise(0.0f, 2.0f);
+    std::vector<PatternData> queries;
+    for (uint64_t id = 3; id <= 20000 && queries.size() < 40; id += 499) {
+        FeatureVector features = db->Retrieve(PatternID(id))->GetData().GetFeatures();
+        for (size_t i = 0; i < features.Dimension(); ++i) {
+            features[i] += noise(rng);
+        }
+        queries.push_back(PatternData::FromFeatures(features, DataModality::NUMERIC));
+    }
+
+    PatternMatcher::Config config;
+    config.similarity_threshold = 0.7f;
+    PatternMatcher exhaustive(db, metric, config);
+
+    config.search_mode = PatternMatcher::SearchMode::SKETCH_RERANK;
+    config.sketch_bits = 256;
+    config.rerank_depth = 256;
+    config.recall_sample_interval = 1;
+    BenchmarkTimer build_timer;
+    PatternMatcher sketched(db, metric, config);  // Builds the sketches
+    double build_elapsed = build_timer.ElapsedMs();
+
+    BenchmarkTimer exhaustive_timer;
+    for (const auto& query : queries) {
+        exhaustive.FindMatches(query);
+    }
+    double exhaustive_elapsed = exhaustive_timer.ElapsedMs() / queries.size();
+
+    // Timed pass without recall sampling
+    config.recall_sample_interval = 0;
+    sketched.SetConfig(config);
+    BenchmarkTimer sketch_timer;
+    for (const auto& query : queries) {
+        sketched.FindMatches(query);
+    }
+    double sketch_elapsed = sketch_timer.ElapsedMs() / queries.size();
+
+    // Instrumented pass for recall
+    config.recall_sample_interval = 1;
+    sketched.SetConfig(config);
+    sketched.ResetSearchStats();
+    for (const auto& query : queries) {
+        sketched.FindMatches(query);
+    }
+    auto stats = sketched.GetSearchStats();
+
+    std::cout << "Matcher (20000 x 64): exhaustive " << exhaustive_elapsed
+              << "ms/query, sketch+rerank " << sketch_elapsed << "ms/query (sketch build "
+              << build_elapsed << "ms), recall " << stats.Recall() << " over "
+              << stats.recall_expected << " matches" << std::endl;
+
+    EXPECT_GE(stats.Recall(), 0.9f);
+    EXPECT_LT(sketch_elapsed * 5.0, exhaustive_elapsed);
+}
+
+TEST(PatternMatcherBenchmark, LayoutRangeSearch_20000x64) {
+    auto db = CreateClusteredDatabase(20000, 64, 200, 6.0f);
+    auto metric = std::make_shared<FeatureCosineSimilarity>();
+
+    std::vector<PatternData> queries;
+    for (uint64_t id = 3; id <= 20000 && queries.size() < 40; id += 499) {
+        queries.push_back(db->Retrieve(PatternID(id))->GetData());
+    }
+
+    PatternMatcher::Config config;
+    config.similarity_threshold = 0.8f;
+    PatternMatcher scan(db, metric, config);
+    PatternMatcher ranged(db, metric, config);
+
+    auto search = std::make_shared<SimilaritySearch>(db, metric);
+    search->SetStoragePrecision(FeaturePrecision::INT8);
+    ranged.SetSearch(search);
+
+    BenchmarkTimer scan_timer;
+    size_t expected_matches = 0;
+    for (const auto& query : queries) {
+        expected_matches += scan.FindMatches(query).size();
+    }
+    double scan_elapsed = scan_timer.ElapsedMs() / queries.size();
+
+    BenchmarkTimer range_timer;
+    size_t matches = 0;
+    for (const auto& query : queries) {
+        matches += ranged.FindMatches(query).size();
+    }
+    double range_elapsed = range_timer.ElapsedMs() / queries.size();
+
+    auto stats = ranged.GetSearchStats();
+    std::cout << "Matcher range search (20000 x 64): exact scan " << scan_elapsed
+              << "ms/query, int8 layout " << range_elapsed << "ms/query, "
+              << stats.patterns_scored / queries.size() << " exact scores/query" << std::endl;
+
+    EXPECT_EQ(expected_matches, matches);
+    EXPECT_LT(range_elapsed, scan_elapsed);
+}
+
+TEST(PatternMatcherBenchmark, SinglePassEvaluate_20000x64) {
+    auto db = CreateClusteredDatabase(20000, 64, 200, 6.0f);
+    auto metric = std::make_shared<FeatureCosineSimilarity>();
+
+    // Windows of one input: 16 candidates
+    std::vector<PatternData> windows;
+    for (uint64_t id = 7; id <= 20000 && windows.size() < 16; id += 1201) {
+        windows.push_back(db->Retrieve(PatternID(id))->GetData());
+    }
+
+    PatternMatcher::Config config;
+    config.similarity_threshold = 0.8f;
+    PatternMatcher matcher(db, metric, config);
+    matcher.FindMatches(windows.front());  // Warm the bound cache
+
+    // Previous engine path: FindMatches followed by MakeDecision
+    BenchmarkTimer two_pass_timer;
+    size_t two_pass_updates = 0;
+    for (const auto& window : windows) {
+        auto matches = matcher.FindMatches(window);
+        auto decision = matcher.MakeDecision(window);
+        two_pass_updates += decision.decision != PatternMatcher::Decision::CREATE_NEW;
+    }
+    double two_pass_elapsed = two_pass_timer.ElapsedMs();
+
+    BenchmarkTimer single_timer;
+    size_t single_updates = 0;
+    for (const auto& window : windows) {
+        auto evaluation = matcher.Evaluate(window);
+        single_updates += evaluation.decision.decision != PatternMatcher::Decision::CREATE_NEW;
+    }
+    double single_elapsed = single_timer.ElapsedMs();
+
+    BenchmarkTimer batch_timer;
+    size_t batch_updates = 0;
+    for (const auto& evaluation : matcher.EvaluateBatch(windows)) {
+        batch_updates += evaluation.decision.decision != PatternMatcher::Decision::CREATE_NEW;
+    }
+    double batch_elapsed = batch_timer.ElapsedMs();
+
+    std::cout << "Evaluate " << windows.size() << " windows (20000 x 64): FindMatches+MakeDecision "
+              << two_pass_elapsed << "ms, Evaluate " << single_elapsed << "ms, EvaluateBatch "
+              << batch_elapsed << "ms" << std::endl;
+
+    EXPECT_EQ(two_pass_updates, single_updates);
+    EXPECT_EQ(two_pass_updates, batch_updates);
+    EXPECT_LT(single_elapsed * 1.6, two_pass_elapsed);
+    EXPECT_LT(batch_elapsed * 2.0, two_pass_elapsed);
+}
+
+// ============================================================================
+// Pattern Engine Ingestion Benchmarks
+// ============================================================================
+
+TEST(PatternEngineBenchmark, ChangePointWindows_SteadyTelemetry) {
+    // Ten minutes of 1 kHz telemetry: a new operating level every minute
+    const double sample_rate = 1000.0;
+    const size_t count = 600000;
+    std::mt19937 rng(12);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    std::uniform_real_distribution<float> level(0.0f, 10.0f);
+    std::vector<float> telemetry(count);
+    float current = level(rng);
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 60000 == 0) {
+            current = level(rng);
+        }
+        telemetry[i] = current + noise(rng);
+    }
+    const double seconds = static_cast<double>(count) / sample_rate;
+
+    for (auto selection : {PatternExtractor::WindowSelection::ALL,
+                           PatternExtractor::WindowSelection::CHANGE_POINTS}) {
+        PatternEngine::Config config;
+        config.extraction_config.max_pattern_size = 1000;  // 250-sample windows
+        config.extraction_config.window_selection = selection;
+        config.enable_auto_refinement = false;
+        PatternEngine engine(config);
+
+        BenchmarkTimer timer;
+        auto batch = engine.ProcessBatch(std::vector<InputView>{
+            InputView::Floats(telemetry.data(), telemetry.size(), DataModality::NUMERIC)});
+        double elapsed = timer.ElapsedMs();
+
+        const bool all = selection == PatternExtractor::WindowSelection::ALL;
+        std::cout << (all ? "All windows: " : "Change points: ") << batch.windows
+                  << " patterns, " << (static_cast<double>(batch.windows) / seconds)
+                  << " patterns per input second, extract " << batch.extraction_time_ms
+                  << "ms, match " << batch.matching_time_ms << "ms, total " << elapsed
+                  << "ms" << std::endl;
+        EXPECT_GT(batch.windows, 0u);
+    }
+}
+
+TEST(PatternEngineBenchmark, ProcessBatchVsProcessInput_4000) {
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::vector<std::vector<uint8_t>> inputs(4000, std::vector<uint8_t>(64));
+    for (auto& input : inputs) {
+        for (auto& b : input) {
+            b = static_cast<uint8_t>(byte(rng));
+        }
+    }
+
+    // Unrelated records: the database grows with every input
+    PatternEngine::Config config;
+    config.similarity_metric = "hausdorff";
+    config.enable_auto_refinement = false;
+
+    PatternEngine serial(config);
+    BenchmarkTimer serial_timer;
+    for (const auto& input : inputs) {
+        serial.ProcessInput(input, DataModality::NUMERIC);
+    }
+    double serial_elapsed = serial_timer.ElapsedMs();
+
+    std::cout << "Ingest 4000 x 64B: ProcessInput " << (4000.0 / serial_elapsed * 1000.0)
+              << " inputs/s" << std::endl;
+
+    const size_t batch_size = 250;
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    double single_thread_rate = 0.0;
+    std::vector<size_t> thread_counts = {1};
+    if (hardware > 1) {
+        thread_counts.push_back(hardware);
+    }
+    for (size_t threads : thread_counts) {
+        // One thread is the caller alone; otherwise the pool's workers join it
+        config.batch_worker_pool = std::make_shared<WorkerPool>(threads - 1);
+        PatternEngine batched(config);
+
+        double extraction = 0.0, matching = 0.0, apply = 0.0;
+        BenchmarkTimer batch_timer;
+        for (size_t start = 0; start < inputs.size(); start += batch_size) {
+            std::vector<std::vector<uint8_t>> chunk(
+                inputs.begin() + start,
+                inputs.begin() + std::min(inputs.size(), start + batch_size));
+            auto batch = batched.ProcessBatch(chunk, DataModality::NUMERIC);
+            extraction += batch.extraction_time_ms;
+            matching += batch.matching_time_ms;
+            apply += batch.apply_time_ms;
+        }
+        double batch_elapsed = batch_timer.ElapsedMs();
+        double rate = 4000.0 / batch_elapsed * 1000.0;
+        if (threads == 1) {
+            single_thread_rate = rate;
+        }
+
+        std::cout << "Ingest 4000 x 64B: ProcessBatch(" << batch_size << ") with " << threads
+                  << " thread(s) " << rate << " inputs/s (extract " << extraction
+                  << "ms, match " << matching << "ms, apply " << apply << "ms)" << std::endl;
+
+        EXPECT_LT(batch_elapsed, serial_elapsed);
+    }
+    EXPECT_GT(single_thread_rate, 0.0);
+}
+
+TEST(PatternEngineBenchmark, IncrementalMaintenance_20000) {
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+
+    PatternEngine::Config config;
+    config.enable_auto_refinement = true;
+    PatternEngine engine(config);
+
+    // Spread-out patterns, one in ten with a near duplicate
+    for (size_t i = 0; i < 20000; ++i) {
+        std::vector<float> features(16);
+        for (auto& f : features) {
+            f = value(rng);
+        }
+        engine.CreatePattern(
+            PatternData::FromFeatures(FeatureVector(features), DataModality::NUMERIC), 0.6f);
+        if (i % 10 == 0) {
+            features[0] += 0.01f;
+            engine.CreatePattern(
+                PatternData::FromFeatures(FeatureVector(features), DataModality::NUMERIC), 0.6f);
+        }
+    }
+
+    BenchmarkTimer full_timer;
+    auto full = engine.RunMaintenance();
+    double full_elapsed = full_timer.ElapsedMs();
+
+    std::cout << "Maintenance over 22000 patterns: " << full_elapsed << "ms, checked "
+              << full.patterns_checked << ", candidates " << full.merge_candidates
+              << ", merged " << full.patterns_merged << std::endl;
+    EXPECT_EQ(2000u, full.patterns_merged);
+
+    // Only patterns changed since the last run are revisited
+    for (size_t i = 0; i < 100; ++i) {
+        std::vector<float> features(16);
+        for (auto& f : features) {
+            f = value(rng);
+        }
+        engine.CreatePattern(
+            PatternData::FromFeatures(FeatureVector(features), DataModality::NUMERIC), 0.6f);
+    }
+    BenchmarkTimer incremental_timer;
+    auto incremental = engine.RunMaintenance();
+    double incremental_elapsed = incremental_timer.ElapsedMs();
+
+    std::cout << "Maintenance after 100 new patterns: " << incremental_elapsed
+              << "ms, checked " << incremental.patterns_checked << std::endl;
+    EXPECT_EQ(100u, incremental.patterns_checked);
+    EXPECT_LT(incremental_elapsed, full_elapsed);
+}
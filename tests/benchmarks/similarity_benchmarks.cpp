@@ -0,0 +1,408 @@
+// File: tests/benchmarks/similarity_benchmarks.cpp
+//
+// Performance benchmarks for Similarity module
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <unordered_set>
+#include "similarity/geometric_similarity.hpp"
+#include "similarity/kmeans_clusterer.hpp"
+#include "similarity/contextual_similarity.hpp"
+#include "similarity/similarity_search.hpp"
+#include "similarity/statistical_similarity.hpp"
+#include "storage/memory_backend.hpp"
+
+using namespace dpan;
+using namespace std::chrono;
+
+// ============================================================================
+// Benchmark Helper
+// ============================================================================
+
+struct BenchmarkTimer {
+    using TimePoint = high_resolution_clock::time_point;
+    TimePoint start;
+
+    BenchmarkTimer() : start(high_resolution_clock::now()) {}
+
+    double ElapsedMs() const {
+        auto end = high_resolution_clock::now();
+        return duration_cast<duration<double, std::milli>>(end - start).count();
+    }
+};
+
+FeatureVector CreatePointCloud(size_t num_points, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+
+    std::vector<float> values(num_points * 2);
+    for (auto& v : values) {
+        v = dist(rng);
+    }
+    return FeatureVector(values);
+}
+
+// All-pairs Hausdorff distance (the pre-index implementation)
+float BruteForceHausdorff(const PointSet<2>& a, const PointSet<2>& b) {
+    auto directed = [](const PointSet<2>& from, const PointSet<2>& to) {
+        float max_min = 0.0f;
+        for (const auto& p : from.points) {
+            float min_dist = std::numeric_limits<float>::infinity();
+            for (const auto& q : to.points) {
+                min_dist = std::min(min_dist, p.DistanceTo(q));
+            }
+            max_min = std::max(max_min, min_dist);
+        }
+        return max_min;
+    };
+    return std::max(directed(a, b), directed(b, a));
+}
+
+// ============================================================================
+// Geometric Similarity Benchmarks
+// ============================================================================
+
+TEST(GeometricSimilarityBenchmark, Hausdorff_4096_Points) {
+    // Query compared against a small database of cached point clouds,
+    // as happens during similarity search
+    HausdorffSimilarity metric;
+    FeatureVector query = CreatePointCloud(4096, 1);
+    std::vector<FeatureVector> database;
+    for (uint32_t i = 0; i < 10; ++i) {
+        database.push_back(CreatePointCloud(4096, 100 + i));
+    }
+
+    // Warm the index cache
+    for (const auto& candidate : database) {
+        metric.ComputeFromFeatures(query, candidate);
+    }
+
+    BenchmarkTimer timer;
+    float checksum = 0.0f;
+    for (const auto& candidate : database) {
+        checksum += metric.ComputeFromFeatures(query, candidate);
+    }
+    double indexed_elapsed = timer.ElapsedMs();
+
+    BenchmarkTimer brute_timer;
+    float brute_checksum = 0.0f;
+    auto query_points = PointSet<2>::FromFeatureVector(query);
+    for (const auto& candidate : database) {
+        float distance = BruteForceHausdorff(query_points, PointSet<2>::FromFeatureVector(candidate));
+        brute_checksum += 1.0f / (1.0f + distance);
+    }
+    double brute_elapsed = brute_timer.ElapsedMs();
+
+    std::cout << "Hausdorff (10 x 4096 points): indexed " << indexed_elapsed
+              << "ms, all-pairs " << brute_elapsed << "ms, speedup "
+              << brute_elapsed / indexed_elapsed << "x" << std::endl;
+
+    EXPECT_NEAR(brute_checksum, checksum, 1e-4f);
+    EXPECT_LT(indexed_elapsed, brute_elapsed);
+}
+
+TEST(GeometricSimilarityBenchmark, Chamfer_4096_Points) {
+    ChamferSimilarity metric;
+    FeatureVector query = CreatePointCloud(4096, 2);
+    std::vector<FeatureVector> database;
+    for (uint32_t i = 0; i < 10; ++i) {
+        database.push_back(CreatePointCloud(4096, 200 + i));
+    }
+
+    for (const auto& candidate : database) {
+        metric.ComputeFromFeatures(query, candidate);
+    }
+
+    BenchmarkTimer timer;
+    for (const auto& candidate : database) {
+        metric.ComputeFromFeatures(query, candidate);
+    }
+    double elapsed = timer.ElapsedMs();
+
+    std::cout << "Chamfer (10 x 4096 points): " << elapsed << "ms, "
+              << elapsed / database.size() << "ms/comparison" << std::endl;
+
+    EXPECT_LT(elapsed, 1000.0); // Should complete in < 1s
+}
+
+// ============================================================================
+// Similarity Search Benchmarks
+// ============================================================================
+
+// Clustered database: vectors scattered around a few shared centres
+std::shared_ptr<PatternDatabase> CreateClusteredDatabase(size_t count, size_t dim,
+                                                         size_t num_clusters, float noise) {
+    auto db = std::make_shared<MemoryBackend>(MemoryBackend::Config{});
+    std::mt19937 rng(42);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+
+    std::vector<std::vector<float>> centres(num_clusters, std::vector<float>(dim));
+    for (auto& centre : centres) {
+        for (auto& v : centre) {
+            v = dist(rng) * 10.0f;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        std::vector<float> values = centres[i % num_clusters];
+        for (auto& v : values) {
+            v += dist(rng) * noise;
+        }
+        PatternData data = PatternData::FromFeatures(FeatureVector(values), DataModality::NUMERIC);
+        db->Store(PatternNode(PatternID(i + 1), data, PatternType::ATOMIC));
+    }
+    return db;
+}
+
+// Unpruned reference scan: decode and evaluate every candidate
+double TimeFullScan(PatternDatabase& db, const SimilarityMetric& metric,
+                    const FeatureVector& query, float& best) {
+    BenchmarkTimer timer;
+    best = -1.0f;
+    QueryOptions all;
+    all.max_results = std::numeric_limits<size_t>::max();
+    for (const auto& id : db.FindAll(all)) {
+        auto node = db.Retrieve(id);
+        best = std::max(best, metric.ComputeFromFeatures(query, node->GetData().GetFeatures()));
+    }
+    return timer.ElapsedMs();
+}
+
+TEST(SimilaritySearchBenchmark, PrunedCosineSearch_20000x128) {
+    auto db = CreateClusteredDatabase(20000, 128, 50, 4.0f);
+    auto metric = std::make_shared<ContextVectorSimilarity>();
+    SimilaritySearch search(db, metric);
+
+    FeatureVector query = db->Retrieve(PatternID(7))->GetData().GetFeatures();
+    auto config = SearchConfig::TopK(10);
+
+    // First search fills the bound cache
+    BenchmarkTimer cold_timer;
+    search.SearchByFeatures(query, config);
+    double cold_elapsed = cold_timer.ElapsedMs();
+
+    BenchmarkTimer timer;
+    auto results = search.SearchByFeatures(query, config);
+    double pruned_elapsed = timer.ElapsedMs();
+    const auto& stats = search.GetLastSearchStats();
+
+    float best = 0.0f;
+    double full_elapsed = TimeFullScan(*db, *metric, query, best);
+
+    std::cout << "Cosine top-10 (20000 x 128): full scan " << full_elapsed
+              << "ms, pruned cold " << cold_elapsed << "ms, warm " << pruned_elapsed
+              << "ms, pruned " << stats.patterns_pruned << "/" << stats.patterns_evaluated
+              << std::endl;
+
+    ASSERT_FALSE(results.empty());
+    EXPECT_FLOAT_EQ(best, results.front().similarity);
+    EXPECT_GT(stats.patterns_pruned, 0u);
+}
+
+TEST(SimilaritySearchBenchmark, PivotHausdorffSearch_2000x64Points) {
+    auto db = CreateClusteredDatabase(2000, 128, 40, 1.0f);
+    auto metric = std::make_shared<HausdorffSimilarity>();
+    SimilaritySearch search(db, metric);
+
+    BenchmarkTimer build_timer;
+    search.BuildPivotIndex(8);
+    double build_elapsed = build_timer.ElapsedMs();
+
+    FeatureVector query = db->Retrieve(PatternID(11))->GetData().GetFeatures();
+    auto config = SearchConfig::TopK(10);
+
+    BenchmarkTimer timer;
+    auto results = search.SearchByFeatures(query, config);
+    double pruned_elapsed = timer.ElapsedMs();
+    const auto& stats = search.GetLastSearchStats();
+
+    float best = 0.0f;
+    double full_elapsed = TimeFullScan(*db, *metric, query, best);
+
+    std::cout << "Hausdorff top-10 (2000 x 64 points): full scan " << full_elapsed
+              << "ms, pivot search " << pruned_elapsed << "ms (index build "
+              << build_elapsed << "ms), pruned " << stats.patterns_pruned << "/"
+              << stats.patterns_evaluated << std::endl;
+
+    ASSERT_FALSE(results.empty());
+    EXPECT_FLOAT_EQ(best, results.front().similarity);
+    EXPECT_LT(pruned_elapsed, full_elapsed);
+}
+
+TEST(SimilaritySearchBenchmark, CascadedMultiMetricSearch_2000x64Points) {
+    auto db = CreateClusteredDatabase(2000, 128, 40, 1.0f);
+    PatternData query = db->Retrieve(PatternID(3))->GetData();
+    auto config = SearchConfig::TopK(10);
+
+    auto make_search = [&db](bool cascade) {
+        MultiMetricSearch search(db);
+        search.AddMetric(std::make_shared<HausdorffSimilarity>(), 1.0f);
+        search.AddMetric(std::make_shared<MomentSimilarity>(), 1.0f);
+        search.SetCascadeEnabled(cascade);
+        return search;
+    };
+
+    MultiMetricSearch full = make_search(false);
+    MultiMetricSearch cascaded = make_search(true);
+
+    BenchmarkTimer full_timer;
+    auto expected = full.Search(query, config);
+    double full_elapsed = full_timer.ElapsedMs();
+
+    BenchmarkTimer cascade_timer;
+    auto results = cascaded.Search(query, config);
+    double cascade_elapsed = cascade_timer.ElapsedMs();
+
+    std::cout << "Multi-metric top-10 (2000 x 64 points): full " << full_elapsed
+              << "ms, cascaded " << cascade_elapsed << "ms" << std::endl;
+    for (const auto& stats : cascaded.GetMetricStats()) {
+        std::cout << "  " << stats.name << ": " << stats.evaluations << " evaluations, "
+                  << stats.evaluations_skipped << " skipped, " << stats.avg_cost_us
+                  << "us each" << std::endl;
+    }
+
+    ASSERT_EQ(expected.size(), results.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_FLOAT_EQ(expected[i].similarity, results[i].similarity);
+    }
+    EXPECT_LT(cascade_elapsed, full_elapsed);
+}
+
+TEST(SimilaritySearchBenchmark, ReducedPrecisionLayout_20000x128) {
+    auto db = CreateClusteredDatabase(20000, 128, 50, 4.0f);
+    auto metric = std::make_shared<ContextVectorSimilarity>();
+    const size_t k = 10;
+    auto config = SearchConfig::TopK(k);
+
+    std::vector<FeatureVector> queries;
+    for (uint64_t id = 5; id <= 200; id += 13) {
+        queries.push_back(db->Retrieve(PatternID(id))->GetData().GetFeatures());
+    }
+
+    // Float32 reference results
+    SimilaritySearch exact(db, metric);
+    exact.SearchByFeatures(queries.front(), config);  // Warm the bound cache
+    std::vector<std::vector<SearchResult>> expected;
+    BenchmarkTimer exact_timer;
+    for (const auto& query : queries) {
+        expected.push_back(exact.SearchByFeatures(query, config));
+    }
+    double exact_elapsed = exact_timer.ElapsedMs();
+    std::cout << "Precision float32: " << exact_elapsed / queries.size()
+              << "ms/query, recall@" << k << " 1" << std::endl;
+
+    for (FeaturePrecision precision : {FeaturePrecision::FLOAT16,
+                                       FeaturePrecision::BFLOAT16,
+                                       FeaturePrecision::INT8}) {
+        SimilaritySearch search(db, metric);
+        BenchmarkTimer build_timer;
+        search.SetStoragePrecision(precision);
+        double build_elapsed = build_timer.ElapsedMs();
+
+        size_t hits = 0;
+        size_t total = 0;
+        BenchmarkTimer timer;
+        std::vector<std::vector<SearchResult>> actual;
+        for (const auto& query : queries) {
+            actual.push_back(search.SearchByFeatures(query, config));
+        }
+        double elapsed = timer.ElapsedMs();
+
+        for (size_t q = 0; q < queries.size(); ++q) {
+            std::unordered_set<PatternID> truth;
+            for (const auto& r : expected[q]) {
+                truth.insert(r.pattern_id);
+            }
+            for (const auto& r : actual[q]) {
+                hits += truth.count(r.pattern_id);
+            }
+            total += expected[q].size();
+        }
+        float recall = total == 0 ? 1.0f : static_cast<float>(hits) / static_cast<float>(total);
+
+        std::cout << "Precision " << ToString(precision) << ": "
+                  << elapsed / queries.size() << "ms/query, recall@" << k << " " << recall
+                  << ", layout " << search.GetLayoutMemoryBytes() / 1024 << "KiB (built in "
+                  << build_elapsed << "ms)" << std::endl;
+
+        EXPECT_GE(recall, 0.95f);
+        EXPECT_LT(search.GetLayoutMemoryBytes(), 20000u * 128u * sizeof(float));
+    }
+}
+
+// ============================================================================
+// Clustering Benchmarks
+// ============================================================================
+
+// count x dim points around `centres` random, overlapping centres
+std::vector<float> CreateBlobMatrix(size_t count, size_t dim, size_t centres, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> centre_value(-50.0f, 50.0f);
+    std::normal_distribution<float> noise(0.0f, 20.0f);
+
+    std::vector<float> centre_points(centres * dim);
+    for (auto& v : centre_points) {
+        v = centre_value(rng);
+    }
+    std::vector<float> points(count * dim);
+    for (size_t i = 0; i < count; ++i) {
+        const float* centre = centre_points.data() + (rng() % centres) * dim;
+        for (size_t d = 0; d < dim; ++d) {
+            points[i * dim + d] = centre[d] + noise(rng);
+        }
+    }
+    return points;
+}
+
+TEST(ClusteringBenchmark, KMeans_10k_100k_1M_Points) {
+    const size_t dim = 16;
+    const size_t k = 32;
+
+    for (size_t count : {size_t{10000}, size_t{100000}, size_t{1000000}}) {
+        auto points = CreateBlobMatrix(count, dim, k, 7);
+
+        std::vector<KMeansClusterer::Algorithm> algorithms = {
+            KMeansClusterer::Algorithm::HAMERLY, KMeansClusterer::Algorithm::MINI_BATCH};
+        if (count <= 100000) {
+            algorithms.insert(algorithms.begin(), KMeansClusterer::Algorithm::LLOYD);
+        }
+
+        double hamerly_inertia = 0.0;
+        uint64_t lloyd_distances = 0;
+        for (auto algorithm : algorithms) {
+            KMeansClusterer::Config config;
+            config.num_clusters = k;
+            config.algorithm = algorithm;
+            config.max_iterations = 50;
+            KMeansClusterer clusterer(config);
+
+            BenchmarkTimer timer;
+            auto result = clusterer.Run(points.data(), count, dim);
+            double elapsed = timer.ElapsedMs();
+
+            const char* name = algorithm == KMeansClusterer::Algorithm::LLOYD ? "lloyd"
+                             : algorithm == KMeansClusterer::Algorithm::HAMERLY ? "hamerly"
+                             : "mini-batch";
+            std::cout << "k-means " << count << "x" << dim << " k=" << k << " " << name << ": "
+                      << elapsed << "ms, " << result.iterations << " iterations, "
+                      << result.distance_computations / count << " distances/point, inertia/point "
+                      << result.inertia / static_cast<double>(count) << std::endl;
+
+            ASSERT_EQ(count, result.assignments.size());
+            if (algorithm == KMeansClusterer::Algorithm::LLOYD) {
+                lloyd_distances = result.distance_computations;
+            } else if (algorithm == KMeansClusterer::Algorithm::HAMERLY) {
+                hamerly_inertia = result.inertia;
+                if (lloyd_distances > 0) {
+                    EXPECT_LT(result.distance_computations, lloyd_distances);
+                }
+            } else {
+                // Mini-batch trades a little quality for cost independent of count
+                EXPECT_LT(result.inertia, hamerly_inertia * 1.25);
+            }
+        }
+    }
+}
@@ -248,6 +248,88 @@ TEST(MemoryBackendBenchmark, GetStats) {
 // Large Scale Storage Benchmarks
 // ============================================================================
 
+TEST(StorageScalabilityBenchmark, Aggregates_100k_Patterns) {
+    MemoryBackend::Config config;
+    MemoryBackend backend(config);
+
+    for (size_t i = 0; i < 100000; ++i) {
+        auto pattern = CreateTestPattern(10);
+        ASSERT_TRUE(backend.Store(pattern));
+    }
+
+    // Maintained totals
+    BenchmarkTimer maintained_timer;
+    PatternAggregates maintained;
+    for (size_t i = 0; i < 1000; ++i) {
+        maintained = backend.GetAggregates();
+    }
+    double maintained_ms = maintained_timer.ElapsedMs() / 1000.0;
+
+    // Full recount, as used by verify mode
+    BenchmarkTimer scan_timer;
+    PatternAggregates scanned = backend.ScanAggregates();
+    double scan_ms = scan_timer.ElapsedMs();
+
+    std::cout << "Aggregates (100k patterns): maintained " << maintained_ms
+              << "ms, scan " << scan_ms << "ms" << std::endl;
+
+    EXPECT_EQ(100000u, maintained.total_patterns);
+    EXPECT_EQ(scanned, maintained);
+    EXPECT_LT(maintained_ms, 0.1);
+}
+
+TEST(StorageScalabilityBenchmark, ParentLookup_100k_Patterns) {
+    MemoryBackend::Config config;
+    MemoryBackend backend(config);
+
+    // 100k atomic patterns, grouped five at a time under 20k composites
+    std::vector<PatternID> atoms;
+    atoms.reserve(100000);
+    for (size_t i = 0; i < 100000; ++i) {
+        auto pattern = CreateTestPattern(10);
+        atoms.push_back(pattern.GetID());
+        ASSERT_TRUE(backend.Store(pattern));
+    }
+    std::vector<PatternID> composites;
+    for (size_t i = 0; i < atoms.size(); i += 5) {
+        PatternNode composite(PatternID::Generate(), CreateTestPattern(10).GetData(),
+                              PatternType::COMPOSITE);
+        for (size_t j = i; j < i + 5; ++j) {
+            composite.AddSubPattern(atoms[j]);
+        }
+        composites.push_back(composite.GetID());
+        ASSERT_TRUE(backend.Store(composite));
+    }
+
+    // Indexed parent lookups
+    BenchmarkTimer indexed_timer;
+    size_t found = 0;
+    for (size_t i = 0; i < 10000; ++i) {
+        found += backend.GetParentPatterns(atoms[i * 10]).size();
+    }
+    double indexed_ms = indexed_timer.ElapsedMs() / 10000.0;
+
+    // Full scan, as every lookup did before the index
+    BenchmarkTimer scan_timer;
+    auto scanned = backend.PatternDatabase::GetParentPatterns(atoms[0]);
+    double scan_ms = scan_timer.ElapsedMs();
+
+    // All descendants of 1000 composites in one call
+    std::vector<PatternID> roots(composites.begin(), composites.begin() + 1000);
+    BenchmarkTimer traverse_timer;
+    auto descendants = backend.TraverseHierarchy(roots, HierarchyDirection::DESCENDANTS, 4);
+    double traverse_ms = traverse_timer.ElapsedMs();
+
+    std::cout << "Parent lookup (100k patterns): indexed " << indexed_ms << "ms, scan "
+              << scan_ms << "ms; descendants of 1000 composites " << traverse_ms << "ms"
+              << std::endl;
+
+    EXPECT_EQ(10000u, found);
+    EXPECT_EQ(backend.GetParentPatterns(atoms[0]), scanned);
+    EXPECT_EQ(5000u, descendants.size());
+    EXPECT_LT(indexed_ms * 100.0, scan_ms);
+}
+
 TEST(StorageScalabilityBenchmark, Store_100k_Patterns) {
     MemoryBackend::Config config;
     MemoryBackend backend(config);
@@ -1,6 +1,12 @@
 // File: tests/core/pattern_engine_test.cpp
 #include "core/pattern_engine.hpp"
+#include "memory/interference.hpp"
+#include "similarity/geometric_similarity.hpp"
 #include <gtest/gtest.h>
+#include <cmath>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
 
 namespace dpan {
 namespace {
@@ -126,6 +132,33 @@ TEST(PatternEngineTest, CreateCompositePatternWorks) {
     EXPECT_EQ(2u, comp_opt->GetSubPatterns().size());
 }
 
+TEST(PatternEngineTest, HierarchyQueriesFollowCompositePatterns) {
+    PatternEngine::Config config = CreateTestConfig();
+    PatternEngine engine(config);
+
+    auto make = [](float x) {
+        return PatternData::FromFeatures(FeatureVector(std::vector<float>{x, 1.0f}),
+                                         DataModality::NUMERIC);
+    };
+    PatternID a = engine.CreatePattern(make(1.0f));
+    PatternID b = engine.CreatePattern(make(2.0f));
+    PatternID ab = engine.CreateCompositePattern({a, b}, make(3.0f));
+    PatternID top = engine.CreateCompositePattern({ab}, make(4.0f));
+    ASSERT_TRUE(top.IsValid());
+
+    EXPECT_EQ(std::vector<PatternID>{ab}, engine.GetParentPatterns(a));
+
+    auto ancestors = engine.TraverseHierarchy({a, b}, HierarchyDirection::ANCESTORS, 4);
+    ASSERT_EQ(2u, ancestors.size());
+    EXPECT_EQ(ab, ancestors[0].id);
+    EXPECT_EQ(top, ancestors[1].id);
+    EXPECT_EQ(2u, ancestors[1].depth);
+
+    ASSERT_TRUE(engine.DeletePattern(ab));
+    EXPECT_TRUE(engine.GetParentPatterns(a).empty());
+    EXPECT_EQ(std::vector<PatternID>{top}, engine.GetParentPatterns(ab));
+}
+
 TEST(PatternEngineTest, GetPatternWorks) {
     PatternEngine::Config config = CreateTestConfig();
     PatternEngine engine(config);
@@ -202,6 +235,34 @@ TEST(PatternEngineTest, FindSimilarPatternsWorks) {
     EXPECT_LE(results.size(), 5u);
 }
 
+TEST(PatternEngineTest, QuantizedSearchLayoutFollowsPatternChanges) {
+    PatternEngine::Config config = CreateTestConfig();
+    config.similarity_metric = "hausdorff";
+    config.search_precision = FeaturePrecision::INT8;
+    PatternEngine engine(config);
+
+    auto make = [](std::vector<float> values) {
+        return PatternData::FromFeatures(FeatureVector(values), DataModality::NUMERIC);
+    };
+    PatternData query = make({1.0f, 1.0f, 1.0f, 1.0f});
+
+    PatternID far = engine.CreatePattern(make({5.0f, 5.0f, 5.0f, 5.0f}));
+    PatternID near = engine.CreatePattern(make({1.0f, 1.0f, 1.0f, 1.5f}));
+    auto results = engine.FindSimilarPatterns(query, 1);
+    ASSERT_EQ(1u, results.size());
+    EXPECT_EQ(near, results[0].pattern_id);
+
+    ASSERT_TRUE(engine.UpdatePattern(far, query));
+    results = engine.FindSimilarPatterns(query, 1);
+    ASSERT_EQ(1u, results.size());
+    EXPECT_EQ(far, results[0].pattern_id);
+
+    ASSERT_TRUE(engine.DeletePattern(far));
+    results = engine.FindSimilarPatterns(query, 2);
+    ASSERT_EQ(1u, results.size());
+    EXPECT_EQ(near, results[0].pattern_id);
+}
+
 TEST(PatternEngineTest, FindSimilarPatternsByIdWorks) {
     PatternEngine::Config config = CreateTestConfig();
     PatternEngine engine(config);
@@ -287,6 +348,40 @@ TEST(PatternEngineTest, GetStatisticsWorks) {
     EXPECT_FLOAT_EQ(0.6f, stats_after.avg_confidence);
 }
 
+TEST(PatternEngineTest, GetStatisticsCountsBeyondQueryLimit) {
+    PatternEngine::Config config = CreateTestConfig();
+    PatternEngine engine(config);
+
+    // More patterns than the default FindAll result limit of 100
+    std::vector<PatternID> ids;
+    for (int i = 0; i < 240; ++i) {
+        FeatureVector features(std::vector<float>{static_cast<float>(i), 1.0f});
+        ids.push_back(engine.CreatePattern(
+            PatternData::FromFeatures(features, DataModality::NUMERIC), i < 120 ? 0.2f : 0.6f));
+    }
+    PatternID composite = engine.CreateCompositePattern(
+        {ids[0], ids[1]},
+        PatternData::FromFeatures(FeatureVector(std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f}),
+                                  DataModality::NUMERIC));
+    ASSERT_TRUE(composite.IsValid());
+    for (int i = 200; i < 240; ++i) {
+        ASSERT_TRUE(engine.DeletePattern(ids[i]));
+    }
+
+    auto stats = engine.GetStatistics();
+    EXPECT_EQ(201u, stats.total_patterns);
+    EXPECT_EQ(200u, stats.atomic_patterns);
+    EXPECT_EQ(1u, stats.composite_patterns);
+    EXPECT_FALSE(stats.aggregates_verified);
+    EXPECT_FLOAT_EQ(200.0f * 8.0f / 201.0f + 16.0f / 201.0f, stats.avg_pattern_size_bytes);
+
+    auto verified = engine.GetStatistics(true);
+    EXPECT_TRUE(verified.aggregates_verified);
+    EXPECT_TRUE(verified.aggregates_consistent);
+    EXPECT_EQ(stats.total_patterns, verified.total_patterns);
+    EXPECT_FLOAT_EQ(stats.avg_confidence, verified.avg_confidence);
+}
+
 TEST(PatternEngineTest, GetConfigWorks) {
     PatternEngine::Config config = CreateTestConfig();
     config.similarity_metric = "euclidean";
@@ -328,6 +423,122 @@ TEST(PatternEngineTest, RunMaintenanceWorks) {
     EXPECT_NO_THROW(engine.RunMaintenance());
 }
 
+TEST(PatternEngineTest, RunMaintenanceMergesNearDuplicatesIncrementally) {
+    PatternEngine::Config config = CreateTestConfig();
+    PatternEngine engine(config);
+
+    auto create = [&](float x) {
+        FeatureVector features(std::vector<float>{x, 1.0f, 2.0f});
+        return engine.CreatePattern(
+            PatternData::FromFeatures(features, DataModality::NUMERIC), 0.6f);
+    };
+
+    // Well separated patterns, every fifth with a near duplicate
+    for (int i = 0; i < 150; ++i) {
+        create(static_cast<float>(i) * 10.0f);
+        if (i % 5 == 0) {
+            create(static_cast<float>(i) * 10.0f + 0.01f);
+        }
+    }
+
+    // Duplicates merged away before their turn are not checked again
+    auto first = engine.RunMaintenance();
+    EXPECT_EQ(150u, first.patterns_checked);
+    EXPECT_EQ(30u, first.patterns_merged);
+    EXPECT_EQ(0u, first.patterns_split);
+    EXPECT_EQ(0u, first.patterns_pending);
+    EXPECT_FALSE(first.budget_exhausted);
+
+    // Merging keeps the originals and adds the merged patterns
+    EXPECT_EQ(210u, engine.GetStatistics().total_patterns);
+
+    // Nothing changed since, so nothing is re-examined
+    auto second = engine.RunMaintenance();
+    EXPECT_EQ(0u, second.patterns_checked);
+    EXPECT_EQ(0u, second.patterns_merged);
+
+    // Only the new pattern is checked, and merges with its neighbor
+    create(15.0f * 10.0f + 0.02f);
+    auto third = engine.RunMaintenance();
+    EXPECT_EQ(1u, third.patterns_checked);
+    EXPECT_EQ(1u, third.patterns_merged);
+}
+
+TEST(PatternEngineTest, SimilarityCacheIsSharedAndInvalidated) {
+    PatternEngine::Config config = CreateTestConfig();
+    PatternEngine engine(config);
+
+    auto cache = engine.GetSimilarityCache();
+    ASSERT_NE(nullptr, cache);
+
+    auto create = [&](float x) {
+        FeatureVector features(std::vector<float>{x, 1.0f, 2.0f});
+        return engine.CreatePattern(
+            PatternData::FromFeatures(features, DataModality::NUMERIC), 0.6f);
+    };
+    PatternID a = create(0.0f);
+    PatternID b = create(5.0f);
+
+    // A memory consumer given the engine's cache scores the pair once
+    InterferenceCalculator interference(std::make_shared<HausdorffSimilarity>());
+    interference.SetSimilarityCache(cache);
+    for (int i = 0; i < 3; ++i) {
+        interference.CalculateInterference(*engine.GetPattern(a), *engine.GetPattern(b), 0.5f);
+    }
+    auto stats = cache->GetConsumerStats("InterferenceCalculator");
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(2u, stats.hits);
+
+    // Updating a pattern drops its pairs
+    EXPECT_TRUE(engine.UpdatePattern(
+        a, PatternData::FromFeatures(FeatureVector(std::vector<float>{0.5f, 1.0f, 2.0f}),
+                                     DataModality::NUMERIC)));
+    EXPECT_EQ(0u, cache->Size());
+    interference.CalculateInterference(*engine.GetPattern(a), *engine.GetPattern(b), 0.5f);
+    EXPECT_EQ(2u, cache->GetConsumerStats("InterferenceCalculator").misses);
+
+    // The refiner's merge checks go through the same cache, and merged
+    // patterns leave it
+    PatternID near_b = create(5.01f);
+    auto maintenance = engine.RunMaintenance();
+    EXPECT_EQ(1u, maintenance.patterns_merged);
+    EXPECT_EQ(1u, cache->GetConsumerStats("PatternRefiner").misses);
+    EXPECT_EQ(0u, cache->Size());
+
+    // Deleting a pattern drops its pairs
+    interference.CalculateInterference(*engine.GetPattern(a), *engine.GetPattern(near_b), 0.5f);
+    EXPECT_EQ(1u, cache->Size());
+    EXPECT_TRUE(engine.DeletePattern(a));
+    EXPECT_EQ(0u, cache->Size());
+
+    config.enable_similarity_cache = false;
+    PatternEngine uncached(config);
+    EXPECT_EQ(nullptr, uncached.GetSimilarityCache());
+}
+
+TEST(PatternEngineTest, RunMaintenanceResumesAfterTimeBudget) {
+    PatternEngine::Config config = CreateTestConfig();
+    PatternEngine engine(config);
+
+    for (int i = 0; i < 300; ++i) {
+        FeatureVector features(std::vector<float>{static_cast<float>(i) * 10.0f, 1.0f});
+        engine.CreatePattern(PatternData::FromFeatures(features, DataModality::NUMERIC), 0.6f);
+    }
+
+    auto partial = engine.RunMaintenance(1e-6f);
+    EXPECT_TRUE(partial.budget_exhausted);
+    EXPECT_GE(partial.patterns_checked, 1u);
+    EXPECT_EQ(300u, partial.patterns_checked + partial.patterns_pending);
+
+    // Later runs continue where the previous one stopped
+    size_t checked = partial.patterns_checked;
+    for (int run = 0; run < 300 && checked < 300; ++run) {
+        checked += engine.RunMaintenance(1e-6f).patterns_checked;
+    }
+    EXPECT_EQ(300u, checked);
+    EXPECT_EQ(0u, engine.RunMaintenance().patterns_pending);
+}
+
 TEST(PatternEngineTest, MultipleInputProcessing) {
     PatternEngine::Config config = CreateTestConfig();
     PatternEngine engine(config);
@@ -403,5 +614,289 @@ TEST(PatternEngineTest, IndexingEnabledVsDisabled) {
     }
 }
 
+TEST(PatternEngineTest, RepeatedInputTakesDuplicateFastPath) {
+    PatternEngine::Config config = CreateTestConfig();
+    PatternEngine engine(config);
+
+    auto input = CreateTestInput(100);
+    auto first = engine.ProcessInput(input, DataModality::NUMERIC);
+    ASSERT_FALSE(first.created_patterns.empty());
+    size_t patterns_after_first = engine.GetStatistics().total_patterns;
+
+    auto second = engine.ProcessInput(input, DataModality::NUMERIC);
+    EXPECT_TRUE(second.created_patterns.empty());
+    EXPECT_EQ(first.created_patterns.size(), second.activated_patterns.size());
+
+    auto stats = engine.GetStatistics();
+    EXPECT_EQ(patterns_after_first, stats.total_patterns);
+    EXPECT_GE(stats.duplicate_hits, second.activated_patterns.size());
+    EXPECT_GE(stats.duplicate_lookups, stats.duplicate_hits);
+
+    // A pattern updated to new data no longer matches the old input
+    PatternData replacement = PatternData::FromFeatures(
+        FeatureVector(std::vector<float>{42.0f}), DataModality::NUMERIC);
+    for (const auto& id : first.created_patterns) {
+        ASSERT_TRUE(engine.UpdatePattern(id, replacement));
+    }
+    engine.ProcessInput(input, DataModality::NUMERIC);
+    EXPECT_EQ(stats.duplicate_hits, engine.GetStatistics().duplicate_hits);
+}
+
+TEST(PatternEngineTest, DuplicateFastPathRecordsInstances) {
+    PatternEngine::Config config = CreateTestConfig();
+    config.similarity_metric = "histogram";
+    PatternEngine engine(config);
+
+    std::vector<float> samples(200);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = std::sin(static_cast<float>(i) * 0.2f) * 3.0f;
+    }
+    auto input = InputView::Floats(samples.data(), samples.size());
+    auto first = engine.ProcessInput(input);
+    ASSERT_FALSE(first.created_patterns.empty());
+    EXPECT_EQ(0u, engine.GetStatistics().patterns_with_instances);
+
+    // Repeats are sampled like any other matched input
+    auto second = engine.ProcessInput(input);
+    auto stats = engine.GetStatistics();
+    ASSERT_GT(stats.duplicate_hits, 0u);
+    EXPECT_EQ(first.created_patterns.size(), stats.patterns_with_instances);
+    EXPECT_GT(stats.instance_reservoir_bytes, 0u);
+
+    std::vector<InputView> batch{input, input};
+    engine.ProcessBatch(batch);
+    EXPECT_EQ(first.created_patterns.size(),
+              engine.GetStatistics().patterns_with_instances);
+}
+
+TEST(PatternEngineTest, BatchRecordsInstancesLikeSerialIngestion) {
+    PatternEngine::Config config = CreateTestConfig();
+    config.similarity_metric = "histogram";
+
+    // Near-identical waves match patterns created by earlier ones, and the
+    // first wave repeats at the end
+    std::vector<std::vector<float>> waves;
+    for (size_t variant = 0; variant < 6; ++variant) {
+        std::vector<float> samples(200);
+        for (size_t i = 0; i < samples.size(); ++i) {
+            samples[i] = std::sin(static_cast<float>(i) * 0.2f) * 3.0f +
+                         0.01f * static_cast<float>(variant);
+        }
+        waves.push_back(std::move(samples));
+    }
+    waves.push_back(waves.front());
+
+    std::vector<InputView> inputs;
+    for (const auto& samples : waves) {
+        inputs.push_back(InputView::Floats(samples.data(), samples.size()));
+    }
+
+    PatternEngine serial(config);
+    for (const auto& input : inputs) {
+        serial.ProcessInput(input);
+    }
+    PatternEngine batched(config);
+    batched.ProcessBatch(inputs);
+
+    auto serial_stats = serial.GetStatistics();
+    auto batch_stats = batched.GetStatistics();
+    ASSERT_EQ(serial_stats.total_patterns, batch_stats.total_patterns);
+    EXPECT_GT(serial_stats.patterns_with_instances, 0u);
+    EXPECT_EQ(serial_stats.patterns_with_instances, batch_stats.patterns_with_instances);
+}
+
+TEST(PatternEngineTest, DuplicateFastPathCoversOneSession) {
+    const std::string path = "/tmp/dpan_engine_duplicate_" +
+        std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".db";
+    PatternEngine::Config config = CreateTestConfig();
+    config.database_type = "persistent";
+    config.database_path = path;
+    config.similarity_metric = "histogram";
+
+    std::vector<float> samples(200);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = std::sin(static_cast<float>(i) * 0.2f) * 3.0f;
+    }
+    auto input = InputView::Floats(samples.data(), samples.size());
+
+    size_t created = 0;
+    {
+        PatternEngine engine(config);
+        created = engine.ProcessInput(input).created_patterns.size();
+        ASSERT_GT(created, 0u);
+        engine.ProcessInput(input);
+        EXPECT_GT(engine.GetStatistics().duplicate_hits, 0u);
+        engine.Flush();
+    }
+
+    // Raw inputs are not stored: after reopening, a repeat is resolved by
+    // similarity matching instead, without creating patterns
+    {
+        PatternEngine engine(config);
+        auto repeat = engine.ProcessInput(input);
+        EXPECT_TRUE(repeat.created_patterns.empty());
+        EXPECT_FALSE(repeat.activated_patterns.empty());
+        auto stats = engine.GetStatistics();
+        EXPECT_EQ(created, stats.total_patterns);
+        EXPECT_GT(stats.duplicate_lookups, 0u);
+        EXPECT_EQ(0u, stats.duplicate_hits);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(PatternEngineTest, DuplicateFastPathCanBeDisabled) {
+    PatternEngine::Config config = CreateTestConfig();
+    config.enable_duplicate_fast_path = false;
+    PatternEngine engine(config);
+
+    auto input = CreateTestInput(100);
+    engine.ProcessInput(input, DataModality::NUMERIC);
+    engine.ProcessInput(input, DataModality::NUMERIC);
+
+    auto stats = engine.GetStatistics();
+    EXPECT_EQ(0u, stats.duplicate_lookups);
+    EXPECT_EQ(0u, stats.duplicate_hits);
+}
+
+TEST(PatternEngineTest, ProcessInputAcceptsTypedFloats) {
+    PatternEngine::Config config = CreateTestConfig();
+    PatternEngine engine(config);
+
+    std::vector<float> samples(200);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = std::sin(static_cast<float>(i) * 0.2f) * 3.0f;
+    }
+
+    auto first = engine.ProcessInput(InputView::Floats(samples.data(), samples.size()));
+    ASSERT_FALSE(first.created_patterns.empty());
+
+    // The same samples as bytes are the same source: exact repeats
+    std::vector<uint8_t> bytes(samples.size() * sizeof(float));
+    std::memcpy(bytes.data(), samples.data(), bytes.size());
+    auto second = engine.ProcessInput(bytes, DataModality::NUMERIC);
+    EXPECT_TRUE(second.created_patterns.empty());
+    EXPECT_EQ(first.created_patterns.size(), second.activated_patterns.size());
+
+    auto discovered = engine.DiscoverPatterns(InputView::Floats(samples.data(), samples.size()));
+    EXPECT_EQ(first.created_patterns.size(), discovered.size());
+}
+
+TEST(PatternEngineTest, ProcessBatchAgreesWithSerialProcessing) {
+    std::vector<std::vector<uint8_t>> inputs;
+    for (size_t i = 0; i < 6; ++i) {
+        auto input = CreateTestInput(100);
+        input[0] = static_cast<uint8_t>(200 + i);
+        inputs.push_back(input);
+    }
+
+    PatternEngine serial(CreateTestConfig());
+    size_t serial_created = 0;
+    for (const auto& input : inputs) {
+        serial_created += serial.ProcessInput(input, DataModality::NUMERIC).created_patterns.size();
+    }
+
+    PatternEngine::Config config = CreateTestConfig();
+    config.batch_worker_pool = std::make_shared<WorkerPool>(2);
+    PatternEngine batched(config);
+
+    // The first input repeats at the end of the batch
+    inputs.push_back(inputs.front());
+    auto batch = batched.ProcessBatch(inputs, DataModality::NUMERIC);
+
+    ASSERT_EQ(inputs.size(), batch.results.size());
+    size_t batch_created = 0;
+    for (const auto& result : batch.results) {
+        batch_created += result.created_patterns.size();
+    }
+    EXPECT_EQ(serial_created, batch_created);
+    EXPECT_EQ(serial.GetStatistics().total_patterns, batched.GetStatistics().total_patterns);
+
+    EXPECT_TRUE(batch.results.back().created_patterns.empty());
+    EXPECT_EQ(batch.results.front().created_patterns, batch.results.back().activated_patterns);
+    EXPECT_EQ(batch.results.front().created_patterns.size(), batch.intra_batch_duplicates);
+
+    EXPECT_GE(batch.total_time_ms, batch.extraction_time_ms + batch.matching_time_ms);
+
+    // Processing the batch again resolves every window to a stored pattern
+    auto again = batched.ProcessBatch(inputs, DataModality::NUMERIC);
+    for (const auto& result : again.results) {
+        EXPECT_TRUE(result.created_patterns.empty());
+    }
+    EXPECT_EQ(serial.GetStatistics().total_patterns, batched.GetStatistics().total_patterns);
+}
+
+TEST(PatternEngineTest, ProcessBatchFoldsSimilarNewWindows) {
+    PatternEngine::Config config = CreateTestConfig();
+    config.similarity_metric = "histogram";
+    PatternEngine engine(config);
+
+    // Slightly different copies of one signal
+    std::vector<std::vector<uint8_t>> inputs;
+    for (size_t i = 0; i < 4; ++i) {
+        auto input = CreateTestInput(100);
+        input[50] = static_cast<uint8_t>(input[50] + i + 1);
+        inputs.push_back(input);
+    }
+
+    auto batch = engine.ProcessBatch(inputs, DataModality::NUMERIC);
+    EXPECT_GT(batch.intra_batch_merges, 0u);
+    EXPECT_EQ(batch.windows - batch.intra_batch_duplicates - batch.intra_batch_merges,
+              engine.GetStatistics().total_patterns);
+
+    size_t activated = 0;
+    for (const auto& result : batch.results) {
+        activated += result.activated_patterns.size();
+    }
+    EXPECT_EQ(batch.intra_batch_merges, activated);
+}
+
+TEST(PatternEngineTest, MatchedInputsAreSampledForSplitting) {
+    PatternEngine::Config config = CreateTestConfig();
+    config.similarity_metric = "histogram";
+    config.enable_duplicate_fast_path = false;
+    config.instance_reservoir_capacity = 4;
+    PatternEngine engine(config);
+
+    // Slightly different sine waves: the first creates patterns, the
+    // rest match them
+    auto wave = [](size_t variant) {
+        std::vector<float> samples(200);
+        for (size_t i = 0; i < samples.size(); ++i) {
+            samples[i] = std::sin(static_cast<float>(i) * 0.2f) * 3.0f +
+                         0.01f * static_cast<float>(variant % 12);
+        }
+        return samples;
+    };
+
+    size_t activated = 0;
+    for (size_t i = 0; i < 12; ++i) {
+        auto samples = wave(i);
+        activated += engine.ProcessInput(InputView::Floats(samples.data(), samples.size()))
+                         .activated_patterns.size();
+    }
+    ASSERT_GT(activated, 0u);
+
+    auto stats = engine.GetStatistics();
+    EXPECT_GE(stats.patterns_with_instances, 1u);
+    EXPECT_GT(stats.instance_reservoir_bytes, 0u);
+
+    // Memory stays bounded however many more inputs match
+    for (size_t i = 0; i < 40; ++i) {
+        auto samples = wave(i);
+        engine.ProcessInput(InputView::Floats(samples.data(), samples.size()));
+    }
+    auto later = engine.GetStatistics();
+    EXPECT_EQ(stats.patterns_with_instances, later.patterns_with_instances);
+    EXPECT_EQ(stats.instance_reservoir_bytes, later.instance_reservoir_bytes);
+
+    config.instance_reservoir_capacity = 0;
+    PatternEngine without(config);
+    auto samples = wave(0);
+    without.ProcessInput(InputView::Floats(samples.data(), samples.size()));
+    without.ProcessInput(InputView::Floats(samples.data(), samples.size()));
+    EXPECT_EQ(0u, without.GetStatistics().patterns_with_instances);
+}
+
 } // namespace
 } // namespace dpan
@@ -0,0 +1,85 @@
+// File: tests/core/worker_pool_test.cpp
+#include "core/worker_pool.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+namespace dpan {
+namespace {
+
+TEST(WorkerPoolTest, RunsEveryIndexOnce) {
+    WorkerPool pool(3);
+    EXPECT_EQ(3u, pool.GetWorkerCount());
+
+    std::vector<std::atomic<int>> hits(1000);
+    pool.ParallelFor(hits.size(), [&](size_t i) { hits[i]++; });
+
+    for (size_t i = 0; i < hits.size(); ++i) {
+        EXPECT_EQ(1, hits[i].load()) << "index " << i;
+    }
+}
+
+TEST(WorkerPoolTest, PoolWithoutWorkersRunsOnCaller) {
+    WorkerPool pool(0);
+    const auto caller = std::this_thread::get_id();
+
+    size_t calls = 0;
+    pool.ParallelFor(10, [&](size_t) {
+        EXPECT_EQ(caller, std::this_thread::get_id());
+        ++calls;
+    });
+
+    EXPECT_EQ(10u, calls);
+}
+
+TEST(WorkerPoolTest, NestedLoopsComplete) {
+    WorkerPool pool(2);
+    std::atomic<size_t> total{0};
+
+    pool.ParallelFor(8, [&](size_t) {
+        pool.ParallelFor(8, [&](size_t) { total++; });
+    });
+
+    EXPECT_EQ(64u, total.load());
+}
+
+TEST(WorkerPoolTest, RethrowsTaskExceptionAfterLoop) {
+    WorkerPool pool(2);
+    std::atomic<size_t> completed{0};
+
+    EXPECT_THROW(pool.ParallelFor(100, [&](size_t i) {
+        if (i == 17) {
+            throw std::runtime_error("task failed");
+        }
+        completed++;
+    }), std::runtime_error);
+    EXPECT_EQ(99u, completed.load());
+
+    // The pool stays usable
+    completed = 0;
+    pool.ParallelFor(10, [&](size_t) { completed++; });
+    EXPECT_EQ(10u, completed.load());
+}
+
+TEST(WorkerPoolTest, ConcurrentCallersShareWorkers) {
+    WorkerPool pool(2);
+    std::atomic<size_t> total{0};
+
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 4; ++t) {
+        callers.emplace_back([&]() {
+            for (int round = 0; round < 20; ++round) {
+                pool.ParallelFor(50, [&](size_t) { total++; });
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    EXPECT_EQ(4u * 20u * 50u, total.load());
+}
+
+} // namespace
+} // namespace dpan
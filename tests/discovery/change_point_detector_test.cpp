@@ -0,0 +1,116 @@
+// File: tests/discovery/change_point_detector_test.cpp
+#include "discovery/change_point_detector.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace dpan {
+namespace {
+
+/// Gaussian noise with a given mean and deviation
+std::vector<float> Noise(size_t count, float mean, float stddev, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> value(mean, stddev);
+    std::vector<float> samples(count);
+    for (auto& sample : samples) {
+        sample = value(rng);
+    }
+    return samples;
+}
+
+/// Indices of the selected windows of size window, hop window / 2
+std::vector<size_t> SelectedWindows(ChangePointDetector& detector,
+                                    const std::vector<float>& samples, size_t window) {
+    std::vector<size_t> selected;
+    const size_t hop = window / 2;
+    for (size_t k = 0; k * hop + window <= samples.size(); ++k) {
+        if (detector.Update(samples.data() + k * hop, window)) {
+            selected.push_back(k);
+        }
+    }
+    return selected;
+}
+
+TEST(ChangePointDetectorTest, RejectsInvalidConfig) {
+    ChangePointDetector::Config config;
+    config.threshold = 0.0f;
+    EXPECT_THROW(ChangePointDetector detector(config), std::invalid_argument);
+
+    config.threshold = 4.0f;
+    config.drift = -0.1f;
+    EXPECT_THROW(ChangePointDetector detector(config), std::invalid_argument);
+
+    config.drift = 0.5f;
+    config.min_scale = 0.0f;
+    EXPECT_THROW(ChangePointDetector detector(config), std::invalid_argument);
+}
+
+TEST(ChangePointDetectorTest, StationarySignalOnlyHeartbeats) {
+    ChangePointDetector::Config config;
+    config.max_interval = 25;
+    ChangePointDetector detector(config);
+
+    auto samples = Noise(199 * 50 + 100, 3.0f, 0.5f, 1);
+    auto selected = SelectedWindows(detector, samples, 100);
+
+    EXPECT_EQ(200u, detector.GetWindowsSeen());
+    ASSERT_EQ(8u, selected.size());
+    for (size_t i = 0; i < selected.size(); ++i) {
+        EXPECT_EQ(i * 25, selected[i]);
+    }
+}
+
+TEST(ChangePointDetectorTest, MeanAndScaleShiftsAreSelectedPromptly) {
+    ChangePointDetector::Config config;
+    config.max_interval = 0;  // No heartbeat: every selection is a change
+    ChangePointDetector detector(config);
+
+    // Level shift at sample 4000, variance change at sample 8000
+    auto samples = Noise(12000, 0.0f, 1.0f, 2);
+    for (size_t i = 4000; i < samples.size(); ++i) {
+        samples[i] += 3.0f;
+    }
+    for (size_t i = 8000; i < samples.size(); ++i) {
+        samples[i] = 3.0f + (samples[i] - 3.0f) * 6.0f;
+    }
+    auto selected = SelectedWindows(detector, samples, 200);
+
+    // Windows 39-40 and 79-80 straddle the changes; a straddling window may
+    // be selected before the first window past the change
+    ASSERT_FALSE(selected.empty());
+    EXPECT_EQ(0u, selected[0]);
+    size_t near_level = 0;
+    size_t near_scale = 0;
+    for (size_t k : selected) {
+        if (k >= 38 && k <= 43) {
+            ++near_level;
+        } else if (k >= 78 && k <= 83) {
+            ++near_scale;
+        } else {
+            EXPECT_EQ(0u, k) << "selected window " << k << " far from a change";
+        }
+    }
+    EXPECT_GE(near_level, 1u);
+    EXPECT_LE(near_level, 2u);
+    EXPECT_GE(near_scale, 1u);
+    EXPECT_LE(near_scale, 2u);
+}
+
+TEST(ChangePointDetectorTest, NonFiniteWindowsAreSelected) {
+    ChangePointDetector detector(ChangePointDetector::Config{});
+    EXPECT_TRUE(detector.Update(1.0, 0.5));
+    EXPECT_FALSE(detector.Update(1.0, 0.5));
+    EXPECT_TRUE(detector.Update(std::numeric_limits<double>::quiet_NaN(), 0.5));
+    EXPECT_TRUE(detector.Update(1.0, 0.5));  // New reference after NaN
+    EXPECT_FALSE(detector.Update(1.0, 0.5));
+
+    detector.Reset();
+    EXPECT_EQ(0u, detector.GetWindowsSeen());
+    EXPECT_TRUE(detector.Update(5.0, 0.5));
+    EXPECT_EQ(1u, detector.GetWindowsSelected());
+}
+
+} // namespace
+} // namespace dpan
@@ -0,0 +1,120 @@
+// File: tests/discovery/content_hash_index_test.cpp
+#include "discovery/content_hash_index.hpp"
+#include "discovery/pattern_creator.hpp"
+#include "discovery/pattern_matcher.hpp"
+#include "similarity/contextual_similarity.hpp"
+#include "storage/memory_backend.hpp"
+#include <gtest/gtest.h>
+#include <cstring>
+
+namespace dpan {
+namespace {
+
+PatternData MakeData(std::vector<float> values) {
+    return PatternData::FromFeatures(FeatureVector(std::move(values)), DataModality::NUMERIC);
+}
+
+TEST(ContentHashIndexTest, AddLookupRemove) {
+    ContentHashIndex index;
+    index.Add(PatternID(1), MakeData({1.0f, 2.0f}));
+    index.Add(PatternID(2), MakeData({1.0f, 2.0f}));
+    index.Add(PatternID(3), MakeData({3.0f}));
+
+    auto ids = index.Lookup(MakeData({1.0f, 2.0f}));
+    EXPECT_EQ(2u, ids.size());
+    EXPECT_TRUE(index.Lookup(MakeData({9.0f})).empty());
+
+    // Re-adding with new data moves the entry
+    index.Add(PatternID(2), MakeData({9.0f}));
+    EXPECT_EQ(1u, index.Lookup(MakeData({1.0f, 2.0f})).size());
+    EXPECT_EQ(1u, index.Lookup(MakeData({9.0f})).size());
+    EXPECT_EQ(3u, index.Size());
+
+    EXPECT_TRUE(index.Remove(PatternID(1)));
+    EXPECT_FALSE(index.Remove(PatternID(1)));
+    EXPECT_TRUE(index.Lookup(MakeData({1.0f, 2.0f})).empty());
+}
+
+TEST(ContentHashIndexTest, SourceHashSeparatesIdenticalData) {
+    ContentHashIndex index;
+    uint64_t source_a = ContentHashIndex::SourceHash({'a', 'b'});
+    uint64_t source_b = ContentHashIndex::SourceHash({'b', 'a'});
+    ASSERT_NE(source_a, source_b);
+
+    index.Add(PatternID(1), MakeData({0.5f, 0.5f}), source_a);
+
+    ASSERT_EQ(1u, index.Lookup(MakeData({0.5f, 0.5f}), source_a).size());
+    EXPECT_TRUE(index.Lookup(MakeData({0.5f, 0.5f}), source_b).empty());
+    EXPECT_TRUE(index.Lookup(MakeData({0.5f, 0.5f})).empty());
+}
+
+TEST(ContentHashIndexTest, SourceHashOfViewsCoversPayloadOnly) {
+    std::vector<float> samples = {1.0f, -2.0f, 3.5f};
+    std::vector<uint8_t> bytes(samples.size() * sizeof(float));
+    std::memcpy(bytes.data(), samples.data(), bytes.size());
+    EXPECT_EQ(ContentHashIndex::SourceHash(bytes),
+              ContentHashIndex::SourceHash(InputView::Floats(samples.data(), samples.size())));
+
+    // Row padding is not part of an image
+    std::vector<uint8_t> packed = {1, 2, 3, 4, 5, 6};
+    std::vector<uint8_t> padded = {1, 2, 3, 0, 4, 5, 6, 9};
+    EXPECT_EQ(ContentHashIndex::SourceHash(InputView::Image(packed.data(), 3, 2)),
+              ContentHashIndex::SourceHash(InputView::Image(padded.data(), 3, 2, 4)));
+    EXPECT_EQ(ContentHashIndex::SourceHash(packed),
+              ContentHashIndex::SourceHash(InputView::Image(padded.data(), 3, 2, 4)));
+}
+
+TEST(ContentHashIndexTest, RebuildIndexesDatabase) {
+    auto db = std::make_shared<MemoryBackend>(MemoryBackend::Config{});
+    for (uint64_t id = 1; id <= 150; ++id) {
+        db->Store(PatternNode(PatternID(id), MakeData({static_cast<float>(id)}), PatternType::ATOMIC));
+    }
+
+    ContentHashIndex index;
+    index.Rebuild(*db);
+    EXPECT_EQ(150u, index.Size());
+    ASSERT_EQ(1u, index.Lookup(MakeData({120.0f})).size());
+    EXPECT_EQ(PatternID(120), index.Lookup(MakeData({120.0f}))[0]);
+}
+
+TEST(ContentHashIndexTest, MatcherFindsDuplicatesAndRepairsStaleEntries) {
+    auto db = std::make_shared<MemoryBackend>(MemoryBackend::Config{});
+    auto index = std::make_shared<ContentHashIndex>();
+
+    PatternCreator creator(db);
+    creator.SetContentIndex(index);
+    PatternMatcher matcher(db, std::make_shared<ContextVectorSimilarity>());
+
+    PatternID id = creator.CreatePattern(MakeData({1.0f, 2.0f, 3.0f}));
+    EXPECT_FALSE(matcher.FindExactDuplicate(MakeData({1.0f, 2.0f, 3.0f})).has_value());
+
+    matcher.SetContentIndex(index);
+    auto duplicate = matcher.FindExactDuplicate(MakeData({1.0f, 2.0f, 3.0f}));
+    ASSERT_TRUE(duplicate.has_value());
+    EXPECT_EQ(id, duplicate->id);
+    EXPECT_FLOAT_EQ(1.0f, duplicate->similarity);
+    EXPECT_FALSE(matcher.FindExactDuplicate(MakeData({1.0f, 2.0f, 4.0f})).has_value());
+
+    // Changed directly in the database: the entry is corrected on lookup
+    db->Update(PatternNode(id, MakeData({7.0f}), PatternType::ATOMIC));
+    EXPECT_FALSE(matcher.FindExactDuplicate(MakeData({1.0f, 2.0f, 3.0f})).has_value());
+    EXPECT_TRUE(index->Lookup(MakeData({1.0f, 2.0f, 3.0f})).empty());
+    EXPECT_TRUE(matcher.FindExactDuplicate(MakeData({7.0f})).has_value());
+
+    // Deleted directly in the database
+    db->Delete(id);
+    EXPECT_FALSE(matcher.FindExactDuplicate(MakeData({7.0f})).has_value());
+    EXPECT_EQ(0u, index->Size());
+
+    // An entry keyed on its source keeps that source when corrected
+    const uint64_t source = ContentHashIndex::SourceHash({'x', 'y'});
+    PatternID sourced = creator.CreatePattern(MakeData({5.0f}));
+    index->Add(sourced, MakeData({5.0f}), source);
+    db->Update(PatternNode(sourced, MakeData({6.0f}), PatternType::ATOMIC));
+    EXPECT_FALSE(matcher.FindExactDuplicate(MakeData({5.0f}), source).has_value());
+    EXPECT_FALSE(matcher.FindExactDuplicate(MakeData({6.0f})).has_value());
+    EXPECT_TRUE(matcher.FindExactDuplicate(MakeData({6.0f}), source).has_value());
+}
+
+} // namespace
+} // namespace dpan
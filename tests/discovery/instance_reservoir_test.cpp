@@ -0,0 +1,151 @@
+// File: tests/discovery/instance_reservoir_test.cpp
+#include "discovery/instance_reservoir.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace dpan {
+namespace {
+
+FeatureVector Instance(float a, float b) {
+    return FeatureVector(std::vector<float>{a, b});
+}
+
+TEST(InstanceReservoirTest, RejectsZeroCapacity) {
+    InstanceReservoir::Config config;
+    config.capacity = 0;
+    EXPECT_THROW(InstanceReservoir reservoir(config), std::invalid_argument);
+}
+
+TEST(InstanceReservoirTest, SummaryCoversEveryInstance) {
+    InstanceReservoir::Config config;
+    config.capacity = 4;
+    InstanceReservoir reservoir(config);
+
+    std::mt19937 rng(1);
+    std::normal_distribution<float> value(3.0f, 2.0f);
+    std::vector<std::vector<float>> all;
+    for (size_t i = 0; i < 500; ++i) {
+        all.push_back({value(rng), value(rng)});
+        ASSERT_TRUE(reservoir.Add(PatternID(7), FeatureVector(all.back())));
+    }
+
+    double mean[2] = {0.0, 0.0};
+    for (const auto& v : all) {
+        mean[0] += v[0] / all.size();
+        mean[1] += v[1] / all.size();
+    }
+    double variance = 0.0;
+    for (const auto& v : all) {
+        variance += ((v[0] - mean[0]) * (v[0] - mean[0]) +
+                     (v[1] - mean[1]) * (v[1] - mean[1])) / all.size();
+    }
+
+    auto summary = reservoir.GetSummary(PatternID(7));
+    ASSERT_TRUE(summary.has_value());
+    EXPECT_EQ(500u, summary->count);
+    EXPECT_NEAR(mean[0], summary->mean[0], 1e-4);
+    EXPECT_NEAR(mean[1], summary->mean[1], 1e-4);
+    EXPECT_NEAR(variance, summary->variance, 1e-3);
+
+    // The sample is bounded and drawn from the recorded instances
+    auto sample = reservoir.GetInstances(PatternID(7));
+    ASSERT_EQ(4u, sample.size());
+    for (const auto& instance : sample) {
+        bool found = false;
+        for (const auto& v : all) {
+            found = found || (v[0] == instance[0] && v[1] == instance[1]);
+        }
+        EXPECT_TRUE(found);
+    }
+}
+
+TEST(InstanceReservoirTest, SampleIsUniformOverTheStream) {
+    // Over many patterns, every stream position is kept equally often
+    InstanceReservoir::Config config;
+    config.capacity = 5;
+    InstanceReservoir reservoir(config);
+
+    const size_t patterns = 2000;
+    const size_t stream = 50;
+    for (size_t p = 1; p <= patterns; ++p) {
+        for (size_t i = 0; i < stream; ++i) {
+            reservoir.Add(PatternID(p), Instance(static_cast<float>(i), 0.0f));
+        }
+    }
+
+    std::vector<size_t> kept(stream, 0);
+    for (size_t p = 1; p <= patterns; ++p) {
+        for (const auto& instance : reservoir.GetInstances(PatternID(p))) {
+            ++kept[static_cast<size_t>(instance[0])];
+        }
+    }
+
+    // Expected 2000 * 5 / 50 = 200 per position
+    for (size_t i = 0; i < stream; ++i) {
+        EXPECT_GT(kept[i], 140u) << "position " << i;
+        EXPECT_LT(kept[i], 260u) << "position " << i;
+    }
+}
+
+TEST(InstanceReservoirTest, MemoryIsBoundedPerPattern) {
+    InstanceReservoir::Config config;
+    config.capacity = 8;
+    InstanceReservoir reservoir(config);
+
+    for (size_t i = 0; i < 8; ++i) {
+        reservoir.Add(PatternID(1), Instance(1.0f, static_cast<float>(i)));
+    }
+    size_t bytes = reservoir.GetMemoryBytes();
+    for (size_t i = 0; i < 10000; ++i) {
+        reservoir.Add(PatternID(1), Instance(2.0f, static_cast<float>(i)));
+    }
+    EXPECT_EQ(bytes, reservoir.GetMemoryBytes());
+    EXPECT_EQ(8u, reservoir.GetInstances(PatternID(1)).size());
+}
+
+TEST(InstanceReservoirTest, MemoryTotalFollowsAddAndRemove) {
+    InstanceReservoir::Config config;
+    config.capacity = 4;
+    InstanceReservoir reservoir(config);
+    EXPECT_EQ(0u, reservoir.GetMemoryBytes());
+
+    reservoir.Add(PatternID(1), Instance(1.0f, 2.0f));
+    size_t one = reservoir.GetMemoryBytes();
+    EXPECT_GE(one, 4u * 2u * sizeof(float) + 2u * sizeof(double));
+
+    for (size_t i = 0; i < 20; ++i) {
+        reservoir.Add(PatternID(2), Instance(static_cast<float>(i), 0.0f));
+    }
+    EXPECT_EQ(2u * one, reservoir.GetMemoryBytes());
+
+    reservoir.Remove(PatternID(1));
+    reservoir.Remove(PatternID(3));
+    EXPECT_EQ(one, reservoir.GetMemoryBytes());
+    reservoir.Clear();
+    EXPECT_EQ(0u, reservoir.GetMemoryBytes());
+}
+
+TEST(InstanceReservoirTest, RejectsMismatchedOrNonFiniteInstances) {
+    InstanceReservoir reservoir(InstanceReservoir::Config{});
+    EXPECT_FALSE(reservoir.Add(PatternID(1), FeatureVector(std::vector<float>{})));
+    EXPECT_FALSE(reservoir.Add(PatternID(1),
+                               Instance(std::numeric_limits<float>::quiet_NaN(), 1.0f)));
+    EXPECT_EQ(0u, reservoir.Size());
+
+    EXPECT_TRUE(reservoir.Add(PatternID(1), Instance(1.0f, 2.0f)));
+    EXPECT_FALSE(reservoir.Add(PatternID(1), FeatureVector(std::vector<float>{1.0f, 2.0f, 3.0f})));
+    EXPECT_EQ(1u, reservoir.GetSummary(PatternID(1))->count);
+
+    reservoir.Add(PatternID(2), Instance(0.0f, 0.0f));
+    EXPECT_EQ(2u, reservoir.Size());
+    reservoir.Remove(PatternID(1));
+    EXPECT_FALSE(reservoir.GetSummary(PatternID(1)).has_value());
+    EXPECT_TRUE(reservoir.GetInstances(PatternID(1)).empty());
+    reservoir.Clear();
+    EXPECT_EQ(0u, reservoir.Size());
+}
+
+} // namespace
+} // namespace dpan
@@ -0,0 +1,161 @@
+// File: tests/discovery/merge_candidate_index_test.cpp
+#include "discovery/merge_candidate_index.hpp"
+#include "storage/memory_backend.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+namespace dpan {
+namespace {
+
+FeatureVector Point(float x, float y, float z) {
+    return FeatureVector(std::vector<float>{x, y, z});
+}
+
+TEST(MergeCandidateIndexTest, RejectsInvalidConfig) {
+    MergeCandidateIndex::Config config;
+    config.num_projections = 0;
+    EXPECT_THROW(MergeCandidateIndex index(config), std::invalid_argument);
+}
+
+TEST(MergeCandidateIndexTest, NeighborsAreNearestFirstWithEuclideanSimilarity) {
+    MergeCandidateIndex index{MergeCandidateIndex::Config()};
+    index.Upsert(PatternID(1), PatternType::ATOMIC, Point(1.0f, 2.0f, 3.0f));
+    index.Upsert(PatternID(2), PatternType::ATOMIC, Point(1.0f, 2.0f, 3.5f));
+    index.Upsert(PatternID(3), PatternType::ATOMIC, Point(1.0f, 2.1f, 3.0f));
+    index.Upsert(PatternID(4), PatternType::ATOMIC, Point(-5.0f, 4.0f, -1.0f));
+
+    auto neighbors = index.Neighbors(PatternID(1), 2, 0.0f);
+    ASSERT_EQ(2u, neighbors.size());
+    EXPECT_EQ(PatternID(3), neighbors[0].id);
+    EXPECT_NEAR(1.0f / 1.1f, neighbors[0].similarity, 1e-5f);
+    EXPECT_EQ(PatternID(2), neighbors[1].id);
+    EXPECT_NEAR(1.0f / 1.5f, neighbors[1].similarity, 1e-5f);
+
+    // Threshold drops the farther one; unknown IDs have no neighbors
+    EXPECT_EQ(1u, index.Neighbors(PatternID(1), 8, 0.8f).size());
+    EXPECT_TRUE(index.Neighbors(PatternID(99), 8, 0.0f).empty());
+}
+
+TEST(MergeCandidateIndexTest, OnlySameTypeAndDimensionAreNeighbors) {
+    MergeCandidateIndex index{MergeCandidateIndex::Config()};
+    index.Upsert(PatternID(1), PatternType::ATOMIC, Point(1.0f, 1.0f, 1.0f));
+    index.Upsert(PatternID(2), PatternType::COMPOSITE, Point(1.0f, 1.0f, 1.0f));
+    index.Upsert(PatternID(3), PatternType::ATOMIC,
+                 FeatureVector(std::vector<float>{1.0f, 1.0f, 1.0f, 1.0f}));
+    index.Upsert(PatternID(4), PatternType::ATOMIC, Point(2.0f, 2.0f, 2.0f));
+
+    auto neighbors = index.Neighbors(PatternID(1), 8, 0.0f);
+    ASSERT_EQ(1u, neighbors.size());
+    EXPECT_EQ(PatternID(4), neighbors[0].id);
+}
+
+TEST(MergeCandidateIndexTest, UpsertReplacesAndRemoveDrops) {
+    MergeCandidateIndex index{MergeCandidateIndex::Config()};
+    index.Upsert(PatternID(1), PatternType::ATOMIC, Point(1.0f, 1.0f, 1.0f));
+    index.Upsert(PatternID(2), PatternType::ATOMIC, Point(9.0f, 9.0f, 9.0f));
+    index.Upsert(PatternID(2), PatternType::ATOMIC, Point(1.0f, 1.0f, 1.0f));
+    EXPECT_EQ(2u, index.Size());
+    ASSERT_EQ(1u, index.Neighbors(PatternID(1), 1, 0.0f).size());
+    EXPECT_FLOAT_EQ(1.0f, index.Neighbors(PatternID(1), 1, 0.0f)[0].similarity);
+
+    EXPECT_TRUE(index.Remove(PatternID(2)));
+    EXPECT_FALSE(index.Remove(PatternID(2)));
+    EXPECT_FALSE(index.Contains(PatternID(2)));
+    EXPECT_TRUE(index.Neighbors(PatternID(1), 1, 0.0f).empty());
+}
+
+TEST(MergeCandidateIndexTest, FindsNearDuplicatesAmongManyPatterns) {
+    std::mt19937 rng(7);
+    std::normal_distribution<float> value(0.0f, 5.0f);
+    std::normal_distribution<float> jitter(0.0f, 0.01f);
+
+    MergeCandidateIndex index{MergeCandidateIndex::Config()};
+    const size_t pairs = 500;
+    for (size_t i = 0; i < pairs; ++i) {
+        std::vector<float> a(16);
+        std::vector<float> b(16);
+        for (size_t d = 0; d < a.size(); ++d) {
+            a[d] = value(rng);
+            b[d] = a[d] + jitter(rng);
+        }
+        index.Upsert(PatternID(2 * i + 1), PatternType::ATOMIC, FeatureVector(a));
+        index.Upsert(PatternID(2 * i + 2), PatternType::ATOMIC, FeatureVector(b));
+    }
+
+    size_t found = 0;
+    for (size_t i = 0; i < pairs; ++i) {
+        auto neighbors = index.Neighbors(PatternID(2 * i + 1), 1, 0.9f);
+        if (!neighbors.empty() && neighbors[0].id == PatternID(2 * i + 2)) {
+            ++found;
+        }
+    }
+    EXPECT_EQ(pairs, found);
+}
+
+TEST(MergeCandidateIndexTest, ThresholdQueriesMatchBruteForce) {
+    // Collinear patterns differ only in magnitude; a random spread around them
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> offset(-0.05f, 0.05f);
+    std::vector<std::vector<float>> points;
+    for (size_t i = 0; i < 400; ++i) {
+        float t = static_cast<float>(i / 2) * 0.03f;
+        points.push_back({t, 2.0f * t + offset(rng), 1.0f + offset(rng), -t});
+    }
+
+    MergeCandidateIndex index{MergeCandidateIndex::Config()};
+    for (size_t i = 0; i < points.size(); ++i) {
+        index.Upsert(PatternID(i + 1), PatternType::ATOMIC, FeatureVector(points[i]));
+    }
+
+    const float threshold = 0.9f;
+    for (size_t i = 0; i < points.size(); i += 7) {
+        size_t expected = 0;
+        for (size_t j = 0; j < points.size(); ++j) {
+            float sum = 0.0f;
+            for (size_t d = 0; d < points[i].size(); ++d) {
+                float diff = points[i][d] - points[j][d];
+                sum += diff * diff;
+            }
+            if (j != i && 1.0f / (1.0f + std::sqrt(sum)) >= threshold) {
+                ++expected;
+            }
+        }
+        auto neighbors = index.Neighbors(PatternID(i + 1), points.size(), threshold);
+        EXPECT_EQ(expected, neighbors.size()) << "pattern " << i;
+        for (size_t n = 1; n < neighbors.size(); ++n) {
+            EXPECT_GE(neighbors[n - 1].similarity, neighbors[n].similarity);
+        }
+    }
+}
+
+TEST(MergeCandidateIndexTest, NonFiniteFeaturesAreNotIndexed) {
+    MergeCandidateIndex index{MergeCandidateIndex::Config()};
+    index.Upsert(PatternID(1), PatternType::ATOMIC, Point(1.0f, 1.0f, 1.0f));
+    index.Upsert(PatternID(1), PatternType::ATOMIC, Point(1.0f, NAN, 1.0f));
+    EXPECT_FALSE(index.Contains(PatternID(1)));
+    EXPECT_EQ(0u, index.Size());
+}
+
+TEST(MergeCandidateIndexTest, RebuildIndexesWholeDatabase) {
+    auto database = std::make_shared<MemoryBackend>(MemoryBackend::Config());
+    for (uint64_t i = 1; i <= 150; ++i) {
+        PatternNode node(PatternID(i),
+                         PatternData::FromFeatures(Point(static_cast<float>(i), 0.0f, 1.0f),
+                                                   DataModality::NUMERIC),
+                         PatternType::ATOMIC);
+        database->Store(node);
+    }
+
+    MergeCandidateIndex index{MergeCandidateIndex::Config()};
+    index.Upsert(PatternID(999), PatternType::ATOMIC, Point(0.0f, 0.0f, 0.0f));
+    auto indexed = index.Rebuild(*database);
+
+    EXPECT_EQ(150u, indexed.size());
+    EXPECT_EQ(150u, index.Size());
+    EXPECT_FALSE(index.Contains(PatternID(999)));
+    EXPECT_GT(index.GetMemoryBytes(), 150u * 3u * sizeof(float));
+}
+
+} // namespace
+} // namespace dpan
@@ -60,6 +60,38 @@ TEST(PatternCreatorTest, CreatePatternSetsInitialConfidence) {
     EXPECT_FLOAT_EQ(0.75f, node_opt->GetConfidenceScore());
 }
 
+TEST(PatternCreatorTest, CreatePatternsBatchStoresAllWithConfidences) {
+    auto db = CreateTestDatabase();
+    PatternCreator creator(db);
+
+    // More than one default query page of existing patterns
+    for (int i = 0; i < 150; ++i) {
+        creator.CreatePattern(PatternData::FromFeatures(
+            FeatureVector(std::vector<float>{static_cast<float>(i)}), DataModality::NUMERIC));
+    }
+
+    std::vector<PatternData> data;
+    std::vector<float> confidences;
+    for (int i = 0; i < 5; ++i) {
+        data.push_back(PatternData::FromFeatures(
+            FeatureVector({static_cast<float>(i), 1.0f}), DataModality::NUMERIC));
+        confidences.push_back(0.1f * (i + 1));
+    }
+
+    auto ids = creator.CreatePatternsBatch(data, confidences);
+    ASSERT_EQ(5u, ids.size());
+    EXPECT_EQ(155u, db->Count());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        auto node = db->Retrieve(ids[i]);
+        ASSERT_TRUE(node.has_value());
+        EXPECT_EQ(data[i], node->GetData());
+        EXPECT_FLOAT_EQ(confidences[i], node->GetConfidenceScore());
+    }
+
+    EXPECT_THROW(creator.CreatePatternsBatch(data, {0.5f}), std::invalid_argument);
+    EXPECT_TRUE(creator.CreatePatternsBatch({}, {}).empty());
+}
+
 TEST(PatternCreatorTest, CreatePatternRejectsInvalidConfidence) {
     auto db = CreateTestDatabase();
     PatternCreator creator(db);
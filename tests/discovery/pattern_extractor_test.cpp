@@ -1,8 +1,10 @@
 // File: tests/discovery/pattern_extractor_test.cpp
 #include "discovery/pattern_extractor.hpp"
+#include "discovery/spectral_extractor.hpp"
 #include <gtest/gtest.h>
 #include <cmath>
 #include <cstring>
+#include <random>
 
 namespace dpan {
 namespace {
@@ -352,5 +354,476 @@ TEST(PatternExtractorTest, FeatureDimensionIsRespected) {
     EXPECT_EQ(64u, features.Dimension());
 }
 
+// ============================================================================
+// Rolling Feature Tests
+// ============================================================================
+
+/// Extract with and without rolling features and compare every feature
+void ExpectRollingMatchesDirect(PatternExtractor::Config config,
+                                const std::vector<float>& values,
+                                float relative_tolerance = 1e-4f) {
+    config.rolling_features = false;
+    PatternExtractor direct(config);
+    config.rolling_features = true;
+    PatternExtractor rolling(config);
+
+    auto raw_data = CreateNumericData(values);
+    auto expected = direct.Extract(raw_data);
+    auto actual = rolling.Extract(raw_data);
+
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const auto& a = expected[i].GetFeatures();
+        const auto& b = actual[i].GetFeatures();
+        ASSERT_EQ(a.Dimension(), b.Dimension());
+        for (size_t d = 0; d < a.Dimension(); ++d) {
+            float tolerance = relative_tolerance * std::max(1.0f, std::abs(a[d]));
+            EXPECT_NEAR(a[d], b[d], tolerance) << "window " << i << " feature " << d;
+        }
+    }
+}
+
+TEST(PatternExtractorTest, RollingFeaturesMatchDirectComputation) {
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0.0f, 0.5f);
+    std::vector<float> values(3000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = std::sin(static_cast<float>(i) * 0.02f) + noise(rng);
+    }
+
+    PatternExtractor::Config config;
+    config.modality = DataModality::NUMERIC;
+    config.max_pattern_size = 800;
+    config.feature_dimension = 128;
+    ExpectRollingMatchesDirect(config, values);
+
+    // Fewer features than the base statistics, and odd window sizes
+    config.feature_dimension = 7;
+    config.max_pattern_size = 404;
+    ExpectRollingMatchesDirect(config, values);
+
+    config.modality = DataModality::AUDIO;
+    config.feature_dimension = 32;
+    config.max_pattern_size = 1000;
+    ExpectRollingMatchesDirect(config, values);
+}
+
+TEST(PatternExtractorTest, RollingFeaturesHandleOffsetsAndFlatSegments) {
+    // Large DC offset, then a constant run, then a ramp
+    std::vector<float> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(500.0f + std::sin(i * 0.3f));
+    }
+    values.insert(values.end(), 600, 2.5f);
+    for (int i = 0; i < 600; ++i) {
+        values.push_back(static_cast<float>(i) * 0.01f - 3.0f);
+    }
+
+    PatternExtractor::Config config;
+    config.modality = DataModality::NUMERIC;
+    config.max_pattern_size = 400;
+    config.feature_dimension = 24;
+
+    // The direct path accumulates in float, so its skewness carries errors
+    // of about float epsilon * offset / std_dev
+    ExpectRollingMatchesDirect(config, values, 2e-3f);
+}
+
+// ============================================================================
+// Typed Input Tests
+// ============================================================================
+
+void ExpectSameFeatures(const std::vector<PatternData>& expected,
+                        const std::vector<PatternData>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].GetModality(), actual[i].GetModality());
+        const auto& a = expected[i].GetFeatures();
+        const auto& b = actual[i].GetFeatures();
+        ASSERT_EQ(a.Dimension(), b.Dimension());
+        for (size_t d = 0; d < a.Dimension(); ++d) {
+            EXPECT_FLOAT_EQ(a[d], b[d]) << "window " << i << " feature " << d;
+        }
+    }
+}
+
+TEST(PatternExtractorTest, FloatViewMatchesFloatBytes) {
+    std::vector<float> values(600);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = std::sin(static_cast<float>(i) * 0.1f) * 2.0f;
+    }
+    auto raw_data = CreateNumericData(values);
+
+    for (DataModality modality : {DataModality::NUMERIC, DataModality::AUDIO}) {
+        PatternExtractor::Config config;
+        config.modality = modality;
+        config.max_pattern_size = 400;
+        PatternExtractor extractor(config);
+
+        auto from_bytes = extractor.Extract(raw_data);
+        auto from_view = extractor.Extract(InputView::Floats(values.data(), values.size(), modality));
+        EXPECT_FALSE(from_bytes.empty());
+        ExpectSameFeatures(from_bytes, from_view);
+    }
+}
+
+TEST(PatternExtractorTest, Pcm16ViewMatchesDecodedFloats) {
+    std::vector<int16_t> pcm(800);
+    std::vector<float> decoded(pcm.size());
+    for (size_t i = 0; i < pcm.size(); ++i) {
+        pcm[i] = static_cast<int16_t>(20000.0f * std::sin(static_cast<float>(i) * 0.05f));
+        decoded[i] = static_cast<float>(pcm[i]) / 32768.0f;
+    }
+
+    PatternExtractor::Config config;
+    config.modality = DataModality::AUDIO;
+    config.max_pattern_size = 512;
+    PatternExtractor extractor(config);
+
+    auto from_pcm = extractor.Extract(InputView::Pcm16(pcm.data(), pcm.size()));
+    auto from_floats = extractor.Extract(
+        InputView::Floats(decoded.data(), decoded.size(), DataModality::AUDIO));
+    EXPECT_FALSE(from_pcm.empty());
+    ExpectSameFeatures(from_floats, from_pcm);
+}
+
+TEST(PatternExtractorTest, ImageViewSkipsRowPadding) {
+    const size_t width = 30;
+    const size_t height = 20;
+    const size_t stride = 32;
+    std::vector<uint8_t> packed(width * height);
+    std::vector<uint8_t> padded(stride * height, 255);
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            uint8_t pixel = static_cast<uint8_t>((x * 7 + y * 13) % 256);
+            packed[y * width + x] = pixel;
+            padded[y * stride + x] = pixel;
+        }
+    }
+
+    PatternExtractor::Config config;
+    config.modality = DataModality::IMAGE;
+    config.max_pattern_size = 100;
+    PatternExtractor extractor(config);
+
+    auto from_packed = extractor.Extract(InputView::Image(packed.data(), width, height));
+    auto from_padded = extractor.Extract(InputView::Image(padded.data(), width, height, stride));
+    EXPECT_EQ(15u, from_packed.size());  // 10 x 10 tiles, 5-pixel step: 5 x 3
+    ExpectSameFeatures(from_packed, from_padded);
+    EXPECT_EQ(DataModality::IMAGE, from_padded.front().GetModality());
+
+    EXPECT_THROW(InputView::Image(padded.data(), width, height, width - 1), std::invalid_argument);
+}
+
+TEST(PatternExtractorTest, ImageBytesWithWidthAreTiledIn2D) {
+    const size_t width = 40;
+    const size_t height = 24;
+    std::vector<uint8_t> pixels(width * height * 3);
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        pixels[i] = static_cast<uint8_t>((i * 31) % 251);
+    }
+
+    PatternExtractor::Config config;
+    config.modality = DataModality::IMAGE;
+    config.max_pattern_size = 64;  // 8 x 8 tiles
+    config.image_width = width;
+    config.image_channels = 3;
+    config.image_pyramid_levels = 2;
+    PatternExtractor extractor(config);
+
+    auto from_bytes = extractor.Extract(pixels);
+    auto from_view = extractor.Extract(
+        InputView::Image(pixels.data(), width, height, 0, 3));
+
+    // Level 0: 9 x 5 tiles of 8 px; level 1: 4 x 2 tiles of 16 px
+    EXPECT_EQ(53u, from_bytes.size());
+    ExpectSameFeatures(from_view, from_bytes);
+}
+
+TEST(PatternExtractorTest, TypedTextViewIsRejected) {
+    PatternExtractor::Config config;
+    config.modality = DataModality::TEXT;
+    PatternExtractor extractor(config);
+
+    std::vector<float> values(100, 1.0f);
+    EXPECT_THROW(extractor.Extract(InputView::Floats(values.data(), values.size(), DataModality::TEXT)),
+                 std::invalid_argument);
+}
+
+// ============================================================================
+// Parallel Extraction Tests
+// ============================================================================
+
+std::vector<float> MakeNoisySine(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 0.5f);
+    std::vector<float> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = std::sin(static_cast<float>(i) * 0.02f) + noise(rng);
+    }
+    return values;
+}
+
+TEST(PatternExtractorTest, ParallelExtractionIsIndependentOfThreadCount) {
+    auto raw_data = CreateNumericData(MakeNoisySine(20000, 5));
+
+    PatternExtractor::Config config;
+    config.max_pattern_size = 400;  // 100-sample windows: ~400-800 of them
+    config.parallel_min_windows = 64;
+    config.parallel_chunk_windows = 16;
+
+    for (DataModality modality : {DataModality::NUMERIC, DataModality::AUDIO,
+                                  DataModality::IMAGE, DataModality::TEXT}) {
+        config.modality = modality;
+        config.worker_pool = std::make_shared<WorkerPool>(0);
+        auto serial = PatternExtractor(config).Extract(raw_data);
+        config.worker_pool = std::make_shared<WorkerPool>(3);
+        auto parallel = PatternExtractor(config).Extract(raw_data);
+
+        EXPECT_GT(serial.size(), 64u);
+        ExpectSameFeatures(serial, parallel);
+    }
+}
+
+TEST(PatternExtractorTest, ParallelChunksMatchSerialWindows) {
+    auto raw_data = CreateNumericData(MakeNoisySine(12000, 9));
+
+    PatternExtractor::Config config;
+    config.modality = DataModality::AUDIO;
+    config.max_pattern_size = 256;
+    config.rolling_features = false;
+    config.parallel_min_windows = 0;
+    auto serial = PatternExtractor(config).Extract(raw_data);
+
+    config.parallel_min_windows = 32;
+    config.parallel_chunk_windows = 7;  // Chunks that do not divide the window count
+    config.worker_pool = std::make_shared<WorkerPool>(2);
+    auto parallel = PatternExtractor(config).Extract(raw_data);
+
+    ExpectSameFeatures(serial, parallel);
+}
+
+TEST(PatternExtractorTest, SmallInputsStaySerial) {
+    auto raw_data = CreateNumericData(MakeNoisySine(3000, 2));
+
+    // 59 windows: below the threshold the rolling pass covers the whole
+    // input at once, exactly as with parallel extraction disabled
+    PatternExtractor::Config config;
+    config.max_pattern_size = 400;
+    config.parallel_min_windows = 0;
+    auto serial = PatternExtractor(config).Extract(raw_data);
+
+    config.parallel_min_windows = 60;
+    config.parallel_chunk_windows = 4;
+    config.worker_pool = std::make_shared<WorkerPool>(2);
+    auto below_threshold = PatternExtractor(config).Extract(raw_data);
+
+    ASSERT_EQ(59u, serial.size());
+    for (size_t i = 0; i < serial.size(); ++i) {
+        EXPECT_EQ(serial[i].GetFeatures().Data(), below_threshold[i].GetFeatures().Data());
+    }
+}
+
+// ============================================================================
+// Hashed N-gram Text Tests
+// ============================================================================
+
+std::vector<uint8_t> TextBytes(const std::string& text) {
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+TEST(PatternExtractorTest, HashedNGramsRequireAnNGramSize) {
+    PatternExtractor::Config config;
+    config.text_features = PatternExtractor::TextFeatures::HASHED_NGRAMS;
+    config.char_ngram_size = 0;
+    config.word_ngram_size = 0;
+    EXPECT_THROW(PatternExtractor extractor(config), std::invalid_argument);
+}
+
+TEST(PatternExtractorTest, HashedNGramsDistinguishWordOrder) {
+    PatternExtractor::Config config;
+    config.modality = DataModality::TEXT;
+    config.min_pattern_size = 1;
+    config.feature_dimension = 64;
+    PatternExtractor histogram(config);
+
+    config.text_features = PatternExtractor::TextFeatures::HASHED_NGRAMS;
+    config.word_ngram_size = 2;
+    PatternExtractor hashed(config);
+
+    auto a = TextBytes("dog bites man");
+    auto b = TextBytes("man bites dog");
+    EXPECT_EQ(histogram.Extract(a)[0].GetFeatures().Data(),
+              histogram.Extract(b)[0].GetFeatures().Data());
+
+    auto fa = hashed.Extract(a)[0].GetFeatures();
+    auto fb = hashed.Extract(b)[0].GetFeatures();
+    EXPECT_NE(fa.Data(), fb.Data());
+    EXPECT_NEAR(1.0f, fa.Norm(), 1e-5f);
+
+    // Word n-grams ignore case
+    config.char_ngram_size = 0;
+    PatternExtractor words_only(config);
+    EXPECT_EQ(words_only.Extract(TextBytes("Dog Bites"))[0].GetFeatures().Data(),
+              words_only.Extract(TextBytes("dog bites"))[0].GetFeatures().Data());
+}
+
+TEST(PatternExtractorTest, HashedNGramWindowsMatchSingleWindows) {
+    std::string text;
+    for (int i = 0; i < 60; ++i) {
+        text += "Sentence " + std::to_string(i * 37) + " talks about pattern discovery, "
+                "then wanders off.\n";
+    }
+    auto bytes = TextBytes(text);
+
+    PatternExtractor::Config config;
+    config.modality = DataModality::TEXT;
+    config.max_pattern_size = 45;  // Windows cut words on both sides
+    config.feature_dimension = 32;
+    config.text_features = PatternExtractor::TextFeatures::HASHED_NGRAMS;
+    config.word_ngram_size = 2;
+    config.parallel_min_windows = 0;
+    PatternExtractor extractor(config);
+
+    // Sliding counts agree with hashing each window on its own
+    auto patterns = extractor.Extract(bytes);
+    const size_t stride = 22;
+    ASSERT_EQ((bytes.size() - 45) / stride + 1, patterns.size());
+    for (size_t k = 0; k < patterns.size(); ++k) {
+        auto single = extractor.ExtractTextWindow(bytes.data() + k * stride, 45);
+        ASSERT_EQ(single.GetFeatures().Data(), patterns[k].GetFeatures().Data())
+            << "window " << k;
+    }
+
+    // And with the windows split into parallel chunks
+    config.parallel_min_windows = 8;
+    config.parallel_chunk_windows = 5;
+    config.worker_pool = std::make_shared<WorkerPool>(2);
+    ExpectSameFeatures(patterns, PatternExtractor(config).Extract(bytes));
+}
+
+// ============================================================================
+// Spectral Audio Tests
+// ============================================================================
+
+TEST(PatternExtractorTest, SpectralAudioRejectsInvalidSettings) {
+    PatternExtractor::Config config;
+    config.audio_features = PatternExtractor::AudioFeatures::MFCC;
+    config.audio_mel_bands = 10;
+    config.audio_mfcc_coefficients = 11;
+    EXPECT_THROW(PatternExtractor extractor(config), std::invalid_argument);
+
+    config.audio_mfcc_coefficients = 10;
+    config.audio_sample_rate = 0.0;
+    EXPECT_THROW(PatternExtractor extractor(config), std::invalid_argument);
+
+    // Ignored while audio features are statistical
+    config.audio_features = PatternExtractor::AudioFeatures::STATISTICAL;
+    EXPECT_NO_THROW(PatternExtractor extractor(config));
+}
+
+TEST(PatternExtractorTest, SpectralAudioWindowsUseTheMelFrontEnd) {
+    auto samples = MakeNoisySine(8000, 21);
+
+    PatternExtractor::Config config;
+    config.modality = DataModality::AUDIO;
+    config.max_pattern_size = 1024;  // 256-sample frames, hop 64
+    config.feature_dimension = 16;
+    config.audio_features = PatternExtractor::AudioFeatures::MFCC;
+    config.audio_mel_bands = 20;
+    config.audio_mfcc_coefficients = 12;
+    config.parallel_min_windows = 0;
+    PatternExtractor extractor(config);
+
+    auto patterns = extractor.Extract(
+        InputView::Floats(samples.data(), samples.size(), DataModality::AUDIO));
+    ASSERT_EQ((8000u - 256u) / 64u + 1u, patterns.size());
+
+    SpectralExtractor::Config spectral;
+    spectral.frame_size = 256;
+    spectral.mel_bands = 20;
+    spectral.mfcc_coefficients = 12;
+    spectral.feature_dimension = 16;
+    SpectralExtractor reference(spectral);
+    std::vector<float> expected(16);
+    for (size_t k = 0; k < patterns.size(); k += 17) {
+        reference.ComputeFrame(samples.data() + k * 64, expected.data());
+        EXPECT_EQ(DataModality::AUDIO, patterns[k].GetModality());
+        EXPECT_EQ(expected, patterns[k].GetFeatures().Data()) << "window " << k;
+
+        // Streaming windows take the same path
+        auto single = extractor.ExtractWindow(samples.data() + k * 64, 256);
+        ASSERT_TRUE(single.has_value());
+        EXPECT_EQ(expected, single->GetFeatures().Data());
+    }
+
+    // Chunked extraction builds the same frames on other threads
+    config.parallel_min_windows = 16;
+    config.parallel_chunk_windows = 9;
+    config.worker_pool = std::make_shared<WorkerPool>(2);
+    ExpectSameFeatures(patterns, PatternExtractor(config).Extract(
+        InputView::Floats(samples.data(), samples.size(), DataModality::AUDIO)));
+}
+
+// ============================================================================
+// Change-Point Window Selection Tests
+// ============================================================================
+
+TEST(PatternExtractorTest, ChangePointsRejectInvalidDetector) {
+    PatternExtractor::Config config;
+    config.change_points.threshold = 0.0f;
+    EXPECT_NO_THROW(PatternExtractor extractor(config));
+
+    config.window_selection = PatternExtractor::WindowSelection::CHANGE_POINTS;
+    EXPECT_THROW(PatternExtractor extractor(config), std::invalid_argument);
+}
+
+TEST(PatternExtractorTest, ChangePointsKeepOnlyChangedWindows) {
+    // Steady telemetry with one level shift at sample 10000
+    std::mt19937 rng(31);
+    std::normal_distribution<float> noise(0.0f, 0.2f);
+    std::vector<float> values(20000);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = (i < 10000 ? 1.0f : 2.0f) + noise(rng);
+    }
+
+    PatternExtractor::Config config;
+    config.max_pattern_size = 400;  // 100-sample windows, hop 50
+    config.rolling_features = false;  // Selected windows are computed directly
+    config.parallel_min_windows = 0;
+    auto all = PatternExtractor(config).Extract(
+        InputView::Floats(values.data(), values.size(), DataModality::NUMERIC));
+    ASSERT_EQ(399u, all.size());
+
+    config.window_selection = PatternExtractor::WindowSelection::CHANGE_POINTS;
+    config.change_points.max_interval = 100;
+    auto selected = PatternExtractor(config).Extract(
+        InputView::Floats(values.data(), values.size(), DataModality::NUMERIC));
+
+    // Windows 0, 100, 200 and 300 as heartbeats, one near the shift at
+    // window 199, then the heartbeat restarts from there
+    ASSERT_GE(selected.size(), 4u);
+    EXPECT_LE(selected.size(), 6u);
+
+    // Selected windows are extracted exactly as without selection
+    ChangePointDetector detector(config.change_points);
+    size_t next = 0;
+    for (size_t k = 0; k < all.size(); ++k) {
+        if (detector.Update(values.data() + k * 50, 100)) {
+            ASSERT_LT(next, selected.size());
+            EXPECT_EQ(all[k].GetFeatures().Data(), selected[next++].GetFeatures().Data())
+                << "window " << k;
+        }
+    }
+    EXPECT_EQ(selected.size(), next);
+
+    // Parallel chunks split the selected windows, not the input
+    config.parallel_min_windows = 2;
+    config.parallel_chunk_windows = 1;
+    config.worker_pool = std::make_shared<WorkerPool>(2);
+    ExpectSameFeatures(selected, PatternExtractor(config).Extract(
+        InputView::Floats(values.data(), values.size(), DataModality::NUMERIC)));
+}
+
 } // namespace
 } // namespace dpan
@@ -2,7 +2,10 @@
 #include "discovery/pattern_matcher.hpp"
 #include "storage/memory_backend.hpp"
 #include <gtest/gtest.h>
+#include <atomic>
 #include <cmath>
+#include <random>
+#include <thread>
 
 namespace dpan {
 namespace {
@@ -34,6 +37,47 @@ public:
     bool IsSymmetric() const override { return true; }
 };
 
+// Mock similarity metric using cosine similarity clamped to [0, 1]
+class MockCosineSimilarity : public SimilarityMetric {
+public:
+    float Compute(const PatternData& a, const PatternData& b) const override {
+        return ComputeFromFeatures(a.GetFeatures(), b.GetFeatures());
+    }
+
+    float ComputeFromFeatures(const FeatureVector& a, const FeatureVector& b) const override {
+        return std::max(0.0f, a.CosineSimilarity(b));
+    }
+
+    // Elements within max_error move the vector by at most r = max_error * sqrt(n),
+    // turning it by at most asin(r / |approx|)
+    float PerturbationBound(const FeatureVector& /*query*/, const FeatureVector& approx,
+                            float max_error) const override {
+        float r = max_error * std::sqrt(static_cast<float>(approx.Dimension()));
+        float norm = approx.Norm();
+        return r < norm ? std::asin(r / norm) + 1e-5f : 1.0f;
+    }
+
+    std::string GetName() const override { return "MockCosine"; }
+    bool ComputesFromFeatures() const override { return true; }
+};
+
+// Database of random vectors around a few directions
+std::shared_ptr<MemoryBackend> CreateRandomDatabase(size_t count, size_t dim, uint32_t seed) {
+    auto db = std::make_shared<MemoryBackend>(MemoryBackend::Config{});
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+
+    for (size_t i = 1; i <= count; ++i) {
+        std::vector<float> values(dim);
+        for (auto& v : values) {
+            v = dist(rng);
+        }
+        PatternData data = PatternData::FromFeatures(FeatureVector(values), DataModality::NUMERIC);
+        db->Store(PatternNode(PatternID(i), data, PatternType::ATOMIC));
+    }
+    return db;
+}
+
 // Helper to create test database
 std::shared_ptr<PatternDatabase> CreateTestDatabase() {
     auto db = std::make_shared<MemoryBackend>(MemoryBackend::Config{});
@@ -356,5 +400,227 @@ TEST(PatternMatcherTest, UseFastSearchOption) {
     EXPECT_NO_THROW(matcher.FindMatches(query));
 }
 
+TEST(PatternMatcherTest, FindMatchesUsesSharedSearchLayout) {
+    auto db = CreateRandomDatabase(400, 16, 11);
+    auto metric = std::make_shared<MockCosineSimilarity>();
+
+    PatternMatcher::Config config;
+    config.similarity_threshold = 0.6f;
+    PatternMatcher plain(db, metric, config);
+    PatternMatcher layered(db, metric, config);
+
+    auto search = std::make_shared<SimilaritySearch>(db, metric);
+    search->SetStoragePrecision(FeaturePrecision::BFLOAT16);
+    layered.SetSearch(search);
+
+    for (uint64_t q = 1; q <= 10; ++q) {
+        PatternData query = db->Retrieve(PatternID(q * 13))->GetData();
+        auto expected = plain.FindMatches(query);
+        auto actual = layered.FindMatches(query);
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(expected[i].id, actual[i].id);
+            EXPECT_FLOAT_EQ(expected[i].similarity, actual[i].similarity);
+        }
+    }
+    EXPECT_GT(search->GetLayoutMemoryBytes(), 0u);
+    EXPECT_LT(layered.GetSearchStats().patterns_scored, layered.GetSearchStats().patterns_scanned);
+
+    auto other_db = std::make_shared<MemoryBackend>(MemoryBackend::Config{});
+    EXPECT_THROW(layered.SetSearch(std::make_shared<SimilaritySearch>(other_db, metric)),
+                 std::invalid_argument);
+    EXPECT_THROW(layered.SetSearch(nullptr), std::invalid_argument);
+}
+
+TEST(PatternMatcherTest, EvaluateAgreesWithFindMatchesAndMakeDecision) {
+    auto db = CreateTestDatabase();
+    PatternMatcher matcher(db, std::make_shared<MockEuclideanSimilarity>());
+
+    PatternData candidate = PatternData::FromFeatures(
+        FeatureVector({2.05f, 4.1f, 6.0f}), DataModality::NUMERIC);
+    auto matches = matcher.FindMatches(candidate);
+    auto decision = matcher.MakeDecision(candidate);
+
+    matcher.ResetSearchStats();
+    auto evaluation = matcher.Evaluate(candidate);
+    EXPECT_EQ(1u, matcher.GetSearchStats().queries);
+
+    ASSERT_EQ(matches.size(), evaluation.matches.size());
+    for (size_t i = 0; i < matches.size(); ++i) {
+        EXPECT_EQ(matches[i].id, evaluation.matches[i].id);
+        EXPECT_FLOAT_EQ(matches[i].similarity, evaluation.matches[i].similarity);
+    }
+    EXPECT_EQ(decision.decision, evaluation.decision.decision);
+    EXPECT_EQ(decision.existing_id, evaluation.decision.existing_id);
+}
+
+TEST(PatternMatcherTest, EvaluateBatchAgreesWithEvaluate) {
+    auto db = CreateRandomDatabase(300, 8, 21);
+    std::vector<std::shared_ptr<SimilarityMetric>> metrics = {
+        std::make_shared<MockCosineSimilarity>(),     // Shared feature decode
+        std::make_shared<MockEuclideanSimilarity>(),  // PatternData Compute
+    };
+
+    std::vector<PatternData> candidates;
+    for (uint64_t id = 5; id <= 300; id += 37) {
+        candidates.push_back(db->Retrieve(PatternID(id))->GetData());
+    }
+
+    for (const auto& metric : metrics) {
+        PatternMatcher::Config config;
+        config.similarity_threshold = metric->ComputesFromFeatures() ? 0.5f : 0.2f;
+        config.weak_match_threshold = config.similarity_threshold;
+        config.max_matches = 5;
+        PatternMatcher matcher(db, metric, config);
+
+        auto batch = matcher.EvaluateBatch(candidates);
+        ASSERT_EQ(candidates.size(), batch.size());
+        for (size_t c = 0; c < candidates.size(); ++c) {
+            auto single = matcher.Evaluate(candidates[c]);
+            ASSERT_EQ(single.matches.size(), batch[c].matches.size()) << metric->GetName();
+            ASSERT_FALSE(batch[c].matches.empty());
+            for (size_t i = 0; i < single.matches.size(); ++i) {
+                EXPECT_EQ(single.matches[i].id, batch[c].matches[i].id);
+                EXPECT_FLOAT_EQ(single.matches[i].similarity, batch[c].matches[i].similarity);
+            }
+            EXPECT_EQ(single.decision.decision, batch[c].decision.decision);
+            EXPECT_EQ(single.decision.existing_id, batch[c].decision.existing_id);
+        }
+    }
+}
+
+// ============================================================================
+// Sketch Search Mode
+// ============================================================================
+
+TEST(PatternMatcherTest, SketchModeRejectsInvalidConfig) {
+    auto db = CreateTestDatabase();
+    auto metric = std::make_shared<MockCosineSimilarity>();
+
+    PatternMatcher::Config config;
+    config.search_mode = PatternMatcher::SearchMode::SKETCH_RERANK;
+    config.sketch_bits = 100;
+    EXPECT_THROW(PatternMatcher(db, metric, config), std::invalid_argument);
+
+    config.sketch_bits = 128;
+    config.rerank_depth = 0;
+    EXPECT_THROW(PatternMatcher(db, metric, config), std::invalid_argument);
+}
+
+TEST(PatternMatcherTest, SketchModeAgreesWithExhaustiveSearch) {
+    auto db = CreateRandomDatabase(600, 24, 7);
+    auto metric = std::make_shared<MockCosineSimilarity>();
+
+    PatternMatcher::Config config;
+    config.similarity_threshold = 0.5f;
+    config.max_matches = 5;
+    PatternMatcher exhaustive(db, metric, config);
+
+    config.search_mode = PatternMatcher::SearchMode::SKETCH_RERANK;
+    config.sketch_bits = 256;
+    config.rerank_depth = 60;
+    config.recall_sample_interval = 1;
+    PatternMatcher sketched(db, metric, config);
+
+    std::mt19937 rng(99);
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+    for (uint64_t q = 1; q <= 30; ++q) {
+        FeatureVector features = db->Retrieve(PatternID(q * 7))->GetData().GetFeatures();
+        for (size_t i = 0; i < features.Dimension(); ++i) {
+            features[i] += noise(rng);
+        }
+        PatternData query = PatternData::FromFeatures(features, DataModality::NUMERIC);
+
+        auto expected = exhaustive.FindMatches(query);
+        auto actual = sketched.FindMatches(query);
+        ASSERT_FALSE(expected.empty());
+        ASSERT_FALSE(actual.empty());
+        EXPECT_EQ(expected.front().id, actual.front().id);
+        EXPECT_FLOAT_EQ(expected.front().similarity, actual.front().similarity);
+    }
+
+    auto stats = sketched.GetSearchStats();
+    EXPECT_EQ(30u, stats.queries);
+    EXPECT_EQ(30u, stats.recall_samples);
+    EXPECT_EQ(30u * 600u, stats.patterns_scanned);
+    EXPECT_EQ(30u * 60u, stats.patterns_scored);
+    EXPECT_GE(stats.Recall(), 0.9f);
+
+    sketched.ResetSearchStats();
+    EXPECT_EQ(0u, sketched.GetSearchStats().queries);
+}
+
+TEST(PatternMatcherTest, SketchModeServesConcurrentQueries) {
+    auto db = CreateRandomDatabase(300, 16, 5);
+    auto metric = std::make_shared<MockCosineSimilarity>();
+
+    PatternMatcher::Config config;
+    config.similarity_threshold = 0.5f;
+    config.search_mode = PatternMatcher::SearchMode::SKETCH_RERANK;
+    config.rerank_depth = 20;
+    PatternMatcher matcher(db, metric, config);
+
+    std::vector<PatternData> queries;
+    std::vector<std::vector<PatternMatcher::Match>> expected;
+    for (uint64_t q = 1; q <= 20; ++q) {
+        queries.push_back(db->Retrieve(PatternID(q * 11))->GetData());
+        expected.push_back(matcher.FindMatches(queries.back()));
+    }
+
+    std::vector<std::thread> workers;
+    std::atomic<size_t> mismatches{0};
+    for (size_t t = 0; t < 4; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t q = 0; q < queries.size(); ++q) {
+                auto actual = matcher.FindMatches(queries[q]);
+                if (actual.size() != expected[q].size() ||
+                    (!actual.empty() && actual.front().id != expected[q].front().id)) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_EQ(0u, mismatches.load());
+    EXPECT_EQ(100u, matcher.GetSearchStats().queries);
+}
+
+TEST(PatternMatcherTest, SketchModeTracksStoreUpdateAndDelete) {
+    auto db = CreateRandomDatabase(200, 8, 3);
+    auto metric = std::make_shared<MockCosineSimilarity>();
+
+    PatternMatcher::Config config;
+    config.similarity_threshold = 0.99f;
+    config.search_mode = PatternMatcher::SearchMode::SKETCH_RERANK;
+    config.rerank_depth = 4;
+    PatternMatcher matcher(db, metric, config);
+
+    std::vector<float> target{1.0f, -1.0f, 2.0f, 0.5f, 0.0f, 3.0f, -2.0f, 1.0f};
+    PatternData query = PatternData::FromFeatures(FeatureVector(target), DataModality::NUMERIC);
+    EXPECT_TRUE(matcher.FindMatches(query).empty());
+
+    // Stored after the sketches were built
+    db->Store(PatternNode(PatternID(500), query, PatternType::ATOMIC));
+    matcher.NotifyPatternChanged(PatternID(500));
+    auto matches = matcher.FindMatches(query);
+    ASSERT_EQ(1u, matches.size());
+    EXPECT_EQ(PatternID(500), matches[0].id);
+
+    // Deleted
+    db->Delete(PatternID(500));
+    matcher.NotifyPatternChanged(PatternID(500));
+    EXPECT_TRUE(matcher.FindMatches(query).empty());
+
+    // Updated in place
+    db->Update(PatternNode(PatternID(42), query, PatternType::ATOMIC));
+    matcher.NotifyPatternChanged(PatternID(42));
+    matches = matcher.FindMatches(query);
+    ASSERT_EQ(1u, matches.size());
+    EXPECT_EQ(PatternID(42), matches[0].id);
+}
+
 } // namespace
 } // namespace dpan
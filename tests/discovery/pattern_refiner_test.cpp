@@ -2,6 +2,8 @@
 #include "discovery/pattern_refiner.hpp"
 #include "storage/memory_backend.hpp"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
 
 namespace dpan {
 namespace {
@@ -231,6 +233,29 @@ TEST(PatternRefinerTest, MergePatternsWorks) {
     EXPECT_FLOAT_EQ(0.65f, merged_node->GetConfidenceScore());  // (0.6 + 0.7) / 2
 }
 
+TEST(PatternRefinerTest, NewPatternIDsSkipStoredIDs) {
+    auto db = CreateTestDatabase();
+    PatternRefiner refiner(db);
+
+    // Occupy the IDs the process-wide generator hands out next
+    const uint64_t next = PatternID::Generate().value() + 1;
+    for (uint64_t offset = 0; offset < 3; ++offset) {
+        PatternData data = PatternData::FromFeatures(
+            FeatureVector(std::vector<float>{1.0f + 0.1f * offset, 2.0f}), DataModality::NUMERIC);
+        ASSERT_TRUE(db->Store(PatternNode(PatternID(next + offset), data, PatternType::ATOMIC)));
+    }
+
+    auto first = refiner.MergePatterns({PatternID(next), PatternID(next + 1)});
+    ASSERT_TRUE(first.success);
+    EXPECT_GE(first.merged_id.value(), next + 3);
+
+    auto second = refiner.MergePatterns({first.merged_id, PatternID(next + 2)});
+    ASSERT_TRUE(second.success);
+    EXPECT_NE(first.merged_id, second.merged_id);
+    EXPECT_TRUE(db->Exists(first.merged_id));
+    EXPECT_TRUE(db->Exists(second.merged_id));
+}
+
 TEST(PatternRefinerTest, MergePatternsRequiresAtLeastTwoPatterns) {
     auto db = CreateTestDatabase();
     PatternRefiner refiner(db);
@@ -392,6 +417,33 @@ TEST(PatternRefinerTest, ShouldMergeRejectsDissimilarPatterns) {
     EXPECT_FALSE(refiner.ShouldMerge(id1, id2));
 }
 
+TEST(PatternRefinerTest, ShouldMergeCacheInvalidatedByUpdate) {
+    auto db = CreateTestDatabase();
+    PatternRefiner refiner(db);
+    auto cache = std::make_shared<PairwiseSimilarityCache>();
+    refiner.SetSimilarityCache(cache);
+    refiner.SetMergeSimilarityThreshold(0.9f);
+
+    PatternID id1 = CreateTestPattern(db, {1.0f, 2.0f, 3.0f});
+    PatternID id2 = CreateTestPattern(db, {1.01f, 2.01f, 3.01f});
+
+    EXPECT_TRUE(refiner.ShouldMerge(id1, id2));
+    EXPECT_TRUE(refiner.ShouldMerge(id2, id1));
+
+    auto stats = cache->GetConsumerStats("PatternRefiner");
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.hits);
+
+    // Moving one pattern far away must not be masked by the cached value
+    FeatureVector far_features(std::vector<float>{100.0f, 200.0f, 300.0f});
+    ASSERT_TRUE(refiner.UpdatePattern(
+        id2, PatternData::FromFeatures(far_features, DataModality::NUMERIC)));
+    EXPECT_FALSE(refiner.ShouldMerge(id1, id2));
+
+    stats = cache->GetConsumerStats("PatternRefiner");
+    EXPECT_EQ(1u, stats.stale);
+}
+
 TEST(PatternRefinerTest, ShouldMergeReturnsFalseForDifferentTypes) {
     auto db = CreateTestDatabase();
     PatternRefiner refiner(db);
@@ -422,6 +474,75 @@ TEST(PatternRefinerTest, ShouldMergeReturnsFalseIfAnyPatternMissing) {
     EXPECT_FALSE(refiner.ShouldMerge(id1, id2));
 }
 
+// ============================================================================
+// Recorded Instance Tests
+// ============================================================================
+
+/// Record count instances scattered around two centres
+void RecordTwoGroups(PatternRefiner& refiner, PatternID id, size_t count) {
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    for (size_t i = 0; i < count; ++i) {
+        float centre = i % 2 == 0 ? 0.0f : 2.0f;
+        FeatureVector features(std::vector<float>{centre + noise(rng), centre + noise(rng)});
+        refiner.RecordInstance(id, PatternData::FromFeatures(features, DataModality::NUMERIC));
+    }
+}
+
+TEST(PatternRefinerTest, RecordedInstancesDriveSplitting) {
+    auto db = CreateTestDatabase();
+    PatternRefiner refiner(db);
+    InstanceReservoir::Config reservoir_config;
+    reservoir_config.capacity = 20;
+    refiner.SetInstanceReservoir(std::make_shared<InstanceReservoir>(reservoir_config));
+
+    // Confident, but its matches fall into two separate groups
+    PatternID id = CreateTestPattern(db, {1.0f, 1.0f}, 0.9f);
+    RecordTwoGroups(refiner, id, 9);
+    EXPECT_FALSE(refiner.NeedsSplitting(id));  // Below min_instances_for_split
+    RecordTwoGroups(refiner, id, 200);
+    EXPECT_TRUE(refiner.NeedsSplitting(id));
+
+    auto result = refiner.SplitPattern(id, 2);
+    ASSERT_TRUE(result.success);
+    ASSERT_EQ(2u, result.new_pattern_ids.size());
+
+    // One sub-pattern per group, each starting from its group's instances
+    auto reservoir = refiner.GetInstanceReservoir();
+    std::vector<float> centres;
+    for (const auto& new_id : result.new_pattern_ids) {
+        auto node = db->Retrieve(new_id);
+        ASSERT_TRUE(node.has_value());
+        centres.push_back(node->GetData().GetFeatures()[0]);
+
+        auto summary = reservoir->GetSummary(new_id);
+        ASSERT_TRUE(summary.has_value());
+        EXPECT_LT(summary->variance, 0.05f);
+        EXPECT_FALSE(refiner.NeedsSplitting(new_id));
+    }
+    std::sort(centres.begin(), centres.end());
+    EXPECT_NEAR(0.0f, centres[0], 0.1f);
+    EXPECT_NEAR(2.0f, centres[1], 0.1f);
+
+    // The original's evidence was consumed by the split
+    EXPECT_FALSE(reservoir->GetSummary(id).has_value());
+    EXPECT_FALSE(refiner.NeedsSplitting(id));
+}
+
+TEST(PatternRefinerTest, TightInstancesDoNotNeedSplitting) {
+    auto db = CreateTestDatabase();
+    PatternRefiner refiner(db);
+    refiner.SetInstanceReservoir(std::make_shared<InstanceReservoir>(InstanceReservoir::Config{}));
+
+    // Low confidence alone no longer triggers a split once instances exist
+    PatternID id = CreateTestPattern(db, {1.0f, 1.0f}, 0.2f);
+    for (size_t i = 0; i < 50; ++i) {
+        FeatureVector features(std::vector<float>{1.0f + 0.01f * (i % 5), 1.0f});
+        refiner.RecordInstance(id, PatternData::FromFeatures(features, DataModality::NUMERIC));
+    }
+    EXPECT_FALSE(refiner.NeedsSplitting(id));
+}
+
 TEST(PatternRefinerTest, SetVarianceThresholdWorks) {
     auto db = CreateTestDatabase();
     PatternRefiner refiner(db);
@@ -0,0 +1,181 @@
+// File: tests/discovery/spectral_extractor_test.cpp
+#include "discovery/spectral_extractor.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace dpan {
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+std::vector<float> Tone(double frequency, double sample_rate, size_t count) {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] = static_cast<float>(
+            0.5 * std::sin(2.0 * kPi * frequency * static_cast<double>(i) / sample_rate));
+    }
+    return samples;
+}
+
+double HzToMel(double hz) {
+    return 2595.0 * std::log10(1.0 + hz / 700.0);
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+TEST(SpectralExtractorTest, RejectsInvalidConfig) {
+    SpectralExtractor::Config config;
+    config.frame_size = 0;
+    EXPECT_THROW(SpectralExtractor extractor(config), std::invalid_argument);
+
+    config.frame_size = 256;
+    config.mel_bands = 0;
+    EXPECT_THROW(SpectralExtractor extractor(config), std::invalid_argument);
+
+    config.mel_bands = 20;
+    config.mfcc_coefficients = 21;
+    EXPECT_THROW(SpectralExtractor extractor(config), std::invalid_argument);
+
+    config.mfcc_coefficients = 13;
+    config.max_frequency = config.sample_rate;  // Above Nyquist
+    EXPECT_THROW(SpectralExtractor extractor(config), std::invalid_argument);
+
+    config.max_frequency = 0.0;
+    SpectralExtractor extractor(config);
+    EXPECT_EQ(256u, extractor.GetFFTSize());
+    EXPECT_DOUBLE_EQ(config.sample_rate / 2.0, extractor.GetConfig().max_frequency);
+}
+
+// ============================================================================
+// Transform
+// ============================================================================
+
+TEST(SpectralExtractorTest, PowerSpectrumMatchesDirectDFT) {
+    SpectralExtractor::Config config;
+    config.frame_size = 300;  // Zero-padded to 512
+    SpectralExtractor extractor(config);
+    ASSERT_EQ(512u, extractor.GetFFTSize());
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::vector<float> frame(config.frame_size);
+    for (auto& sample : frame) {
+        sample = value(rng);
+    }
+
+    std::vector<float> features(config.feature_dimension);
+    extractor.ComputeFrame(frame.data(), features.data());
+    const auto& power = extractor.GetPowerSpectrum();
+    ASSERT_EQ(257u, power.size());
+
+    const size_t n = extractor.GetFFTSize();
+    for (size_t k = 0; k <= n / 2; ++k) {
+        double re = 0.0;
+        double im = 0.0;
+        for (size_t i = 0; i < frame.size(); ++i) {
+            const double hann = 0.5 - 0.5 * std::cos(2.0 * kPi * i / frame.size());
+            const double angle = -2.0 * kPi * static_cast<double>(k * i) / n;
+            re += frame[i] * hann * std::cos(angle);
+            im += frame[i] * hann * std::sin(angle);
+        }
+        const double expected = (re * re + im * im) / n;
+        EXPECT_NEAR(expected, power[k], 1e-4 + 1e-4 * expected) << "bin " << k;
+    }
+}
+
+// ============================================================================
+// Features
+// ============================================================================
+
+TEST(SpectralExtractorTest, ToneEnergyLandsInItsMelBand) {
+    SpectralExtractor::Config config;
+    config.frame_size = 1024;
+    config.mel_bands = 24;
+    config.feature_dimension = 24;
+    config.log_compress = false;
+    SpectralExtractor extractor(config);
+
+    const double high_mel = HzToMel(config.sample_rate / 2.0);
+    for (double frequency : {300.0, 1000.0, 3500.0}) {
+        auto tone = Tone(frequency, config.sample_rate, config.frame_size);
+        std::vector<float> features(config.feature_dimension);
+        extractor.ComputeFrame(tone.data(), features.data());
+
+        // The strongest filter is one of the two whose triangles cover the tone
+        size_t loudest = static_cast<size_t>(
+            std::max_element(features.begin(), features.end()) - features.begin());
+        double position = HzToMel(frequency) / high_mel * (config.mel_bands + 1);
+        EXPECT_LE(std::abs(static_cast<double>(loudest + 1) - position), 1.0)
+            << frequency << " Hz peaked in band " << loudest;
+    }
+}
+
+TEST(SpectralExtractorTest, MfccIsDctOfLogMel) {
+    SpectralExtractor::Config config;
+    config.frame_size = 512;
+    config.mel_bands = 26;
+    config.feature_dimension = 32;
+    SpectralExtractor log_mel(config);
+
+    config.mfcc_coefficients = 13;
+    SpectralExtractor mfcc(config);
+
+    std::mt19937 rng(11);
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+    auto frame = Tone(700.0, config.sample_rate, config.frame_size);
+    for (auto& sample : frame) {
+        sample += noise(rng);
+    }
+
+    std::vector<float> mel(config.feature_dimension);
+    std::vector<float> cepstrum(config.feature_dimension);
+    log_mel.ComputeFrame(frame.data(), mel.data());
+    mfcc.ComputeFrame(frame.data(), cepstrum.data());
+
+    const size_t bands = config.mel_bands;
+    for (size_t k = 0; k < 13; ++k) {
+        double sum = 0.0;
+        for (size_t b = 0; b < bands; ++b) {
+            sum += mel[b] * std::cos(kPi * k * (b + 0.5) / bands);
+        }
+        sum *= std::sqrt((k == 0 ? 1.0 : 2.0) / bands);
+        EXPECT_NEAR(sum, cepstrum[k], 1e-3) << "coefficient " << k;
+    }
+    for (size_t k = 13; k < config.feature_dimension; ++k) {
+        EXPECT_FLOAT_EQ(0.0f, cepstrum[k]);
+    }
+}
+
+TEST(SpectralExtractorTest, ExtractReusesStateAcrossFrames) {
+    SpectralExtractor::Config config;
+    config.frame_size = 400;
+    config.hop_size = 160;
+    config.mfcc_coefficients = 13;
+    config.feature_dimension = 13;
+    SpectralExtractor extractor(config);
+
+    auto samples = Tone(440.0, config.sample_rate, 4000);
+    for (size_t i = 2000; i < samples.size(); ++i) {
+        samples[i] *= 0.1f;  // Quieter second half
+    }
+    auto frames = extractor.Extract(samples.data(), samples.size());
+    ASSERT_EQ((4000u - 400u) / 160u + 1u, frames.size());
+
+    // Each frame matches a fresh extractor given that frame alone
+    for (size_t k : {size_t{0}, size_t{9}, frames.size() - 1}) {
+        SpectralExtractor fresh(config);
+        std::vector<float> expected(config.feature_dimension);
+        fresh.ComputeFrame(samples.data() + k * 160, expected.data());
+        for (size_t d = 0; d < config.feature_dimension; ++d) {
+            EXPECT_FLOAT_EQ(expected[d], frames[k][d]) << "frame " << k;
+        }
+    }
+    EXPECT_GT(frames.front()[0], frames.back()[0]);
+}
+
+} // namespace
+} // namespace dpan
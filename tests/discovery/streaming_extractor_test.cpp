@@ -0,0 +1,275 @@
+// File: tests/discovery/streaming_extractor_test.cpp
+#include "discovery/streaming_extractor.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace dpan {
+namespace {
+
+std::vector<uint8_t> CreateNumericData(const std::vector<float>& values) {
+    std::vector<uint8_t> bytes(values.size() * sizeof(float));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+    return bytes;
+}
+
+std::vector<float> MakeSignal(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+    std::vector<float> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = std::sin(static_cast<float>(i) * 0.05f) + noise(rng);
+    }
+    return values;
+}
+
+/// Batch extraction computing every window directly, as the stream does
+std::vector<PatternData> BatchExtract(PatternExtractor::Config config,
+                                      const std::vector<uint8_t>& bytes) {
+    config.rolling_features = false;
+    return PatternExtractor(config).Extract(bytes);
+}
+
+/// Feed a buffer in random-sized chunks and collect all patterns
+std::vector<PatternData> PushInRandomChunks(StreamingExtractor& stream,
+                                            const std::vector<uint8_t>& bytes,
+                                            uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> chunk_size(1, 97);
+    std::vector<PatternData> patterns;
+    size_t offset = 0;
+    while (offset < bytes.size()) {
+        size_t n = std::min(chunk_size(rng), bytes.size() - offset);
+        auto chunk = stream.Push(bytes.data() + offset, n);
+        patterns.insert(patterns.end(), chunk.begin(), chunk.end());
+        offset += n;
+    }
+    return patterns;
+}
+
+void ExpectSamePatterns(const std::vector<PatternData>& expected,
+                        const std::vector<PatternData>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const auto& a = expected[i].GetFeatures();
+        const auto& b = actual[i].GetFeatures();
+        ASSERT_EQ(a.Dimension(), b.Dimension());
+        for (size_t d = 0; d < a.Dimension(); ++d) {
+            EXPECT_FLOAT_EQ(a[d], b[d]) << "window " << i << " feature " << d;
+        }
+    }
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+TEST(StreamingExtractorTest, DefaultWindowAndHopFollowModality) {
+    StreamingExtractor::Config config;
+    config.extraction.modality = DataModality::NUMERIC;
+    config.extraction.max_pattern_size = 256;
+
+    StreamingExtractor numeric(config);
+    EXPECT_EQ(64u, numeric.GetWindowSize());
+    EXPECT_EQ(32u, numeric.GetHopSize());
+
+    config.extraction.modality = DataModality::AUDIO;
+    StreamingExtractor audio(config);
+    EXPECT_EQ(16u, audio.GetHopSize());
+
+    config.extraction.modality = DataModality::TEXT;
+    StreamingExtractor text(config);
+    EXPECT_EQ(256u, text.GetWindowSize());
+}
+
+TEST(StreamingExtractorTest, RejectsWindowWithoutCompleteSample) {
+    StreamingExtractor::Config config;
+    config.extraction.modality = DataModality::NUMERIC;
+    config.extraction.min_pattern_size = 1;
+    config.extraction.max_pattern_size = 3;
+
+    EXPECT_THROW(StreamingExtractor stream(config), std::invalid_argument);
+}
+
+// ============================================================================
+// Equivalence with batch extraction
+// ============================================================================
+
+TEST(StreamingExtractorTest, NumericChunksMatchBatchExtract) {
+    StreamingExtractor::Config config;
+    config.extraction.modality = DataModality::NUMERIC;
+    config.extraction.max_pattern_size = 512;
+
+    auto bytes = CreateNumericData(MakeSignal(2000, 7));
+    auto expected = BatchExtract(config.extraction, bytes);
+
+    StreamingExtractor stream(config);
+    auto actual = PushInRandomChunks(stream, bytes, 11);
+
+    EXPECT_FALSE(expected.empty());
+    ExpectSamePatterns(expected, actual);
+    EXPECT_EQ(2000u, stream.GetSamplesConsumed());
+}
+
+TEST(StreamingExtractorTest, AudioChunksMatchBatchExtract) {
+    StreamingExtractor::Config config;
+    config.extraction.modality = DataModality::AUDIO;
+    config.extraction.max_pattern_size = 400;
+
+    auto bytes = CreateNumericData(MakeSignal(1500, 3));
+    auto expected = BatchExtract(config.extraction, bytes);
+
+    StreamingExtractor stream(config);
+    ExpectSamePatterns(expected, PushInRandomChunks(stream, bytes, 5));
+}
+
+TEST(StreamingExtractorTest, TextChunksMatchBatchExtract) {
+    StreamingExtractor::Config config;
+    config.extraction.modality = DataModality::TEXT;
+    config.extraction.max_pattern_size = 64;
+
+    std::string text;
+    for (int i = 0; i < 40; ++i) {
+        text += "the quick brown fox " + std::to_string(i) + " jumps over the lazy dog. ";
+    }
+    std::vector<uint8_t> bytes(text.begin(), text.end());
+    auto expected = BatchExtract(config.extraction, bytes);
+
+    StreamingExtractor stream(config);
+    ExpectSamePatterns(expected, PushInRandomChunks(stream, bytes, 13));
+}
+
+TEST(StreamingExtractorTest, HashedTextChunksMatchBatchExtract) {
+    StreamingExtractor::Config config;
+    config.extraction.modality = DataModality::TEXT;
+    config.extraction.max_pattern_size = 50;
+    config.extraction.text_features = PatternExtractor::TextFeatures::HASHED_NGRAMS;
+    config.extraction.word_ngram_size = 2;
+
+    std::string text;
+    for (int i = 0; i < 40; ++i) {
+        text += "streams of words " + std::to_string(i * 11) + " cross chunk edges. ";
+    }
+    std::vector<uint8_t> bytes(text.begin(), text.end());
+    auto expected = BatchExtract(config.extraction, bytes);
+
+    StreamingExtractor stream(config);
+    ExpectSamePatterns(expected, PushInRandomChunks(stream, bytes, 17));
+}
+
+TEST(StreamingExtractorTest, ChangePointChunksMatchBatchExtract) {
+    StreamingExtractor::Config config;
+    config.extraction.modality = DataModality::NUMERIC;
+    config.extraction.max_pattern_size = 256;  // 64 samples, hop 32
+    config.extraction.window_selection = PatternExtractor::WindowSelection::CHANGE_POINTS;
+    config.extraction.change_points.max_interval = 20;
+
+    // Three plateaus of noise
+    auto signal = MakeSignal(6000, 19);
+    for (size_t i = 0; i < signal.size(); ++i) {
+        signal[i] = (signal[i] - std::sin(static_cast<float>(i) * 0.05f)) +
+                    (i < 2000 ? 1.0f : i < 4000 ? 4.0f : 2.0f);
+    }
+    auto bytes = CreateNumericData(signal);
+    auto expected = BatchExtract(config.extraction, bytes);
+
+    StreamingExtractor stream(config);
+    ExpectSamePatterns(expected, PushInRandomChunks(stream, bytes, 23));
+
+    // 186 windows: heartbeats plus the two level shifts
+    EXPECT_EQ(186u, stream.GetWindowsEmitted());
+    EXPECT_GE(expected.size(), 11u);
+    EXPECT_LE(expected.size(), 14u);
+    EXPECT_EQ(expected.size(), stream.GetPatternsEmitted());
+    EXPECT_DOUBLE_EQ(expected.size() * 1000.0 / 6000.0, stream.GetPatternsPerSecond(1000.0));
+
+    stream.Reset();
+    EXPECT_EQ(0u, stream.GetPatternsEmitted());
+    EXPECT_DOUBLE_EQ(0.0, stream.GetPatternsPerSecond(1000.0));
+    ExpectSamePatterns(expected, PushInRandomChunks(stream, bytes, 29));
+}
+
+TEST(StreamingExtractorTest, SampleSplitAcrossChunksIsReassembled) {
+    StreamingExtractor::Config config;
+    config.extraction.modality = DataModality::NUMERIC;
+    config.extraction.min_pattern_size = 4;
+    config.extraction.max_pattern_size = 16;
+    config.extraction.noise_threshold = 0.0f;
+
+    std::vector<float> values = {1.5f, -2.25f, 3.0f, 4.75f};
+    auto bytes = CreateNumericData(values);
+
+    StreamingExtractor stream(config);
+    std::vector<float> seen;
+    auto collect = [&](const StreamingExtractor::WindowView& window) {
+        seen.assign(window.samples, window.samples + window.size);
+    };
+    // Split inside the first, second and fourth floats
+    stream.Feed(bytes.data(), 1, collect);
+    stream.Feed(bytes.data() + 1, 6, collect);
+    stream.Feed(bytes.data() + 7, 7, collect);
+    EXPECT_TRUE(seen.empty());
+    stream.Feed(bytes.data() + 14, 2, collect);
+
+    EXPECT_EQ(values, seen);
+    EXPECT_EQ(1u, stream.GetWindowsEmitted());
+}
+
+// ============================================================================
+// Windows and memory
+// ============================================================================
+
+TEST(StreamingExtractorTest, WindowViewsCoverStreamAtHopSize) {
+    StreamingExtractor::Config config;
+    config.extraction.modality = DataModality::NUMERIC;
+    config.extraction.min_pattern_size = 4;
+    config.extraction.max_pattern_size = 4;
+    config.format = StreamingExtractor::SampleFormat::UINT8;
+    config.hop_samples = 3;
+
+    std::vector<uint8_t> bytes(20);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(i);
+    }
+
+    StreamingExtractor stream(config);
+    std::vector<uint64_t> starts;
+    stream.Feed(bytes.data(), bytes.size(), [&](const StreamingExtractor::WindowView& window) {
+        ASSERT_EQ(4u, window.size);
+        for (size_t i = 0; i < window.size; ++i) {
+            EXPECT_FLOAT_EQ(static_cast<float>(window.start + i) / 255.0f, window.samples[i]);
+        }
+        starts.push_back(window.start);
+    });
+
+    EXPECT_EQ((std::vector<uint64_t>{0, 3, 6, 9, 12, 15}), starts);
+}
+
+TEST(StreamingExtractorTest, BufferSizeIndependentOfStreamLength) {
+    StreamingExtractor::Config config;
+    config.extraction.modality = DataModality::NUMERIC;
+    config.extraction.max_pattern_size = 256;
+
+    StreamingExtractor stream(config);
+    size_t initial = stream.GetBufferBytes();
+
+    auto chunk = CreateNumericData(MakeSignal(1000, 1));
+    uint64_t windows = 0;
+    for (int i = 0; i < 200; ++i) {
+        stream.Feed(chunk.data(), chunk.size(),
+                    [&](const StreamingExtractor::WindowView&) { ++windows; });
+    }
+
+    EXPECT_EQ(initial, stream.GetBufferBytes());
+    EXPECT_EQ(200000u, stream.GetSamplesConsumed());
+    EXPECT_EQ(windows, stream.GetWindowsEmitted());
+    EXPECT_EQ((200000u - 64u) / 32u + 1u, windows);
+
+    stream.Reset();
+    EXPECT_EQ(0u, stream.GetSamplesConsumed());
+    EXPECT_EQ(0u, stream.GetWindowsEmitted());
+}
+
+} // namespace
+} // namespace dpan
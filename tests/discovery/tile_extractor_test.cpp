@@ -0,0 +1,188 @@
+// File: tests/discovery/tile_extractor_test.cpp
+#include "discovery/tile_extractor.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+namespace dpan {
+namespace {
+
+/// Tile features computed pixel by pixel
+std::vector<float> BruteForceFeatures(const std::vector<uint8_t>& pixels,
+                                      size_t width, size_t height, size_t channels,
+                                      size_t row_stride,
+                                      const TileExtractor::Tile& tile) {
+    auto at = [&](size_t x, size_t y, size_t c) {
+        return static_cast<double>(pixels[y * row_stride + x * channels + c]);
+    };
+    auto region_mean = [&](size_t x0, size_t y0, size_t w, size_t h, size_t c) {
+        double sum = 0.0;
+        for (size_t y = y0; y < y0 + h; ++y) {
+            for (size_t x = x0; x < x0 + w; ++x) {
+                sum += at(x, y, c);
+            }
+        }
+        return sum / static_cast<double>(w * h);
+    };
+
+    std::vector<float> features;
+    const size_t half = tile.size / 2;
+    for (size_t c = 0; c < channels; ++c) {
+        double mean = region_mean(tile.x, tile.y, tile.size, tile.size, c);
+        double variance = 0.0;
+        double gradient = 0.0;
+        for (size_t y = tile.y; y < tile.y + tile.size; ++y) {
+            for (size_t x = tile.x; x < tile.x + tile.size; ++x) {
+                variance += (at(x, y, c) - mean) * (at(x, y, c) - mean);
+                double dx = x + 1 < width ? at(x + 1, y, c) - at(x, y, c) : 0.0;
+                double dy = y + 1 < height ? at(x, y + 1, c) - at(x, y, c) : 0.0;
+                gradient += dx * dx + dy * dy;
+            }
+        }
+        const double n = static_cast<double>(tile.size * tile.size);
+        features.push_back(static_cast<float>(mean / 255.0));
+        features.push_back(static_cast<float>(std::sqrt(variance / n) / 255.0));
+        features.push_back(static_cast<float>(gradient / n / (255.0 * 255.0)));
+        const size_t rest = tile.size - half;
+        features.push_back(static_cast<float>(region_mean(tile.x, tile.y, half, half, c) / 255.0));
+        features.push_back(static_cast<float>(region_mean(tile.x + half, tile.y, rest, half, c) / 255.0));
+        features.push_back(static_cast<float>(region_mean(tile.x, tile.y + half, half, rest, c) / 255.0));
+        features.push_back(static_cast<float>(region_mean(tile.x + half, tile.y + half, rest, rest, c) / 255.0));
+    }
+    return features;
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+TEST(TileExtractorTest, RejectsInvalidConfig) {
+    TileExtractor::Config config;
+    config.tile_size = 0;
+    EXPECT_THROW(TileExtractor extractor(config), std::invalid_argument);
+
+    config.tile_size = 8;
+    config.pyramid_levels = 0;
+    EXPECT_THROW(TileExtractor extractor(config), std::invalid_argument);
+
+    config.pyramid_levels = 1;
+    config.feature_dimension = 0;
+    EXPECT_THROW(TileExtractor extractor(config), std::invalid_argument);
+}
+
+TEST(TileExtractorTest, RejectsNonImageView) {
+    TileExtractor extractor(TileExtractor::Config{});
+    std::vector<float> samples(256, 0.5f);
+    EXPECT_THROW(extractor.Extract(InputView::Floats(samples.data(), samples.size())),
+                 std::invalid_argument);
+}
+
+// ============================================================================
+// Tiling
+// ============================================================================
+
+TEST(TileExtractorTest, PyramidLevelsTileTheFrame) {
+    std::vector<uint8_t> pixels(64 * 32, 100);
+
+    TileExtractor::Config config;
+    config.tile_size = 16;
+    config.pyramid_levels = 3;
+    TileExtractor extractor(config);
+    auto tiles = extractor.Extract(InputView::Image(pixels.data(), 64, 32));
+
+    // Level 0: 7 x 3 tiles of 16 px; level 1: 3 x 1 of 32 px; level 2 does not fit
+    ASSERT_EQ(24u, tiles.size());
+    EXPECT_EQ(0u, tiles[0].level);
+    EXPECT_EQ(8u, tiles[1].x);
+    EXPECT_EQ(8u, tiles[7].y);
+    EXPECT_EQ(1u, tiles[21].level);
+    EXPECT_EQ(32u, tiles[21].size);
+    EXPECT_EQ(16u, tiles[22].x);
+
+    for (const auto& tile : tiles) {
+        EXPECT_EQ(128u, tile.features.Dimension());
+        EXPECT_NEAR(100.0f / 255.0f, tile.features[0], 1e-6f);
+        EXPECT_FLOAT_EQ(0.0f, tile.features[1]);
+        EXPECT_FLOAT_EQ(0.0f, tile.features[2]);
+    }
+}
+
+TEST(TileExtractorTest, SmallFrameIsTiledAtItsShortSide) {
+    std::vector<uint8_t> pixels(6 * 4, 7);
+
+    TileExtractor::Config config;
+    config.tile_size = 16;
+    config.pyramid_levels = 2;
+    TileExtractor extractor(config);
+    auto tiles = extractor.Extract(InputView::Image(pixels.data(), 6, 4));
+
+    // 4-pixel tiles with a 2-pixel step: one row of two
+    ASSERT_EQ(2u, tiles.size());
+    EXPECT_EQ(4u, tiles[0].size);
+    EXPECT_EQ(2u, tiles[1].x);
+}
+
+TEST(TileExtractorTest, FeaturesMatchPixelComputation) {
+    const size_t width = 37;
+    const size_t height = 23;
+    const size_t channels = 3;
+    const size_t row_stride = width * channels + 5;  // Padded rows
+
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> value(0, 255);
+    std::vector<uint8_t> pixels(row_stride * height);
+    for (auto& pixel : pixels) {
+        pixel = static_cast<uint8_t>(value(rng));
+    }
+
+    TileExtractor::Config config;
+    config.tile_size = 7;
+    config.stride = 3;
+    config.pyramid_levels = 2;
+    config.feature_dimension = 16;  // Truncates the 21 channel features
+    TileExtractor extractor(config);
+    auto tiles = extractor.Extract(
+        InputView::Image(pixels.data(), width, height, row_stride, channels));
+
+    ASSERT_FALSE(tiles.empty());
+    for (const auto& tile : tiles) {
+        auto expected = BruteForceFeatures(pixels, width, height, channels, row_stride, tile);
+        ASSERT_EQ(16u, tile.features.Dimension());
+        for (size_t d = 0; d < 16; ++d) {
+            EXPECT_NEAR(expected[d], tile.features[d], 1e-5f)
+                << "tile (" << tile.x << ", " << tile.y << ") level " << tile.level
+                << " feature " << d;
+        }
+    }
+}
+
+TEST(TileExtractorTest, GradientEnergyFollowsEdges) {
+    // Left half dark, right half bright
+    const size_t width = 32;
+    const size_t height = 16;
+    std::vector<uint8_t> pixels(width * height);
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            pixels[y * width + x] = x < width / 2 ? 0 : 255;
+        }
+    }
+
+    TileExtractor::Config config;
+    config.tile_size = 8;
+    config.feature_dimension = 7;
+    TileExtractor extractor(config);
+    auto tiles = extractor.Extract(InputView::Image(pixels.data(), width, height));
+
+    for (const auto& tile : tiles) {
+        bool spans_edge = tile.x < width / 2 && tile.x + tile.size > width / 2;
+        bool touches_edge = tile.x + tile.size == width / 2;
+        if (spans_edge || touches_edge) {
+            EXPECT_GT(tile.features[2], 0.0f) << "tile at x = " << tile.x;
+        } else {
+            EXPECT_FLOAT_EQ(0.0f, tile.features[2]) << "tile at x = " << tile.x;
+        }
+    }
+}
+
+} // namespace
+} // namespace dpan
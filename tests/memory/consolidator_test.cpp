@@ -282,6 +282,44 @@ TEST_F(MemoryConsolidatorTest, FindClusters_TooFewPatterns) {
     EXPECT_TRUE(clusters.empty());
 }
 
+TEST_F(MemoryConsolidatorTest, FindClusters_PartitionsKeepGroupsApart) {
+    // Three groups of 30 patterns, far apart in feature space
+    std::vector<PatternID> ids;
+    std::unordered_map<PatternID, int> group_of;
+    for (int group = 0; group < 3; ++group) {
+        for (int i = 0; i < 30; ++i) {
+            std::vector<float> features(8);
+            for (size_t d = 0; d < features.size(); ++d) {
+                features[d] = group * 100.0f + static_cast<float>(d) + 0.01f * i;
+            }
+            PatternNode node(PatternID::Generate(),
+                             PatternData::FromFeatures(FeatureVector(features), DataModality::NUMERIC),
+                             PatternType::ATOMIC);
+            backend_->Store(node);
+            ids.push_back(node.GetID());
+            group_of[node.GetID()] = group;
+        }
+    }
+
+    MemoryConsolidator::Config config;
+    config.cluster_partition_size = 0;
+    auto all_pairs = MemoryConsolidator(config).FindClusters(ids, *backend_, *similarity_);
+    EXPECT_EQ(3u, all_pairs.size());
+
+    // Partitioned: every pattern still clustered, never across groups
+    config.cluster_partition_size = 20;
+    auto partitioned = MemoryConsolidator(config).FindClusters(ids, *backend_, *similarity_);
+    size_t clustered = 0;
+    for (const auto& cluster : partitioned) {
+        EXPECT_GE(cluster.size(), config.min_cluster_size);
+        for (PatternID id : cluster) {
+            EXPECT_EQ(group_of[cluster[0]], group_of[id]);
+        }
+        clustered += cluster.size();
+    }
+    EXPECT_EQ(ids.size(), clustered);
+}
+
 TEST_F(MemoryConsolidatorTest, CreateClusterParent_CreatesNewPattern) {
     MemoryConsolidator consolidator;
 
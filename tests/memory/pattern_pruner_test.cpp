@@ -631,6 +631,44 @@ TEST_F(PatternPrunerTest, PrunePatterns_SafetyChecksPreventPruning) {
     EXPECT_TRUE(pattern_db_->Exists(hub_id));
 }
 
+TEST_F(PatternPrunerTest, PrunePatterns_KeepsSubPatternsOfStoredParents) {
+    PatternPruner::Config config;
+    config.utility_threshold = 0.3f;
+    config.min_pattern_age = std::chrono::milliseconds(10);
+    PatternPruner pruner(config);
+
+    auto child = CreateTestPattern();
+    auto loose = CreateTestPattern();
+    PatternID child_id = child.GetID();
+    PatternID loose_id = loose.GetID();
+    pattern_db_->Store(std::move(child));
+    pattern_db_->Store(std::move(loose));
+
+    PatternNode composite(PatternID::Generate(), CreateTestPattern().GetData(),
+                          PatternType::COMPOSITE);
+    composite.AddSubPattern(child_id);
+    pattern_db_->Store(composite);
+
+    std::unordered_map<PatternID, float> utilities;
+    utilities[child_id] = 0.1f;
+    utilities[loose_id] = 0.1f;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(15));
+
+    EXPECT_TRUE(pruner.IsSubPattern(child_id, *pattern_db_));
+    EXPECT_FALSE(pruner.IsSubPattern(loose_id, *pattern_db_));
+
+    auto result = pruner.PrunePatterns(*pattern_db_, *assoc_matrix_, utilities);
+    EXPECT_EQ(std::vector<PatternID>{loose_id}, result.pruned_patterns);
+    EXPECT_EQ(1u, result.patterns_kept_safe);
+    EXPECT_TRUE(pattern_db_->Exists(child_id));
+
+    // Once its parent is gone the sub-pattern is prunable
+    pattern_db_->Delete(composite.GetID());
+    result = pruner.PrunePatterns(*pattern_db_, *assoc_matrix_, utilities);
+    EXPECT_EQ(std::vector<PatternID>{child_id}, result.pruned_patterns);
+}
+
 TEST_F(PatternPrunerTest, PrunePatterns_MixedUtilities) {
     PatternPruner::Config config;
     config.utility_threshold = 0.3f;
@@ -26,6 +26,7 @@
 #include <memory>
 #include <thread>
 #include <chrono>
+#include <algorithm>
 
 using namespace dpan;
 namespace fs = std::filesystem;
@@ -267,6 +268,25 @@ TEST_F(TierManagerTest, StorePattern_Success) {
     EXPECT_EQ(MemoryTier::ACTIVE, *tier);
 }
 
+TEST_F(TierManagerTest, GetPatternsInTier_ListsTierMembers) {
+    CreateManager();
+
+    PatternNode active1 = CreateTestPattern();
+    PatternNode active2 = CreateTestPattern();
+    PatternNode warm = CreateTestPattern();
+
+    EXPECT_TRUE(manager_->StorePattern(active1, MemoryTier::ACTIVE));
+    EXPECT_TRUE(manager_->StorePattern(active2, MemoryTier::ACTIVE));
+    EXPECT_TRUE(manager_->StorePattern(warm, MemoryTier::WARM));
+
+    std::vector<PatternID> expected{active1.GetID(), active2.GetID()};
+    std::sort(expected.begin(), expected.end());
+
+    EXPECT_EQ(expected, manager_->GetPatternsInTier(MemoryTier::ACTIVE));
+    EXPECT_EQ(std::vector<PatternID>{warm.GetID()}, manager_->GetPatternsInTier(MemoryTier::WARM));
+    EXPECT_TRUE(manager_->GetPatternsInTier(MemoryTier::COLD).empty());
+}
+
 TEST_F(TierManagerTest, LoadPattern_Success) {
     CreateManager();
 
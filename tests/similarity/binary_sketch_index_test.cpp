@@ -0,0 +1,76 @@
+// File: tests/similarity/binary_sketch_index_test.cpp
+#include "similarity/binary_sketch_index.hpp"
+#include <gtest/gtest.h>
+
+namespace dpan {
+namespace {
+
+TEST(BinarySketchIndexTest, InvalidConfigThrows) {
+    BinarySketchIndex::Config config;
+    config.num_bits = 96;
+    EXPECT_THROW(BinarySketchIndex index(config), std::invalid_argument);
+}
+
+TEST(BinarySketchIndexTest, HammingDistanceReflectsAngle) {
+    BinarySketchIndex index;
+    FeatureVector v(std::vector<float>{1.0f, 2.0f, -3.0f, 0.5f});
+    FeatureVector scaled(std::vector<float>{2.0f, 4.0f, -6.0f, 1.0f});
+    FeatureVector opposite(std::vector<float>{-1.0f, -2.0f, 3.0f, -0.5f});
+
+    auto a = index.Sketch(v);
+    auto b = index.Sketch(scaled);
+    auto c = index.Sketch(opposite);
+    ASSERT_EQ(2u, a.size());
+
+    EXPECT_EQ(0u, BinarySketchIndex::HammingDistance(a.data(), b.data(), a.size()));
+
+    // Sign projections of x and -x differ except where a dot product is exactly zero
+    EXPECT_GE(BinarySketchIndex::HammingDistance(a.data(), c.data(), a.size()), 120u);
+}
+
+TEST(BinarySketchIndexTest, NearestRanksByHammingDistance) {
+    BinarySketchIndex index;
+    index.Upsert(PatternID(1), FeatureVector(std::vector<float>{1.0f, 0.0f, 0.0f}));
+    index.Upsert(PatternID(2), FeatureVector(std::vector<float>{0.9f, 0.1f, 0.0f}));
+    index.Upsert(PatternID(3), FeatureVector(std::vector<float>{-1.0f, 0.0f, 0.0f}));
+    index.Upsert(PatternID(4), FeatureVector(std::vector<float>{1.0f, 0.0f}));  // Other dimension
+
+    auto nearest = index.Nearest(FeatureVector(std::vector<float>{1.0f, 0.05f, 0.0f}), 4);
+    ASSERT_EQ(4u, nearest.size());
+    EXPECT_TRUE((nearest[0] == PatternID(1) && nearest[1] == PatternID(2)) ||
+                (nearest[0] == PatternID(2) && nearest[1] == PatternID(1)));
+    EXPECT_EQ(PatternID(3), nearest[2]);
+    EXPECT_EQ(PatternID(4), nearest[3]);
+
+    EXPECT_EQ(2u, index.Nearest(FeatureVector(std::vector<float>{1.0f, 0.0f, 0.0f}), 2).size());
+}
+
+TEST(BinarySketchIndexTest, RemoveKeepsSlotsDense) {
+    auto unit = [](size_t axis) {
+        std::vector<float> values(5, 0.0f);
+        values[axis] = 1.0f;
+        return FeatureVector(values);
+    };
+
+    BinarySketchIndex index;
+    for (uint64_t id = 1; id <= 5; ++id) {
+        index.Upsert(PatternID(id), unit(id - 1));
+    }
+
+    EXPECT_TRUE(index.Remove(PatternID(2)));
+    EXPECT_FALSE(index.Remove(PatternID(2)));
+    EXPECT_EQ(4u, index.Size());
+    EXPECT_FALSE(index.Contains(PatternID(2)));
+
+    // The last pattern moved into the freed slot and still matches itself
+    auto nearest = index.Nearest(unit(4), 1);
+    ASSERT_EQ(1u, nearest.size());
+    EXPECT_EQ(PatternID(5), nearest[0]);
+
+    index.Clear();
+    EXPECT_EQ(0u, index.Size());
+    EXPECT_TRUE(index.Nearest(unit(0), 3).empty());
+}
+
+} // namespace
+} // namespace dpan
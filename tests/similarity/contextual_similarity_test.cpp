@@ -2,6 +2,7 @@
 #include "similarity/contextual_similarity.hpp"
 #include "core/pattern_node.hpp"
 #include <gtest/gtest.h>
+#include <random>
 
 namespace dpan {
 namespace {
@@ -87,6 +88,51 @@ TEST(ContextVectorSimilarityTest, IsSymmetric) {
     EXPECT_FLOAT_EQ(sim1, sim2);
 }
 
+TEST(ContextVectorSimilarityTest, BoundedCosineIsExactAboveThreshold) {
+    ContextVectorSimilarity metric;
+    std::mt19937 rng(7);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+
+    auto random_vector = [&](size_t dim) {
+        std::vector<float> values(dim);
+        for (auto& v : values) {
+            v = dist(rng);
+        }
+        return FeatureVector(values);
+    };
+
+    FeatureVector query = random_vector(100);
+    auto query_summary = metric.ComputeBoundSummary(query);
+
+    for (int i = 0; i < 50; ++i) {
+        FeatureVector candidate = random_vector(100);
+        auto candidate_summary = metric.ComputeBoundSummary(candidate);
+        float exact = metric.ComputeFromFeatures(query, candidate);
+
+        for (float threshold : {-1.0f, 0.0f, 0.1f, exact, 0.3f, 0.9f}) {
+            float bounded = metric.ComputeFromFeaturesBounded(
+                query, query_summary, candidate, candidate_summary, threshold);
+            if (exact >= threshold) {
+                EXPECT_EQ(exact, bounded);
+            } else {
+                EXPECT_LT(bounded, threshold);
+            }
+        }
+    }
+}
+
+TEST(ContextVectorSimilarityTest, ZeroVectorSummaryBoundsToZero) {
+    ContextVectorSimilarity metric;
+
+    FeatureVector zero(std::vector<float>(40, 0.0f));
+    FeatureVector other(std::vector<float>(40, 1.0f));
+
+    EXPECT_FLOAT_EQ(0.0f, metric.UpperBoundFromSummaries(metric.ComputeBoundSummary(zero),
+                                                         metric.ComputeBoundSummary(other)));
+    EXPECT_FLOAT_EQ(1.0f, metric.UpperBoundFromSummaries(metric.ComputeBoundSummary(other),
+                                                         metric.ComputeBoundSummary(other)));
+}
+
 // ============================================================================
 // TemporalSimilarity Tests
 // ============================================================================
@@ -2,6 +2,9 @@
 #include "similarity/geometric_similarity.hpp"
 #include <gtest/gtest.h>
 #include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
 
 namespace dpan {
 namespace {
@@ -428,5 +431,193 @@ TEST(GeometricSimilarityTest, DifferentMetricsProduceDifferentResults) {
     EXPECT_GT(modified_sim, hausdorff_sim);
 }
 
+// ============================================================================
+// Spatial Acceleration Tests
+// ============================================================================
+
+// Random feature vector holding num_points 2-D points
+FeatureVector RandomPointCloud(size_t num_points, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+
+    std::vector<float> values(num_points * 2);
+    for (auto& v : values) {
+        v = dist(rng);
+    }
+    return FeatureVector(values);
+}
+
+// All-pairs directed nearest distances, used as the reference
+std::vector<float> BruteForceNearest(const PointSet<2>& from, const PointSet<2>& to) {
+    std::vector<float> result;
+    for (const auto& p : from.points) {
+        float best = std::numeric_limits<float>::infinity();
+        for (const auto& q : to.points) {
+            best = std::min(best, p.DistanceTo(q));
+        }
+        result.push_back(best);
+    }
+    return result;
+}
+
+TEST(PointSetIndexTest, NearestMatchesBruteForce) {
+    auto cloud = PointSet<2>::FromFeatureVector(RandomPointCloud(1000, 1));
+    auto queries = PointSet<2>::FromFeatureVector(RandomPointCloud(200, 2));
+    PointSetIndex<2> index(cloud);
+
+    EXPECT_EQ(1000u, index.Size());
+
+    auto expected = BruteForceNearest(queries, cloud);
+    for (size_t i = 0; i < queries.Size(); ++i) {
+        EXPECT_FLOAT_EQ(expected[i], std::sqrt(index.NearestSquaredDistance(queries.points[i])));
+    }
+}
+
+TEST(PointSetIndexTest, EmptyIndexReturnsInfinity) {
+    PointSetIndex<2> index(PointSet<2>{});
+    EXPECT_TRUE(std::isinf(index.NearestSquaredDistance(Point<2>())));
+}
+
+TEST(PointSetIndexTest, EarlyAbandonStaysWithinBound) {
+    auto cloud = PointSet<2>::FromFeatureVector(RandomPointCloud(1000, 3));
+    PointSetIndex<2> index(cloud);
+
+    Point<2> query;
+    float exact = index.NearestSquaredDistance(query);
+    float bound = exact + 25.0f;
+
+    float abandoned = index.NearestSquaredDistance(query, bound);
+    EXPECT_GE(abandoned, exact);
+    EXPECT_LE(abandoned, bound);
+}
+
+TEST(HausdorffSimilarityTest, LargePointSetsMatchBruteForce) {
+    HausdorffSimilarity metric;
+    FeatureVector fv1 = RandomPointCloud(2000, 4);
+    FeatureVector fv2 = RandomPointCloud(1500, 5);
+
+    auto a = PointSet<2>::FromFeatureVector(fv1);
+    auto b = PointSet<2>::FromFeatureVector(fv2);
+    auto ab = BruteForceNearest(a, b);
+    auto ba = BruteForceNearest(b, a);
+    float expected = std::max(*std::max_element(ab.begin(), ab.end()),
+                              *std::max_element(ba.begin(), ba.end()));
+
+    EXPECT_FLOAT_EQ(1.0f / (1.0f + expected), metric.ComputeFromFeatures(fv1, fv2));
+}
+
+TEST(ChamferSimilarityTest, LargePointSetsMatchBruteForce) {
+    ChamferSimilarity metric;
+    FeatureVector fv1 = RandomPointCloud(2000, 6);
+    FeatureVector fv2 = RandomPointCloud(1500, 7);
+
+    auto a = PointSet<2>::FromFeatureVector(fv1);
+    auto b = PointSet<2>::FromFeatureVector(fv2);
+    auto ab = BruteForceNearest(a, b);
+    auto ba = BruteForceNearest(b, a);
+    float avg_ab = std::accumulate(ab.begin(), ab.end(), 0.0f) / ab.size();
+    float avg_ba = std::accumulate(ba.begin(), ba.end(), 0.0f) / ba.size();
+    float expected = (avg_ab + avg_ba) / 2.0f;
+
+    EXPECT_FLOAT_EQ(1.0f / (1.0f + expected), metric.ComputeFromFeatures(fv1, fv2));
+}
+
+TEST(ModifiedHausdorffSimilarityTest, LargePointSetsMatchBruteForce) {
+    ModifiedHausdorffSimilarity metric;
+    FeatureVector fv1 = RandomPointCloud(2000, 8);
+    FeatureVector fv2 = RandomPointCloud(1500, 9);
+
+    auto a = PointSet<2>::FromFeatureVector(fv1);
+    auto b = PointSet<2>::FromFeatureVector(fv2);
+    auto ab = BruteForceNearest(a, b);
+    auto ba = BruteForceNearest(b, a);
+    float avg_ab = std::accumulate(ab.begin(), ab.end(), 0.0f) / ab.size();
+    float avg_ba = std::accumulate(ba.begin(), ba.end(), 0.0f) / ba.size();
+    float expected = std::max(avg_ab, avg_ba);
+
+    EXPECT_FLOAT_EQ(1.0f / (1.0f + expected), metric.ComputeFromFeatures(fv1, fv2));
+}
+
+TEST(SpatialIndexCacheTest, ReusesIndexForRepeatedFeatures) {
+    SpatialIndexCache cache;
+    FeatureVector fv = RandomPointCloud(100, 10);
+
+    auto first = cache.GetOrBuild<2>(fv);
+    auto second = cache.GetOrBuild<2>(FeatureVector(fv.Data()));
+
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(1u, cache.Hits());
+    EXPECT_EQ(1u, cache.Misses());
+}
+
+TEST(SpatialIndexCacheTest, DistinguishesPointDimensionality) {
+    SpatialIndexCache cache;
+    FeatureVector fv({1.0f, 2.0f, 3.0f, 4.0f});
+
+    EXPECT_EQ(2u, cache.GetOrBuild<2>(fv)->Size());
+    EXPECT_EQ(4u, cache.GetOrBuild<1>(fv)->Size());
+}
+
+TEST(SpatialIndexCacheTest, SharedAcrossMetrics) {
+    auto cache = std::make_shared<SpatialIndexCache>();
+    HausdorffSimilarity hausdorff(cache);
+    ChamferSimilarity chamfer(cache);
+
+    FeatureVector fv1 = RandomPointCloud(500, 11);
+    FeatureVector fv2 = RandomPointCloud(500, 12);
+
+    hausdorff.ComputeFromFeatures(fv1, fv2);
+    chamfer.ComputeFromFeatures(fv1, fv2);
+
+    EXPECT_EQ(cache, chamfer.GetIndexCache());
+    EXPECT_EQ(2u, cache->Misses());
+    EXPECT_EQ(2u, cache->Hits());
+}
+
+// ============================================================================
+// Bounded Evaluation Tests
+// ============================================================================
+
+TEST(GeometricBoundsTest, BoundedEvaluationIsExactAboveThreshold) {
+    HausdorffSimilarity hausdorff;
+    ChamferSimilarity chamfer;
+    ModifiedHausdorffSimilarity modified;
+    const SimilarityMetric* metrics[] = {&hausdorff, &chamfer, &modified};
+
+    FeatureVector query = RandomPointCloud(200, 21);
+    for (uint32_t seed = 22; seed < 30; ++seed) {
+        FeatureVector candidate = RandomPointCloud(200, seed);
+        for (const auto* metric : metrics) {
+            float exact = metric->ComputeFromFeatures(query, candidate);
+            for (float threshold : {0.0f, exact * 0.5f, exact, exact * 1.5f, 0.99f}) {
+                float bounded = metric->ComputeFromFeaturesBounded(query, {}, candidate, {}, threshold);
+                if (exact >= threshold) {
+                    EXPECT_FLOAT_EQ(exact, bounded) << metric->GetName();
+                } else {
+                    EXPECT_LT(bounded, threshold) << metric->GetName();
+                }
+            }
+        }
+    }
+}
+
+TEST(GeometricBoundsTest, HausdorffSummaryBoundIsValid) {
+    HausdorffSimilarity metric;
+
+    FeatureVector query = RandomPointCloud(100, 31);
+    auto query_summary = metric.ComputeBoundSummary(query);
+
+    for (uint32_t seed = 32; seed < 40; ++seed) {
+        FeatureVector candidate = RandomPointCloud(100, seed);
+        for (auto& v : candidate.Data()) {
+            v += static_cast<float>(seed - 32) * 5.0f;  // Drift boxes apart
+        }
+
+        float bound = metric.UpperBoundFromSummaries(query_summary,
+                                                     metric.ComputeBoundSummary(candidate));
+        EXPECT_GE(bound, metric.ComputeFromFeatures(query, candidate));
+    }
+}
+
 } // namespace
 } // namespace dpan
@@ -0,0 +1,157 @@
+// File: tests/similarity/kmeans_clusterer_test.cpp
+#include "similarity/kmeans_clusterer.hpp"
+#include "core/worker_pool.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace dpan {
+namespace {
+
+/// Points around `clusters` well-separated centres; label[i] is the centre
+/// of point i
+std::vector<float> Blobs(size_t clusters, size_t per_cluster, size_t dimension,
+                         uint32_t seed, std::vector<size_t>* labels = nullptr) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 0.5f);
+    std::vector<float> points;
+    points.reserve(clusters * per_cluster * dimension);
+    for (size_t i = 0; i < per_cluster; ++i) {
+        for (size_t c = 0; c < clusters; ++c) {
+            for (size_t d = 0; d < dimension; ++d) {
+                float centre = (d % clusters == c) ? 20.0f : 0.0f;
+                points.push_back(centre + noise(rng));
+            }
+            if (labels) {
+                labels->push_back(c);
+            }
+        }
+    }
+    return points;
+}
+
+/// Whether two labelings induce the same partition
+bool SamePartition(const std::vector<uint32_t>& assignments, const std::vector<size_t>& labels) {
+    std::set<std::pair<size_t, uint32_t>> pairs;
+    std::set<size_t> labels_seen;
+    std::set<uint32_t> clusters_seen;
+    for (size_t i = 0; i < labels.size(); ++i) {
+        pairs.insert({labels[i], assignments[i]});
+        labels_seen.insert(labels[i]);
+        clusters_seen.insert(assignments[i]);
+    }
+    return pairs.size() == labels_seen.size() && pairs.size() == clusters_seen.size();
+}
+
+TEST(SquaredEuclideanDistanceTest, MatchesScalarSum) {
+    std::vector<float> a(19);
+    std::vector<float> b(19);
+    float expected = 0.0f;
+    for (size_t d = 0; d < a.size(); ++d) {
+        a[d] = static_cast<float>(d) * 0.5f;
+        b[d] = 3.0f - static_cast<float>(d);
+        expected += (a[d] - b[d]) * (a[d] - b[d]);
+    }
+    EXPECT_FLOAT_EQ(expected, SquaredEuclideanDistance(a.data(), b.data(), a.size()));
+    EXPECT_FLOAT_EQ(0.0f, SquaredEuclideanDistance(a.data(), a.data(), a.size()));
+}
+
+TEST(KMeansClustererTest, RejectsInvalidInput) {
+    KMeansClusterer::Config config;
+    config.num_clusters = 0;
+    EXPECT_THROW(KMeansClusterer clusterer(config), std::invalid_argument);
+
+    config.num_clusters = 3;
+    config.tolerance = -1.0f;
+    EXPECT_THROW(KMeansClusterer clusterer(config), std::invalid_argument);
+
+    config.tolerance = 0.0f;
+    KMeansClusterer clusterer(config);
+    std::vector<float> points = {1.0f, 2.0f, 3.0f, 4.0f};
+    EXPECT_THROW(clusterer.Run(points.data(), 2, 2), std::invalid_argument);
+    EXPECT_THROW(clusterer.Run(points.data(), 4, 0), std::invalid_argument);
+}
+
+TEST(KMeansClustererTest, AlgorithmsRecoverSeparatedClusters) {
+    std::vector<size_t> labels;
+    auto points = Blobs(4, 500, 8, 1, &labels);
+    const size_t count = labels.size();
+
+    KMeansClusterer::Config config;
+    config.num_clusters = 4;
+    config.mini_batch_size = 256;
+    for (auto algorithm : {KMeansClusterer::Algorithm::LLOYD,
+                           KMeansClusterer::Algorithm::HAMERLY,
+                           KMeansClusterer::Algorithm::MINI_BATCH}) {
+        config.algorithm = algorithm;
+        auto result = KMeansClusterer(config).Run(points.data(), count, 8);
+
+        ASSERT_EQ(count, result.assignments.size());
+        ASSERT_EQ(4u * 8u, result.centroids.size());
+        EXPECT_TRUE(SamePartition(result.assignments, labels));
+        for (size_t size : result.cluster_sizes) {
+            EXPECT_EQ(500u, size);
+        }
+        // Noise variance 0.25 per dimension
+        EXPECT_LT(result.inertia / static_cast<double>(count), 8 * 0.25 * 1.2);
+    }
+}
+
+TEST(KMeansClustererTest, HamerlyMatchesLloydWithFewerDistances) {
+    auto points = Blobs(10, 400, 16, 2);
+    const size_t count = points.size() / 16;
+
+    KMeansClusterer::Config config;
+    config.num_clusters = 12;  // More centroids than blobs: centroids keep moving
+    config.tolerance = 0.0f;
+    config.algorithm = KMeansClusterer::Algorithm::LLOYD;
+    auto lloyd = KMeansClusterer(config).Run(points.data(), count, 16);
+    config.algorithm = KMeansClusterer::Algorithm::HAMERLY;
+    auto hamerly = KMeansClusterer(config).Run(points.data(), count, 16);
+
+    EXPECT_EQ(lloyd.assignments, hamerly.assignments);
+    EXPECT_EQ(lloyd.iterations, hamerly.iterations);
+    ASSERT_EQ(lloyd.centroids.size(), hamerly.centroids.size());
+    for (size_t i = 0; i < lloyd.centroids.size(); ++i) {
+        EXPECT_FLOAT_EQ(lloyd.centroids[i], hamerly.centroids[i]);
+    }
+    EXPECT_LT(hamerly.distance_computations, lloyd.distance_computations / 2);
+}
+
+TEST(KMeansClustererTest, ResultDoesNotDependOnThreads) {
+    auto points = Blobs(5, 3000, 4, 3);
+    const size_t count = points.size() / 4;
+
+    KMeansClusterer::Config config;
+    config.num_clusters = 5;
+    config.worker_pool = std::make_shared<WorkerPool>(0);
+    auto serial = KMeansClusterer(config).Run(points.data(), count, 4);
+    config.worker_pool = std::make_shared<WorkerPool>(3);
+    auto parallel = KMeansClusterer(config).Run(points.data(), count, 4);
+
+    EXPECT_EQ(serial.assignments, parallel.assignments);
+    EXPECT_EQ(serial.centroids, parallel.centroids);
+    EXPECT_DOUBLE_EQ(serial.inertia, parallel.inertia);
+}
+
+TEST(KMeansClustererTest, DuplicatePointsLeaveClustersEmpty) {
+    std::vector<float> points(10 * 3, 1.5f);
+    KMeansClusterer::Config config;
+    config.num_clusters = 3;
+    auto result = KMeansClusterer(config).Run(points.data(), 10, 3);
+
+    EXPECT_TRUE(result.converged);
+    EXPECT_DOUBLE_EQ(0.0, result.inertia);
+    size_t total = 0;
+    for (size_t size : result.cluster_sizes) {
+        total += size;
+    }
+    EXPECT_EQ(10u, total);
+    for (float value : result.centroids) {
+        EXPECT_FLOAT_EQ(1.5f, value);
+    }
+}
+
+} // namespace
+} // namespace dpan
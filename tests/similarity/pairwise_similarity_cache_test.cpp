@@ -0,0 +1,193 @@
+// File: tests/similarity/pairwise_similarity_cache_test.cpp
+#include "similarity/pairwise_similarity_cache.hpp"
+#include "core/pattern_node.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace dpan {
+namespace {
+
+PatternNode MakeNode(uint64_t id, const std::vector<float>& values) {
+    PatternData data = PatternData::FromFeatures(FeatureVector(values), DataModality::NUMERIC);
+    return PatternNode(PatternID(id), data, PatternType::ATOMIC);
+}
+
+// ============================================================================
+// Basic Caching
+// ============================================================================
+
+TEST(PairwiseSimilarityCacheTest, InvalidConfigThrows) {
+    PairwiseSimilarityCache::Config config;
+    config.capacity = 0;
+    EXPECT_THROW(PairwiseSimilarityCache cache(config), std::invalid_argument);
+}
+
+TEST(PairwiseSimilarityCacheTest, SymmetricPairSharesEntry) {
+    PairwiseSimilarityCache cache;
+    auto a = MakeNode(1, {1.0f, 2.0f});
+    auto b = MakeNode(2, {3.0f, 4.0f});
+
+    int calls = 0;
+    auto compute = [&]() { ++calls; return 0.25f; };
+
+    EXPECT_FLOAT_EQ(0.25f, cache.GetOrCompute(a, b, "m", true, "test", compute));
+    EXPECT_FLOAT_EQ(0.25f, cache.GetOrCompute(b, a, "m", true, "test", compute));
+    EXPECT_FLOAT_EQ(0.25f, cache.GetOrCompute(a, b, "m", true, "test", compute));
+
+    EXPECT_EQ(1, calls);
+    EXPECT_EQ(1u, cache.Size());
+
+    auto stats = cache.GetConsumerStats("test");
+    EXPECT_EQ(2u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_NEAR(2.0f / 3.0f, stats.HitRate(), 1e-6f);
+}
+
+TEST(PairwiseSimilarityCacheTest, AsymmetricOrientationsCachedSeparately) {
+    PairwiseSimilarityCache cache;
+    auto a = MakeNode(1, {1.0f});
+    auto b = MakeNode(2, {2.0f});
+
+    EXPECT_FLOAT_EQ(0.1f, cache.GetOrCompute(a, b, "kl", false, "test", [] { return 0.1f; }));
+    EXPECT_FLOAT_EQ(0.9f, cache.GetOrCompute(b, a, "kl", false, "test", [] { return 0.9f; }));
+
+    EXPECT_FLOAT_EQ(0.1f, cache.GetOrCompute(a, b, "kl", false, "test", [] { return -1.0f; }));
+    EXPECT_FLOAT_EQ(0.9f, cache.GetOrCompute(b, a, "kl", false, "test", [] { return -1.0f; }));
+    EXPECT_EQ(1u, cache.Size());
+}
+
+TEST(PairwiseSimilarityCacheTest, MetricNameIsPartOfKey) {
+    PairwiseSimilarityCache cache;
+    auto a = MakeNode(1, {1.0f});
+    auto b = MakeNode(2, {2.0f});
+
+    cache.GetOrCompute(a, b, "cosine", true, "test", [] { return 0.5f; });
+    EXPECT_FLOAT_EQ(0.7f, cache.GetOrCompute(a, b, "euclidean", true, "test", [] { return 0.7f; }));
+    EXPECT_EQ(2u, cache.Size());
+}
+
+// ============================================================================
+// Invalidation
+// ============================================================================
+
+TEST(PairwiseSimilarityCacheTest, GenerationBumpMakesEntryStale) {
+    PairwiseSimilarityCache cache;
+    auto a = MakeNode(1, {1.0f, 2.0f});
+    auto b = MakeNode(2, {3.0f, 4.0f});
+
+    cache.GetOrCompute(a, b, "m", true, "test", [] { return 0.25f; });
+
+    b.BumpGeneration();
+    EXPECT_FLOAT_EQ(0.75f, cache.GetOrCompute(a, b, "m", true, "test", [] { return 0.75f; }));
+    EXPECT_EQ(1u, cache.GetConsumerStats("test").stale);
+
+    // The refreshed value is served afterwards
+    EXPECT_FLOAT_EQ(0.75f, cache.GetOrCompute(a, b, "m", true, "test", [] { return -1.0f; }));
+}
+
+TEST(PairwiseSimilarityCacheTest, ContentChangeMakesEntryStaleWithoutGeneration) {
+    PairwiseSimilarityCache cache;
+    auto a = MakeNode(1, {1.0f, 2.0f});
+    auto b = MakeNode(2, {3.0f, 4.0f});
+
+    cache.GetOrCompute(a, b, "m", true, "test", [] { return 0.25f; });
+
+    // Same id, different data, generation left at zero (e.g. reloaded node)
+    auto b_reloaded = MakeNode(2, {5.0f, 6.0f});
+    EXPECT_FLOAT_EQ(0.5f, cache.GetOrCompute(a, b_reloaded, "m", true, "test", [] { return 0.5f; }));
+}
+
+TEST(PairwiseSimilarityCacheTest, InvalidateRemovesAllPairsOfPattern) {
+    PairwiseSimilarityCache cache;
+    auto a = MakeNode(1, {1.0f});
+    auto b = MakeNode(2, {2.0f});
+    auto c = MakeNode(3, {3.0f});
+
+    cache.GetOrCompute(a, b, "m", true, "test", [] { return 0.1f; });
+    cache.GetOrCompute(a, c, "m", true, "test", [] { return 0.2f; });
+    cache.GetOrCompute(b, c, "m", true, "test", [] { return 0.3f; });
+
+    EXPECT_EQ(2u, cache.Invalidate(PatternID(1)));
+    EXPECT_EQ(1u, cache.Size());
+}
+
+TEST(PairwiseSimilarityCacheTest, CloneAndMovePreserveGeneration) {
+    auto node = MakeNode(1, {1.0f});
+    node.BumpGeneration();
+    node.BumpGeneration();
+
+    PatternNode cloned = node.Clone();
+    EXPECT_EQ(2u, cloned.GetGeneration());
+
+    PatternNode moved(std::move(cloned));
+    EXPECT_EQ(2u, moved.GetGeneration());
+    EXPECT_EQ(PairwiseSimilarityCache::VersionOf(node), PairwiseSimilarityCache::VersionOf(moved));
+}
+
+// ============================================================================
+// Capacity and Concurrency
+// ============================================================================
+
+TEST(PairwiseSimilarityCacheTest, CapacityIsBounded) {
+    PairwiseSimilarityCache::Config config;
+    config.capacity = 32;
+    config.num_shards = 4;
+    PairwiseSimilarityCache cache(config);
+
+    std::vector<PatternNode> nodes;
+    for (uint64_t i = 1; i <= 20; ++i) {
+        nodes.push_back(MakeNode(i, {static_cast<float>(i)}));
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        for (size_t j = i + 1; j < nodes.size(); ++j) {
+            cache.GetOrCompute(nodes[i], nodes[j], "m", true, "test", [] { return 0.5f; });
+        }
+    }
+
+    EXPECT_LE(cache.Size(), 32u);
+    EXPECT_GT(cache.Evictions(), 0u);
+}
+
+TEST(PairwiseSimilarityCacheTest, ConcurrentConsumersTrackSeparateStats) {
+    PairwiseSimilarityCache cache;
+
+    std::vector<PatternNode> nodes;
+    for (uint64_t i = 1; i <= 16; ++i) {
+        nodes.push_back(MakeNode(i, {static_cast<float>(i), 1.0f}));
+    }
+
+    auto worker = [&](const std::string& consumer) {
+        for (int round = 0; round < 3; ++round) {
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                for (size_t j = i + 1; j < nodes.size(); ++j) {
+                    float expected = static_cast<float>(i * 100 + j);
+                    float value = cache.GetOrCompute(nodes[i], nodes[j], "m", true, consumer,
+                                                      [&] { return expected; });
+                    EXPECT_FLOAT_EQ(expected, value);
+                }
+            }
+        }
+    };
+
+    std::thread t1(worker, "consumer_a");
+    std::thread t2(worker, "consumer_b");
+    t1.join();
+    t2.join();
+
+    const uint64_t lookups = 3 * (16 * 15 / 2);
+    auto all = cache.GetAllConsumerStats();
+    ASSERT_EQ(2u, all.size());
+    EXPECT_EQ("consumer_a", all[0].consumer);
+    EXPECT_EQ("consumer_b", all[1].consumer);
+    for (const auto& stats : all) {
+        EXPECT_EQ(lookups, stats.hits + stats.misses);
+        EXPECT_GE(stats.hits, lookups / 3);
+    }
+
+    cache.ResetStats();
+    EXPECT_EQ(0u, cache.GetConsumerStats("consumer_a").hits);
+}
+
+} // namespace
+} // namespace dpan
@@ -0,0 +1,255 @@
+// File: tests/similarity/quantized_feature_store_test.cpp
+#include "similarity/quantized_feature_store.hpp"
+#include "similarity/similarity_search.hpp"
+#include "similarity/contextual_similarity.hpp"
+#include "storage/memory_backend.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <unordered_set>
+
+namespace dpan {
+namespace {
+
+std::vector<float> RandomValues(std::mt19937& rng, size_t dim, float scale) {
+    std::normal_distribution<float> dist(0.0f, scale);
+    std::vector<float> values(dim);
+    for (auto& v : values) {
+        v = dist(rng);
+    }
+    return values;
+}
+
+// ============================================================================
+// Element Conversions
+// ============================================================================
+
+TEST(QuantizedFeatureStoreTest, HalfRoundTripsRepresentableValues) {
+    for (float value : {0.0f, 1.0f, -2.5f, 0.333251953125f, 65504.0f, -65504.0f,
+                        6.103515625e-05f, 5.9604644775390625e-08f}) {
+        uint16_t code = QuantizedFeatureStore::FloatToHalf(value);
+        EXPECT_EQ(value, QuantizedFeatureStore::HalfToFloat(code)) << value;
+    }
+}
+
+TEST(QuantizedFeatureStoreTest, HalfHandlesSpecialValues) {
+    const float inf = std::numeric_limits<float>::infinity();
+    EXPECT_EQ(inf, QuantizedFeatureStore::HalfToFloat(QuantizedFeatureStore::FloatToHalf(inf)));
+    EXPECT_EQ(-inf, QuantizedFeatureStore::HalfToFloat(QuantizedFeatureStore::FloatToHalf(-inf)));
+    EXPECT_EQ(inf, QuantizedFeatureStore::HalfToFloat(QuantizedFeatureStore::FloatToHalf(1.0e6f)));
+    EXPECT_TRUE(std::isnan(QuantizedFeatureStore::HalfToFloat(
+        QuantizedFeatureStore::FloatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+
+    // Rounds to nearest even: 1 + 2^-11 lies halfway between 1 and 1 + 2^-10
+    EXPECT_EQ(1.0f, QuantizedFeatureStore::HalfToFloat(
+        QuantizedFeatureStore::FloatToHalf(1.0f + std::ldexp(1.0f, -11))));
+}
+
+TEST(QuantizedFeatureStoreTest, HalfRelativeErrorIsBounded) {
+    std::mt19937 rng(3);
+    for (float value : RandomValues(rng, 1000, 100.0f)) {
+        float decoded = QuantizedFeatureStore::HalfToFloat(QuantizedFeatureStore::FloatToHalf(value));
+        EXPECT_LE(std::abs(decoded - value), std::abs(value) * std::ldexp(1.0f, -11) + 1e-7f);
+    }
+}
+
+TEST(QuantizedFeatureStoreTest, BFloat16KeepsRangeAndBoundsError) {
+    // Beyond the half range, unlike FLOAT16
+    float big = QuantizedFeatureStore::BFloat16ToFloat(QuantizedFeatureStore::FloatToBFloat16(1.0e30f));
+    EXPECT_NEAR(1.0f, big / 1.0e30f, 1.0f / 256.0f);
+    EXPECT_TRUE(std::isnan(QuantizedFeatureStore::BFloat16ToFloat(
+        QuantizedFeatureStore::FloatToBFloat16(std::numeric_limits<float>::quiet_NaN()))));
+
+    std::mt19937 rng(4);
+    for (float value : RandomValues(rng, 1000, 100.0f)) {
+        float decoded = QuantizedFeatureStore::BFloat16ToFloat(
+            QuantizedFeatureStore::FloatToBFloat16(value));
+        EXPECT_LE(std::abs(decoded - value), std::abs(value) * std::ldexp(1.0f, -8));
+    }
+}
+
+// ============================================================================
+// Store
+// ============================================================================
+
+TEST(QuantizedFeatureStoreTest, Int8ErrorBoundedByPerVectorScale) {
+    QuantizedFeatureStore store(FeaturePrecision::INT8);
+    std::mt19937 rng(5);
+
+    // Vectors of very different magnitude each get their own scale
+    auto small = RandomValues(rng, 64, 0.01f);
+    auto large = RandomValues(rng, 64, 1000.0f);
+    store.Upsert(PatternID(1), FeatureVector(small));
+    store.Upsert(PatternID(2), FeatureVector(large));
+
+    for (const auto& [slot, values] : {std::make_pair(size_t(0), small),
+                                       std::make_pair(size_t(1), large)}) {
+        float max_abs = 0.0f;
+        for (float v : values) {
+            max_abs = std::max(max_abs, std::abs(v));
+        }
+        std::vector<float> decoded(store.DimensionAt(slot));
+        store.Decode(slot, decoded.data());
+        for (size_t i = 0; i < values.size(); ++i) {
+            EXPECT_LE(std::abs(decoded[i] - values[i]), max_abs / 127.0f * 0.5f + 1e-6f);
+            EXPECT_LE(std::abs(decoded[i] - values[i]), store.ErrorAt(slot));
+        }
+        EXPECT_LE(store.ErrorAt(slot), max_abs / 127.0f * 0.5f + 1e-6f);
+    }
+}
+
+TEST(QuantizedFeatureStoreTest, UpsertRemoveAndCompaction) {
+    QuantizedFeatureStore store(FeaturePrecision::FLOAT16);
+    for (uint64_t id = 1; id <= 10; ++id) {
+        store.Upsert(PatternID(id), FeatureVector(std::vector<float>(8, static_cast<float>(id))));
+    }
+    EXPECT_EQ(10u, store.Size());
+
+    // Replace with a different dimension, then remove most entries
+    store.Upsert(PatternID(3), FeatureVector(std::vector<float>(4, 30.0f)));
+    for (uint64_t id = 4; id <= 10; ++id) {
+        EXPECT_TRUE(store.Remove(PatternID(id)));
+    }
+    EXPECT_FALSE(store.Remove(PatternID(42)));
+    EXPECT_EQ(3u, store.Size());
+    EXPECT_FALSE(store.Contains(PatternID(5)));
+
+    for (size_t slot = 0; slot < store.Size(); ++slot) {
+        FeatureVector decoded;
+        store.Decode(slot, decoded);
+        float expected = store.IdAt(slot) == PatternID(3) ? 30.0f
+                                                          : static_cast<float>(store.IdAt(slot).value());
+        ASSERT_EQ(store.IdAt(slot) == PatternID(3) ? 4u : 8u, decoded.Dimension());
+        for (size_t i = 0; i < decoded.Dimension(); ++i) {
+            EXPECT_EQ(expected, decoded[i]);
+        }
+    }
+
+    store.Clear();
+    EXPECT_EQ(0u, store.Size());
+}
+
+// ============================================================================
+// SimilaritySearch Layout
+// ============================================================================
+
+class QuantizedSearchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_shared<MemoryBackend>(MemoryBackend::Config{});
+        std::mt19937 rng(11);
+        for (uint64_t id = 1; id <= 300; ++id) {
+            Add(PatternID(id), RandomValues(rng, 32, 1.0f));
+        }
+        metric_ = std::make_shared<ContextVectorSimilarity>();
+    }
+
+    void Add(PatternID id, const std::vector<float>& values) {
+        PatternData data = PatternData::FromFeatures(FeatureVector(values), DataModality::NUMERIC);
+        db_->Store(PatternNode(id, data, PatternType::ATOMIC));
+    }
+
+    std::shared_ptr<MemoryBackend> db_;
+    std::shared_ptr<ContextVectorSimilarity> metric_;
+};
+
+TEST_F(QuantizedSearchTest, ReturnsExactScoresWithHighRecall) {
+    SimilaritySearch exact(db_, metric_);
+    auto config = SearchConfig::TopK(10);
+
+    for (FeaturePrecision precision : {FeaturePrecision::FLOAT16,
+                                       FeaturePrecision::BFLOAT16,
+                                       FeaturePrecision::INT8}) {
+        SimilaritySearch search(db_, metric_);
+        search.SetStoragePrecision(precision);
+        EXPECT_EQ(precision, search.GetStoragePrecision());
+        EXPECT_GT(search.GetLayoutMemoryBytes(), 0u);
+
+        size_t hits = 0;
+        size_t total = 0;
+        for (uint64_t q = 1; q <= 20; ++q) {
+            FeatureVector query = db_->Retrieve(PatternID(q))->GetData().GetFeatures();
+            auto expected = exact.SearchByFeatures(query, config);
+            auto actual = search.SearchByFeatures(query, config);
+
+            std::unordered_set<PatternID> truth;
+            for (const auto& r : expected) {
+                truth.insert(r.pattern_id);
+            }
+            for (const auto& r : actual) {
+                hits += truth.count(r.pattern_id);
+                float score = metric_->ComputeFromFeatures(
+                    query, db_->Retrieve(r.pattern_id)->GetData().GetFeatures());
+                EXPECT_FLOAT_EQ(score, r.similarity);
+            }
+            total += expected.size();
+            ASSERT_FALSE(actual.empty());
+            EXPECT_EQ(expected.front().pattern_id, actual.front().pattern_id);
+        }
+        EXPECT_GE(static_cast<float>(hits) / static_cast<float>(total), 0.95f) << ToString(precision);
+    }
+}
+
+TEST_F(QuantizedSearchTest, SelectiveFilterStillFillsResults) {
+    SimilaritySearch exact(db_, metric_);
+    SimilaritySearch search(db_, metric_);
+    search.SetStoragePrecision(FeaturePrecision::INT8, 1);
+
+    // Only 6 of the 300 patterns pass; the query's nearest neighbours do not
+    auto config = SearchConfig::TopK(5);
+    config.filter = [](const PatternNode& node) { return node.GetID().value() % 50 == 0; };
+
+    FeatureVector query = db_->Retrieve(PatternID(7))->GetData().GetFeatures();
+    auto expected = exact.SearchByFeatures(query, config);
+    auto actual = search.SearchByFeatures(query, config);
+
+    ASSERT_GE(expected.size(), 3u);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (const auto& r : actual) {
+        EXPECT_EQ(0u, r.pattern_id.value() % 50);
+    }
+    EXPECT_EQ(expected.front().pattern_id, actual.front().pattern_id);
+}
+
+TEST_F(QuantizedSearchTest, LayoutTracksStoreDeleteAndRefresh) {
+    SimilaritySearch search(db_, metric_);
+    search.SetStoragePrecision(FeaturePrecision::INT8, 2);
+
+    std::vector<float> target(32, 0.0f);
+    target[0] = 1.0f;
+    FeatureVector query(target);
+
+    // Stored after the layout was built
+    Add(PatternID(1000), target);
+    search.NotifyPatternChanged(PatternID(1000));
+    auto results = search.SearchByFeatures(query, SearchConfig::TopK(1));
+    ASSERT_EQ(1u, results.size());
+    EXPECT_EQ(PatternID(1000), results[0].pattern_id);
+
+    // Deleted patterns disappear once reported
+    db_->Delete(PatternID(1000));
+    search.NotifyPatternChanged(PatternID(1000));
+    results = search.SearchByFeatures(query, SearchConfig::TopK(1));
+    ASSERT_EQ(1u, results.size());
+    EXPECT_NE(PatternID(1000), results[0].pattern_id);
+
+    // In-place update becomes visible once reported
+    PatternNode updated(PatternID(5),
+                        PatternData::FromFeatures(query, DataModality::NUMERIC),
+                        PatternType::ATOMIC);
+    db_->Update(updated);
+    search.NotifyPatternChanged(PatternID(5));
+    results = search.SearchByFeatures(query, SearchConfig::TopK(1));
+    ASSERT_EQ(1u, results.size());
+    EXPECT_EQ(PatternID(5), results[0].pattern_id);
+    EXPECT_FLOAT_EQ(1.0f, results[0].similarity);
+
+    // Back to float32 drops the layout
+    search.SetStoragePrecision(FeaturePrecision::FLOAT32);
+    EXPECT_EQ(0u, search.GetLayoutMemoryBytes());
+    EXPECT_THROW(search.SetStoragePrecision(FeaturePrecision::INT8, 0), std::invalid_argument);
+}
+
+} // namespace
+} // namespace dpan
@@ -66,6 +66,30 @@ private:
     float value_;
 };
 
+/// Metric that counts its evaluations
+class CountingMetric : public SimilarityMetric {
+public:
+    explicit CountingMetric(float value) : value_(value) {}
+
+    float Compute(const PatternData& a, const PatternData& b) const override {
+        return ComputeFromFeatures(a.GetFeatures(), b.GetFeatures());
+    }
+
+    float ComputeFromFeatures(const FeatureVector&, const FeatureVector&) const override {
+        ++calls_;
+        return value_;
+    }
+
+    std::string GetName() const override { return "Counting"; }
+    bool ComputesFromFeatures() const override { return true; }
+
+    int Calls() const { return calls_; }
+
+private:
+    float value_;
+    mutable int calls_{0};
+};
+
 // ============================================================================
 // Helper Functions
 // ============================================================================
@@ -323,6 +347,76 @@ TEST(CompositeMetricTest, IsSymmetricWhenAllMetricsSymmetric) {
     EXPECT_TRUE(composite.IsSymmetric());
 }
 
+TEST(CompositeMetricTest, CascadeStopsBeforeUnreachableMetrics) {
+    CompositeMetric composite;
+    auto cheap = std::make_shared<ConstantMetric>(0.0f);
+    auto expensive = std::make_shared<CountingMetric>(1.0f);
+
+    composite.AddMetric(cheap, 1.0f);
+    composite.AddMetric(expensive, 1.0f);
+    composite.SetCascadeEnabled(true);
+
+    FeatureVector a({1.0f, 2.0f});
+    FeatureVector b({2.0f, 1.0f});
+
+    // 0.5 * 0.0 + 0.5 * (at most 1.0) can never reach 0.8
+    float similarity = composite.ComputeFromFeaturesBounded(a, {}, b, {}, 0.8f);
+    EXPECT_LT(similarity, 0.8f);
+    EXPECT_EQ(0, expensive->Calls());
+
+    auto stats = composite.GetMetricStats();
+    ASSERT_EQ(2u, stats.size());
+    EXPECT_EQ("Constant", stats[0].name);
+    EXPECT_EQ(1u, stats[0].evaluations);
+    EXPECT_EQ(0u, stats[1].evaluations);
+    EXPECT_EQ(1u, stats[1].evaluations_skipped);
+
+    // A reachable threshold evaluates everything and gives the exact sum
+    EXPECT_FLOAT_EQ(0.5f, composite.ComputeFromFeaturesBounded(a, {}, b, {}, 0.4f));
+    EXPECT_EQ(1, expensive->Calls());
+}
+
+TEST(CompositeMetricTest, CascadeDisabledEvaluatesAllMetrics) {
+    CompositeMetric composite;
+    auto expensive = std::make_shared<CountingMetric>(1.0f);
+
+    composite.AddMetric(std::make_shared<ConstantMetric>(0.0f), 1.0f);
+    composite.AddMetric(expensive, 1.0f);
+    EXPECT_FALSE(composite.IsCascadeEnabled());
+
+    FeatureVector a(std::vector<float>{1.0f});
+    FeatureVector b(std::vector<float>{2.0f});
+
+    EXPECT_FLOAT_EQ(0.5f, composite.ComputeFromFeaturesBounded(a, {}, b, {}, 0.8f));
+    EXPECT_EQ(1, expensive->Calls());
+}
+
+TEST(CompositeMetricTest, CascadeMatchesWeightedSum) {
+    CompositeMetric plain;
+    CompositeMetric cascaded;
+    for (auto* composite : {&plain, &cascaded}) {
+        composite->AddMetric(std::make_shared<CosineSimilarityMetric>(), 2.0f);
+        composite->AddMetric(std::make_shared<EuclideanSimilarityMetric>(), 1.0f);
+        composite->AddMetric(std::make_shared<ConstantMetric>(0.25f), 0.5f);
+    }
+    cascaded.SetCascadeEnabled(true);
+
+    FeatureVector query({1.0f, 2.0f, 3.0f});
+    for (int i = 0; i < 20; ++i) {
+        FeatureVector candidate({1.0f + i * 0.3f, 2.0f - i * 0.2f, 3.0f + (i % 3)});
+        float exact = plain.ComputeFromFeatures(query, candidate);
+
+        for (float threshold : {0.0f, 0.5f, exact, 0.9f}) {
+            float bounded = cascaded.ComputeFromFeaturesBounded(query, {}, candidate, {}, threshold);
+            if (exact >= threshold) {
+                EXPECT_EQ(exact, bounded);
+            } else {
+                EXPECT_LT(bounded, threshold);
+            }
+        }
+    }
+}
+
 TEST(CompositeMetricTest, ComputeFromFeaturesWorks) {
     CompositeMetric composite;
 
@@ -1,9 +1,14 @@
 // File: tests/similarity/similarity_search_test.cpp
 #include "similarity/similarity_search.hpp"
 #include "similarity/similarity_metric.hpp"
+#include "similarity/contextual_similarity.hpp"
+#include "similarity/geometric_similarity.hpp"
 #include "storage/memory_backend.hpp"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <random>
 
 namespace dpan {
 namespace {
@@ -237,6 +242,295 @@ TEST(SimilaritySearchTest, SetMetricRejectsNull) {
     EXPECT_THROW(search.SetMetric(nullptr), std::invalid_argument);
 }
 
+// ============================================================================
+// Bound-based Pruning Tests
+// ============================================================================
+
+// Database of random feature vectors; `spread` offsets each vector so that
+// point-set metrics see well separated clusters
+std::shared_ptr<PatternDatabase> CreateRandomDatabase(size_t count, size_t dim,
+                                                      float spread, uint32_t seed) {
+    auto db = std::make_shared<MemoryBackend>(MemoryBackend::Config{});
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+
+    for (size_t i = 0; i < count; ++i) {
+        float offset = spread * static_cast<float>(i % 17);
+        std::vector<float> values(dim);
+        for (auto& v : values) {
+            v = dist(rng) + offset;
+        }
+        PatternData data = PatternData::FromFeatures(FeatureVector(values), DataModality::NUMERIC);
+        db->Store(PatternNode(PatternID(i + 1), data, PatternType::ATOMIC));
+    }
+
+    return db;
+}
+
+// Reference top-k computed without any bounds
+std::vector<SearchResult> BruteForceTopK(PatternDatabase& db,
+                                         const SimilarityMetric& metric,
+                                         const FeatureVector& query,
+                                         const SearchConfig& config) {
+    std::vector<SearchResult> all;
+    QueryOptions options;
+    options.max_results = std::numeric_limits<size_t>::max();
+    for (const auto& id : db.FindAll(options)) {
+        auto node = db.Retrieve(id);
+        float similarity = metric.ComputeFromFeatures(query, node->GetData().GetFeatures());
+        if (similarity >= config.min_similarity) {
+            all.emplace_back(id, similarity);
+        }
+    }
+    std::sort(all.begin(), all.end());
+    if (all.size() > config.max_results) {
+        all.erase(all.begin() + config.max_results, all.end());
+    }
+    return all;
+}
+
+void ExpectSameSimilarities(const std::vector<SearchResult>& expected,
+                            const std::vector<SearchResult>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_FLOAT_EQ(expected[i].similarity, actual[i].similarity);
+    }
+}
+
+TEST(SimilaritySearchPruningTest, CosineSearchMatchesBruteForce) {
+    auto db = CreateRandomDatabase(300, 64, 0.0f, 1);
+    auto metric = std::make_shared<ContextVectorSimilarity>();
+    SimilaritySearch search(db, metric);
+
+    std::mt19937 rng(2);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> values(64);
+    for (auto& v : values) {
+        v = dist(rng);
+    }
+    FeatureVector query(values);
+
+    auto config = SearchConfig::TopK(5);
+    auto expected = BruteForceTopK(*db, *metric, query, config);
+
+    // Second run uses cached summaries as well as early abandon
+    for (int run = 0; run < 2; ++run) {
+        auto results = search.SearchByFeatures(query, config);
+        ExpectSameSimilarities(expected, results);
+        EXPECT_GT(search.GetLastSearchStats().patterns_pruned, 0u);
+    }
+}
+
+TEST(SimilaritySearchPruningTest, PivotSearchMatchesBruteForce) {
+    auto db = CreateRandomDatabase(200, 32, 3.0f, 3);
+    auto metric = std::make_shared<HausdorffSimilarity>();
+    SimilaritySearch search(db, metric);
+    search.BuildPivotIndex(4);
+    EXPECT_EQ(4u, search.GetPivotCount());
+
+    auto query_node = db->Retrieve(PatternID(42));
+    FeatureVector query = query_node->GetData().GetFeatures();
+
+    for (const auto& config : {SearchConfig::TopK(5), SearchConfig::WithThreshold(0.3f)}) {
+        auto expected = BruteForceTopK(*db, *metric, query, config);
+        auto results = search.Search(query_node->GetData(), config);
+
+        ExpectSameSimilarities(expected, results);
+        EXPECT_GT(search.GetLastSearchStats().patterns_pruned, 0u);
+    }
+}
+
+TEST(SimilaritySearchPruningTest, PivotIndexRequiresTrueMetric) {
+    auto db = CreateTestDatabase();
+    SimilaritySearch search(db, std::make_shared<MockSumSimilarity>());
+
+    EXPECT_THROW(search.BuildPivotIndex(4), std::runtime_error);
+    EXPECT_NO_THROW(search.BuildPivotIndex(0));
+    EXPECT_EQ(0u, search.GetPivotCount());
+}
+
+TEST(SimilaritySearchPruningTest, UpdatedPatternInvalidatesCachedBounds) {
+    auto db = CreateRandomDatabase(100, 32, 3.0f, 4);
+    auto metric = std::make_shared<HausdorffSimilarity>();
+    FeatureVector query = db->Retrieve(PatternID(1))->GetData().GetFeatures();
+    PatternData query_data = PatternData::FromFeatures(query, DataModality::NUMERIC);
+
+    // One search per path, each with bounds cached for every pattern
+    std::vector<std::unique_ptr<SimilaritySearch>> searches;
+    for (int i = 0; i < 3; ++i) {
+        searches.push_back(std::make_unique<SimilaritySearch>(db, metric));
+        searches.back()->BuildPivotIndex(4);
+        searches.back()->RangeSearchBatch({query_data}, 0.0f);
+    }
+
+    // Give a distant pattern the query's content behind the searches' backs;
+    // stale bounds would prune it
+    db->Update(PatternNode(PatternID(17), query_data, PatternType::ATOMIC));
+
+    auto contains_17 = [](const std::vector<SearchResult>& found) {
+        return std::any_of(found.begin(), found.end(), [](const SearchResult& r) {
+            return r.pattern_id == PatternID(17);
+        });
+    };
+    auto config = SearchConfig::WithThreshold(0.99f);
+    auto results = searches[0]->SearchByFeatures(query, config);
+    ExpectSameSimilarities(BruteForceTopK(*db, *metric, query, config), results);
+    EXPECT_TRUE(contains_17(results));
+    EXPECT_TRUE(contains_17(searches[1]->RangeSearch(query_data, 0.99f)));
+    EXPECT_TRUE(contains_17(searches[2]->RangeSearchBatch({query_data}, 0.99f)[0]));
+}
+
+// ============================================================================
+// Declarative Filter Tests
+// ============================================================================
+
+// ============================================================================
+// Range Search Tests
+// ============================================================================
+
+TEST(SimilaritySearchRangeTest, RangeSearchMatchesBruteForce) {
+    auto db = CreateRandomDatabase(200, 32, 3.0f, 5);
+    auto metric = std::make_shared<HausdorffSimilarity>();
+    SimilaritySearch search(db, metric);
+    search.BuildPivotIndex(4);
+
+    PatternData query = db->Retrieve(PatternID(9))->GetData();
+    auto ranked = BruteForceTopK(*db, *metric, query.GetFeatures(), SearchConfig::TopK(200));
+    const float threshold = ranked[20].similarity;
+
+    auto expected = BruteForceTopK(*db, *metric, query.GetFeatures(),
+                                   SearchConfig::WithThreshold(threshold, 200));
+    ASSERT_GE(expected.size(), 21u);
+
+    ExpectSameSimilarities(expected, search.RangeSearch(query, threshold));
+    ExpectSameSimilarities(expected, search.RangeSearch(query, threshold, 200, true));
+    EXPECT_GT(search.GetLastSearchStats().patterns_pruned, 0u);
+
+    // The limit keeps the most similar patterns
+    auto limited = search.RangeSearch(query, threshold, 5);
+    ExpectSameSimilarities(std::vector<SearchResult>(expected.begin(), expected.begin() + 5), limited);
+}
+
+TEST(SimilaritySearchRangeTest, RangeSearchUsesLayoutWithExactScores) {
+    auto db = CreateRandomDatabase(300, 32, 3.0f, 6);
+    auto metric = std::make_shared<HausdorffSimilarity>();
+    SimilaritySearch search(db, metric);
+    search.SetStoragePrecision(FeaturePrecision::FLOAT16);
+
+    PatternData query = db->Retrieve(PatternID(4))->GetData();
+    auto ranked = BruteForceTopK(*db, *metric, query.GetFeatures(), SearchConfig::TopK(300));
+    const float threshold = ranked[15].similarity;
+
+    auto expected = BruteForceTopK(*db, *metric, query.GetFeatures(),
+                                   SearchConfig::WithThreshold(threshold, 300));
+    auto results = search.RangeSearch(query, threshold);
+    ExpectSameSimilarities(expected, results);
+
+    // Only near neighbours were scored exactly
+    const auto& stats = search.GetLastSearchStats();
+    EXPECT_EQ(300u, stats.patterns_evaluated);
+    EXPECT_GT(stats.patterns_pruned, 200u);
+}
+
+TEST(SimilaritySearchRangeTest, RangeSearchOverLayoutMissesNoMatch) {
+    auto db = CreateRandomDatabase(300, 32, 3.0f, 7);
+    std::vector<std::shared_ptr<SimilarityMetric>> metrics{
+        std::make_shared<HausdorffSimilarity>(), std::make_shared<ChamferSimilarity>()};
+
+    for (const auto& metric : metrics) {
+        for (FeaturePrecision precision : {FeaturePrecision::BFLOAT16, FeaturePrecision::INT8}) {
+            SimilaritySearch search(db, metric);
+            search.SetStoragePrecision(precision);
+
+            for (uint64_t q = 1; q <= 5; ++q) {
+                PatternData query = db->Retrieve(PatternID(q * 31))->GetData();
+                auto ranked = BruteForceTopK(*db, *metric, query.GetFeatures(),
+                                             SearchConfig::TopK(300));
+                for (size_t rank : {3u, 40u}) {
+                    const float threshold = ranked[rank].similarity;
+                    auto expected = BruteForceTopK(*db, *metric, query.GetFeatures(),
+                                                   SearchConfig::WithThreshold(threshold, 300));
+                    ExpectSameSimilarities(expected, search.RangeSearch(query, threshold));
+                }
+            }
+        }
+    }
+}
+
+TEST(SimilaritySearchRangeTest, RangeSearchBatchMatchesRangeSearch) {
+    auto db = CreateRandomDatabase(250, 16, 3.0f, 8);
+    auto metric = std::make_shared<HausdorffSimilarity>();
+    SimilaritySearch search(db, metric);
+    search.BuildPivotIndex(4);
+
+    std::vector<PatternData> queries;
+    for (uint64_t id = 3; id <= 250; id += 41) {
+        queries.push_back(db->Retrieve(PatternID(id))->GetData());
+    }
+    const float threshold = BruteForceTopK(*db, *metric, queries[0].GetFeatures(),
+                                           SearchConfig::TopK(250))[25].similarity;
+
+    auto batch = search.RangeSearchBatch(queries, threshold, 10);
+    EXPECT_EQ(250u * queries.size(), search.GetLastSearchStats().patterns_evaluated);
+    EXPECT_GT(search.GetLastSearchStats().patterns_pruned, 0u);
+
+    ASSERT_EQ(queries.size(), batch.size());
+    for (size_t q = 0; q < queries.size(); ++q) {
+        ExpectSameSimilarities(search.RangeSearch(queries[q], threshold, 10, true), batch[q]);
+    }
+}
+
+TEST(SimilaritySearchFilterTest, PatternFilterMatchesResidualFilter) {
+    auto db = CreateRandomDatabase(300, 32, 0.0f, 5);
+    for (uint64_t i = 1; i <= 300; ++i) {
+        auto node = db->Retrieve(PatternID(i));
+        node->SetConfidenceScore(i % 5 == 0 ? 0.9f : 0.2f);
+        db->Update(*node);
+    }
+
+    auto metric = std::make_shared<ContextVectorSimilarity>();
+    SimilaritySearch search(db, metric);
+    FeatureVector query = db->Retrieve(PatternID(7))->GetData().GetFeatures();
+
+    SearchConfig residual = SearchConfig::TopK(10);
+    residual.filter = [](const PatternNode& node) {
+        return node.GetConfidenceScore() >= 0.5f;
+    };
+    auto expected = search.SearchByFeatures(query, residual);
+    EXPECT_EQ(300u, search.GetLastSearchStats().patterns_evaluated);
+
+    SearchConfig declarative = SearchConfig::TopK(10);
+    declarative.pattern_filter.min_confidence = 0.5f;
+    declarative.pattern_filter.types = {PatternType::ATOMIC};
+    auto results = search.SearchByFeatures(query, declarative);
+
+    // Only the 60 confident patterns are ever retrieved
+    EXPECT_EQ(60u, search.GetLastSearchStats().patterns_evaluated);
+    ASSERT_EQ(expected.size(), results.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].pattern_id, results[i].pattern_id);
+        EXPECT_FLOAT_EQ(expected[i].similarity, results[i].similarity);
+    }
+}
+
+TEST(SimilaritySearchFilterTest, AllowListRestrictsApproximateSearch) {
+    auto db = CreateRandomDatabase(50, 8, 1.0f, 6);
+    auto metric = std::make_shared<ContextVectorSimilarity>();
+    ApproximateSearch search(db, metric, 1);
+    search.BuildIndex();
+
+    SearchConfig config = SearchConfig::TopK(50);
+    config.pattern_filter.allowed_ids = std::vector<PatternID>{PatternID(3), PatternID(9)};
+
+    auto query = db->Retrieve(PatternID(1))->GetData();
+    auto results = search.Search(query, config);
+
+    ASSERT_EQ(2u, results.size());
+    for (const auto& result : results) {
+        EXPECT_TRUE(result.pattern_id == PatternID(3) || result.pattern_id == PatternID(9));
+    }
+}
+
 // ============================================================================
 // ApproximateSearch Tests
 // ============================================================================
@@ -378,6 +672,37 @@ TEST(MultiMetricSearchTest, WeightedCombinationWorks) {
     EXPECT_LE(results.size(), 3u);
 }
 
+TEST(MultiMetricSearchTest, CascadeMatchesFullEvaluation) {
+    auto db = CreateRandomDatabase(200, 32, 3.0f, 5);
+
+    MultiMetricSearch full(db);
+    MultiMetricSearch cascaded(db);
+    for (auto* search : {&full, &cascaded}) {
+        search->AddMetric(std::make_shared<MockSumSimilarity>(), 1.0f);
+        search->AddMetric(std::make_shared<HausdorffSimilarity>(), 1.0f);
+    }
+    cascaded.SetCascadeEnabled(true);
+    EXPECT_TRUE(cascaded.IsCascadeEnabled());
+
+    PatternData query = db->Retrieve(PatternID(9))->GetData();
+
+    // Sum similarities are tiny here, so a 0.6 threshold is decided before
+    // both metrics run. Which one goes first depends on measured cost, and
+    // the two cost about the same.
+    for (const auto& config : {SearchConfig::TopK(5), SearchConfig::WithThreshold(0.6f)}) {
+        ExpectSameSimilarities(full.Search(query, config), cascaded.Search(query, config));
+    }
+
+    auto stats = cascaded.GetMetricStats();
+    ASSERT_EQ(2u, stats.size());
+    EXPECT_EQ("Hausdorff", stats[1].name);
+    EXPECT_GT(stats[0].evaluations + stats[1].evaluations, 0u);
+    EXPECT_GT(stats[0].evaluations_skipped + stats[1].evaluations_skipped, 0u);
+
+    cascaded.ResetMetricStats();
+    EXPECT_EQ(0u, cascaded.GetMetricStats()[0].evaluations);
+}
+
 // ============================================================================
 // SearchConfig Tests
 // ============================================================================
@@ -0,0 +1,91 @@
+// File: tests/storage/indices/hierarchy_index_test.cpp
+#include "storage/indices/hierarchy_index.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+
+namespace dpan {
+namespace {
+
+std::vector<PatternID> Sorted(std::vector<PatternID> ids) {
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+TEST(HierarchyIndexTest, DefaultConstructorCreatesEmpty) {
+    HierarchyIndex index;
+    EXPECT_EQ(0u, index.Size());
+    EXPECT_TRUE(index.GetParents(PatternID(1)).empty());
+    EXPECT_TRUE(index.GetSubPatterns(PatternID(1)).empty());
+}
+
+TEST(HierarchyIndexTest, LinksAreIndexedBothWays) {
+    HierarchyIndex index;
+    index.SetSubPatterns(PatternID(10), {PatternID(1), PatternID(2), PatternID(1)});
+    index.SetSubPatterns(PatternID(11), {PatternID(2), PatternID(3)});
+
+    EXPECT_EQ(4u, index.Size());
+    EXPECT_EQ((std::vector<PatternID>{PatternID(1), PatternID(2)}),
+              index.GetSubPatterns(PatternID(10)));
+    EXPECT_EQ((std::vector<PatternID>{PatternID(10), PatternID(11)}),
+              Sorted(index.GetParents(PatternID(2))));
+    EXPECT_TRUE(index.HasParents(PatternID(3)));
+    EXPECT_FALSE(index.HasParents(PatternID(10)));
+}
+
+TEST(HierarchyIndexTest, SetReplacesAndRemoveDropsLinks) {
+    HierarchyIndex index;
+    index.SetSubPatterns(PatternID(10), {PatternID(1), PatternID(2)});
+    index.SetSubPatterns(PatternID(10), {PatternID(2), PatternID(3)});
+
+    EXPECT_EQ(2u, index.Size());
+    EXPECT_FALSE(index.HasParents(PatternID(1)));
+    EXPECT_EQ(std::vector<PatternID>{PatternID(10)}, index.GetParents(PatternID(3)));
+
+    EXPECT_TRUE(index.RemoveParent(PatternID(10)));
+    EXPECT_FALSE(index.RemoveParent(PatternID(10)));
+    EXPECT_EQ(0u, index.Size());
+    EXPECT_FALSE(index.HasParents(PatternID(2)));
+
+    index.SetSubPatterns(PatternID(11), {PatternID(4)});
+    index.SetSubPatterns(PatternID(11), {});
+    EXPECT_EQ(0u, index.Size());
+}
+
+TEST(HierarchyIndexTest, TraverseReportsEachPatternAtItsSmallestDepth) {
+    // 100 -> {10, 11}, 10 -> {1, 2}, 11 -> {2, 3}, 3 -> {100} (a cycle)
+    HierarchyIndex index;
+    index.SetSubPatterns(PatternID(100), {PatternID(10), PatternID(11)});
+    index.SetSubPatterns(PatternID(10), {PatternID(1), PatternID(2)});
+    index.SetSubPatterns(PatternID(11), {PatternID(2), PatternID(3)});
+    index.SetSubPatterns(PatternID(3), {PatternID(100)});
+
+    auto descendants = index.Traverse({PatternID(100)}, HierarchyDirection::DESCENDANTS, 10);
+    ASSERT_EQ(5u, descendants.size());
+    EXPECT_EQ(PatternID(10), descendants[0].id);
+    EXPECT_EQ(1u, descendants[0].depth);
+    EXPECT_EQ(PatternID(3), descendants[4].id);
+    EXPECT_EQ(2u, descendants[4].depth);
+
+    EXPECT_EQ(2u, index.Traverse({PatternID(100)}, HierarchyDirection::DESCENDANTS, 1).size());
+    EXPECT_TRUE(index.Traverse({PatternID(100)}, HierarchyDirection::DESCENDANTS, 0).empty());
+
+    // Ancestors of two roots at once; a root reachable from the other is not reported
+    auto ancestors = index.Traverse({PatternID(2), PatternID(11)},
+                                    HierarchyDirection::ANCESTORS, 10);
+    std::vector<PatternID> ids;
+    for (const auto& entry : ancestors) {
+        ids.push_back(entry.id);
+    }
+    EXPECT_EQ((std::vector<PatternID>{PatternID(3), PatternID(10), PatternID(100)}), Sorted(ids));
+}
+
+TEST(HierarchyIndexTest, ClearRemovesAllLinks) {
+    HierarchyIndex index;
+    index.SetSubPatterns(PatternID(10), {PatternID(1), PatternID(2)});
+    index.Clear();
+    EXPECT_EQ(0u, index.Size());
+    EXPECT_TRUE(index.GetParents(PatternID(1)).empty());
+}
+
+} // namespace
+} // namespace dpan
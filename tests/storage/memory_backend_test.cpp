@@ -439,6 +439,59 @@ TEST(MemoryBackendTest, FindAllRespectsMaxResults) {
     EXPECT_LE(results.size(), 10u);
 }
 
+TEST(MemoryBackendTest, FindByFilterCombinesPredicates) {
+    MemoryBackend::Config config;
+    MemoryBackend backend(config);
+
+    std::vector<PatternID> expected;
+    for (int i = 0; i < 12; ++i) {
+        PatternID id = PatternID::Generate();
+        FeatureVector features(3);
+        DataModality modality = (i % 2 == 0) ? DataModality::NUMERIC : DataModality::AUDIO;
+        PatternType type = (i % 3 == 0) ? PatternType::COMPOSITE : PatternType::ATOMIC;
+        PatternNode node(id, PatternData::FromFeatures(features, modality), type);
+        node.SetConfidenceScore(0.1f * static_cast<float>(i % 10));
+        backend.Store(node);
+
+        if (type == PatternType::ATOMIC && modality == DataModality::NUMERIC &&
+            node.GetConfidenceScore() >= 0.3f) {
+            expected.push_back(id);
+        }
+    }
+
+    PatternFilter filter;
+    filter.types = {PatternType::ATOMIC};
+    filter.modalities = {DataModality::NUMERIC};
+    filter.min_confidence = 0.3f;
+
+    QueryOptions options;
+    std::vector<PatternID> results = backend.FindByFilter(filter, options);
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(expected, results);
+
+    // An allow-list narrows the result further
+    ASSERT_FALSE(expected.empty());
+    filter.allowed_ids = std::vector<PatternID>{expected.front(), PatternID::Generate()};
+    results = backend.FindByFilter(filter, options);
+    ASSERT_EQ(1u, results.size());
+    EXPECT_EQ(expected.front(), results.front());
+}
+
+TEST(MemoryBackendTest, FindByFilterEmptyFilterMatchesAll) {
+    MemoryBackend::Config config;
+    MemoryBackend backend(config);
+
+    for (int i = 0; i < 8; ++i) {
+        backend.Store(CreateTestPattern());
+    }
+
+    QueryOptions options;
+    EXPECT_EQ(8u, backend.FindByFilter(PatternFilter{}, options).size());
+
+    options.max_results = 3;
+    EXPECT_EQ(3u, backend.FindByFilter(PatternFilter{}, options).size());
+}
+
 // ============================================================================
 // Statistics Tests
 // ============================================================================
@@ -470,6 +523,127 @@ TEST(MemoryBackendTest, GetStatsReturnsValidStats) {
     EXPECT_GT(stats.memory_usage_bytes, 0u);
 }
 
+TEST(MemoryBackendTest, AggregatesTrackEveryWrite) {
+    MemoryBackend::Config config;
+    MemoryBackend backend(config);
+
+    std::vector<PatternNode> batch;
+    for (int i = 0; i < 150; ++i) {
+        PatternNode node = CreateTestPattern();
+        node.SetConfidenceScore(0.25f);
+        batch.push_back(std::move(node));
+    }
+    ASSERT_EQ(150u, backend.StoreBatch(batch));
+
+    PatternNode composite(PatternID::Generate(),
+                          PatternData::FromFeatures(FeatureVector(5), DataModality::NUMERIC),
+                          PatternType::COMPOSITE);
+    composite.SetConfidenceScore(0.75f);
+    ASSERT_TRUE(backend.Store(composite));
+
+    // Type and confidence change on update; 20 patterns are deleted
+    PatternNode meta(batch[0].GetID(), batch[0].GetData(), PatternType::META);
+    meta.SetConfidenceScore(1.0f);
+    ASSERT_TRUE(backend.Update(meta));
+    std::vector<PatternID> doomed;
+    for (int i = 1; i < 21; ++i) {
+        doomed.push_back(batch[i].GetID());
+    }
+    ASSERT_EQ(20u, backend.DeleteBatch(doomed));
+    ASSERT_TRUE(backend.Delete(batch[21].GetID()));
+    EXPECT_FALSE(backend.Delete(batch[21].GetID()));
+
+    PatternAggregates aggregates = backend.GetAggregates();
+    EXPECT_EQ(130u, aggregates.total_patterns);
+    EXPECT_EQ(128u, aggregates.atomic_patterns);
+    EXPECT_EQ(1u, aggregates.composite_patterns);
+    EXPECT_EQ(1u, aggregates.meta_patterns);
+    EXPECT_FLOAT_EQ((128 * 0.25f + 0.75f + 1.0f) / 130.0f, aggregates.AverageConfidence());
+    EXPECT_EQ(128u * 12u + 20u + 12u, aggregates.feature_bytes);
+    EXPECT_EQ(backend.ScanAggregates(), aggregates);
+
+    backend.Clear();
+    EXPECT_EQ(PatternAggregates{}, backend.GetAggregates());
+    EXPECT_EQ(0u, backend.GetStats().memory_usage_bytes);
+}
+
+TEST(MemoryBackendTest, HierarchyTracksEveryWrite) {
+    MemoryBackend::Config config;
+    MemoryBackend backend(config);
+
+    std::vector<PatternID> atoms;
+    for (int i = 0; i < 4; ++i) {
+        PatternNode node = CreateTestPattern();
+        atoms.push_back(node.GetID());
+        ASSERT_TRUE(backend.Store(node));
+    }
+
+    PatternNode composite(PatternID::Generate(), CreateTestPattern().GetData(),
+                          PatternType::COMPOSITE);
+    composite.AddSubPattern(atoms[0]);
+    composite.AddSubPattern(atoms[1]);
+    ASSERT_TRUE(backend.Store(composite));
+
+    PatternNode meta(PatternID::Generate(), CreateTestPattern().GetData(), PatternType::META);
+    meta.AddSubPattern(composite.GetID());
+    meta.AddSubPattern(atoms[2]);
+    ASSERT_TRUE(backend.Store(meta));
+
+    EXPECT_EQ(std::vector<PatternID>{composite.GetID()}, backend.GetParentPatterns(atoms[0]));
+    EXPECT_EQ(composite.GetSubPatterns(), backend.GetSubPatterns(composite.GetID()));
+    EXPECT_TRUE(backend.GetParentPatterns(atoms[3]).empty());
+
+    auto ancestors = backend.TraverseHierarchy({atoms[0]}, HierarchyDirection::ANCESTORS, 5);
+    ASSERT_EQ(2u, ancestors.size());
+    EXPECT_EQ(meta.GetID(), ancestors[1].id);
+    EXPECT_EQ(2u, ancestors[1].depth);
+    EXPECT_EQ(4u, backend.TraverseHierarchy(
+        {meta.GetID()}, HierarchyDirection::DESCENDANTS, 5).size());
+
+    // Update replaces the links, delete drops them
+    composite.RemoveSubPattern(atoms[0]);
+    composite.AddSubPattern(atoms[3]);
+    ASSERT_TRUE(backend.Update(composite));
+    EXPECT_TRUE(backend.GetParentPatterns(atoms[0]).empty());
+    EXPECT_EQ(std::vector<PatternID>{composite.GetID()}, backend.GetParentPatterns(atoms[3]));
+
+    ASSERT_TRUE(backend.Delete(meta.GetID()));
+    EXPECT_TRUE(backend.GetParentPatterns(composite.GetID()).empty());
+    EXPECT_TRUE(backend.GetParentPatterns(atoms[2]).empty());
+
+    // The index answers exactly what a scan of the stored nodes would
+    for (PatternID id : atoms) {
+        EXPECT_EQ(backend.PatternDatabase::GetParentPatterns(id), backend.GetParentPatterns(id));
+    }
+
+    backend.Clear();
+    EXPECT_TRUE(backend.GetSubPatterns(composite.GetID()).empty());
+}
+
+TEST(MemoryBackendTest, GetStatsMemoryMatchesNodeEstimates) {
+    MemoryBackend::Config config;
+    MemoryBackend backend(config);
+
+    std::vector<PatternID> ids;
+    for (int i = 0; i < 10; ++i) {
+        PatternNode node = CreateTestPattern();
+        ids.push_back(node.GetID());
+        backend.Store(node);
+    }
+    PatternNode parent = CreateTestPattern(ids[0]);
+    parent.AddSubPattern(ids[1]);
+    backend.Update(parent);
+    backend.Delete(ids[2]);
+
+    size_t expected = 0;
+    for (PatternID id : ids) {
+        if (auto node = backend.Retrieve(id)) {
+            expected += node->EstimateMemoryUsage();
+        }
+    }
+    EXPECT_EQ(expected, backend.GetStats().memory_usage_bytes);
+}
+
 // ============================================================================
 // Maintenance Tests
 // ============================================================================
@@ -485,6 +485,49 @@ TEST(PersistentBackendTest, FindByTimeRangeReturnsMatchingPatterns) {
     CleanupDatabase(db_path);
 }
 
+TEST(PersistentBackendTest, FindByFilterUsesIndexedAndResidualPredicates) {
+    std::string db_path = GetTempDbPath();
+
+    {
+        PersistentBackend::Config config;
+        config.db_path = db_path;
+        PersistentBackend backend(config);
+
+        // Created before the time window
+        backend.Store(CreateTestPattern());
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+        Timestamp start = Timestamp::Now();
+        std::vector<PatternID> confident;
+        for (int i = 0; i < 6; ++i) {
+            PatternNode node = CreateTestPattern();
+            node.SetConfidenceScore(i < 4 ? 0.9f : 0.1f);
+            if (i < 4) {
+                confident.push_back(node.GetID());
+            }
+            backend.Store(node);
+        }
+
+        PatternFilter filter;
+        filter.types = {PatternType::ATOMIC};
+        filter.created_after = start;
+
+        QueryOptions options;
+        EXPECT_EQ(6u, backend.FindByFilter(filter, options).size());
+
+        filter.min_confidence = 0.5f;
+        std::vector<PatternID> results = backend.FindByFilter(filter, options);
+        std::sort(confident.begin(), confident.end());
+        std::sort(results.begin(), results.end());
+        EXPECT_EQ(confident, results);
+
+        filter.types = {PatternType::COMPOSITE};
+        EXPECT_TRUE(backend.FindByFilter(filter, options).empty());
+    }
+
+    CleanupDatabase(db_path);
+}
+
 TEST(PersistentBackendTest, FindAllReturnsAllPatterns) {
     std::string db_path = GetTempDbPath();
 
@@ -552,6 +595,91 @@ TEST(PersistentBackendTest, GetStatsReturnsValidStats) {
     CleanupDatabase(db_path);
 }
 
+TEST(PersistentBackendTest, AggregatesLoadOnceAndTrackWrites) {
+    std::string db_path = GetTempDbPath();
+
+    {
+        PersistentBackend::Config config;
+        config.db_path = db_path;
+        PersistentBackend backend(config);
+
+        // Written before the totals are first loaded
+        std::vector<PatternID> ids;
+        for (int i = 0; i < 4; ++i) {
+            PatternNode node = CreateTestPattern();
+            node.SetConfidenceScore(0.5f);
+            ids.push_back(node.GetID());
+            backend.Store(node);
+        }
+        EXPECT_EQ(4u, backend.GetAggregates().total_patterns);
+
+        // Written after: kept current without rescanning
+        PatternNode composite(ids[0], backend.Retrieve(ids[0])->GetData(), PatternType::COMPOSITE);
+        composite.SetConfidenceScore(0.9f);
+        ASSERT_TRUE(backend.Update(composite));
+        ASSERT_TRUE(backend.Delete(ids[1]));
+        ASSERT_EQ(1u, backend.DeleteBatch({ids[2], ids[1]}));
+        std::vector<PatternNode> batch;
+        batch.push_back(CreateTestPattern());
+        batch.push_back(CreateTestPattern());
+        EXPECT_EQ(2u, backend.StoreBatch(batch));
+
+        PatternAggregates aggregates = backend.GetAggregates();
+        EXPECT_EQ(4u, aggregates.total_patterns);
+        EXPECT_EQ(3u, aggregates.atomic_patterns);
+        EXPECT_EQ(1u, aggregates.composite_patterns);
+        EXPECT_EQ(4u * 12u, aggregates.feature_bytes);
+        EXPECT_EQ(backend.ScanAggregates(), aggregates);
+
+        backend.Clear();
+        EXPECT_EQ(PatternAggregates{}, backend.GetAggregates());
+    }
+
+    CleanupDatabase(db_path);
+}
+
+TEST(PersistentBackendTest, HierarchyLoadedFromTableAndTracked) {
+    std::string db_path = GetTempDbPath();
+
+    PatternID atom_a = PatternID::Generate();
+    PatternID atom_b = PatternID::Generate();
+    PatternID composite_id = PatternID::Generate();
+    {
+        PersistentBackend::Config config;
+        config.db_path = db_path;
+        PersistentBackend backend(config);
+
+        backend.Store(CreateTestPattern(atom_a));
+        backend.Store(CreateTestPattern(atom_b));
+        PatternNode composite(composite_id, CreateTestPattern().GetData(), PatternType::COMPOSITE);
+        composite.AddSubPattern(atom_a);
+        backend.Store(composite);
+    }
+
+    {
+        // Links written by an earlier instance are loaded from the table
+        PersistentBackend::Config config;
+        config.db_path = db_path;
+        PersistentBackend backend(config);
+
+        EXPECT_EQ(std::vector<PatternID>{composite_id}, backend.GetParentPatterns(atom_a));
+        EXPECT_EQ(std::vector<PatternID>{atom_a}, backend.GetSubPatterns(composite_id));
+
+        // Later writes are tracked
+        PatternNode composite(composite_id, CreateTestPattern().GetData(), PatternType::COMPOSITE);
+        composite.AddSubPattern(atom_b);
+        ASSERT_TRUE(backend.Update(composite));
+        EXPECT_TRUE(backend.GetParentPatterns(atom_a).empty());
+        EXPECT_EQ(1u, backend.TraverseHierarchy(
+            {atom_b}, HierarchyDirection::ANCESTORS, 3).size());
+
+        ASSERT_TRUE(backend.Delete(composite_id));
+        EXPECT_TRUE(backend.GetParentPatterns(atom_b).empty());
+    }
+
+    CleanupDatabase(db_path);
+}
+
 // ============================================================================
 // Maintenance Tests
 // ============================================================================